@@ -2,7 +2,11 @@
 #include <filesystem>
 #include <chrono>
 #include <format>
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cstdio>
+#endif
 
 std::ofstream Logger::stream_;
 
@@ -15,10 +19,15 @@ void Logger::Init()
 	// ログファイルの名前にコンマ何秒はいらないので、削って秒にする
 	std::chrono::time_point<std::chrono::system_clock, std::chrono::seconds>
 		nowSeconds = std::chrono::time_point_cast<std::chrono::seconds>(now);
+#if defined(__cpp_lib_chrono) && __cpp_lib_chrono >= 201907L
 	// 日本時間 (PCの設定時間)　に変換
 	std::chrono::zoned_time localTime{ std::chrono::current_zone(), nowSeconds };
 	// formatを使って年月日_時分秒の文字列に変換
 	std::string dateString = std::format("{:%Y%m%d_%H%M%S}", localTime);
+#else
+	// タイムゾーンを扱えない標準ライブラリ(テスト・ツール用のビルド)ではUTCのまま
+	std::string dateString = std::format("{:%Y%m%d_%H%M%S}", nowSeconds);
+#endif
 	// 時刻を使ってファイル名を決定
 	std::string logFilePath = std::string("logs/") + dateString + ".log";
 	stream_.open(logFilePath, std::ios::out);
@@ -37,6 +46,11 @@ void Logger::Write(const std::string& msg)
 		stream_ << msg << std::endl;
 	}
 
+#ifdef _WIN32
 	// デバッグ出力にも流す
 	OutputDebugStringA((msg + "\n").c_str());
+#else
+	// Windows以外(テスト・ツール)は標準エラー出力に流す
+	std::fputs((msg + "\n").c_str(), stderr);
+#endif
 }
@@ -0,0 +1,377 @@
+#include "AudioConverter.h"
+#include "MathConfig.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <numeric>
+
+namespace {
+	constexpr double kPi = 3.14159265358979323846;
+	// 位相の数の上限 (比を約分しても大きい時は近い位相で代用する)
+	constexpr uint32_t kMaxPhaseCount = 1024;
+	// Kaiser窓の形 (大きいほど阻止域が深く、遷移帯が広い)
+	constexpr double kKaiserBeta = 8.0;
+	// カットオフをナイキスト周波数より少し下げて、遷移帯で折り返さないようにする
+	constexpr double kCutoffScale = 0.95;
+	// 3ch以上をステレオにまとめる時のセンター/サラウンドの係数 (-3dB)
+	constexpr float kDownmixGain = 0.70710678f;
+
+	// 第1種変形ベッセル関数 (Kaiser窓用)
+	double BesselI0(double x) {
+		double sum = 1.0;
+		double term = 1.0;
+		for (int k = 1; k < 32; ++k) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+			if (term < sum * 1e-12) {
+				break;
+			}
+		}
+		return sum;
+	}
+
+	// 係数と波形の積和 (countは8の倍数)
+	inline float Dot(const float* a, const float* b, uint32_t count) {
+#if defined(MATH_USE_AVX)
+		__m256 sum = _mm256_setzero_ps();
+		for (uint32_t i = 0; i < count; i += 8) {
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+		}
+		__m128 r = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+		r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+		r = _mm_add_ss(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(r);
+#elif defined(MATH_USE_SSE)
+		// 加算の依存を切るために2つに分けて足す
+		__m128 sum0 = _mm_setzero_ps();
+		__m128 sum1 = _mm_setzero_ps();
+		for (uint32_t i = 0; i < count; i += 8) {
+			sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+			sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+		}
+		__m128 r = _mm_add_ps(sum0, sum1);
+		r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+		r = _mm_add_ss(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_cvtss_f32(r);
+#else
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < count; ++i) {
+			sum += a[i] * b[i];
+		}
+		return sum;
+#endif
+	}
+
+	void ConvertInt16(const int16_t* source, size_t count, float* destination) {
+		constexpr float kScale = 1.0f / 32768.0f;
+		size_t i = 0;
+#ifdef MATH_USE_SSE
+		const __m128 scale = _mm_set1_ps(kScale);
+		for (; i + 8 <= count; i += 8) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			// 上位16bitに置いてから算術シフトで符号拡張する
+			const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(destination + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+#endif
+		for (; i < count; ++i) {
+			destination[i] = static_cast<float>(source[i]) * kScale;
+		}
+	}
+
+	void ConvertInt32(const int32_t* source, size_t count, float* destination) {
+		constexpr float kScale = 1.0f / 2147483648.0f;
+		size_t i = 0;
+#ifdef MATH_USE_SSE
+		const __m128 scale = _mm_set1_ps(kScale);
+		for (; i + 4 <= count; i += 4) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			_mm_storeu_ps(destination + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+		}
+#endif
+		for (; i < count; ++i) {
+			destination[i] = static_cast<float>(source[i]) * kScale;
+		}
+	}
+
+	void ConvertFloat64(const double* source, size_t count, float* destination) {
+		size_t i = 0;
+#ifdef MATH_USE_SSE
+		for (; i + 4 <= count; i += 4) {
+			const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(source + i));
+			const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(source + i + 2));
+			_mm_storeu_ps(destination + i, _mm_movelh_ps(lo, hi));
+		}
+#endif
+		for (; i < count; ++i) {
+			destination[i] = static_cast<float>(source[i]);
+		}
+	}
+
+	// 変換できる形式か
+	bool IsConvertible(const WaveFormat& format) {
+		if (format.channelCount == 0 || format.channelCount > 8 || format.sampleRate == 0) {
+			return false;
+		}
+		if (format.blockAlign != format.channelCount * (format.bitsPerSample / 8)) {
+			return false;
+		}
+		if (format.sampleType == WaveSampleType::Float) {
+			return format.bitsPerSample == 32 || format.bitsPerSample == 64;
+		}
+		return format.bitsPerSample == 8 || format.bitsPerSample == 16 || format.bitsPerSample == 24 || format.bitsPerSample == 32;
+	}
+}
+
+void ConvertSamplesToFloat(const void* source, const WaveFormat& format, size_t sampleCount, float* destination)
+{
+	assert(IsConvertible(format));
+	const uint8_t* bytes = static_cast<const uint8_t*>(source);
+	if (format.sampleType == WaveSampleType::Float) {
+		if (format.bitsPerSample == 32) {
+			std::memcpy(destination, source, sampleCount * sizeof(float));
+		} else {
+			ConvertFloat64(static_cast<const double*>(source), sampleCount, destination);
+		}
+		return;
+	}
+
+	switch (format.bitsPerSample) {
+	case 8:
+		// 8bitだけは符号なし (128が無音)
+		for (size_t i = 0; i < sampleCount; ++i) {
+			destination[i] = static_cast<float>(static_cast<int>(bytes[i]) - 128) * (1.0f / 128.0f);
+		}
+		break;
+	case 16:
+		ConvertInt16(static_cast<const int16_t*>(source), sampleCount, destination);
+		break;
+	case 24:
+		// 3バイトを32bitの上位に詰めて符号付きにする
+		for (size_t i = 0; i < sampleCount; ++i) {
+			const uint8_t* p = bytes + i * 3;
+			const uint32_t v = (uint32_t(p[0]) << 8) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 24);
+			destination[i] = static_cast<float>(static_cast<int32_t>(v)) * (1.0f / 2147483648.0f);
+		}
+		break;
+	case 32:
+		// 有効ビットが少なくても上位に詰めてあるので、そのまま割ればよい
+		ConvertInt32(static_cast<const int32_t*>(source), sampleCount, destination);
+		break;
+	default:
+		break;
+	}
+}
+
+void ConvertFloatToInt16(const float* source, size_t sampleCount, int16_t* destination)
+{
+	size_t i = 0;
+#ifdef MATH_USE_SSE
+	// 先に[-1, 1]に収めておく (cvtpsは範囲外だと0x80000000になるため)
+	const __m128 scale = _mm_set1_ps(32768.0f);
+	const __m128 minValue = _mm_set1_ps(-1.0f);
+	const __m128 maxValue = _mm_set1_ps(1.0f);
+	for (; i + 8 <= sampleCount; i += 8) {
+		const __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i), minValue), maxValue);
+		const __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i + 4), minValue), maxValue);
+		// 1.0は32768になるが、packsで32767に飽和する
+		const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)), _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), packed);
+	}
+#endif
+	for (; i < sampleCount; ++i) {
+		const float v = std::clamp(source[i], -1.0f, 1.0f) * 32768.0f;
+		destination[i] = static_cast<int16_t>((std::min)(std::lrint(v), 32767L));
+	}
+}
+
+void RemixChannels(const float* source, uint16_t sourceChannelCount, uint64_t frameCount, float* destination, uint16_t destinationChannelCount)
+{
+	assert(sourceChannelCount >= 1 && sourceChannelCount <= 8);
+	assert(destinationChannelCount <= 2 || destinationChannelCount == sourceChannelCount);
+	if (sourceChannelCount == destinationChannelCount) {
+		std::memcpy(destination, source, size_t(frameCount) * sourceChannelCount * sizeof(float));
+		return;
+	}
+
+	if (sourceChannelCount == 1) {
+		// モノラル -> ステレオは両方に同じ音
+		for (uint64_t i = 0; i < frameCount; ++i) {
+			destination[i * 2] = source[i];
+			destination[i * 2 + 1] = source[i];
+		}
+		return;
+	}
+
+	if (sourceChannelCount == 2) {
+		// ステレオ -> モノラルは平均
+		for (uint64_t i = 0; i < frameCount; ++i) {
+			destination[i] = (source[i * 2] + source[i * 2 + 1]) * 0.5f;
+		}
+		return;
+	}
+
+	// 3ch以上: FL FR FC LFE BL BR SL SR の並びとしてステレオにまとめる (LFEは捨てる)
+	static constexpr float kLeft[8] = { 1.0f, 0.0f, kDownmixGain, 0.0f, kDownmixGain, 0.0f, kDownmixGain, 0.0f };
+	static constexpr float kRight[8] = { 0.0f, 1.0f, kDownmixGain, 0.0f, 0.0f, kDownmixGain, 0.0f, kDownmixGain };
+	// 全チャンネルが最大でも割れないように、係数の合計で正規化する
+	float leftSum = 0.0f;
+	float rightSum = 0.0f;
+	for (uint16_t c = 0; c < sourceChannelCount; ++c) {
+		leftSum += kLeft[c];
+		rightSum += kRight[c];
+	}
+	const float leftScale = 1.0f / (std::max)(leftSum, 1.0f);
+	const float rightScale = 1.0f / (std::max)(rightSum, 1.0f);
+
+	for (uint64_t i = 0; i < frameCount; ++i) {
+		const float* frame = source + i * sourceChannelCount;
+		float left = 0.0f;
+		float right = 0.0f;
+		for (uint16_t c = 0; c < sourceChannelCount; ++c) {
+			left += frame[c] * kLeft[c];
+			right += frame[c] * kRight[c];
+		}
+		left *= leftScale;
+		right *= rightScale;
+		if (destinationChannelCount == 2) {
+			destination[i * 2] = left;
+			destination[i * 2 + 1] = right;
+		} else {
+			destination[i] = (left + right) * 0.5f;
+		}
+	}
+}
+
+AudioResampler::AudioResampler(uint32_t sourceRate, uint32_t destinationRate, uint32_t zeroCrossingCount)
+{
+	assert(sourceRate > 0 && destinationRate > 0 && zeroCrossingCount > 0);
+	const uint32_t divisor = std::gcd(sourceRate, destinationRate);
+	upFactor_ = destinationRate / divisor;
+	downFactor_ = sourceRate / divisor;
+	phaseCount_ = (std::min)(upFactor_, kMaxPhaseCount);
+
+	// 下げる時は出力のナイキスト周波数で切り、その分だけsincを横に伸ばす
+	const double ratio = (std::min)(1.0, double(upFactor_) / double(downFactor_));
+	const double cutoff = 0.5 * ratio * kCutoffScale; // 変換元の1サンプルあたりの周期
+	const uint32_t halfTapCount = static_cast<uint32_t>(std::ceil(zeroCrossingCount / ratio));
+	tapCount_ = (halfTapCount * 2 + 7) & ~7u;
+	const double halfWidth = tapCount_ / 2.0;
+	const double windowScale = 1.0 / BesselI0(kKaiserBeta);
+
+	// 位相pは変換元のサンプルの間の p / phaseCount_ の位置 (端のphaseCount_は次のサンプルの位置)
+	// タップkは 位置 + (k - tapCount_ / 2 + 1) - p / phaseCount_ のサンプルに掛かる
+	coefficients_.resize(size_t(phaseCount_ + 1) * tapCount_);
+	for (uint32_t p = 0; p <= phaseCount_; ++p) {
+		const double t = double(p) / phaseCount_;
+		float* phase = &coefficients_[size_t(p) * tapCount_];
+		double sum = 0.0;
+		for (uint32_t k = 0; k < tapCount_; ++k) {
+			const double x = double(k) - halfWidth + 1.0 - t;
+			const double u = x / halfWidth;
+			double value = 0.0;
+			if (std::abs(u) <= 1.0) {
+				const double arg = 2.0 * cutoff * x;
+				const double sinc = (x == 0.0) ? 1.0 : std::sin(kPi * arg) / (kPi * arg);
+				value = 2.0 * cutoff * sinc * BesselI0(kKaiserBeta * std::sqrt(1.0 - u * u)) * windowScale;
+			}
+			phase[k] = static_cast<float>(value);
+			sum += value;
+		}
+		// 直流の利得を1にそろえる (位相ごとに音量が揺れないように)
+		for (uint32_t k = 0; k < tapCount_; ++k) {
+			phase[k] = static_cast<float>(phase[k] / sum);
+		}
+	}
+}
+
+uint64_t AudioResampler::GetOutputFrameCount(uint64_t frameCount) const
+{
+	return (frameCount * upFactor_ + downFactor_ - 1) / downFactor_;
+}
+
+void AudioResampler::Process(const float* source, uint16_t channelCount, uint64_t frameCount, float* destination)
+{
+	const uint64_t outputFrameCount = GetOutputFrameCount(frameCount);
+	const uint32_t halfTapCount = tapCount_ / 2;
+	// 前にhalfTapCount、後ろにtapCount_分の無音を足して、端でも範囲チェック無しで積和できるようにする
+	planar_.assign(size_t(frameCount) + halfTapCount + tapCount_ + 1, 0.0f);
+
+	const uint32_t stepInteger = downFactor_ / upFactor_;
+	const uint32_t stepFraction = downFactor_ % upFactor_;
+	const bool isExactPhase = phaseCount_ == upFactor_;
+
+	for (uint16_t c = 0; c < channelCount; ++c) {
+		// 1チャンネル分を連続に並べる
+		float* samples = planar_.data() + halfTapCount;
+		for (uint64_t i = 0; i < frameCount; ++i) {
+			samples[i] = source[i * channelCount + c];
+		}
+
+		// 出力nの位置は n * M / L を整数部と余りで持って進める
+		uint64_t position = 0;
+		uint32_t fraction = 0;
+		for (uint64_t n = 0; n < outputFrameCount; ++n) {
+			const uint32_t phase = isExactPhase ? fraction
+				: static_cast<uint32_t>((uint64_t(fraction) * phaseCount_ + upFactor_ / 2) / upFactor_);
+			// タップ0は position - halfTapCount + 1 のサンプル
+			const float* window = planar_.data() + position + 1;
+			destination[n * channelCount + c] = Dot(window, &coefficients_[size_t(phase) * tapCount_], tapCount_);
+
+			position += stepInteger;
+			fraction += stepFraction;
+			if (fraction >= upFactor_) {
+				fraction -= upFactor_;
+				++position;
+			}
+		}
+	}
+}
+
+bool ConvertToMixFormat(const WaveFormat& format, const void* data, size_t size, const AudioMixFormat& mixFormat, std::vector<float>& output)
+{
+	output.clear();
+	const uint16_t channelCount = mixFormat.channelCount;
+	if (!IsConvertible(format) || mixFormat.sampleRate == 0 || channelCount == 0
+		|| (channelCount > 2 && channelCount != format.channelCount)) {
+		Logger::Write(std::format("ミキシング形式に変換できない形式です ({}ch {}bit {}Hz -> {}ch {}Hz)",
+			format.channelCount, format.bitsPerSample, format.sampleRate, channelCount, mixFormat.sampleRate));
+		return false;
+	}
+
+	const uint64_t frameCount = size / format.blockAlign;
+	std::vector<float> samples(size_t(frameCount) * format.channelCount);
+	ConvertSamplesToFloat(data, format, samples.size(), samples.data());
+
+	// チャンネルを減らす時は先に減らし、増やす時は後で増やす (レート変換するチャンネルを少なくする)
+	const bool isRemixFirst = channelCount < format.channelCount;
+	uint16_t currentChannelCount = format.channelCount;
+	if (isRemixFirst) {
+		std::vector<float> remixed(size_t(frameCount) * channelCount);
+		RemixChannels(samples.data(), currentChannelCount, frameCount, remixed.data(), channelCount);
+		samples.swap(remixed);
+		currentChannelCount = channelCount;
+	}
+
+	uint64_t currentFrameCount = frameCount;
+	if (format.sampleRate != mixFormat.sampleRate) {
+		AudioResampler resampler(format.sampleRate, mixFormat.sampleRate);
+		currentFrameCount = resampler.GetOutputFrameCount(frameCount);
+		std::vector<float> resampled(size_t(currentFrameCount) * currentChannelCount);
+		resampler.Process(samples.data(), currentChannelCount, frameCount, resampled.data());
+		samples.swap(resampled);
+	}
+
+	if (currentChannelCount != channelCount) {
+		output.resize(size_t(currentFrameCount) * channelCount);
+		RemixChannels(samples.data(), currentChannelCount, currentFrameCount, output.data(), channelCount);
+	} else {
+		output = std::move(samples);
+	}
+	return true;
+}
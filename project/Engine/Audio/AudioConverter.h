@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "WaveReader.h"
+
+// ミキシングで使う形式 (floatのインターリーブ)
+// 読み込み時に全部の音をこの形式にそろえておくと、再生中の変換が要らず、ソースボイスも1種類で済む
+struct AudioMixFormat {
+	uint32_t sampleRate = 48000;
+	uint16_t channelCount = 2;
+};
+
+/// <summary>
+/// PCM(8/16/24/32bit整数、32/64bit浮動小数)を[-1, 1]のfloatにする
+/// </summary>
+/// <param name="source">変換元 (インターリーブのままでよい)</param>
+/// <param name="format">変換元の形式</param>
+/// <param name="sampleCount">サンプル数 (フレーム数 * チャンネル数)</param>
+/// <param name="destination">書き込み先 (sampleCount個)</param>
+void ConvertSamplesToFloat(const void* source, const WaveFormat& format, size_t sampleCount, float* destination);
+
+/// <summary>
+/// floatを16bit整数にする (範囲外は飽和させる)
+/// </summary>
+void ConvertFloatToInt16(const float* source, size_t sampleCount, int16_t* destination);
+
+/// <summary>
+/// チャンネル数を変える
+/// 1chと2chの間は複製/平均、3ch以上(WAVEの既定の並び FL FR FC LFE BL BR SL SR)からはステレオにまとめる
+/// </summary>
+/// <param name="source">変換元 (インターリーブ)</param>
+/// <param name="sourceChannelCount">変換元のチャンネル数 (1～8)</param>
+/// <param name="frameCount">フレーム数</param>
+/// <param name="destination">書き込み先 (インターリーブ、frameCount * destinationChannelCount個)</param>
+/// <param name="destinationChannelCount">変換先のチャンネル数 (1か2、または変換元と同じ)</param>
+void RemixChannels(const float* source, uint16_t sourceChannelCount, uint64_t frameCount, float* destination, uint16_t destinationChannelCount);
+
+/// <summary>
+/// 窓付きsinc(Kaiser窓)のポリフェーズフィルタでサンプリングレートを変える
+/// レートの比を約分した L/M の位相を持ち(多すぎる時は近い位相で代用)、1出力サンプルはタップ数分の積和になる
+/// 下げる時はカットオフを出力のナイキスト周波数に合わせて折り返しを抑える
+/// </summary>
+class AudioResampler {
+public:
+	/// <summary>
+	/// コンストラクタ (フィルタを作る)
+	/// </summary>
+	/// <param name="sourceRate">変換元のサンプリングレート</param>
+	/// <param name="destinationRate">変換先のサンプリングレート</param>
+	/// <param name="zeroCrossingCount">片側のsincの零点の数 (多いほど急峻で重い)</param>
+	AudioResampler(uint32_t sourceRate, uint32_t destinationRate, uint32_t zeroCrossingCount = 16);
+
+	// 変換後のフレーム数
+	uint64_t GetOutputFrameCount(uint64_t frameCount) const;
+
+	/// <summary>
+	/// まとめて変換する (前後は無音として扱う)
+	/// </summary>
+	/// <param name="source">変換元 (インターリーブ)</param>
+	/// <param name="channelCount">チャンネル数</param>
+	/// <param name="frameCount">変換元のフレーム数</param>
+	/// <param name="destination">書き込み先 (インターリーブ、GetOutputFrameCount(frameCount) * channelCount個)</param>
+	void Process(const float* source, uint16_t channelCount, uint64_t frameCount, float* destination);
+
+	uint32_t GetTapCount() const { return tapCount_; }
+	uint32_t GetPhaseCount() const { return phaseCount_; }
+
+private:
+	uint32_t upFactor_; // L
+	uint32_t downFactor_; // M
+	uint32_t phaseCount_;
+	uint32_t tapCount_; // 1位相の係数の数 (8の倍数)
+	std::vector<float> coefficients_; // (phaseCount_ + 1) * tapCount_
+	std::vector<float> planar_; // 1チャンネル分の作業領域 (前後に無音を足す)
+};
+
+/// <summary>
+/// PCMをミキシング形式(float、指定のレートとチャンネル数)に変換する
+/// </summary>
+/// <param name="format">変換元の形式</param>
+/// <param name="data">変換元の波形データ</param>
+/// <param name="size">dataのバイト数</param>
+/// <param name="mixFormat">変換先の形式</param>
+/// <param name="output">書き込み先 (インターリーブ)</param>
+/// <returns>変換できたらtrue (チャンネル数などが対応外ならfalse)</returns>
+bool ConvertToMixFormat(const WaveFormat& format, const void* data, size_t size, const AudioMixFormat& mixFormat, std::vector<float>& output);
@@ -0,0 +1,289 @@
+#include "AudioMixer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace {
+	constexpr uint64_t kFixedOne = uint64_t(1) << 32;
+	// 32.32の小数部をfloatにする係数
+	constexpr float kFixedToFloat = 1.0f / 4294967296.0f;
+
+	inline float LoadSample(int16_t sample) {
+		return static_cast<float>(sample) * (1.0f / 32768.0f);
+	}
+
+	inline float LoadSample(float sample) {
+		return sample;
+	}
+
+	/// <summary>
+	/// 1ボイス分をバスに足す
+	/// 同じサンプリングレートなら補間せずにそのまま、違えば隣のフレームと線形補間する
+	/// </summary>
+	/// <returns>まだ続きがあればtrue</returns>
+	template<class Sample, uint32_t kSourceChannels>
+	bool MixFrames(const Sample* samples, uint32_t sourceFrameCount, bool isLoop, uint64_t& position, uint64_t step,
+		float leftGain, float rightGain, float* bus, uint32_t frameCount) {
+		const uint64_t end = uint64_t(sourceFrameCount) << 32;
+		uint32_t mixed = 0;
+		while (mixed < frameCount) {
+			if (position >= end) {
+				if (!isLoop) {
+					return false;
+				}
+				position %= end;
+			}
+
+			// 波形の終わりまでに出せるフレーム数
+			const uint64_t remaining = (end - position + step - 1) / step;
+			const uint32_t count = static_cast<uint32_t>((std::min)(remaining, uint64_t(frameCount - mixed)));
+			float* out = bus + mixed * 2;
+
+			if (step == kFixedOne) {
+				const Sample* in = samples + (position >> 32) * kSourceChannels;
+				for (uint32_t i = 0; i < count; ++i) {
+					if constexpr (kSourceChannels == 1) {
+						const float s = LoadSample(in[i]);
+						out[i * 2 + 0] += s * leftGain;
+						out[i * 2 + 1] += s * rightGain;
+					} else {
+						out[i * 2 + 0] += LoadSample(in[i * 2 + 0]) * leftGain;
+						out[i * 2 + 1] += LoadSample(in[i * 2 + 1]) * rightGain;
+					}
+				}
+				position += uint64_t(count) << 32;
+			} else {
+				// 最後のフレームより前は次のフレームが必ずあるので、境目の判定をループの外に出す
+				const uint64_t lastFrame = uint64_t(sourceFrameCount - 1) << 32;
+				const uint32_t safeCount = position < lastFrame
+					? static_cast<uint32_t>((std::min)(uint64_t(count), (lastFrame - position + step - 1) / step)) : 0;
+				for (uint32_t i = 0; i < safeCount; ++i) {
+					const Sample* in = samples + (position >> 32) * kSourceChannels;
+					const float t = static_cast<float>(static_cast<uint32_t>(position)) * kFixedToFloat;
+					if constexpr (kSourceChannels == 1) {
+						const float a = LoadSample(in[0]);
+						const float s = a + (LoadSample(in[1]) - a) * t;
+						out[i * 2 + 0] += s * leftGain;
+						out[i * 2 + 1] += s * rightGain;
+					} else {
+						const float l = LoadSample(in[0]);
+						const float r = LoadSample(in[1]);
+						out[i * 2 + 0] += (l + (LoadSample(in[2]) - l) * t) * leftGain;
+						out[i * 2 + 1] += (r + (LoadSample(in[3]) - r) * t) * rightGain;
+					}
+					position += step;
+				}
+				// 最後のフレームの次はループなら先頭、そうでなければ同じフレーム
+				for (uint32_t i = safeCount; i < count; ++i) {
+					const uint32_t index = static_cast<uint32_t>(position >> 32);
+					const uint32_t next = index + 1 < sourceFrameCount ? index + 1 : (isLoop ? 0 : index);
+					const float t = static_cast<float>(static_cast<uint32_t>(position)) * kFixedToFloat;
+					for (uint32_t c = 0; c < kSourceChannels; ++c) {
+						const float a = LoadSample(samples[index * kSourceChannels + c]);
+						const float b = LoadSample(samples[next * kSourceChannels + c]);
+						const float s = a + (b - a) * t;
+						if constexpr (kSourceChannels == 1) {
+							out[i * 2 + 0] += s * leftGain;
+							out[i * 2 + 1] += s * rightGain;
+						} else {
+							out[i * 2 + c] += s * (c == 0 ? leftGain : rightGain);
+						}
+					}
+					position += step;
+				}
+			}
+			mixed += count;
+		}
+		return isLoop || position < end;
+	}
+}
+
+AudioMixer::AudioMixer(uint32_t sampleRate, uint32_t maxVoiceCount)
+	: voices_(maxVoiceCount), sampleRate_(sampleRate)
+{
+	assert(sampleRate > 0 && maxVoiceCount > 0 && maxVoiceCount <= 0xFFFF);
+	activeIndices_.reserve(maxVoiceCount);
+	freeIndices_.reserve(maxVoiceCount);
+	// 小さい番号から使うように逆順に積む
+	for (uint32_t i = maxVoiceCount; i > 0; --i) {
+		freeIndices_.push_back(i - 1);
+	}
+}
+
+VoiceId AudioMixer::Play(const AudioBufferView& buffer, float gain, float pan, bool isLoop)
+{
+	if (!buffer.data || buffer.frameCount == 0 || buffer.sampleRate == 0 ||
+		(buffer.channelCount != 1 && buffer.channelCount != 2)) {
+		return kInvalidVoiceId;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (freeIndices_.empty()) {
+		return kInvalidVoiceId;
+	}
+	const uint32_t index = freeIndices_.back();
+	freeIndices_.pop_back();
+
+	Voice& voice = voices_[index];
+	voice.buffer = buffer;
+	voice.position = 0;
+	voice.step = (uint64_t(buffer.sampleRate) << 32) / sampleRate_;
+	voice.gain = gain;
+	voice.pan = (std::clamp)(pan, -1.0f, 1.0f);
+	voice.isLoop = isLoop;
+	voice.isActive = true;
+	// 0番の世代は使わない (番号が0にならないように)
+	voice.generation = static_cast<uint16_t>(voice.generation + 1);
+	if (voice.generation == 0) {
+		voice.generation = 1;
+	}
+	UpdatePanGains(voice);
+
+	voice.activeSlot = static_cast<uint32_t>(activeIndices_.size());
+	activeIndices_.push_back(index);
+	return (static_cast<VoiceId>(voice.generation) << 16) | index;
+}
+
+void AudioMixer::Stop(VoiceId voiceId)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (FindVoice(voiceId)) {
+		Deactivate(voiceId & 0xFFFF);
+	}
+}
+
+void AudioMixer::StopAll()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	while (!activeIndices_.empty()) {
+		Deactivate(activeIndices_.back());
+	}
+}
+
+void AudioMixer::SetGain(VoiceId voiceId, float gain)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (Voice* voice = FindVoice(voiceId)) {
+		voice->gain = gain;
+		UpdatePanGains(*voice);
+	}
+}
+
+void AudioMixer::SetPan(VoiceId voiceId, float pan)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (Voice* voice = FindVoice(voiceId)) {
+		voice->pan = (std::clamp)(pan, -1.0f, 1.0f);
+		UpdatePanGains(*voice);
+	}
+}
+
+bool AudioMixer::IsPlaying(VoiceId voiceId) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return FindVoice(voiceId) != nullptr;
+}
+
+void AudioMixer::SetMasterGain(float gain)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	masterGain_ = gain;
+}
+
+void AudioMixer::Mix(float* output, uint32_t frameCount)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	std::fill(output, output + size_t(frameCount) * kChannelCount, 0.0f);
+
+	for (size_t i = 0; i < activeIndices_.size();) {
+		const uint32_t index = activeIndices_[i];
+		if (MixVoice(voices_[index], output, frameCount)) {
+			++i;
+		} else {
+			// 末尾と入れ替えて消すので同じ位置をもう一度見る
+			Deactivate(index);
+		}
+	}
+
+	// マスター音量をかけて[-1, 1]に収める
+	const size_t sampleCount = size_t(frameCount) * kChannelCount;
+	for (size_t i = 0; i < sampleCount; ++i) {
+		const float sample = output[i] * masterGain_;
+		if (sample > 1.0f || sample < -1.0f) {
+			++clippedSampleCount_;
+		}
+		output[i] = (std::clamp)(sample, -1.0f, 1.0f);
+	}
+}
+
+uint32_t AudioMixer::GetActiveVoiceCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return static_cast<uint32_t>(activeIndices_.size());
+}
+
+uint64_t AudioMixer::GetClippedSampleCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return clippedSampleCount_;
+}
+
+void AudioMixer::Deactivate(uint32_t index)
+{
+	Voice& voice = voices_[index];
+	assert(voice.isActive);
+	// 末尾のボイスを空いた位置に移す
+	const uint32_t last = activeIndices_.back();
+	activeIndices_[voice.activeSlot] = last;
+	voices_[last].activeSlot = voice.activeSlot;
+	activeIndices_.pop_back();
+
+	voice.isActive = false;
+	voice.buffer = {};
+	freeIndices_.push_back(index);
+}
+
+AudioMixer::Voice* AudioMixer::FindVoice(VoiceId voiceId)
+{
+	const uint32_t index = voiceId & 0xFFFF;
+	if (voiceId == kInvalidVoiceId || index >= voices_.size()) {
+		return nullptr;
+	}
+	Voice& voice = voices_[index];
+	return (voice.isActive && voice.generation == (voiceId >> 16)) ? &voice : nullptr;
+}
+
+const AudioMixer::Voice* AudioMixer::FindVoice(VoiceId voiceId) const
+{
+	return const_cast<AudioMixer*>(this)->FindVoice(voiceId);
+}
+
+void AudioMixer::UpdatePanGains(Voice& voice)
+{
+	if (voice.buffer.channelCount == 1) {
+		// モノラルは等パワーで振り分ける (中央で左右とも-3dB)
+		const float angle = (voice.pan + 1.0f) * std::numbers::pi_v<float> * 0.25f;
+		voice.leftGain = voice.gain * std::cos(angle);
+		voice.rightGain = voice.gain * std::sin(angle);
+	} else {
+		// ステレオは反対側だけを絞る (中央でそのまま)
+		voice.leftGain = voice.gain * (std::min)(1.0f, 1.0f - voice.pan);
+		voice.rightGain = voice.gain * (std::min)(1.0f, 1.0f + voice.pan);
+	}
+}
+
+bool AudioMixer::MixVoice(Voice& voice, float* bus, uint32_t frameCount)
+{
+	const AudioBufferView& buffer = voice.buffer;
+	if (buffer.format == AudioSampleFormat::Int16) {
+		const int16_t* samples = static_cast<const int16_t*>(buffer.data);
+		return buffer.channelCount == 1
+			? MixFrames<int16_t, 1>(samples, buffer.frameCount, voice.isLoop, voice.position, voice.step, voice.leftGain, voice.rightGain, bus, frameCount)
+			: MixFrames<int16_t, 2>(samples, buffer.frameCount, voice.isLoop, voice.position, voice.step, voice.leftGain, voice.rightGain, bus, frameCount);
+	}
+	const float* samples = static_cast<const float*>(buffer.data);
+	return buffer.channelCount == 1
+		? MixFrames<float, 1>(samples, buffer.frameCount, voice.isLoop, voice.position, voice.step, voice.leftGain, voice.rightGain, bus, frameCount)
+		: MixFrames<float, 2>(samples, buffer.frameCount, voice.isLoop, voice.position, voice.step, voice.leftGain, voice.rightGain, bus, frameCount);
+}
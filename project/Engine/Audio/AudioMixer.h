@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// サンプルの型
+enum class AudioSampleFormat {
+	Int16,
+	Float32,
+};
+
+// ミキサーに渡す波形データ (インターリーブ、1chか2ch)
+// 中身はミキサーが再生している間は呼び出し側が持っておく
+struct AudioBufferView {
+	const void* data = nullptr;
+	uint32_t frameCount = 0;
+	uint16_t channelCount = 0;
+	uint32_t sampleRate = 0;
+	AudioSampleFormat format = AudioSampleFormat::Int16;
+};
+
+// 再生中の音の番号 (0は無効、止まった後の番号は別の音に使われない)
+using VoiceId = uint32_t;
+constexpr VoiceId kInvalidVoiceId = 0;
+
+// プラットフォームによらないソフトウェアミキサー
+// 全ボイスをfloatのステレオバスに足し合わせ、マスター音量をかけて[-1, 1]に収める
+// 出力はAudioOutputの派生クラス(XAudio2、WAVファイル、何もしない)がMixを呼んで取り出す
+// Play/Stopなどはゲームのスレッド、Mixは出力のスレッドから呼んでよい
+class AudioMixer
+{
+public:
+	static constexpr uint32_t kChannelCount = 2;
+
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="sampleRate">出力のサンプリングレート</param>
+	/// <param name="maxVoiceCount">同時に鳴らせる数</param>
+	explicit AudioMixer(uint32_t sampleRate = 48000, uint32_t maxVoiceCount = 256);
+
+	AudioMixer(const AudioMixer&) = delete;
+	AudioMixer& operator=(const AudioMixer&) = delete;
+
+	/// <summary>
+	/// 再生を始める (サンプリングレートが違えば線形補間で合わせる)
+	/// </summary>
+	/// <param name="buffer">波形データ</param>
+	/// <param name="gain">音量 (1で等倍)</param>
+	/// <param name="pan">左右の位置 (-1で左、0で中央、1で右)</param>
+	/// <param name="isLoop">最後まで行ったら先頭に戻るか</param>
+	/// <returns>ボイスの番号 (空きが無いか、データが無効ならkInvalidVoiceId)</returns>
+	VoiceId Play(const AudioBufferView& buffer, float gain = 1.0f, float pan = 0.0f, bool isLoop = false);
+
+	void Stop(VoiceId voiceId);
+	void StopAll();
+	void SetGain(VoiceId voiceId, float gain);
+	void SetPan(VoiceId voiceId, float pan);
+	bool IsPlaying(VoiceId voiceId) const;
+
+	void SetMasterGain(float gain);
+
+	/// <summary>
+	/// 全ボイスを混ぜてバスに書き出し、再生位置を進める
+	/// </summary>
+	/// <param name="output">書き込み先 (インターリーブのステレオ、frameCount * 2個)</param>
+	/// <param name="frameCount">フレーム数</param>
+	void Mix(float* output, uint32_t frameCount);
+
+	uint32_t GetSampleRate() const { return sampleRate_; }
+	uint32_t GetMaxVoiceCount() const { return static_cast<uint32_t>(voices_.size()); }
+	uint32_t GetActiveVoiceCount() const;
+
+	// これまでに[-1, 1]を超えて切り詰めたサンプル数
+	uint64_t GetClippedSampleCount() const;
+
+private:
+	struct Voice {
+		AudioBufferView buffer;
+		uint64_t position; // 再生位置 (32.32の固定小数、フレーム単位)
+		uint64_t step; // 1出力フレームで進む量 (32.32の固定小数)
+		float gain;
+		float pan;
+		float leftGain; // gainとpanから求めた左右の音量
+		float rightGain;
+		uint32_t activeSlot; // activeIndices_の中の位置
+		uint16_t generation; // 番号の使い回しを見分ける
+		bool isActive;
+		bool isLoop;
+	};
+
+	void Deactivate(uint32_t index);
+	Voice* FindVoice(VoiceId voiceId);
+	const Voice* FindVoice(VoiceId voiceId) const;
+	static void UpdatePanGains(Voice& voice);
+	// 1ボイス分をバスに足す (最後まで行ったらfalse)
+	static bool MixVoice(Voice& voice, float* bus, uint32_t frameCount);
+
+	mutable std::mutex mutex_;
+	std::vector<Voice> voices_;
+	std::vector<uint32_t> activeIndices_; // 鳴っているボイスの番号
+	std::vector<uint32_t> freeIndices_; // 空いているボイスの番号
+	uint32_t sampleRate_;
+	float masterGain_ = 1.0f;
+	uint64_t clippedSampleCount_ = 0;
+};
@@ -0,0 +1,130 @@
+#include "AudioOutput.h"
+#include "AudioMixer.h"
+#include "Logger.h"
+#include <algorithm>
+
+namespace {
+	constexpr uint16_t kFormatFloat = 0x0003;
+	constexpr uint32_t kBytesPerSample = sizeof(float);
+	constexpr uint32_t kFormatChunkSize = 16;
+	// RIFF(12) + fmtチャンク(8 + 16) + dataチャンクのヘッダ(8)
+	constexpr uint32_t kHeaderSize = 12 + 8 + kFormatChunkSize + 8;
+
+	void WriteLE16(uint8_t* p, uint16_t value) {
+		p[0] = static_cast<uint8_t>(value);
+		p[1] = static_cast<uint8_t>(value >> 8);
+	}
+
+	void WriteLE32(uint8_t* p, uint32_t value) {
+		for (int i = 0; i < 4; ++i) {
+			p[i] = static_cast<uint8_t>(value >> (i * 8));
+		}
+	}
+
+	void WriteTag(uint8_t* p, const char (&tag)[5]) {
+		std::copy(tag, tag + 4, p);
+	}
+
+	// 波形データのバイト数からWAVのヘッダを作る
+	void MakeWaveHeader(uint8_t (&header)[kHeaderSize], uint32_t sampleRate, uint32_t dataSize) {
+		const uint16_t blockAlign = static_cast<uint16_t>(AudioMixer::kChannelCount * kBytesPerSample);
+		WriteTag(header, "RIFF");
+		WriteLE32(header + 4, kHeaderSize - 8 + dataSize);
+		WriteTag(header + 8, "WAVE");
+		WriteTag(header + 12, "fmt ");
+		WriteLE32(header + 16, kFormatChunkSize);
+		WriteLE16(header + 20, kFormatFloat);
+		WriteLE16(header + 22, static_cast<uint16_t>(AudioMixer::kChannelCount));
+		WriteLE32(header + 24, sampleRate);
+		WriteLE32(header + 28, sampleRate * blockAlign);
+		WriteLE16(header + 32, blockAlign);
+		WriteLE16(header + 34, static_cast<uint16_t>(kBytesPerSample * 8));
+		WriteTag(header + 36, "data");
+		WriteLE32(header + 40, dataSize);
+	}
+}
+
+bool NullAudioOutput::Start(AudioMixer& mixer)
+{
+	mixer_ = &mixer;
+	renderedFrameCount_ = 0;
+	return true;
+}
+
+void NullAudioOutput::Stop()
+{
+	mixer_ = nullptr;
+}
+
+const float* NullAudioOutput::Render(uint32_t frameCount)
+{
+	if (!mixer_) {
+		return nullptr;
+	}
+	buffer_.resize(size_t(frameCount) * AudioMixer::kChannelCount);
+	mixer_->Mix(buffer_.data(), frameCount);
+	renderedFrameCount_ += frameCount;
+	return buffer_.data();
+}
+
+WaveFileAudioOutput::WaveFileAudioOutput(const std::string& filePath)
+	: filePath_(filePath)
+{
+}
+
+WaveFileAudioOutput::~WaveFileAudioOutput()
+{
+	Stop();
+}
+
+bool WaveFileAudioOutput::Start(AudioMixer& mixer)
+{
+	Stop();
+	file_.open(filePath_, std::ios_base::binary | std::ios_base::trunc);
+	if (!file_.is_open()) {
+		Logger::Write("WAVの書き出し先を開けませんでした: " + filePath_);
+		return false;
+	}
+
+	// サイズはStopで埋めるので、ひとまず0で書いておく
+	uint8_t header[kHeaderSize];
+	MakeWaveHeader(header, mixer.GetSampleRate(), 0);
+	file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+	mixer_ = &mixer;
+	renderedFrameCount_ = 0;
+	return true;
+}
+
+void WaveFileAudioOutput::Stop()
+{
+	if (!mixer_) {
+		return;
+	}
+
+	// WAVのサイズは32bitまでなので、超えた分はヘッダには入れない
+	const uint64_t dataSize = renderedFrameCount_ * AudioMixer::kChannelCount * kBytesPerSample;
+	const uint32_t headerDataSize = static_cast<uint32_t>((std::min)(dataSize, uint64_t(UINT32_MAX - kHeaderSize)));
+	uint8_t header[kHeaderSize];
+	MakeWaveHeader(header, mixer_->GetSampleRate(), headerDataSize);
+	file_.seekp(0, std::ios_base::beg);
+	file_.write(reinterpret_cast<const char*>(header), sizeof(header));
+	file_.close();
+
+	mixer_ = nullptr;
+}
+
+bool WaveFileAudioOutput::Render(uint32_t frameCount)
+{
+	if (!mixer_) {
+		return false;
+	}
+	buffer_.resize(size_t(frameCount) * AudioMixer::kChannelCount);
+	mixer_->Mix(buffer_.data(), frameCount);
+	file_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size() * sizeof(float)));
+	if (!file_) {
+		return false;
+	}
+	renderedFrameCount_ += frameCount;
+	return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class AudioMixer;
+
+// ミキサーの出力先
+// Startの後は出力先がミキサーのMixを呼んで音を取り出す
+class AudioOutput
+{
+public:
+	virtual ~AudioOutput() = default;
+
+	/// <summary>
+	/// 出力を始める
+	/// </summary>
+	/// <param name="mixer">音を取り出すミキサー (Stopまで呼び出し側が持っておく)</param>
+	/// <returns>始められたらtrue</returns>
+	virtual bool Start(AudioMixer& mixer) = 0;
+
+	virtual void Stop() = 0;
+};
+
+// どこにも出さない出力 (ミキサーの計測やテスト用)
+// 自分からはMixを呼ばないので、Renderで好きな量だけ進める
+class NullAudioOutput : public AudioOutput
+{
+public:
+	bool Start(AudioMixer& mixer) override;
+	void Stop() override;
+
+	/// <summary>
+	/// ミキサーを進める
+	/// </summary>
+	/// <param name="frameCount">フレーム数</param>
+	/// <returns>混ぜた結果 (インターリーブのステレオ、次のRenderまで有効。Start前ならnullptr)</returns>
+	const float* Render(uint32_t frameCount);
+
+	// これまでに進めたフレーム数
+	uint64_t GetRenderedFrameCount() const { return renderedFrameCount_; }
+
+private:
+	AudioMixer* mixer_ = nullptr;
+	std::vector<float> buffer_;
+	uint64_t renderedFrameCount_ = 0;
+};
+
+// WAVファイル(32bit float、ステレオ)に書き出す出力
+// Renderで進めた分を書き足し、Stopでヘッダのサイズを埋める
+class WaveFileAudioOutput : public AudioOutput
+{
+public:
+	explicit WaveFileAudioOutput(const std::string& filePath);
+	~WaveFileAudioOutput() override;
+
+	bool Start(AudioMixer& mixer) override;
+	void Stop() override;
+
+	/// <summary>
+	/// ミキサーを進めてファイルに書き足す
+	/// </summary>
+	/// <param name="frameCount">フレーム数</param>
+	/// <returns>書けたらtrue</returns>
+	bool Render(uint32_t frameCount);
+
+	uint64_t GetRenderedFrameCount() const { return renderedFrameCount_; }
+
+private:
+	std::string filePath_;
+	std::ofstream file_;
+	AudioMixer* mixer_ = nullptr;
+	std::vector<float> buffer_;
+	uint64_t renderedFrameCount_ = 0;
+};
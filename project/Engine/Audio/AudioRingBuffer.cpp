@@ -0,0 +1,97 @@
+#include "AudioRingBuffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+AudioRingBuffer::AudioRingBuffer(size_t capacity)
+{
+	assert(capacity > 0);
+	buffer_.resize(capacity);
+}
+
+size_t AudioRingBuffer::GetWritableSize() const
+{
+	// 相手(読み出し側)の位置はacquireで読み、そこまでのデータを使い終わったことを保証する
+	const size_t write = writePosition_.load(std::memory_order_relaxed);
+	const size_t read = readPosition_.load(std::memory_order_acquire);
+	return buffer_.size() - (write - read);
+}
+
+size_t AudioRingBuffer::Write(const void* data, size_t size)
+{
+	const uint8_t* source = static_cast<const uint8_t*>(data);
+	size_t written = 0;
+	// 折り返しをまたぐ時は2回に分かれる
+	while (written < size) {
+		size_t available = 0;
+		uint8_t* destination = AcquireWrite(available);
+		const size_t count = (std::min)(available, size - written);
+		if (count == 0) {
+			break;
+		}
+		std::memcpy(destination, source + written, count);
+		CommitWrite(count);
+		written += count;
+	}
+	return written;
+}
+
+uint8_t* AudioRingBuffer::AcquireWrite(size_t& size)
+{
+	const size_t write = writePosition_.load(std::memory_order_relaxed);
+	const size_t offset = write % buffer_.size();
+	size = (std::min)(GetWritableSize(), buffer_.size() - offset);
+	return buffer_.data() + offset;
+}
+
+void AudioRingBuffer::CommitWrite(size_t size)
+{
+	assert(size <= GetWritableSize());
+	// releaseで書いた中身が読み出し側から見えてから位置が進むようにする
+	writePosition_.store(writePosition_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+}
+
+size_t AudioRingBuffer::GetReadableSize() const
+{
+	const size_t write = writePosition_.load(std::memory_order_acquire);
+	const size_t read = readPosition_.load(std::memory_order_relaxed);
+	return write - read;
+}
+
+size_t AudioRingBuffer::Read(void* data, size_t size)
+{
+	uint8_t* destination = static_cast<uint8_t*>(data);
+	size_t readSize = 0;
+	while (readSize < size) {
+		size_t available = 0;
+		const uint8_t* source = AcquireRead(available);
+		const size_t count = (std::min)(available, size - readSize);
+		if (count == 0) {
+			break;
+		}
+		std::memcpy(destination + readSize, source, count);
+		CommitRead(count);
+		readSize += count;
+	}
+	return readSize;
+}
+
+const uint8_t* AudioRingBuffer::AcquireRead(size_t& size)
+{
+	const size_t read = readPosition_.load(std::memory_order_relaxed);
+	const size_t offset = read % buffer_.size();
+	size = (std::min)(GetReadableSize(), buffer_.size() - offset);
+	return buffer_.data() + offset;
+}
+
+void AudioRingBuffer::CommitRead(size_t size)
+{
+	assert(size <= GetReadableSize());
+	readPosition_.store(readPosition_.load(std::memory_order_relaxed) + size, std::memory_order_release);
+}
+
+void AudioRingBuffer::Reset()
+{
+	writePosition_.store(0, std::memory_order_relaxed);
+	readPosition_.store(0, std::memory_order_relaxed);
+}
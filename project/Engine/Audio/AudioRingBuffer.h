@@ -0,0 +1,73 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 1つのスレッドが書き込み、別の1つのスレッドが読み出すリングバッファ (ロックなし)
+// 読み書きの位置は増え続ける値で持ち、容量で割った余りを使う
+// 容量は切り上げないので、フレームの倍数で区切って使う時(StreamingSound)は容量もその倍数にすれば
+// AcquireWrite/AcquireReadで得る領域がフレームの途中で折り返さない
+class AudioRingBuffer
+{
+public:
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="capacity">容量 (バイト)</param>
+	explicit AudioRingBuffer(size_t capacity);
+
+	AudioRingBuffer(const AudioRingBuffer&) = delete;
+	AudioRingBuffer& operator=(const AudioRingBuffer&) = delete;
+
+	// ---- 書き込み側のスレッドから呼ぶ ----
+
+	// 書き込める量 (バイト)
+	size_t GetWritableSize() const;
+
+	/// <summary>
+	/// 書き込めるだけ書き込む
+	/// </summary>
+	/// <returns>書き込んだバイト数</returns>
+	size_t Write(const void* data, size_t size);
+
+	/// <summary>
+	/// 直接書き込める連続した領域を得る (折り返しの手前まで)
+	/// 書いた後にCommitWriteで進める
+	/// </summary>
+	/// <param name="size">領域のバイト数の出力先</param>
+	/// <returns>領域の先頭 (sizeが0なら満杯)</returns>
+	uint8_t* AcquireWrite(size_t& size);
+	void CommitWrite(size_t size);
+
+	// ---- 読み出し側のスレッドから呼ぶ ----
+
+	// 読み出せる量 (バイト)
+	size_t GetReadableSize() const;
+
+	/// <summary>
+	/// 読み出せるだけ読み出す
+	/// </summary>
+	/// <returns>読み出したバイト数</returns>
+	size_t Read(void* data, size_t size);
+
+	/// <summary>
+	/// 直接読める連続した領域を得る (折り返しの手前まで)
+	/// 読んだ後にCommitReadで進める
+	/// </summary>
+	/// <param name="size">領域のバイト数の出力先</param>
+	/// <returns>領域の先頭 (sizeが0なら空)</returns>
+	const uint8_t* AcquireRead(size_t& size);
+	void CommitRead(size_t size);
+
+	// 空にする (読み書きどちらのスレッドも触っていない時だけ呼ぶ)
+	void Reset();
+
+	size_t GetCapacity() const { return buffer_.size(); }
+
+private:
+	std::vector<uint8_t> buffer_;
+	std::atomic<size_t> writePosition_ = 0;
+	char padding_[64] = {}; // 読み書きの位置を別のキャッシュラインに置く
+	std::atomic<size_t> readPosition_ = 0;
+};
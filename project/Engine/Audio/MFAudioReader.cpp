@@ -0,0 +1,176 @@
+#include "MFAudioReader.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <propvarutil.h>
+#pragma comment(lib, "propsys.lib")
+
+namespace {
+	constexpr DWORD kAudioStream = static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM);
+}
+
+MFAudioReader::~MFAudioReader()
+{
+	Close();
+}
+
+bool MFAudioReader::Open(const wchar_t* wpath)
+{
+	Close();
+
+	HRESULT hr = MFCreateSourceReaderFromURL(wpath, nullptr, &reader_);
+	if (FAILED(hr)) {
+		Logger::Write(std::format("MFCreateSourceReaderFromURLエラー (0x{:08X})", static_cast<uint32_t>(hr)));
+		reader_.Reset();
+		return false;
+	}
+
+	// 最初の音声ストリームだけを読む
+	hr = reader_->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_ALL_STREAMS), FALSE);
+	if (SUCCEEDED(hr)) {
+		hr = reader_->SetStreamSelection(kAudioStream, TRUE);
+	}
+	if (FAILED(hr)) {
+		Logger::Write("音声ストリームを選べませんでした");
+		Close();
+		return false;
+	}
+
+	// ネイティブ型からch/rateを取っておく
+	Microsoft::WRL::ComPtr<IMFMediaType> mediaType;
+	UINT32 ch = 2, rate = 48000;
+	if (SUCCEEDED(reader_->GetNativeMediaType(kAudioStream, 0, &mediaType))) {
+		UINT32 v = 0;
+		if (SUCCEEDED(mediaType->GetUINT32(MF_MT_AUDIO_NUM_CHANNELS, &v))) {
+			ch = v;
+		}
+		if (SUCCEEDED(mediaType->GetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, &v))) {
+			rate = v;
+		}
+	}
+
+	hr = MFCreateMediaType(&mediaType);
+	if (FAILED(hr)) {
+		Logger::Write("MFCreateMediaTypeエラー");
+		Close();
+		return false;
+	}
+	mediaType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
+	mediaType->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM);
+	mediaType->SetUINT32(MF_MT_AUDIO_NUM_CHANNELS, ch);
+	mediaType->SetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, rate);
+	mediaType->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16);
+	mediaType->SetUINT32(MF_MT_AUDIO_BLOCK_ALIGNMENT, (ch * 16) / 8);
+	mediaType->SetUINT32(MF_MT_AUDIO_AVG_BYTES_PER_SECOND, rate * (ch * 16) / 8);
+
+	hr = reader_->SetCurrentMediaType(kAudioStream, nullptr, mediaType.Get());
+	if (FAILED(hr)) {
+		Logger::Write("SetCurrentMediaTypeエラー");
+		Close();
+		return false;
+	}
+
+	Microsoft::WRL::ComPtr<IMFMediaType> finalType;
+	hr = reader_->GetCurrentMediaType(kAudioStream, &finalType);
+	if (FAILED(hr)) {
+		Logger::Write("GetCurrentMediaTypeエラー");
+		Close();
+		return false;
+	}
+
+	WAVEFORMATEX* waveFormat = nullptr;
+	hr = MFCreateWaveFormatExFromMFMediaType(finalType.Get(), &waveFormat, nullptr);
+	if (FAILED(hr) || waveFormat == nullptr) {
+		Logger::Write("MFCreateWaveFormatExFromMFMediaTypeエラー");
+		Close();
+		return false;
+	}
+	format_ = *waveFormat;
+	CoTaskMemFree(waveFormat);
+
+	// 長さ(100ns単位)が分かれば全体の大きさを見積もる
+	PROPVARIANT duration;
+	PropVariantInit(&duration);
+	if (SUCCEEDED(reader_->GetPresentationAttribute(static_cast<DWORD>(MF_SOURCE_READER_MEDIASOURCE), MF_PD_DURATION, &duration)) &&
+		duration.vt == VT_UI8) {
+		estimatedSize_ = duration.uhVal.QuadPart * format_.nAvgBytesPerSec / 10000000;
+	}
+	PropVariantClear(&duration);
+	return true;
+}
+
+void MFAudioReader::Close()
+{
+	ReleaseBuffer();
+	reader_.Reset();
+	format_ = {};
+	estimatedSize_ = 0;
+	isEnd_ = false;
+}
+
+size_t MFAudioReader::Read(void* buffer, size_t size)
+{
+	BYTE* destination = static_cast<BYTE*>(buffer);
+	size_t readSize = 0;
+	while (readSize < size && reader_) {
+		// 読みかけのサンプルから取り出す
+		if (bufferOffset_ < bufferLength_) {
+			const size_t count = (std::min)(size - readSize, size_t(bufferLength_ - bufferOffset_));
+			std::memcpy(destination + readSize, bufferData_ + bufferOffset_, count);
+			bufferOffset_ += static_cast<DWORD>(count);
+			readSize += count;
+			continue;
+		}
+		ReleaseBuffer();
+		if (isEnd_) {
+			break;
+		}
+
+		// 次のサンプルを変換する
+		Microsoft::WRL::ComPtr<IMFSample> sample;
+		DWORD flags = 0;
+		HRESULT hr = reader_->ReadSample(kAudioStream, 0, nullptr, &flags, nullptr, &sample);
+		if (FAILED(hr) || (flags & MF_SOURCE_READERF_ENDOFSTREAM)) {
+			isEnd_ = true;
+			continue;
+		}
+		// データの無いサンプル(ストリームの切れ目など)は飛ばす
+		if (!sample || FAILED(sample->ConvertToContiguousBuffer(&buffer_))) {
+			buffer_.Reset();
+			continue;
+		}
+		DWORD maxLength = 0;
+		if (FAILED(buffer_->Lock(&bufferData_, &maxLength, &bufferLength_))) {
+			buffer_.Reset();
+			bufferData_ = nullptr;
+			bufferLength_ = 0;
+		}
+	}
+	return readSize;
+}
+
+bool MFAudioReader::Rewind()
+{
+	if (!reader_) {
+		return false;
+	}
+	ReleaseBuffer();
+	PROPVARIANT position;
+	InitPropVariantFromInt64(0, &position);
+	HRESULT hr = reader_->SetCurrentPosition(GUID_NULL, position);
+	PropVariantClear(&position);
+	isEnd_ = FAILED(hr);
+	return SUCCEEDED(hr);
+}
+
+void MFAudioReader::ReleaseBuffer()
+{
+	if (buffer_ && bufferData_) {
+		buffer_->Unlock();
+	}
+	buffer_.Reset();
+	bufferData_ = nullptr;
+	bufferLength_ = 0;
+	bufferOffset_ = 0;
+}
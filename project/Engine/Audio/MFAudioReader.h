@@ -0,0 +1,65 @@
+#pragma once
+#include <Windows.h>
+#include <wrl.h>
+#include <mfapi.h>
+#include <mfidl.h>
+#include <mfreadwrite.h>
+#include <cstddef>
+#include <cstdint>
+
+// Media Foundationで音声ファイル(MP3など)を16bit PCMに変換しながら少しずつ読む
+// MFStartupはSound::Initで済ませておく
+class MFAudioReader
+{
+public:
+	MFAudioReader() = default;
+	~MFAudioReader();
+
+	MFAudioReader(const MFAudioReader&) = delete;
+	MFAudioReader& operator=(const MFAudioReader&) = delete;
+
+	/// <summary>
+	/// ファイルを開いて出力形式(16bit PCM)を決める
+	/// </summary>
+	/// <param name="wpath">ファイルパス</param>
+	/// <returns>開けたらtrue (失敗の理由はログに出す)</returns>
+	bool Open(const wchar_t* wpath);
+
+	void Close();
+
+	bool IsOpen() const { return reader_ != nullptr; }
+
+	// 出力の波形フォーマット
+	const WAVEFORMATEX& GetFormat() const { return format_; }
+
+	// 曲の長さから見積もった全体のバイト数 (分からなければ0)
+	uint64_t GetEstimatedSize() const { return estimatedSize_; }
+
+	bool IsEnd() const { return isEnd_ && bufferOffset_ >= bufferLength_; }
+
+	/// <summary>
+	/// 変換した波形データを読む
+	/// </summary>
+	/// <param name="buffer">読み込み先</param>
+	/// <param name="size">読み込み先のバイト数</param>
+	/// <returns>読んだバイト数 (末尾なら0)</returns>
+	size_t Read(void* buffer, size_t size);
+
+	// 先頭に戻る
+	bool Rewind();
+
+private:
+	// 読み終わったサンプルのバッファを返す
+	void ReleaseBuffer();
+
+	Microsoft::WRL::ComPtr<IMFSourceReader> reader_;
+	WAVEFORMATEX format_ = {};
+	uint64_t estimatedSize_ = 0;
+
+	// 読みかけのサンプル (Lockしたまま少しずつ取り出す)
+	Microsoft::WRL::ComPtr<IMFMediaBuffer> buffer_;
+	BYTE* bufferData_ = nullptr;
+	DWORD bufferLength_ = 0;
+	DWORD bufferOffset_ = 0;
+	bool isEnd_ = false;
+};
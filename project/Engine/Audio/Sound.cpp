@@ -2,12 +2,65 @@
 #include <vector>
 #include <assert.h>
 #include "Logger.h"
+#include "WaveReader.h"
+#include "MFAudioReader.h"
 #include <algorithm>
+#include <cstring>
+
+namespace {
+	// 見積もりを超えた時に最低限空けておく量
+	constexpr size_t kDecodeChunkSize = 64 * 1024;
+
+	// WAVEの既定のスピーカーの並び (FL FR FC LFE BL BR SL SR、AudioConverterのRemixChannelsと同じ)
+	constexpr DWORD kDefaultSpeakers[] = {
+		SPEAKER_FRONT_LEFT, SPEAKER_FRONT_RIGHT, SPEAKER_FRONT_CENTER, SPEAKER_LOW_FREQUENCY,
+		SPEAKER_BACK_LEFT, SPEAKER_BACK_RIGHT, SPEAKER_SIDE_LEFT, SPEAKER_SIDE_RIGHT,
+	};
+
+	// XAudio2は64bit浮動小数を鳴らせないので、読み込んだ場所で32bitに詰め直す
+	// 前から順に書くので、書き込みが読み込みを追い越さない
+	// 戻り値は変換後のバイト数 (64bit浮動小数でなければそのまま)
+	size_t ConvertFloat64ToFloat32InPlace(WaveFormat& format, BYTE* data, size_t size) {
+		if (format.sampleType != WaveSampleType::Float || format.bitsPerSample != 64) {
+			return size;
+		}
+		const size_t sampleCount = size / sizeof(double);
+		for (size_t i = 0; i < sampleCount; ++i) {
+			double value;
+			std::memcpy(&value, data + i * sizeof(double), sizeof(double));
+			const float converted = static_cast<float>(value);
+			std::memcpy(data + i * sizeof(float), &converted, sizeof(float));
+		}
+		format.bitsPerSample = 32;
+		format.validBitsPerSample = 32;
+		format.blockAlign = static_cast<uint16_t>(format.channelCount * sizeof(float));
+		return sampleCount * sizeof(float);
+	}
+
+	// 古いAPI用に、呼び出し側がSoundUnloadで解放するバッファに移す
+	SoundData MakeSoundData(const WAVEFORMATEXTENSIBLE& wfex, const std::vector<BYTE>& buffer) {
+		SoundData soundData = {};
+		soundData.wfex = wfex;
+		soundData.pBuffer = new BYTE[buffer.size()];
+		std::memcpy(soundData.pBuffer, buffer.data(), buffer.size());
+		soundData.bufferSize = static_cast<unsigned int>(buffer.size());
+		return soundData;
+	}
+}
 
 bool Sound::Init()
 {
 	HRESULT result = XAudio2Create(&xAudio2_, 0, XAUDIO2_DEFAULT_PROCESSOR);
 	result = xAudio2_->CreateMasteringVoice(&masterVoice_);
+	// 位置を付けた音のパンに出力のチャンネル数を使う
+	XAUDIO2_VOICE_DETAILS masterDetails = {};
+	masterVoice_->GetVoiceDetails(&masterDetails);
+	voicePool_.Init(xAudio2_.Get(), 32, masterDetails.InputChannels);
+	// 読み込んだ音をマスターボイスと同じレートにそろえる (取れなければ既定の48kHzステレオのまま)
+	if (masterDetails.InputSampleRate > 0 && masterDetails.InputChannels > 0) {
+		mixFormat_.sampleRate = masterDetails.InputSampleRate;
+		mixFormat_.channelCount = static_cast<uint16_t>((std::min)(masterDetails.InputChannels, UINT32(2)));
+	}
 
 	result = MFStartup(MF_VERSION, 0);
 	if (SUCCEEDED(result)) {
@@ -19,6 +72,9 @@ bool Sound::Init()
 
 void Sound::Shutdown()
 {
+	// ソースボイスはマスターボイスより先に破棄する
+	voicePool_.Shutdown();
+
 	if (masterVoice_) {
 		masterVoice_->DestroyVoice();
 		masterVoice_ = nullptr;
@@ -35,66 +91,25 @@ void Sound::Shutdown()
 
 SoundData Sound::SoundLoadWave(const char* filename) {
 	/*--ファイルオープン--*/
-	// ファイル入力ストリームのインスタンス
-	std::ifstream file;
-	// .wavファイルをバイナリ―モードで開く
-	file.open(filename, std::ios_base::binary);
-	// ファイルオープン失敗を検出する
-	assert(file.is_open());
-
-	/*--.wavデータ読み込み--*/
-	RiffHeader riff;
-	file.read((char*)&riff, sizeof(riff));
-	// ファイルがRIFFかチェック
-	if (strncmp(riff.chunk.id, "RIFF", 4) != 0) {
-		assert(0);
-	}
-	// タイプがWAVEかチェック
-	if (strncmp(riff.type, "WAVE", 4) != 0) {
-		assert(0);
-	}
-
-	// Formatチャンクの読み込み
-	FormatChunk format = {};
-	// チャンクヘッダーの確認
-	file.read((char*)&format, sizeof(ChunkHeader));
-	if (strncmp(format.chunk.id, "fmt ", 4) != 0) {
-		assert(0);
-	}
-
-	// チャンク本体の読み込み
-	assert(format.chunk.size <= sizeof(format.fmt));
-	file.read((char*)&format.fmt, format.chunk.size);
-
-	// Dataチャンクの読み込み
-	ChunkHeader data;
-	file.read((char*)&data, sizeof(data));
-	// JUNKチャンクを検出した場合
-	if (strncmp(data.id, "JUNK", 4) == 0) {
-		// 読み取り位置をJUNKチャンクの終わりまで進める
-		file.seekg(data.size, std::ios_base::cur);
-		// 再読み込み
-		file.read((char*)&data, sizeof(data));
-	}
-
-	if (strncmp(data.id, "data", 4) != 0) {
-		assert(0);
-	}
-
-	// Dataチャンクのデータ部(波形データ)の読み込み
-	char* pBuffer = new char[data.size];
-	file.read(pBuffer, data.size);
-
-	// WAVEファイルを閉じる
-	file.close();
+	// チャンクの並びによらずfmtとdataを探す
+	WaveReader reader;
+	bool isOpened = reader.Open(filename);
+	assert(isOpened);
+	(void)isOpened;
+
+	/*--波形データ読み込み--*/
+	const size_t dataSize = static_cast<size_t>(reader.GetDataSize());
+	BYTE* pBuffer = new BYTE[dataSize];
+	WaveFormat format = reader.GetFormat();
+	size_t readSize = ConvertFloat64ToFloat32InPlace(format, pBuffer, reader.Read(pBuffer, dataSize));
 
 	/*--読み込んだ音声データをリターン--*/
 	// returnするための音声データ
 	SoundData soundData = {};
 
-	soundData.wfex = format.fmt;
-	soundData.pBuffer = reinterpret_cast<BYTE*>(pBuffer);
-	soundData.bufferSize = data.size;
+	soundData.wfex = ToWaveFormatExtensible(format);
+	soundData.pBuffer = pBuffer;
+	soundData.bufferSize = static_cast<unsigned int>(readSize);
 
 	return soundData;
 }
@@ -102,167 +117,102 @@ SoundData Sound::SoundLoadWave(const char* filename) {
 SoundData Sound::SoundLoadMP3(const wchar_t* wpath)
 {
 	Logger::Write("SoundLoadMp3開始");
-	SoundData soundData = {};
-	if (!mfStarted_) {
-		return soundData;
+	WAVEFORMATEXTENSIBLE wfex = {};
+	std::vector<BYTE> buffer;
+	if (!DecodeMP3(wpath, wfex, buffer)) {
+		return {};
 	}
+	return MakeSoundData(wfex, buffer);
+}
 
-	Microsoft::WRL::ComPtr<IMFSourceReader> pMFSourceReader{ nullptr };
-	MFCreateSourceReaderFromURL(wpath, nullptr, &pMFSourceReader);
-	Logger::Write("MFCreateSourceReaderFromURL通った");
-
-	// ストリーム選択
-	HRESULT hr = pMFSourceReader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_ALL_STREAMS), FALSE);
-
-	if (FAILED(hr)) {
-		return soundData;
+SoundData Sound::SoundLoad(const char* filename)
+{
+	Logger::Write("Soundロード開始");
+	WAVEFORMATEXTENSIBLE wfex = {};
+	std::vector<BYTE> buffer;
+	if (!Decode(filename, wfex, buffer)) {
+		return {};
 	}
-	Logger::Write("MF_SOURCE_READER_ALL_STREAMS通った");
+	return MakeSoundData(wfex, buffer);
+}
 
-	hr = pMFSourceReader->SetStreamSelection(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), TRUE);
+bool Sound::Decode(const char* filename, WAVEFORMATEXTENSIBLE& wfex, std::vector<BYTE>& buffer)
+{
+	std::string path(filename ? filename : "");
+	std::string ext = ToLowerExt(path);
 
-	if (FAILED(hr)) {
-		return soundData;
+	Logger::Write("Soundがwavかmp3か判定開始");
+	if (ext == ".wav") {
+		Logger::Write("Soundはwav");
+		return DecodeWave(filename, wfex, buffer);
 	}
-	Logger::Write("MF_SOURCE_READER_FIRST_AUDIO_STREAM通った");
-
-	// ネイティブ型からch/rateを取っておく
-	Microsoft::WRL::ComPtr<IMFMediaType> pMFMediaType{ nullptr };
-	UINT32 ch = 2, rate = 48000;
-	if (SUCCEEDED(pMFSourceReader->GetNativeMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), 0, &pMFMediaType))) {
-		UINT32 v = 0;
-		if (SUCCEEDED(pMFMediaType->GetUINT32(MF_MT_AUDIO_NUM_CHANNELS, &v))) {
-			ch = v;
-		}
-
-		if (SUCCEEDED(pMFMediaType->GetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, &v))) {
-			rate = v;
-		}
+	// mp3はMedia Foundationで読むのでWindowsだけ、oggは読めない
+	// Linuxでも読むにはdr_mp3とstb_vorbisをライセンスごとexternals/に入れてからここで振り分ける
+	if (ext == ".mp3") {
+		Logger::Write("Soundはmp3");
+		std::wstring w = ToWide(filename);
+		return DecodeMP3(w.c_str(), wfex, buffer);
 	}
 
-	hr = MFCreateMediaType(&pMFMediaType);
+	Logger::Write("未対応の音声形式です: " + path);
+	return false;
+}
 
-	if (FAILED(hr)) {
-		Logger::Write("MFCreateMediaTypeエラー");
-		return soundData;
-	}
-	Logger::Write("MFCreateMediaType通った");
-
-	pMFMediaType->SetGUID(MF_MT_MAJOR_TYPE, MFMediaType_Audio);
-	pMFMediaType->SetGUID(MF_MT_SUBTYPE, MFAudioFormat_PCM);
-	pMFMediaType->SetUINT32(MF_MT_AUDIO_NUM_CHANNELS, ch);
-	pMFMediaType->SetUINT32(MF_MT_AUDIO_SAMPLES_PER_SECOND, rate);
-	pMFMediaType->SetUINT32(MF_MT_AUDIO_BITS_PER_SAMPLE, 16);
-	pMFMediaType->SetUINT32(MF_MT_AUDIO_BLOCK_ALIGNMENT, (ch * 16) / 8);
-	pMFMediaType->SetUINT32(MF_MT_AUDIO_AVG_BYTES_PER_SECOND, rate * (ch * 16) / 8);
-
-	hr = pMFSourceReader->SetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), nullptr, pMFMediaType.Get());
-	
-	if (FAILED(hr)) {
-		Logger::Write("SetCurrentMediaTypeエラー");
-		return soundData;
+bool Sound::DecodeWave(const char* filename, WAVEFORMATEXTENSIBLE& wfex, std::vector<BYTE>& buffer)
+{
+	WaveReader reader;
+	if (!reader.Open(filename)) {
+		return false;
 	}
-	Logger::Write("SetCurrentMediaType通った");
+	buffer.resize(static_cast<size_t>(reader.GetDataSize()));
+	WaveFormat format = reader.GetFormat();
+	buffer.resize(ConvertFloat64ToFloat32InPlace(format, buffer.data(), reader.Read(buffer.data(), buffer.size())));
+	wfex = ToWaveFormatExtensible(format);
+	return true;
+}
 
-	Microsoft::WRL::ComPtr<IMFMediaType> finalType;
-	hr = pMFSourceReader->GetCurrentMediaType(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), &finalType);
-	
-	if (FAILED(hr)) {
-		Logger::Write("GetCurrentMediaTypeエラー");
-		return soundData;
+bool Sound::DecodeMP3(const wchar_t* wpath, WAVEFORMATEXTENSIBLE& wfex, std::vector<BYTE>& mediaData)
+{
+	if (!mfStarted_) {
+		return false;
 	}
-	Logger::Write("GetCurrentMediaType通った");
-
-	WAVEFORMATEX* waveFormat{ nullptr };
-	hr = MFCreateWaveFormatExFromMFMediaType(finalType.Get(), &waveFormat, nullptr);
 
-	if (FAILED(hr) || waveFormat == nullptr) {
-		Logger::Write("waveFormatがnullptrかMFCreateWaveFormatExFromMFMediaTypeエラー");
-		return soundData;
+	MFAudioReader reader;
+	if (!reader.Open(wpath)) {
+		return false;
 	}
-
-	std::vector<BYTE> mediaData;
-
+	// Media Foundationの出力は16bitステレオのPCMなので基本形式のまま
+	wfex = {};
+	wfex.Format = reader.GetFormat();
+
+	// 曲の長さから大きさを見積もって先に確保し、そこへ直接書き込む
+	// (見積もりを超えたら倍々で広げる)
+	mediaData.clear();
+	mediaData.resize(static_cast<size_t>(reader.GetEstimatedSize()) + kDecodeChunkSize);
+	size_t size = 0;
 	while (true) {
-		Microsoft::WRL::ComPtr<IMFSample> pMFSample{ nullptr };
-		DWORD dwStreamsFlags{ 0 };
-		pMFSourceReader->ReadSample(static_cast<DWORD>(MF_SOURCE_READER_FIRST_AUDIO_STREAM), 0, nullptr, &dwStreamsFlags, nullptr, &pMFSample);
-
-		if (dwStreamsFlags & MF_SOURCE_READERF_ENDOFSTREAM) {
-			break;
+		if (mediaData.size() - size < kDecodeChunkSize) {
+			mediaData.resize(mediaData.size() * 2);
 		}
-
-		Microsoft::WRL::ComPtr<IMFMediaBuffer> pMFMediaBuffer{ nullptr };
-		pMFSample->ConvertToContiguousBuffer(&pMFMediaBuffer);
-
-		BYTE* pBuffer{ nullptr };
-		DWORD cbCurrentLength = 0, maxLength = 0;
-		pMFMediaBuffer->Lock(&pBuffer, &maxLength, &cbCurrentLength);
-
-		if (cbCurrentLength) {
-			size_t old = mediaData.size();
-			mediaData.resize(old + cbCurrentLength);
-			std::memcpy(mediaData.data() + old, pBuffer, cbCurrentLength);
+		const size_t readSize = reader.Read(mediaData.data() + size, mediaData.size() - size);
+		if (readSize == 0) {
+			break;
 		}
-
-		//mediaData.resize(static_cast<size_t>(mediaData.size()) + static_cast<size_t>(cbCurrentLength));
-		//memcpy(mediaData.data() + mediaData.size() - static_cast<size_t>(cbCurrentLength), pBuffer, static_cast<size_t>(cbCurrentLength));
-
-		pMFMediaBuffer->Unlock();
+		size += readSize;
 	}
+	mediaData.resize(size);
 
-	BYTE* heap = new BYTE[mediaData.size()];
-	memcpy(heap, mediaData.data(), mediaData.size());
-
-	soundData.wfex = *waveFormat;
-	soundData.pBuffer = heap;
-	soundData.bufferSize = static_cast<unsigned int>(mediaData.size());
-
-	CoTaskMemFree(waveFormat);
-
-	return soundData;
+	return true;
 }
 
-SoundData Sound::SoundLoad(const char* filename)
-{
-	Logger::Write("Soundロード開始");
-	std::string path(filename ? filename : "");
-	std::string ext = ToLowerExt(path);
-
-	SoundData soundData = {};
-
-	Logger::Write("Soundがwavかmp3か判定開始");
-	if (ext == ".wav") {
-		Logger::Write("Soundはwav");
-		soundData = SoundLoadWave(filename);
-	}
-	if (ext == ".mp3") {
-		Logger::Write("Soundはmp3");
-		std::wstring w = ToWide(filename);
-		soundData = SoundLoadMP3(w.c_str());
-	}
-
-	return soundData;
+// 音声再生
+SourceVoiceId Sound::SoundPlayWave(const SoundData& soundData, int priority, float volume) {
+	// 同じ波形フォーマットで鳴り終わったSourceVoiceを使い回す
+	return voicePool_.Play(soundData.wfex.Format, soundData.pBuffer, soundData.bufferSize, priority, volume);
 }
 
-// 音声再生
-void Sound::SoundPlayWave(const SoundData& soundData) {
-	HRESULT result;
-
-	// 波形フォーマットを元にSourceVoiceの生成
-	IXAudio2SourceVoice* pSourceVoice = nullptr;
-	result = xAudio2_->CreateSourceVoice(&pSourceVoice, &soundData.wfex);
-	assert(SUCCEEDED(result));
-
-	// 再生する波形データの設定
-	XAUDIO2_BUFFER buf{};
-	buf.pAudioData = soundData.pBuffer;
-	buf.AudioBytes = soundData.bufferSize;
-	buf.Flags = XAUDIO2_END_OF_STREAM;
-
-	// 波形データの再生
-	result = pSourceVoice->SubmitSourceBuffer(&buf);
-	result = pSourceVoice->Start();
+SourceVoiceId Sound::SoundPlayWave(const SoundHandle& sound, int priority, float volume) {
+	return voicePool_.Play(sound, priority, volume);
 }
 
 // 音声データ解放
@@ -275,6 +225,37 @@ void Sound::SoundUnload(SoundData* soundData) {
 	soundData->wfex = {};
 }
 
+WAVEFORMATEXTENSIBLE Sound::ToWaveFormatExtensible(const WaveFormat& format) {
+	const WORD formatTag = format.sampleType == WaveSampleType::Float ? WAVE_FORMAT_IEEE_FLOAT : WAVE_FORMAT_PCM;
+	WAVEFORMATEXTENSIBLE wfex = {};
+	wfex.Format.wFormatTag = formatTag;
+	wfex.Format.nChannels = format.channelCount;
+	wfex.Format.nSamplesPerSec = format.sampleRate;
+	wfex.Format.nAvgBytesPerSec = format.sampleRate * format.blockAlign;
+	wfex.Format.nBlockAlign = format.blockAlign;
+	wfex.Format.wBitsPerSample = format.bitsPerSample;
+	wfex.Format.cbSize = 0;
+
+	const uint16_t validBits = format.validBitsPerSample ? format.validBitsPerSample : format.bitsPerSample;
+	if (format.channelCount <= 2 && validBits == format.bitsPerSample) {
+		return wfex;
+	}
+
+	// 基本形式では表せないので拡張部分を付ける
+	wfex.Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+	wfex.Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+	wfex.Samples.wValidBitsPerSample = validBits;
+	wfex.dwChannelMask = format.channelMask;
+	if (wfex.dwChannelMask == 0) {
+		for (uint16_t i = 0; i < format.channelCount && i < std::size(kDefaultSpeakers); ++i) {
+			wfex.dwChannelMask |= kDefaultSpeakers[i];
+		}
+	}
+	// KSDATAFORMAT_SUBTYPE_PCM/IEEE_FLOAT (先頭が元の形式タグで、残りは共通)
+	wfex.SubFormat = { formatTag, 0x0000, 0x0010, { 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 } };
+	return wfex;
+}
+
 std::wstring Sound::ToWide(const char* utf8) {
 	if (!utf8) {
 		return L"";
@@ -2,37 +2,25 @@
 #include <Windows.h>
 #include <wrl.h>
 #include <xAudio2.h>
+#include <mmreg.h>
 #include <fstream>
+#include <vector>
 #include <mfapi.h>
 #include <mfidl.h>
 #include <mfreadwrite.h>
+#include "AudioConverter.h"
+#include "SoundAsset.h"
+#include "SourceVoicePool.h"
+#include "WaveReader.h"
 #pragma comment(lib, "xaudio2.lib")
 #pragma comment(lib, "mfplat.lib")
 #pragma comment(lib, "Mfreadwrite.lib")
 #pragma comment(lib, "mfuuid.lib")
 
-// チャンクヘッダ
-struct ChunkHeader {
-	char id[4]; // チャンク毎のID
-	int32_t size; // チャンクサイズ
-};
-
-// RIFFヘッダチャンク
-struct RiffHeader {
-	ChunkHeader chunk; // "RIFF"
-	char type[4]; // "WAVE"
-};
-
-// FMTチャンク
-struct FormatChunk {
-	ChunkHeader chunk; // "fmt"
-	WAVEFORMATEX fmt; // 波形フォーマット
-};
-
 // 音声データ
 struct SoundData {
-	// 波形フォーマット
-	WAVEFORMATEX wfex;
+	// 波形フォーマット (3ch以上などはEXTENSIBLE、XAudio2にはwfex.Formatを渡す)
+	WAVEFORMATEXTENSIBLE wfex;
 	// バッファの先頭アドレス
 	BYTE* pBuffer;
 	// バッファのサイズ
@@ -47,15 +35,66 @@ public:
 	SoundData SoundLoadWave(const char* filename);
 	SoundData SoundLoadMP3(const wchar_t* wpath);
 	SoundData SoundLoad(const char* filename);
-	void SoundPlayWave(const SoundData& soundData);
+
+	/// <summary>
+	/// 拡張子に合わせて波形データを読み込む (SoundLoadとSoundCacheで使う)
+	/// </summary>
+	/// <param name="filename">ファイルパス (.wav/.mp3)</param>
+	/// <param name="wfex">波形フォーマットの書き込み先</param>
+	/// <param name="buffer">波形データの書き込み先</param>
+	/// <returns>読み込めたらtrue</returns>
+	bool Decode(const char* filename, WAVEFORMATEXTENSIBLE& wfex, std::vector<BYTE>& buffer);
+	/// <summary>
+	/// 再生する (ソースボイスはプールから使い回す)
+	/// </summary>
+	/// <param name="soundData">音声データ (再生が終わるまで解放しない)</param>
+	/// <param name="priority">優先度 (同時に鳴らせる数を超えた時、低いものから止める)</param>
+	/// <param name="volume">音量</param>
+	/// <returns>音の番号 (鳴らせなければkInvalidSourceVoiceId)</returns>
+	SourceVoiceId SoundPlayWave(const SoundData& soundData, int priority = 0, float volume = 1.0f);
+	/// <summary>
+	/// 共有している音声データを再生する (鳴り終わるまでプールがハンドルを持つ)
+	/// </summary>
+	/// <param name="sound">音声データ</param>
+	/// <param name="priority">優先度 (同時に鳴らせる数を超えた時、低いものから止める)</param>
+	/// <param name="volume">音量</param>
+	/// <returns>音の番号 (鳴らせなければkInvalidSourceVoiceId)</returns>
+	SourceVoiceId SoundPlayWave(const SoundHandle& sound, int priority = 0, float volume = 1.0f);
 	void SoundUnload(SoundData* soundData);
 
-private:
+	// ミキサーの出力(XAudio2AudioOutput)などに渡す
+	IXAudio2* GetXAudio2() const { return xAudio2_.Get(); }
+
+	// 再生が終わったボイスを空きに戻す (毎フレーム呼ぶ)
+	void Update() { voicePool_.Update(); }
+
+	// マスターボイスの入力に合わせたミキシング形式 (SoundCacheに渡すと再生時にXAudio2が変換しなくて済む)
+	// チャンネル数はRemixChannelsで作れる2chまで
+	const AudioMixFormat& GetMixFormat() const { return mixFormat_; }
+
+	// 効果音のボイスの使用状況
+	const SourceVoicePool& GetVoicePool() const { return voicePool_; }
+	// 鳴っている音の設定を変える (SpatialAudioで使う)
+	SourceVoicePool& GetVoicePool() { return voicePool_; }
+
+	// StreamingSoundなどでも使う変換
 	static std::wstring ToWide(const char* utf8);
 	static std::string  ToLowerExt(const std::string& path);
+	/// <summary>
+	/// XAudio2に渡す形式にする
+	/// 3ch以上か、有効ビット数が入れ物のビット数と違う時はWAVE_FORMAT_EXTENSIBLEにして
+	/// スピーカーの割り当て(無ければWAVEの既定の並び)と有効ビット数を入れる。それ以外はPCM/IEEE_FLOATの基本形式
+	/// </summary>
+	static WAVEFORMATEXTENSIBLE ToWaveFormatExtensible(const WaveFormat& format);
+
+private:
+	static bool DecodeWave(const char* filename, WAVEFORMATEXTENSIBLE& wfex, std::vector<BYTE>& buffer);
+	bool DecodeMP3(const wchar_t* wpath, WAVEFORMATEXTENSIBLE& wfex, std::vector<BYTE>& mediaData);
 
 	Microsoft::WRL::ComPtr<IXAudio2> xAudio2_;
 	IXAudio2MasteringVoice* masterVoice_;
+	SourceVoicePool voicePool_;
+	AudioMixFormat mixFormat_;
 
 	bool mfStarted_ = false;
 };
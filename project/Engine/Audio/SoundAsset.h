@@ -0,0 +1,17 @@
+#pragma once
+#include <Windows.h>
+#include <mmreg.h>
+#include <memory>
+#include <vector>
+
+// SoundCacheで共有する音声データ (読み込んだ後は変更しない)
+struct SoundAsset {
+	// 波形フォーマット (3ch以上などはEXTENSIBLE、XAudio2にはwfex.Formatを渡す)
+	WAVEFORMATEXTENSIBLE wfex;
+	// 波形データ
+	std::vector<BYTE> buffer;
+};
+
+// 共有する音声データへの参照 (最後の参照が消えたら解放される)
+// SourceVoicePoolは鳴らしている間これを持つので、キャッシュから外しても再生中のデータは消えない
+using SoundHandle = std::shared_ptr<const SoundAsset>;
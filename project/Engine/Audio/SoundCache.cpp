@@ -0,0 +1,105 @@
+#include "SoundCache.h"
+#include "Logger.h"
+#include <cstring>
+#include <format>
+
+namespace {
+	// XAudio2の形式からWaveFormatに戻す (EXTENSIBLEならSubFormatの形式タグと有効ビット数、スピーカーの割り当ても戻す)
+	WaveFormat ToWaveFormat(const WAVEFORMATEXTENSIBLE& wfex) {
+		const bool isExtensible = wfex.Format.wFormatTag == WAVE_FORMAT_EXTENSIBLE;
+		const WORD formatTag = isExtensible ? static_cast<WORD>(wfex.SubFormat.Data1) : wfex.Format.wFormatTag;
+		WaveFormat format;
+		format.sampleType = formatTag == WAVE_FORMAT_IEEE_FLOAT ? WaveSampleType::Float : WaveSampleType::Pcm;
+		format.channelCount = wfex.Format.nChannels;
+		format.sampleRate = wfex.Format.nSamplesPerSec;
+		format.bitsPerSample = wfex.Format.wBitsPerSample;
+		format.validBitsPerSample = isExtensible ? wfex.Samples.wValidBitsPerSample : wfex.Format.wBitsPerSample;
+		format.blockAlign = wfex.Format.nBlockAlign;
+		format.channelMask = isExtensible ? wfex.dwChannelMask : 0;
+		return format;
+	}
+}
+
+SoundCache::SoundCache(Sound& sound)
+	: sound_(sound)
+{
+}
+
+SoundCache::SoundCache(Sound& sound, const AudioMixFormat& mixFormat)
+	: sound_(sound)
+	, mixFormat_(mixFormat)
+{
+}
+
+SoundHandle SoundCache::Load(const std::string& filePath)
+{
+	auto it = pathToSound_.find(filePath);
+	if (it != pathToSound_.end()) {
+		return it->second;
+	}
+
+	auto asset = std::make_shared<SoundAsset>();
+	asset->wfex = {};
+	if (!sound_.Decode(filePath.c_str(), asset->wfex, asset->buffer)) {
+		// 失敗したものは覚えず、次のLoadでもう一度読む
+		Logger::Write("音声を読み込めませんでした: " + filePath);
+		return nullptr;
+	}
+	if (mixFormat_ && !ConvertAsset(*asset)) {
+		Logger::Write("音声をミキシング形式に変換できませんでした: " + filePath);
+		return nullptr;
+	}
+	asset->buffer.shrink_to_fit();
+
+	residentBytes_ += asset->buffer.size();
+	Logger::Write(std::format("[SoundCache] {} ({} bytes, 合計 {} bytes)", filePath, asset->buffer.size(), residentBytes_));
+	SoundHandle handle = std::move(asset);
+	pathToSound_.emplace(filePath, handle);
+	return handle;
+}
+
+size_t SoundCache::Trim()
+{
+	size_t count = 0;
+	for (auto it = pathToSound_.begin(); it != pathToSound_.end();) {
+		// キャッシュだけが持っているものを捨てる
+		if (it->second.use_count() == 1) {
+			residentBytes_ -= it->second->buffer.size();
+			it = pathToSound_.erase(it);
+			++count;
+		} else {
+			++it;
+		}
+	}
+	return count;
+}
+
+void SoundCache::Clear()
+{
+	pathToSound_.clear();
+	residentBytes_ = 0;
+}
+
+bool SoundCache::ConvertAsset(SoundAsset& asset) const
+{
+	const WaveFormat sourceFormat = ToWaveFormat(asset.wfex);
+	std::vector<float> samples;
+	if (!ConvertToMixFormat(sourceFormat, asset.buffer.data(), asset.buffer.size(), *mixFormat_, samples)) {
+		return false;
+	}
+
+	WaveFormat mixFormat;
+	mixFormat.sampleType = WaveSampleType::Float;
+	mixFormat.channelCount = mixFormat_->channelCount;
+	mixFormat.sampleRate = mixFormat_->sampleRate;
+	mixFormat.bitsPerSample = 32;
+	mixFormat.validBitsPerSample = 32;
+	mixFormat.blockAlign = static_cast<uint16_t>(mixFormat_->channelCount * sizeof(float));
+	asset.wfex = Sound::ToWaveFormatExtensible(mixFormat);
+
+	asset.buffer.resize(samples.size() * sizeof(float));
+	if (!samples.empty()) {
+		std::memcpy(asset.buffer.data(), samples.data(), asset.buffer.size());
+	}
+	return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "AudioConverter.h"
+#include "Sound.h"
+
+/// <summary>
+/// 読み込んだ音声をパスごとに1つだけ持っておく
+/// 同じパスを何度Loadしても読み込み(MP3のデコード)は最初の1回だけで、シーンをまたいでも同じデータを共有する
+/// </summary>
+class SoundCache {
+public:
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="sound">読み込みに使うSound (Init済み)</param>
+	explicit SoundCache(Sound& sound);
+
+	/// <summary>
+	/// コンストラクタ (読み込んだ音声を全部mixFormatのfloatにそろえる)
+	/// 形式が1つになるので再生時の変換が要らず、ソースボイスもプールで使い回しやすくなる
+	/// 16bitの音声はfloatになる分だけメモリが2倍になる
+	/// </summary>
+	/// <param name="sound">読み込みに使うSound (Init済み)</param>
+	/// <param name="mixFormat">そろえる形式</param>
+	SoundCache(Sound& sound, const AudioMixFormat& mixFormat);
+
+	/// <summary>
+	/// 音声を読み込む (読み込み済みならそれを返す)
+	/// </summary>
+	/// <param name="filePath">ファイルパス (.wav/.mp3)</param>
+	/// <returns>音声データ (読み込めなければnullptr)</returns>
+	SoundHandle Load(const std::string& filePath);
+
+	/// <summary>
+	/// キャッシュの外から参照されていない音声を捨てる
+	/// SoundPlayWaveで鳴らしている音声はプールがハンドルを持っているので、鳴り終わるまで捨てない
+	/// </summary>
+	/// <returns>捨てた数</returns>
+	size_t Trim();
+
+	// 全部の音声をキャッシュから外す (外で持っているハンドルはそのまま使える)
+	void Clear();
+
+	// キャッシュが持っている波形データのバイト数
+	size_t GetResidentBytes() const { return residentBytes_; }
+
+	// キャッシュしている音声の数
+	size_t GetCount() const { return pathToSound_.size(); }
+
+private:
+	// 読み込んだ音声をミキシング形式に変換する
+	bool ConvertAsset(SoundAsset& asset) const;
+
+	Sound& sound_;
+	std::optional<AudioMixFormat> mixFormat_;
+	std::unordered_map<std::string, SoundHandle> pathToSound_;
+	size_t residentBytes_ = 0;
+};
@@ -0,0 +1,307 @@
+#include "SourceVoicePool.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <format>
+#include <numbers>
+
+SourceVoicePool::~SourceVoicePool()
+{
+	Shutdown();
+}
+
+void SourceVoicePool::Init(IXAudio2* xAudio2, uint32_t maxVoiceCount, uint32_t outputChannelCount)
+{
+	assert(xAudio2 && maxVoiceCount > 0 && maxVoiceCount <= 0xFFFF && outputChannelCount > 0);
+	Shutdown();
+	xAudio2_ = xAudio2;
+	maxVoiceCount_ = maxVoiceCount;
+	outputChannelCount_ = outputChannelCount;
+	// 入力は2chまでしか割り当てを変えない
+	outputMatrix_.resize(size_t(outputChannelCount) * 2);
+	// Slotのアドレスが変わらないように先に確保する
+	slots_.reserve(maxVoiceCount);
+	// コールバックの中で確保し直さないように多めに取っておく
+	finishedIds_.reserve(size_t(maxVoiceCount) * 4);
+	finishedScratch_.reserve(size_t(maxVoiceCount) * 4);
+}
+
+void SourceVoicePool::Shutdown()
+{
+	// DestroyVoiceはコールバックが終わるのを待つので、この後は何も積まれない
+	for (Slot& slot : slots_) {
+		DestroyVoice(slot);
+	}
+	slots_.clear();
+	activeCount_ = 0;
+	freeCount_ = 0;
+	std::lock_guard<std::mutex> lock(finishedMutex_);
+	finishedIds_.clear();
+}
+
+SourceVoiceId SourceVoicePool::Play(const WAVEFORMATEX& format, const BYTE* data, uint32_t size, int priority, float volume)
+{
+	Update();
+	if (!xAudio2_ || !data || size == 0) {
+		return kInvalidSourceVoiceId;
+	}
+
+	const int32_t index = AcquireSlot(format, MakeFormatKey(format), priority);
+	if (index < 0) {
+		return kInvalidSourceVoiceId;
+	}
+	Slot& slot = slots_[index];
+
+	// 0番の世代は使わない (番号が0にならないように)
+	slot.generation = static_cast<uint16_t>(slot.generation + 1);
+	if (slot.generation == 0) {
+		slot.generation = 1;
+	}
+	const SourceVoiceId id = (static_cast<SourceVoiceId>(slot.generation) << 16) | static_cast<uint32_t>(index);
+
+	XAUDIO2_BUFFER buffer = {};
+	buffer.pAudioData = data;
+	buffer.AudioBytes = size;
+	buffer.Flags = XAUDIO2_END_OF_STREAM;
+	// 終わった時にどの再生かを見分ける
+	buffer.pContext = reinterpret_cast<void*>(static_cast<uintptr_t>(id));
+
+	// 前の再生で位置を付けていたら中央・等速に戻す
+	if (slot.isSpatial) {
+		SetOutputGains(slot, 1.0f, 1.0f);
+		slot.voice->SetFrequencyRatio(1.0f);
+		slot.isSpatial = false;
+	}
+	slot.voice->SetVolume(volume);
+	if (FAILED(slot.voice->SubmitSourceBuffer(&buffer))) {
+		return kInvalidSourceVoiceId;
+	}
+	slot.voice->Start();
+
+	slot.priority = priority;
+	slot.startOrder = nextStartOrder_++;
+	SetState(slot, SlotState::Playing);
+	return id;
+}
+
+SourceVoiceId SourceVoicePool::Play(const SoundHandle& sound, int priority, float volume)
+{
+	if (!sound) {
+		return kInvalidSourceVoiceId;
+	}
+	const SourceVoiceId id = Play(sound->wfex.Format, sound->buffer.data(), static_cast<uint32_t>(sound->buffer.size()), priority, volume);
+	if (id != kInvalidSourceVoiceId) {
+		// XAudio2が波形データを読み終わるまで解放されないようにする
+		slots_[id & 0xFFFF].sound = sound;
+	}
+	return id;
+}
+
+bool SourceVoicePool::SetSpatialOutput(SourceVoiceId id, float volume, float pan, float frequencyRatio)
+{
+	Slot* slot = FindSlot(id);
+	if (!slot || slot->state != SlotState::Playing) {
+		return false;
+	}
+
+	pan = (std::clamp)(pan, -1.0f, 1.0f);
+	const uint32_t sourceChannelCount = static_cast<uint32_t>((slot->formatKey.format >> 40) & 0xFF);
+	if (sourceChannelCount == 1) {
+		const float angle = (pan + 1.0f) * std::numbers::pi_v<float> * 0.25f;
+		SetOutputGains(*slot, std::cos(angle), std::sin(angle));
+	} else {
+		SetOutputGains(*slot, (std::min)(1.0f, 1.0f - pan), (std::min)(1.0f, 1.0f + pan));
+	}
+	slot->voice->SetVolume(volume);
+	slot->voice->SetFrequencyRatio((std::clamp)(frequencyRatio, XAUDIO2_MIN_FREQ_RATIO, XAUDIO2_DEFAULT_FREQ_RATIO));
+	slot->isSpatial = true;
+	return true;
+}
+
+void SourceVoicePool::Stop(SourceVoiceId id)
+{
+	Slot* slot = FindSlot(id);
+	if (!slot || slot->state != SlotState::Playing) {
+		return;
+	}
+	// 捨てたバッファのOnBufferEndが来るまでは次の再生に使わない
+	slot->voice->Stop();
+	slot->voice->FlushSourceBuffers();
+	SetState(*slot, SlotState::Stopping);
+}
+
+void SourceVoicePool::StopAll()
+{
+	for (Slot& slot : slots_) {
+		if (slot.state == SlotState::Playing) {
+			slot.voice->Stop();
+			slot.voice->FlushSourceBuffers();
+			SetState(slot, SlotState::Stopping);
+		}
+	}
+}
+
+bool SourceVoicePool::IsPlaying(SourceVoiceId id)
+{
+	Update();
+	const Slot* slot = FindSlot(id);
+	return slot && slot->state == SlotState::Playing;
+}
+
+void SourceVoicePool::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock(finishedMutex_);
+		finishedScratch_.swap(finishedIds_);
+	}
+	for (SourceVoiceId id : finishedScratch_) {
+		// 盗まれたり止められた後の古い番号はFindSlotで弾かれる
+		if (Slot* slot = FindSlot(id)) {
+			SetState(*slot, SlotState::Free);
+		}
+	}
+	finishedScratch_.clear();
+}
+
+SourceVoicePool::FormatKey SourceVoicePool::MakeFormatKey(const WAVEFORMATEX& format)
+{
+	FormatKey key;
+	key.format = (uint64_t(format.wFormatTag) << 48) | (uint64_t(format.nChannels & 0xFF) << 40) |
+		(uint64_t(format.wBitsPerSample & 0xFF) << 32) | uint64_t(format.nSamplesPerSec);
+	// EXTENSIBLEは有効ビット数やスピーカーの割り当てが違うと同じボイスで鳴らせない
+	if (format.wFormatTag == WAVE_FORMAT_EXTENSIBLE && format.cbSize >= sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX)) {
+		const WAVEFORMATEXTENSIBLE& extensible = reinterpret_cast<const WAVEFORMATEXTENSIBLE&>(format);
+		key.extensible = (uint64_t(extensible.SubFormat.Data1 & 0xFFFF) << 48) |
+			(uint64_t(extensible.Samples.wValidBitsPerSample) << 32) | uint64_t(extensible.dwChannelMask);
+	}
+	return key;
+}
+
+int32_t SourceVoicePool::AcquireSlot(const WAVEFORMATEX& format, const FormatKey& formatKey, int priority)
+{
+	// 同じ形式の空きボイスがあればそのまま使う
+	for (size_t i = 0; i < slots_.size(); ++i) {
+		if (slots_[i].state == SlotState::Free && slots_[i].voice && slots_[i].formatKey == formatKey) {
+			return static_cast<int32_t>(i);
+		}
+	}
+
+	// 上限まではボイスを増やす
+	if (slots_.size() < maxVoiceCount_) {
+		slots_.emplace_back();
+		++freeCount_;
+		Slot& slot = slots_.back();
+		return CreateVoice(slot, format, formatKey) ? static_cast<int32_t>(slots_.size() - 1) : -1;
+	}
+
+	// 鳴っていないボイスがあれば、形式が違っても作り直して使う
+	int32_t victim = -1;
+	for (size_t i = 0; i < slots_.size(); ++i) {
+		if (slots_[i].state != SlotState::Playing) {
+			victim = static_cast<int32_t>(i);
+			break;
+		}
+	}
+
+	// 全部鳴っていたら、優先度が一番低く、その中で一番古い音を止める
+	if (victim < 0) {
+		for (size_t i = 0; i < slots_.size(); ++i) {
+			const Slot& slot = slots_[i];
+			if (slot.priority > priority) {
+				continue;
+			}
+			if (victim < 0 || slot.priority < slots_[victim].priority ||
+				(slot.priority == slots_[victim].priority && slot.startOrder < slots_[victim].startOrder)) {
+				victim = static_cast<int32_t>(i);
+			}
+		}
+		if (victim < 0) {
+			return -1;
+		}
+		++stolenCount_;
+	}
+
+	// 止めてすぐ使い回すと捨てたバッファの扱いが非同期で危ないので、作り直す
+	// (DestroyVoiceは処理が終わるのを待つ)
+	Slot& slot = slots_[victim];
+	DestroyVoice(slot);
+	return CreateVoice(slot, format, formatKey) ? victim : -1;
+}
+
+bool SourceVoicePool::CreateVoice(Slot& slot, const WAVEFORMATEX& format, const FormatKey& formatKey)
+{
+	HRESULT result = xAudio2_->CreateSourceVoice(&slot.voice, &format, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
+	if (FAILED(result)) {
+		Logger::Write(std::format("ソースボイスを作れませんでした (0x{:08X})", static_cast<uint32_t>(result)));
+		slot.voice = nullptr;
+		return false;
+	}
+	slot.formatKey = formatKey;
+	slot.isSpatial = false;
+	return true;
+}
+
+void SourceVoicePool::DestroyVoice(Slot& slot)
+{
+	if (slot.voice) {
+		slot.voice->DestroyVoice();
+		slot.voice = nullptr;
+	}
+	SetState(slot, SlotState::Free);
+}
+
+void SourceVoicePool::SetState(Slot& slot, SlotState state)
+{
+	if (slot.state == state) {
+		return;
+	}
+	activeCount_ -= slot.state == SlotState::Playing ? 1 : 0;
+	freeCount_ -= slot.state == SlotState::Free ? 1 : 0;
+	slot.state = state;
+	// 空きに戻ったボイスはもうバッファを読まないので、音声データを離す
+	if (state == SlotState::Free) {
+		slot.sound.reset();
+	}
+	activeCount_ += state == SlotState::Playing ? 1 : 0;
+	freeCount_ += state == SlotState::Free ? 1 : 0;
+}
+
+void SourceVoicePool::SetOutputGains(Slot& slot, float leftGain, float rightGain)
+{
+	const uint32_t sourceChannelCount = static_cast<uint32_t>((slot.formatKey.format >> 40) & 0xFF);
+	if (sourceChannelCount > 2) {
+		return;
+	}
+
+	// level[出力 * 入力の数 + 入力]。出力の0が左、1が右で、3ch目以降(センターなど)には送らない
+	std::fill(outputMatrix_.begin(), outputMatrix_.end(), 0.0f);
+	if (outputChannelCount_ == 1) {
+		for (uint32_t i = 0; i < sourceChannelCount; ++i) {
+			outputMatrix_[i] = (leftGain + rightGain) * 0.5f;
+		}
+	} else if (sourceChannelCount == 1) {
+		outputMatrix_[0] = leftGain;
+		outputMatrix_[1] = rightGain;
+	} else {
+		outputMatrix_[0] = leftGain;
+		outputMatrix_[3] = rightGain;
+	}
+	slot.voice->SetOutputMatrix(nullptr, sourceChannelCount, outputChannelCount_, outputMatrix_.data());
+}
+
+SourceVoicePool::Slot* SourceVoicePool::FindSlot(SourceVoiceId id)
+{
+	const uint32_t index = id & 0xFFFF;
+	if (id == kInvalidSourceVoiceId || index >= slots_.size()) {
+		return nullptr;
+	}
+	Slot& slot = slots_[index];
+	return (slot.state != SlotState::Free && slot.generation == (id >> 16)) ? &slot : nullptr;
+}
+
+void SourceVoicePool::OnBufferEnd(void* bufferContext) noexcept
+{
+	std::lock_guard<std::mutex> lock(finishedMutex_);
+	finishedIds_.push_back(static_cast<SourceVoiceId>(reinterpret_cast<uintptr_t>(bufferContext)));
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <Windows.h>
+#include <xAudio2.h>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "SoundAsset.h"
+
+// プールで鳴らした音の番号 (0は無効)
+using SourceVoiceId = uint32_t;
+constexpr SourceVoiceId kInvalidSourceVoiceId = 0;
+
+// 効果音用のソースボイスを使い回すプール
+// 再生が終わったボイス(OnBufferEnd)は作り直さずに、同じ波形フォーマットの次の再生に使う
+// ボイスの数がmaxVoiceCountに達したら、優先度が低く古い音を止めて(盗んで)鳴らす
+// Play/Stop/Updateはゲームのスレッドから呼ぶ
+class SourceVoicePool : private IXAudio2VoiceCallback
+{
+public:
+	SourceVoicePool() = default;
+	~SourceVoicePool();
+
+	SourceVoicePool(const SourceVoicePool&) = delete;
+	SourceVoicePool& operator=(const SourceVoicePool&) = delete;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="xAudio2">ボイスを作るXAudio2</param>
+	/// <param name="maxVoiceCount">同時に鳴らせる数 (作るボイスの上限)</param>
+	/// <param name="outputChannelCount">出力先(マスターボイス)のチャンネル数 (SetSpatialOutputのパンに使う)</param>
+	void Init(IXAudio2* xAudio2, uint32_t maxVoiceCount = 32, uint32_t outputChannelCount = 2);
+
+	// 全ボイスを破棄する (マスターボイスより先に呼ぶ)
+	void Shutdown();
+
+	/// <summary>
+	/// 再生する
+	/// </summary>
+	/// <param name="format">波形フォーマット</param>
+	/// <param name="data">波形データ (再生が終わるまで呼び出し側が持っておく)</param>
+	/// <param name="size">波形データのバイト数</param>
+	/// <param name="priority">優先度 (大きいほど止められにくい)</param>
+	/// <param name="volume">音量</param>
+	/// <returns>音の番号 (上限に達していて、止められる音も無ければkInvalidSourceVoiceId)</returns>
+	SourceVoiceId Play(const WAVEFORMATEX& format, const BYTE* data, uint32_t size, int priority = 0, float volume = 1.0f);
+
+	/// <summary>
+	/// 共有している音声データを再生する
+	/// ハンドルはボイスが空きに戻る(鳴り終わってUpdateで回収される、止めたバッファが捨てられる、ボイスを壊す)まで持っておく
+	/// </summary>
+	/// <param name="sound">音声データ</param>
+	/// <param name="priority">優先度 (大きいほど止められにくい)</param>
+	/// <param name="volume">音量</param>
+	/// <returns>音の番号 (データが無いか、鳴らせなければkInvalidSourceVoiceId)</returns>
+	SourceVoiceId Play(const SoundHandle& sound, int priority = 0, float volume = 1.0f);
+
+	/// <summary>
+	/// 鳴っている音の音量、左右の位置、再生速度を変える (SpatialAudioから毎フレーム呼ぶ)
+	/// パンはAudioMixerと同じで、モノラルは等パワー(中央で-3dB)、ステレオは反対側を絞る
+	/// この設定をしたボイスは、次のPlayで中央・等速に戻す
+	/// </summary>
+	/// <param name="id">音の番号</param>
+	/// <param name="volume">音量</param>
+	/// <param name="pan">左右の位置 (-1で左、0で中央、1で右)</param>
+	/// <param name="frequencyRatio">再生速度の比 (1で等速、XAUDIO2_DEFAULT_FREQ_RATIOまで)</param>
+	/// <returns>鳴っていればtrue (鳴り終わった番号ならfalse)</returns>
+	bool SetSpatialOutput(SourceVoiceId id, float volume, float pan, float frequencyRatio);
+
+	void Stop(SourceVoiceId id);
+	void StopAll();
+	bool IsPlaying(SourceVoiceId id);
+
+	// 再生が終わったボイスを空きに戻す (毎フレーム呼ぶ、Playの中でも呼ぶ)
+	void Update();
+
+	// 鳴っているボイスの数
+	uint32_t GetActiveVoiceCount() const { return activeCount_; }
+	// 空いているボイスの数 (鳴らし終わって次の再生を待っているもの)
+	uint32_t GetFreeVoiceCount() const { return freeCount_; }
+	uint32_t GetMaxVoiceCount() const { return maxVoiceCount_; }
+	// 上限に達したために止めた音の数
+	uint64_t GetStolenCount() const { return stolenCount_; }
+
+private:
+	enum class SlotState {
+		Free, // 空き (同じ形式ならすぐ使える)
+		Playing,
+		Stopping, // Stopで止めて、積んであったバッファが捨てられるのを待っている
+	};
+
+	// ボイスを使い回せるかを決める形式のキー
+	struct FormatKey {
+		uint64_t format = 0; // 形式タグ16bit、チャンネル数8bit、ビット数8bit、サンプリングレート32bit
+		uint64_t extensible = 0; // EXTENSIBLEの時だけ、SubFormatの形式タグ16bit、有効ビット数16bit、スピーカーの割り当て32bit
+		bool operator==(const FormatKey&) const = default;
+	};
+
+	struct Slot {
+		IXAudio2SourceVoice* voice = nullptr;
+		FormatKey formatKey;
+		SoundHandle sound; // 鳴らしている音声データ (空きに戻ったら離す)
+		uint64_t startOrder = 0; // 鳴らし始めた順番 (古いものから止める)
+		int priority = 0;
+		uint16_t generation = 0;
+		SlotState state = SlotState::Free;
+		bool isSpatial = false; // SetSpatialOutputで出力先の割り当てを変えたか
+	};
+
+	// 波形フォーマットからプールのキーを作る
+	static FormatKey MakeFormatKey(const WAVEFORMATEX& format);
+
+	// 新しい再生に使うスロットを選ぶ (必要ならボイスを作り直す)
+	int32_t AcquireSlot(const WAVEFORMATEX& format, const FormatKey& formatKey, int priority);
+	bool CreateVoice(Slot& slot, const WAVEFORMATEX& format, const FormatKey& formatKey);
+	void DestroyVoice(Slot& slot);
+	void SetState(Slot& slot, SlotState state);
+	// 左右の音量から出力の行列を作って設定する
+	void SetOutputGains(Slot& slot, float leftGain, float rightGain);
+	Slot* FindSlot(SourceVoiceId id);
+
+	// IXAudio2VoiceCallback (XAudio2のスレッドから呼ばれる)
+	void __stdcall OnVoiceProcessingPassStart(UINT32) noexcept override {}
+	void __stdcall OnVoiceProcessingPassEnd() noexcept override {}
+	void __stdcall OnStreamEnd() noexcept override {}
+	void __stdcall OnBufferStart(void*) noexcept override {}
+	void __stdcall OnBufferEnd(void* bufferContext) noexcept override;
+	void __stdcall OnLoopEnd(void*) noexcept override {}
+	void __stdcall OnVoiceError(void*, HRESULT) noexcept override {}
+
+	IXAudio2* xAudio2_ = nullptr;
+	uint32_t maxVoiceCount_ = 0;
+	uint32_t outputChannelCount_ = 2;
+	std::vector<Slot> slots_;
+	std::vector<float> outputMatrix_; // SetOutputMatrixに渡す作業領域
+	uint32_t activeCount_ = 0;
+	uint32_t freeCount_ = 0;
+	uint64_t nextStartOrder_ = 0;
+	uint64_t stolenCount_ = 0;
+
+	// 再生が終わった音の番号 (コールバックで積み、Updateで取り出す)
+	std::mutex finishedMutex_;
+	std::vector<SourceVoiceId> finishedIds_;
+	std::vector<SourceVoiceId> finishedScratch_;
+};
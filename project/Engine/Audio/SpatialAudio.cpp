@@ -0,0 +1,333 @@
+#include "SpatialAudio.h"
+#include "MathConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	// これより近いと向きが決まらないので、パンとドップラーを0にする
+	constexpr float kMinDirectionDistance = 1e-4f;
+	// minDistanceの下限 (0だと減衰の式が0/0になる)
+	constexpr float kMinEmitterDistance = 1e-3f;
+	// 視線方向の速さを音速のこの割合までに抑える (音速に近づくと比が発散するため)
+	constexpr float kMaxVelocityRatio = 0.5f;
+	// 再生速度の比の範囲 (上はソースボイスを作る時の上限に合わせる)
+	constexpr float kMinFrequencyRatio = 0.5f;
+	constexpr float kMaxFrequencyRatio = XAUDIO2_DEFAULT_FREQ_RATIO;
+
+	constexpr size_t kNotFound = (std::numeric_limits<size_t>::max)();
+}
+
+void SpatialAudio::EmitterSoA::PushBack()
+{
+	positionX.push_back(0.0f);
+	positionY.push_back(0.0f);
+	positionZ.push_back(0.0f);
+	velocityX.push_back(0.0f);
+	velocityY.push_back(0.0f);
+	velocityZ.push_back(0.0f);
+	minDistance.push_back(1.0f);
+	maxDistance.push_back(1.0f);
+	volume.push_back(1.0f);
+	outputVolume.push_back(0.0f);
+	pan.push_back(0.0f);
+	frequencyRatio.push_back(1.0f);
+	voiceId.push_back(kInvalidSourceVoiceId);
+	handleIndex.push_back(0);
+}
+
+void SpatialAudio::EmitterSoA::RemoveSwapBack(size_t index)
+{
+	const size_t last = Size() - 1;
+	if (index != last) {
+		positionX[index] = positionX[last];
+		positionY[index] = positionY[last];
+		positionZ[index] = positionZ[last];
+		velocityX[index] = velocityX[last];
+		velocityY[index] = velocityY[last];
+		velocityZ[index] = velocityZ[last];
+		minDistance[index] = minDistance[last];
+		maxDistance[index] = maxDistance[last];
+		volume[index] = volume[last];
+		outputVolume[index] = outputVolume[last];
+		pan[index] = pan[last];
+		frequencyRatio[index] = frequencyRatio[last];
+		voiceId[index] = voiceId[last];
+		handleIndex[index] = handleIndex[last];
+	}
+	positionX.pop_back();
+	positionY.pop_back();
+	positionZ.pop_back();
+	velocityX.pop_back();
+	velocityY.pop_back();
+	velocityZ.pop_back();
+	minDistance.pop_back();
+	maxDistance.pop_back();
+	volume.pop_back();
+	outputVolume.pop_back();
+	pan.pop_back();
+	frequencyRatio.pop_back();
+	voiceId.pop_back();
+	handleIndex.pop_back();
+}
+
+SpatialAudio::SpatialAudio(SourceVoicePool& voicePool)
+	: voicePool_(voicePool)
+{
+}
+
+EmitterId SpatialAudio::CreateEmitter(const Vector3& position, float minDistance, float maxDistance)
+{
+	if (emitters_.Size() >= kMaxEmitterCount) {
+		return kInvalidEmitterId;
+	}
+
+	uint32_t handleIndex = 0;
+	if (!freeHandles_.empty()) {
+		handleIndex = freeHandles_.back();
+		freeHandles_.pop_back();
+	} else {
+		handleIndex = static_cast<uint32_t>(handles_.size());
+		handles_.emplace_back();
+	}
+
+	// 0番の世代は使わない (番号が0にならないように)
+	Handle& handle = handles_[handleIndex];
+	handle.generation = static_cast<uint16_t>(handle.generation + 1);
+	if (handle.generation == 0) {
+		handle.generation = 1;
+	}
+	handle.isUsed = true;
+	handle.index = static_cast<uint32_t>(emitters_.Size());
+
+	emitters_.PushBack();
+	const size_t index = handle.index;
+	emitters_.positionX[index] = position.x;
+	emitters_.positionY[index] = position.y;
+	emitters_.positionZ[index] = position.z;
+	emitters_.minDistance[index] = (std::max)(minDistance, kMinEmitterDistance);
+	emitters_.maxDistance[index] = (std::max)(maxDistance, emitters_.minDistance[index]);
+	emitters_.handleIndex[index] = handleIndex;
+	ComputeOutputs(index, index + 1);
+
+	return (static_cast<EmitterId>(handle.generation) << 16) | handleIndex;
+}
+
+void SpatialAudio::DestroyEmitter(EmitterId id)
+{
+	const size_t index = FindIndex(id);
+	if (index == kNotFound) {
+		return;
+	}
+	if (emitters_.voiceId[index] != kInvalidSourceVoiceId) {
+		voicePool_.Stop(emitters_.voiceId[index]);
+	}
+
+	// 最後の要素を消した位置に移すので、その番号の指す位置を直す
+	const size_t last = emitters_.Size() - 1;
+	handles_[emitters_.handleIndex[last]].index = static_cast<uint32_t>(index);
+	emitters_.RemoveSwapBack(index);
+
+	const uint32_t handleIndex = id & 0xFFFF;
+	handles_[handleIndex].isUsed = false;
+	freeHandles_.push_back(handleIndex);
+}
+
+void SpatialAudio::SetEmitterPosition(EmitterId id, const Vector3& position)
+{
+	const size_t index = FindIndex(id);
+	if (index != kNotFound) {
+		emitters_.positionX[index] = position.x;
+		emitters_.positionY[index] = position.y;
+		emitters_.positionZ[index] = position.z;
+	}
+}
+
+void SpatialAudio::SetEmitterVelocity(EmitterId id, const Vector3& velocity)
+{
+	const size_t index = FindIndex(id);
+	if (index != kNotFound) {
+		emitters_.velocityX[index] = velocity.x;
+		emitters_.velocityY[index] = velocity.y;
+		emitters_.velocityZ[index] = velocity.z;
+	}
+}
+
+void SpatialAudio::SetEmitterVolume(EmitterId id, float volume)
+{
+	const size_t index = FindIndex(id);
+	if (index != kNotFound) {
+		emitters_.volume[index] = volume;
+	}
+}
+
+SourceVoiceId SpatialAudio::Play(EmitterId id, const SoundHandle& sound, int priority)
+{
+	const size_t index = FindIndex(id);
+	if (index == kNotFound) {
+		return kInvalidSourceVoiceId;
+	}
+
+	if (emitters_.voiceId[index] != kInvalidSourceVoiceId) {
+		voicePool_.Stop(emitters_.voiceId[index]);
+	}
+
+	// 鳴らし始めから今の位置の音にする
+	ComputeOutputs(index, index + 1);
+	const SourceVoiceId voiceId = voicePool_.Play(sound, priority, emitters_.outputVolume[index]);
+	if (voiceId != kInvalidSourceVoiceId) {
+		voicePool_.SetSpatialOutput(voiceId, emitters_.outputVolume[index], emitters_.pan[index], emitters_.frequencyRatio[index]);
+	}
+	emitters_.voiceId[index] = voiceId;
+	return voiceId;
+}
+
+void SpatialAudio::Stop(EmitterId id)
+{
+	const size_t index = FindIndex(id);
+	if (index != kNotFound && emitters_.voiceId[index] != kInvalidSourceVoiceId) {
+		voicePool_.Stop(emitters_.voiceId[index]);
+		emitters_.voiceId[index] = kInvalidSourceVoiceId;
+	}
+}
+
+void SpatialAudio::SetListener(const Vector3& position, const Matrix4x4& viewMatrix, float deltaTime)
+{
+	if (hasListener_ && deltaTime > 0.0f) {
+		listenerVelocity_ = (position - listenerPosition_) / deltaTime;
+	} else {
+		listenerVelocity_ = { 0.0f, 0.0f, 0.0f };
+	}
+	listenerPosition_ = position;
+	// ビュー行列の回転はカメラの回転の転置なので、1列目がワールド空間の右方向
+	listenerRight_ = { viewMatrix.m[0][0], viewMatrix.m[1][0], viewMatrix.m[2][0] };
+	hasListener_ = true;
+}
+
+void SpatialAudio::Update()
+{
+	ComputeOutputs(0, emitters_.Size());
+
+	// 鳴っている音にだけ反映し、鳴り終わったものは番号を忘れる
+	for (size_t i = 0; i < emitters_.Size(); ++i) {
+		const SourceVoiceId voiceId = emitters_.voiceId[i];
+		if (voiceId != kInvalidSourceVoiceId &&
+			!voicePool_.SetSpatialOutput(voiceId, emitters_.outputVolume[i], emitters_.pan[i], emitters_.frequencyRatio[i])) {
+			emitters_.voiceId[i] = kInvalidSourceVoiceId;
+		}
+	}
+}
+
+SpatialOutput SpatialAudio::GetOutput(EmitterId id) const
+{
+	SpatialOutput output;
+	const size_t index = FindIndex(id);
+	if (index != kNotFound) {
+		output.volume = emitters_.outputVolume[index];
+		output.pan = emitters_.pan[index];
+		output.frequencyRatio = emitters_.frequencyRatio[index];
+	}
+	return output;
+}
+
+size_t SpatialAudio::FindIndex(EmitterId id) const
+{
+	const uint32_t handleIndex = id & 0xFFFF;
+	if (id == kInvalidEmitterId || handleIndex >= handles_.size()) {
+		return kNotFound;
+	}
+	const Handle& handle = handles_[handleIndex];
+	return (handle.isUsed && handle.generation == (id >> 16)) ? handle.index : kNotFound;
+}
+
+void SpatialAudio::ComputeOutputs(size_t begin, size_t end)
+{
+	size_t i = begin;
+#ifdef MATH_USE_SSE
+	const EmitterSoA& e = emitters_;
+	const __m128 listenerX = _mm_set1_ps(listenerPosition_.x);
+	const __m128 listenerY = _mm_set1_ps(listenerPosition_.y);
+	const __m128 listenerZ = _mm_set1_ps(listenerPosition_.z);
+	const __m128 rightX = _mm_set1_ps(listenerRight_.x);
+	const __m128 rightY = _mm_set1_ps(listenerRight_.y);
+	const __m128 rightZ = _mm_set1_ps(listenerRight_.z);
+	const __m128 listenerVelocityX = _mm_set1_ps(listenerVelocity_.x);
+	const __m128 listenerVelocityY = _mm_set1_ps(listenerVelocity_.y);
+	const __m128 listenerVelocityZ = _mm_set1_ps(listenerVelocity_.z);
+	const __m128 rolloff = _mm_set1_ps(rolloffFactor_);
+	const __m128 speed = _mm_set1_ps(speedOfSound_);
+	const __m128 velocityLimit = _mm_set1_ps(speedOfSound_ * kMaxVelocityRatio);
+	const __m128 negativeVelocityLimit = _mm_set1_ps(-speedOfSound_ * kMaxVelocityRatio);
+	const __m128 negativeDoppler = _mm_set1_ps(-dopplerFactor_);
+	const __m128 minDirection = _mm_set1_ps(kMinDirectionDistance);
+	const __m128 minDirectionSq = _mm_set1_ps(kMinDirectionDistance * kMinDirectionDistance);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 negativeOne = _mm_set1_ps(-1.0f);
+	const __m128 minRatio = _mm_set1_ps(kMinFrequencyRatio);
+	const __m128 maxRatio = _mm_set1_ps(kMaxFrequencyRatio);
+
+	for (; i + 4 <= end; i += 4) {
+		// リスナーから音源への向き
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&e.positionX[i]), listenerX);
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&e.positionY[i]), listenerY);
+		const __m128 dz = _mm_sub_ps(_mm_loadu_ps(&e.positionZ[i]), listenerZ);
+		const __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		const __m128 distance = _mm_sqrt_ps(distanceSq);
+		// 近すぎる時は向きを0にする
+		const __m128 isFar = _mm_cmpgt_ps(distanceSq, minDirectionSq);
+		const __m128 inverseDistance = _mm_and_ps(isFar, _mm_div_ps(one, _mm_max_ps(distance, minDirection)));
+
+		// 距離による減衰: min / (min + rolloff * (clamp(distance, min, max) - min))
+		const __m128 minDistance = _mm_loadu_ps(&e.minDistance[i]);
+		const __m128 clamped = _mm_min_ps(_mm_max_ps(distance, minDistance), _mm_loadu_ps(&e.maxDistance[i]));
+		const __m128 attenuation = _mm_div_ps(minDistance, _mm_add_ps(minDistance, _mm_mul_ps(rolloff, _mm_sub_ps(clamped, minDistance))));
+		_mm_storeu_ps(&emitters_.outputVolume[i], _mm_mul_ps(_mm_loadu_ps(&e.volume[i]), attenuation));
+
+		// 右方向の成分がパン
+		const __m128 side = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, rightX), _mm_mul_ps(dy, rightY)), _mm_mul_ps(dz, rightZ));
+		_mm_storeu_ps(&emitters_.pan[i], _mm_min_ps(_mm_max_ps(_mm_mul_ps(side, inverseDistance), negativeOne), one));
+
+		// ドップラー: 速度の、音源からリスナーへの向きの成分を使う (OpenALと同じ式)
+		// ratio = (音速 - リスナーの成分) / (音速 - 音源の成分)、近づくと1より大きくなる
+		const __m128 scale = _mm_mul_ps(inverseDistance, negativeDoppler);
+		__m128 listenerSpeed = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, listenerVelocityX), _mm_mul_ps(dy, listenerVelocityY)), _mm_mul_ps(dz, listenerVelocityZ));
+		__m128 sourceSpeed = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(dx, _mm_loadu_ps(&e.velocityX[i])),
+			_mm_mul_ps(dy, _mm_loadu_ps(&e.velocityY[i]))),
+			_mm_mul_ps(dz, _mm_loadu_ps(&e.velocityZ[i])));
+		listenerSpeed = _mm_min_ps(_mm_max_ps(_mm_mul_ps(listenerSpeed, scale), negativeVelocityLimit), velocityLimit);
+		sourceSpeed = _mm_min_ps(_mm_max_ps(_mm_mul_ps(sourceSpeed, scale), negativeVelocityLimit), velocityLimit);
+		const __m128 ratio = _mm_div_ps(_mm_sub_ps(speed, listenerSpeed), _mm_sub_ps(speed, sourceSpeed));
+		_mm_storeu_ps(&emitters_.frequencyRatio[i], _mm_min_ps(_mm_max_ps(ratio, minRatio), maxRatio));
+	}
+#endif
+	ComputeOutputsScalar(i, end);
+}
+
+void SpatialAudio::ComputeOutputsScalar(size_t begin, size_t end)
+{
+	EmitterSoA& e = emitters_;
+	const float velocityLimit = speedOfSound_ * kMaxVelocityRatio;
+	for (size_t i = begin; i < end; ++i) {
+		const float dx = e.positionX[i] - listenerPosition_.x;
+		const float dy = e.positionY[i] - listenerPosition_.y;
+		const float dz = e.positionZ[i] - listenerPosition_.z;
+		const float distanceSq = dx * dx + dy * dy + dz * dz;
+		const float distance = std::sqrt(distanceSq);
+		const float inverseDistance = distanceSq > kMinDirectionDistance * kMinDirectionDistance ? 1.0f / distance : 0.0f;
+
+		const float minDistance = e.minDistance[i];
+		const float clamped = (std::min)((std::max)(distance, minDistance), e.maxDistance[i]);
+		e.outputVolume[i] = e.volume[i] * minDistance / (minDistance + rolloffFactor_ * (clamped - minDistance));
+
+		const float side = dx * listenerRight_.x + dy * listenerRight_.y + dz * listenerRight_.z;
+		e.pan[i] = std::clamp(side * inverseDistance, -1.0f, 1.0f);
+
+		const float scale = -inverseDistance * dopplerFactor_;
+		const float listenerSpeed = std::clamp(
+			(dx * listenerVelocity_.x + dy * listenerVelocity_.y + dz * listenerVelocity_.z) * scale, -velocityLimit, velocityLimit);
+		const float sourceSpeed = std::clamp(
+			(dx * e.velocityX[i] + dy * e.velocityY[i] + dz * e.velocityZ[i]) * scale, -velocityLimit, velocityLimit);
+		e.frequencyRatio[i] = std::clamp((speedOfSound_ - listenerSpeed) / (speedOfSound_ - sourceSpeed), kMinFrequencyRatio, kMaxFrequencyRatio);
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Matrix.h"
+#include "SourceVoicePool.h"
+
+// 位置を持つ音源(エミッター)の番号 (0は無効)
+using EmitterId = uint32_t;
+constexpr EmitterId kInvalidEmitterId = 0;
+
+// エミッターごとに求めた、鳴っている音に渡す値
+struct SpatialOutput {
+	float volume = 0.0f; // 音量 (エミッターの音量 * 距離による減衰)
+	float pan = 0.0f; // 左右の位置 (-1で左、0で中央、1で右)
+	float frequencyRatio = 1.0f; // ドップラー効果による再生速度の比
+};
+
+/// <summary>
+/// 3D空間に置いた音を、聞く位置(リスナー、カメラ)に合わせて鳴らす
+/// 距離による減衰(OpenALのINVERSE_DISTANCE_CLAMPEDと同じ)、左右の位置、ドップラー効果をUpdateで全エミッターまとめて求め、
+/// 鳴っている音にだけSourceVoicePool::SetSpatialOutputで反映する
+/// エミッターは要素ごとの配列(SoA)で持ち、4つずつSSEで計算する
+/// 1単位を1m、速度は1秒あたりの単位で扱う
+/// </summary>
+class SpatialAudio {
+public:
+	// 同時に置けるエミッターの数 (番号の下位16bitに入る数)
+	static constexpr uint32_t kMaxEmitterCount = 0xFFFF;
+
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="voicePool">鳴らすのに使うプール (Sound::GetVoicePool、Init済み)</param>
+	explicit SpatialAudio(SourceVoicePool& voicePool);
+
+	/// <summary>
+	/// エミッターを置く
+	/// </summary>
+	/// <param name="position">位置</param>
+	/// <param name="minDistance">これより近いと減衰しない距離</param>
+	/// <param name="maxDistance">これより遠いとそれ以上減衰しない距離</param>
+	/// <returns>エミッターの番号 (置ききれなければkInvalidEmitterId)</returns>
+	EmitterId CreateEmitter(const Vector3& position, float minDistance = 1.0f, float maxDistance = 100.0f);
+
+	// エミッターを消す (鳴っている音も止める)
+	void DestroyEmitter(EmitterId id);
+
+	void SetEmitterPosition(EmitterId id, const Vector3& position);
+	// 移動の速さと向き (ドップラー効果に使う)
+	void SetEmitterVelocity(EmitterId id, const Vector3& velocity);
+	void SetEmitterVolume(EmitterId id, float volume);
+
+	/// <summary>
+	/// エミッターの位置で鳴らす (1つのエミッターで鳴らせるのは1つだけで、鳴っている音は止める)
+	/// </summary>
+	/// <param name="id">エミッターの番号</param>
+	/// <param name="sound">音声データ (鳴り終わるまでプールがハンドルを持つ)</param>
+	/// <param name="priority">優先度 (SourceVoicePool::Playと同じ)</param>
+	/// <returns>音の番号 (鳴らせなければkInvalidSourceVoiceId)</returns>
+	SourceVoiceId Play(EmitterId id, const SoundHandle& sound, int priority = 0);
+
+	void Stop(EmitterId id);
+
+	/// <summary>
+	/// リスナーを設定する (毎フレームUpdateの前に呼ぶ)
+	/// 速度は前のフレームの位置との差から求める
+	/// </summary>
+	/// <param name="position">位置 (DebugCamera::GetPosition)</param>
+	/// <param name="viewMatrix">ビュー行列 (DebugCamera::GetViewMatrix、右方向を取り出してパンに使う)</param>
+	/// <param name="deltaTime">前のフレームからの秒数</param>
+	void SetListener(const Vector3& position, const Matrix4x4& viewMatrix, float deltaTime);
+
+	// 全エミッターの減衰、パン、ドップラーを求めて、鳴っている音に反映する (毎フレーム呼ぶ)
+	void Update();
+
+	// Updateで求めた値 (無効な番号なら既定値)
+	SpatialOutput GetOutput(EmitterId id) const;
+
+	uint32_t GetEmitterCount() const { return static_cast<uint32_t>(emitters_.Size()); }
+
+	// 音速 (既定は343m/s)
+	void SetSpeedOfSound(float speedOfSound) { speedOfSound_ = speedOfSound; }
+	// ドップラー効果の強さ (0で無し)
+	void SetDopplerFactor(float dopplerFactor) { dopplerFactor_ = dopplerFactor; }
+	// 距離による減衰の強さ (0で減衰しない)
+	void SetRolloffFactor(float rolloffFactor) { rolloffFactor_ = rolloffFactor; }
+
+private:
+	// エミッターを要素ごとの配列で持つ (消す時は最後の要素で埋めて詰める)
+	struct EmitterSoA {
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> velocityX, velocityY, velocityZ;
+		std::vector<float> minDistance, maxDistance;
+		std::vector<float> volume;
+		// Updateの結果
+		std::vector<float> outputVolume, pan, frequencyRatio;
+		std::vector<SourceVoiceId> voiceId;
+		std::vector<uint32_t> handleIndex; // この要素を指している番号のスロット
+
+		size_t Size() const { return positionX.size(); }
+		void PushBack();
+		// index番目を最後の要素で上書きして、最後を消す
+		void RemoveSwapBack(size_t index);
+	};
+
+	// 番号から配列の位置を引くためのスロット
+	struct Handle {
+		uint32_t index = 0; // EmitterSoAの位置
+		uint16_t generation = 0;
+		bool isUsed = false;
+	};
+
+	// 番号から配列の位置を引く (無効ならSIZE_MAX)
+	size_t FindIndex(EmitterId id) const;
+	// [begin, end)のエミッターの減衰、パン、ドップラーを求める
+	void ComputeOutputs(size_t begin, size_t end);
+	void ComputeOutputsScalar(size_t begin, size_t end);
+
+	SourceVoicePool& voicePool_;
+	EmitterSoA emitters_;
+	std::vector<Handle> handles_;
+	std::vector<uint32_t> freeHandles_;
+
+	// リスナー
+	Vector3 listenerPosition_ = { 0.0f, 0.0f, 0.0f };
+	Vector3 listenerVelocity_ = { 0.0f, 0.0f, 0.0f };
+	Vector3 listenerRight_ = { 1.0f, 0.0f, 0.0f };
+	bool hasListener_ = false;
+
+	float speedOfSound_ = 343.0f;
+	float dopplerFactor_ = 1.0f;
+	float rolloffFactor_ = 1.0f;
+};
@@ -0,0 +1,252 @@
+#include "StreamingSound.h"
+#include "AudioRingBuffer.h"
+#include "MFAudioReader.h"
+#include "Sound.h"
+#include "WaveReader.h"
+#include "Logger.h"
+#include <algorithm>
+#include <format>
+
+// unique_ptrで持つ読み込みクラスの定義が要るのでここで定義する
+StreamingSound::StreamingSound() = default;
+
+StreamingSound::~StreamingSound()
+{
+	Close();
+}
+
+bool StreamingSound::Open(IXAudio2* xAudio2, const std::string& filePath, bool isLoop)
+{
+	Close();
+	if (!xAudio2) {
+		return false;
+	}
+
+	const std::string ext = Sound::ToLowerExt(filePath);
+	if (ext == ".wav") {
+		waveReader_ = std::make_unique<WaveReader>();
+		if (!waveReader_->Open(filePath)) {
+			Close();
+			return false;
+		}
+		// XAudio2は64bit浮動小数を鳴らせない (読み込みながら変換はしないので、全部読み込むSoundCacheを使う)
+		const WaveFormat& waveFormat = waveReader_->GetFormat();
+		if (waveFormat.sampleType == WaveSampleType::Float && waveFormat.bitsPerSample == 64) {
+			Logger::Write("64bit浮動小数のWAVはストリーミングできません: " + filePath);
+			Close();
+			return false;
+		}
+		format_ = Sound::ToWaveFormatExtensible(waveFormat);
+	} else if (ext == ".mp3") {
+		mfReader_ = std::make_unique<MFAudioReader>();
+		std::wstring w = Sound::ToWide(filePath.c_str());
+		if (!mfReader_->Open(w.c_str())) {
+			Close();
+			return false;
+		}
+		format_ = {};
+		format_.Format = mfReader_->GetFormat();
+	} else {
+		Logger::Write("ストリーミングできない音声形式です: " + filePath);
+		return false;
+	}
+
+	// 1バッファはkBufferMilliseconds分 (フレームの途中で切れないようにする)
+	const WAVEFORMATEX& format = format_.Format;
+	bufferSize_ = static_cast<uint32_t>(uint64_t(format.nAvgBytesPerSec) * kBufferMilliseconds / 1000);
+	bufferSize_ = (std::max)(bufferSize_ - bufferSize_ % format.nBlockAlign, uint32_t(format.nBlockAlign));
+	ringBuffer_ = std::make_unique<AudioRingBuffer>(size_t(bufferSize_) * kBufferCount);
+
+	HRESULT result = xAudio2->CreateSourceVoice(&sourceVoice_, &format_.Format, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
+	if (FAILED(result)) {
+		Logger::Write(std::format("ストリーミング用のソースボイスを作れませんでした (0x{:08X})", static_cast<uint32_t>(result)));
+		sourceVoice_ = nullptr;
+		Close();
+		return false;
+	}
+
+	isLoop_ = isLoop;
+	isStopRequested_ = false;
+	isSourceEnd_ = false;
+	isFinished_.store(false, std::memory_order_relaxed);
+
+	// 最初の1つだけここで詰めてすぐ鳴らせるようにし、残りはスレッドで先読みする
+	if (FillAndSubmit()) {
+		thread_ = std::thread(&StreamingSound::DecodeThread, this);
+	}
+	return true;
+}
+
+void StreamingSound::Close()
+{
+	if (thread_.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			isStopRequested_ = true;
+		}
+		condition_.notify_one();
+		thread_.join();
+	}
+
+	// DestroyVoiceはコールバックが終わるのを待つので、この後はバッファを解放してよい
+	if (sourceVoice_) {
+		sourceVoice_->Stop();
+		sourceVoice_->DestroyVoice();
+		sourceVoice_ = nullptr;
+	}
+
+	waveReader_.reset();
+	mfReader_.reset();
+	ringBuffer_.reset();
+	bufferSize_ = 0;
+	format_ = {};
+}
+
+size_t StreamingSound::GetResidentBytes() const
+{
+	return ringBuffer_ ? ringBuffer_->GetCapacity() : 0;
+}
+
+void StreamingSound::Play()
+{
+	if (sourceVoice_) {
+		sourceVoice_->Start();
+	}
+}
+
+void StreamingSound::Pause()
+{
+	if (sourceVoice_) {
+		sourceVoice_->Stop();
+	}
+}
+
+void StreamingSound::SetVolume(float volume)
+{
+	if (sourceVoice_) {
+		sourceVoice_->SetVolume(volume);
+	}
+}
+
+void StreamingSound::DecodeThread()
+{
+	// Media Foundationの読み込みをこのスレッドで使う
+	HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+	while (true) {
+		{
+			// リングバッファに1バッファ分の空きができるまで待つ
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this] { return isStopRequested_ || ringBuffer_->GetWritableSize() >= bufferSize_; });
+			if (isStopRequested_) {
+				break;
+			}
+		}
+		if (!FillAndSubmit()) {
+			break;
+		}
+	}
+
+	if (SUCCEEDED(hr)) {
+		CoUninitialize();
+	}
+}
+
+bool StreamingSound::FillAndSubmit()
+{
+	// 1バッファ分ずつしか書かないので、空いている領域は折り返しの手前で切れない
+	size_t writableSize = 0;
+	BYTE* data = ringBuffer_->AcquireWrite(writableSize);
+	if (writableSize < bufferSize_) {
+		return true;
+	}
+	size_t size = ReadSource(data, bufferSize_);
+	// ループなら先頭に戻って、同じバッファの残りを詰める (継ぎ目で途切れないように)
+	while (isLoop_ && size < bufferSize_) {
+		if (!RewindSource()) {
+			break;
+		}
+		const size_t readSize = ReadSource(data + size, bufferSize_ - size);
+		if (readSize == 0) {
+			break;
+		}
+		size += readSize;
+	}
+
+	// ちょうどバッファの区切りで終わった時も、最後のバッファにEND_OF_STREAMを付ける
+	const bool isEnd = size < bufferSize_ || (!isLoop_ && IsSourceEnd());
+	if (size == 0) {
+		// 積むものが無いので、これまでに積んだ分が鳴り終わったら終わりにする
+		MarkSourceEnd();
+		return false;
+	}
+
+	// OnBufferEndで読み終わりにできるよう、積む前に書き込みを確定する
+	ringBuffer_->CommitWrite(size);
+
+	XAUDIO2_BUFFER buffer = {};
+	buffer.AudioBytes = static_cast<UINT32>(size);
+	buffer.pAudioData = data;
+	buffer.Flags = isEnd ? XAUDIO2_END_OF_STREAM : 0;
+	// 使い終わった時に読み終わりにするバイト数
+	buffer.pContext = reinterpret_cast<void*>(static_cast<uintptr_t>(size));
+	sourceVoice_->SubmitSourceBuffer(&buffer);
+	if (isEnd) {
+		MarkSourceEnd();
+	}
+	return !isEnd;
+}
+
+size_t StreamingSound::ReadSource(BYTE* buffer, size_t size)
+{
+	if (waveReader_) {
+		return waveReader_->Read(buffer, size);
+	}
+	return mfReader_ ? mfReader_->Read(buffer, size) : 0;
+}
+
+bool StreamingSound::RewindSource()
+{
+	if (waveReader_) {
+		waveReader_->Seek(0);
+		return true;
+	}
+	return mfReader_ && mfReader_->Rewind();
+}
+
+bool StreamingSound::IsSourceEnd() const
+{
+	if (waveReader_) {
+		return waveReader_->IsEnd();
+	}
+	return !mfReader_ || mfReader_->IsEnd();
+}
+
+void StreamingSound::MarkSourceEnd()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	isSourceEnd_ = true;
+	// 積んだ分を全部鳴らし終わっていれば、OnStreamEndはもう来ない
+	if (ringBuffer_->GetReadableSize() == 0) {
+		isFinished_.store(true, std::memory_order_release);
+	}
+}
+
+void StreamingSound::OnStreamEnd() noexcept
+{
+	isFinished_.store(true, std::memory_order_release);
+}
+
+void StreamingSound::OnBufferEnd(void* context) noexcept
+{
+	{
+		// 待っているデコードのスレッドが空きを見落とさないよう、ロックの中で進める
+		std::lock_guard<std::mutex> lock(mutex_);
+		ringBuffer_->CommitRead(static_cast<size_t>(reinterpret_cast<uintptr_t>(context)));
+		// END_OF_STREAMを付けられなかった時(最後の読み込みが0バイト)も、積んだ分を鳴らし終わったら終わりにする
+		if (isSourceEnd_ && ringBuffer_->GetReadableSize() == 0) {
+			isFinished_.store(true, std::memory_order_release);
+		}
+	}
+	condition_.notify_one();
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <Windows.h>
+#include <xAudio2.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class AudioRingBuffer;
+class WaveReader;
+class MFAudioReader;
+
+// BGMのような長い曲を少しずつ読みながら鳴らす
+// 別スレッドで少し先(kBufferCount * kBufferMilliseconds)までデコードしてリングバッファ(AudioRingBuffer)に詰め、
+// 詰めた区間をそのままXAudio2に積む。XAudio2が使い終わったら(OnBufferEnd)その分を読み終わりにして次を詰める
+// 書き込むのはデコードのスレッド、読み終わりにするのはXAudio2のスレッドなので、リングバッファはロックなしで使える
+// 曲の長さによらずメモリはリングバッファの分だけで、開く時も最初のバッファ分しか待たない
+class StreamingSound : private IXAudio2VoiceCallback
+{
+public:
+	// 1バッファの長さ
+	static constexpr uint32_t kBufferMilliseconds = 100;
+	// リングバッファに入るバッファの数 (先読みする量)
+	static constexpr uint32_t kBufferCount = 4;
+
+	StreamingSound();
+	~StreamingSound();
+
+	StreamingSound(const StreamingSound&) = delete;
+	StreamingSound& operator=(const StreamingSound&) = delete;
+
+	/// <summary>
+	/// 開いて最初のバッファを詰める (鳴らすのはPlay)
+	/// </summary>
+	/// <param name="xAudio2">ボイスを作るXAudio2 (Sound::GetXAudio2)</param>
+	/// <param name="filePath">ファイルパス (.wav/.mp3、.mp3はSound::Initの後で)</param>
+	/// <param name="isLoop">最後まで行ったら先頭に戻るか</param>
+	/// <returns>開けたらtrue</returns>
+	bool Open(IXAudio2* xAudio2, const std::string& filePath, bool isLoop = true);
+
+	// 止めてファイルとバッファを解放する (マスターボイスより先に呼ぶ)
+	void Close();
+
+	// 再生する (Pauseの後は続きから)
+	void Play();
+	void Pause();
+	void SetVolume(float volume);
+
+	// ループしない曲を最後まで鳴らし終わったか
+	bool IsFinished() const { return isFinished_.load(std::memory_order_acquire); }
+
+	// リングバッファのバイト数 (曲の長さによらない)
+	size_t GetResidentBytes() const;
+
+private:
+	// デコードのスレッド
+	void DecodeThread();
+	// リングバッファの空きにバッファを1つ分詰めて積む (最後まで行ったらfalse)
+	bool FillAndSubmit();
+	size_t ReadSource(BYTE* buffer, size_t size);
+	bool RewindSource();
+	// 読み込み元を最後まで読んだか (MP3は最後を越えて読もうとするまで分からない)
+	bool IsSourceEnd() const;
+	// 読み込み元の終わりまで積んだことを記録し、もう鳴らすものが無ければ終わりにする
+	void MarkSourceEnd();
+
+	// IXAudio2VoiceCallback (XAudio2のスレッドから呼ばれる)
+	void __stdcall OnVoiceProcessingPassStart(UINT32) noexcept override {}
+	void __stdcall OnVoiceProcessingPassEnd() noexcept override {}
+	void __stdcall OnStreamEnd() noexcept override;
+	void __stdcall OnBufferStart(void*) noexcept override {}
+	void __stdcall OnBufferEnd(void*) noexcept override;
+	void __stdcall OnLoopEnd(void*) noexcept override {}
+	void __stdcall OnVoiceError(void*, HRESULT) noexcept override {}
+
+	// どちらか一方だけを使う
+	std::unique_ptr<WaveReader> waveReader_;
+	std::unique_ptr<MFAudioReader> mfReader_;
+
+	WAVEFORMATEXTENSIBLE format_ = {}; // XAudio2にはformat_.Formatを渡す
+	IXAudio2SourceVoice* sourceVoice_ = nullptr;
+	bool isLoop_ = false;
+
+	// 容量はbufferSize_ * kBufferCountなので、1バッファ分ずつ詰めれば折り返しをまたがない
+	std::unique_ptr<AudioRingBuffer> ringBuffer_;
+	uint32_t bufferSize_ = 0; // 1回に積むバイト数
+
+	std::thread thread_;
+	std::mutex mutex_; // 空きを待つのに使う (リングバッファ自体はロックなし)
+	std::condition_variable condition_;
+	bool isStopRequested_ = false;
+	bool isSourceEnd_ = false; // 最後のバッファまで積んだ (mutex_で守る)
+	std::atomic<bool> isFinished_ = false;
+};
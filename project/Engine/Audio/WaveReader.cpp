@@ -0,0 +1,216 @@
+#include "WaveReader.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+namespace {
+	constexpr uint16_t kFormatPcm = 0x0001;
+	constexpr uint16_t kFormatFloat = 0x0003;
+	constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+	// KSDATAFORMAT_SUBTYPE_〇〇 の先頭2バイト以外 (先頭2バイトが元のformatTag)
+	constexpr uint8_t kSubFormatBase[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+
+	// WAVEFORMATEXTENSIBLEまでのfmtチャンクの大きさ
+	constexpr uint32_t kMaxFormatChunkSize = 40;
+
+	uint16_t ReadLE16(const uint8_t* p) {
+		return static_cast<uint16_t>(p[0] | (p[1] << 8));
+	}
+
+	uint32_t ReadLE32(const uint8_t* p) {
+		return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+			(static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+	}
+
+	bool ReadBytes(std::ifstream& file, void* buffer, size_t size) {
+		file.read(static_cast<char*>(buffer), static_cast<std::streamsize>(size));
+		return static_cast<size_t>(file.gcount()) == size;
+	}
+
+	bool IsSupportedFormat(const WaveFormat& format) {
+		if (format.channelCount == 0 || format.sampleRate == 0 || format.bitsPerSample == 0 || format.bitsPerSample % 8 != 0) {
+			return false;
+		}
+		if (format.blockAlign != format.channelCount * format.bitsPerSample / 8) {
+			return false;
+		}
+		if (format.validBitsPerSample == 0 || format.validBitsPerSample > format.bitsPerSample) {
+			return false;
+		}
+		if (format.sampleType == WaveSampleType::Float) {
+			return format.bitsPerSample == 32 || format.bitsPerSample == 64;
+		}
+		return format.bitsPerSample <= 32;
+	}
+}
+
+bool WaveReader::Open(const std::string& filePath)
+{
+	Close();
+	file_.open(filePath, std::ios_base::binary);
+	if (!file_.is_open()) {
+		Logger::Write("WAVを開けませんでした: " + filePath);
+		return false;
+	}
+	filePath_ = filePath;
+
+	file_.seekg(0, std::ios_base::end);
+	const uint64_t fileSize = static_cast<uint64_t>(file_.tellg());
+	file_.seekg(0, std::ios_base::beg);
+
+	// RIFFヘッダ
+	uint8_t riff[12];
+	if (!ReadBytes(file_, riff, sizeof(riff)) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+		Logger::Write("RIFF/WAVEではありません: " + filePath);
+		Close();
+		return false;
+	}
+	// RIFFのサイズが入っていないファイル(書き出し途中など)はファイルの終わりまで見る
+	const uint32_t riffSize = ReadLE32(riff + 4);
+	const uint64_t riffEnd = riffSize >= 4 ? (std::min)(uint64_t(8) + riffSize, fileSize) : fileSize;
+
+	// チャンクを順にたどる (サイズが奇数のチャンクの後ろには1バイトの詰め物がある)
+	bool hasFormat = false;
+	bool hasData = false;
+	uint64_t chunkPosition = sizeof(riff);
+	while (chunkPosition + 8 <= riffEnd && !(hasFormat && hasData)) {
+		file_.clear();
+		file_.seekg(static_cast<std::streamoff>(chunkPosition), std::ios_base::beg);
+		uint8_t header[8];
+		if (!ReadBytes(file_, header, sizeof(header))) {
+			break;
+		}
+		const uint32_t chunkSize = ReadLE32(header + 4);
+		const uint64_t bodyPosition = chunkPosition + 8;
+
+		if (std::memcmp(header, "fmt ", 4) == 0) {
+			if (!ReadFormatChunk(chunkSize)) {
+				Close();
+				return false;
+			}
+			hasFormat = true;
+		} else if (std::memcmp(header, "data", 4) == 0) {
+			// 途中で切れているファイルは読める所まで
+			dataOffset_ = bodyPosition;
+			dataSize_ = (std::min)(uint64_t(chunkSize), fileSize - bodyPosition);
+			hasData = true;
+		}
+		chunkPosition = bodyPosition + chunkSize + (chunkSize & 1);
+	}
+
+	if (!hasFormat || !hasData) {
+		Logger::Write(std::format("{}チャンクがありません: {}", hasFormat ? "data" : "fmt ", filePath));
+		Close();
+		return false;
+	}
+
+	dataSize_ -= dataSize_ % format_.blockAlign;
+	Seek(0);
+	return true;
+}
+
+void WaveReader::Close()
+{
+	if (file_.is_open()) {
+		file_.close();
+	}
+	file_.clear();
+	filePath_.clear();
+	format_ = {};
+	dataOffset_ = 0;
+	dataSize_ = 0;
+	position_ = 0;
+}
+
+void WaveReader::Seek(uint64_t frame)
+{
+	position_ = (std::min)(frame * format_.blockAlign, dataSize_);
+	file_.clear();
+	file_.seekg(static_cast<std::streamoff>(dataOffset_ + position_), std::ios_base::beg);
+}
+
+size_t WaveReader::Read(void* buffer, size_t size)
+{
+	if (format_.blockAlign == 0) {
+		return 0;
+	}
+	size -= size % format_.blockAlign;
+	return ReadData(buffer, size);
+}
+
+bool WaveReader::ReadFormatChunk(uint32_t chunkSize)
+{
+	if (chunkSize < 16) {
+		Logger::Write("fmtチャンクが短すぎます: " + filePath_);
+		return false;
+	}
+
+	uint8_t fmt[kMaxFormatChunkSize] = {};
+	const uint32_t readSize = (std::min)(chunkSize, kMaxFormatChunkSize);
+	if (!ReadBytes(file_, fmt, readSize)) {
+		Logger::Write("fmtチャンクを読めませんでした: " + filePath_);
+		return false;
+	}
+
+	uint16_t formatTag = ReadLE16(fmt);
+	format_.channelCount = ReadLE16(fmt + 2);
+	format_.sampleRate = ReadLE32(fmt + 4);
+	format_.blockAlign = ReadLE16(fmt + 12);
+	format_.bitsPerSample = ReadLE16(fmt + 14);
+	format_.validBitsPerSample = format_.bitsPerSample;
+	format_.channelMask = 0;
+
+	// WAVE_FORMAT_EXTENSIBLEは拡張部分のSubFormatが本当の形式
+	if (formatTag == kFormatExtensible) {
+		if (readSize < kMaxFormatChunkSize || ReadLE16(fmt + 16) < 22) {
+			Logger::Write("WAVE_FORMAT_EXTENSIBLEの拡張部分が足りません: " + filePath_);
+			return false;
+		}
+		format_.validBitsPerSample = ReadLE16(fmt + 18);
+		format_.channelMask = ReadLE32(fmt + 20);
+		const uint8_t* subFormat = fmt + 24;
+		if (std::memcmp(subFormat + 2, kSubFormatBase, sizeof(kSubFormatBase)) != 0) {
+			Logger::Write("未対応のSubFormatです: " + filePath_);
+			return false;
+		}
+		formatTag = ReadLE16(subFormat);
+		// 0は「全ビット使用」の意味で書かれていることがある
+		if (format_.validBitsPerSample == 0) {
+			format_.validBitsPerSample = format_.bitsPerSample;
+		}
+	}
+
+	if (formatTag == kFormatPcm) {
+		format_.sampleType = WaveSampleType::Pcm;
+	} else if (formatTag == kFormatFloat) {
+		format_.sampleType = WaveSampleType::Float;
+	} else {
+		Logger::Write(std::format("未対応のWAV形式です (formatTag 0x{:04X}): {}", formatTag, filePath_));
+		return false;
+	}
+
+	if (!IsSupportedFormat(format_)) {
+		Logger::Write(std::format("未対応のWAV形式です ({}ch, {}Hz, {}bit, blockAlign {}): {}",
+			format_.channelCount, format_.sampleRate, format_.bitsPerSample, format_.blockAlign, filePath_));
+		return false;
+	}
+	return true;
+}
+
+size_t WaveReader::ReadData(void* buffer, size_t size)
+{
+	size = static_cast<size_t>((std::min)(uint64_t(size), dataSize_ - position_));
+	if (size == 0) {
+		return 0;
+	}
+	file_.read(static_cast<char*>(buffer), static_cast<std::streamsize>(size));
+	const size_t readSize = static_cast<size_t>(file_.gcount());
+	position_ += readSize;
+	// 読めなかったら(ファイルが途中で消えたなど)そこを終わりにする
+	if (readSize < size) {
+		dataSize_ = position_;
+	}
+	return readSize;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// サンプルの種類
+enum class WaveSampleType {
+	Pcm, // 整数 (8bitは符号なし、それ以外は符号付き)
+	Float, // IEEE浮動小数
+};
+
+// WAVの形式 (WAVE_FORMAT_EXTENSIBLEはSubFormatを見てPcm/Floatに直す)
+struct WaveFormat {
+	WaveSampleType sampleType = WaveSampleType::Pcm;
+	uint16_t channelCount = 0;
+	uint32_t sampleRate = 0;
+	uint16_t bitsPerSample = 0; // 1サンプルの入れ物のビット数
+	uint16_t validBitsPerSample = 0; // 実際に使っているビット数 (EXTENSIBLEでなければbitsPerSampleと同じ)
+	uint16_t blockAlign = 0; // 1フレーム(全チャンネル1サンプルずつ)のバイト数
+	uint32_t channelMask = 0; // スピーカーの割り当て (0なら既定の並び)
+};
+
+// WAVファイルを少しずつ読む
+// チャンクの並びは決め打ちせずに全部たどり、fmtとdata以外(LIST, fact, bext, JUNKなど)は読み飛ばす
+// 波形データは開いた時には読まず、Readで必要な分だけ読む
+class WaveReader
+{
+public:
+	WaveReader() = default;
+	~WaveReader() = default;
+
+	WaveReader(const WaveReader&) = delete;
+	WaveReader& operator=(const WaveReader&) = delete;
+
+	/// <summary>
+	/// ファイルを開いてチャンクを調べる
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>対応している形式で、fmtとdataが見つかればtrue (失敗の理由はログに出す)</returns>
+	bool Open(const std::string& filePath);
+
+	void Close();
+
+	bool IsOpen() const { return file_.is_open(); }
+
+	const WaveFormat& GetFormat() const { return format_; }
+
+	// 波形データ全体のバイト数
+	uint64_t GetDataSize() const { return dataSize_; }
+
+	// 全体のフレーム数
+	uint64_t GetFrameCount() const { return format_.blockAlign ? dataSize_ / format_.blockAlign : 0; }
+
+	// 次に読むフレーム
+	uint64_t GetFramePosition() const { return format_.blockAlign ? position_ / format_.blockAlign : 0; }
+
+	// 最後まで読んだか
+	bool IsEnd() const { return position_ >= dataSize_; }
+
+	/// <summary>
+	/// 読み出す位置を変える
+	/// </summary>
+	/// <param name="frame">フレーム番号 (末尾を超えたら末尾)</param>
+	void Seek(uint64_t frame);
+
+	/// <summary>
+	/// 波形データを読む (フレーム単位に切り捨てる)
+	/// </summary>
+	/// <param name="buffer">読み込み先</param>
+	/// <param name="size">読み込み先のバイト数</param>
+	/// <returns>読んだバイト数 (末尾なら0)</returns>
+	size_t Read(void* buffer, size_t size);
+
+private:
+	bool ReadFormatChunk(uint32_t chunkSize);
+	// 今の位置から波形データをそのまま読む (フレーム単位にはしない)
+	size_t ReadData(void* buffer, size_t size);
+
+	std::ifstream file_;
+	std::string filePath_;
+	WaveFormat format_;
+	uint64_t dataOffset_ = 0; // ファイル内の波形データの位置
+	uint64_t dataSize_ = 0;
+	uint64_t position_ = 0; // 波形データ内の次に読む位置
+};
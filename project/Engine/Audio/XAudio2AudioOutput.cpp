@@ -0,0 +1,81 @@
+#include "XAudio2AudioOutput.h"
+#include "AudioMixer.h"
+#include "Logger.h"
+#include <format>
+
+XAudio2AudioOutput::XAudio2AudioOutput(IXAudio2* xAudio2)
+	: xAudio2_(xAudio2)
+{
+}
+
+XAudio2AudioOutput::~XAudio2AudioOutput()
+{
+	Stop();
+}
+
+bool XAudio2AudioOutput::Start(AudioMixer& mixer)
+{
+	Stop();
+	if (!xAudio2_) {
+		return false;
+	}
+
+	WAVEFORMATEX wfex = {};
+	wfex.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+	wfex.nChannels = static_cast<WORD>(AudioMixer::kChannelCount);
+	wfex.nSamplesPerSec = mixer.GetSampleRate();
+	wfex.wBitsPerSample = 32;
+	wfex.nBlockAlign = static_cast<WORD>(wfex.nChannels * sizeof(float));
+	wfex.nAvgBytesPerSec = wfex.nSamplesPerSec * wfex.nBlockAlign;
+
+	HRESULT result = xAudio2_->CreateSourceVoice(&sourceVoice_, &wfex, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
+	if (FAILED(result)) {
+		Logger::Write(std::format("ミキサー出力用のソースボイスを作れませんでした (0x{:08X})", static_cast<uint32_t>(result)));
+		sourceVoice_ = nullptr;
+		return false;
+	}
+
+	mixer_ = &mixer;
+	isStopping_ = false;
+	// 全部のバッファを埋めてから鳴らし始める
+	for (uint32_t i = 0; i < kBufferCount; ++i) {
+		SubmitBuffer(i);
+	}
+	sourceVoice_->Start();
+	return true;
+}
+
+void XAudio2AudioOutput::Stop()
+{
+	if (!sourceVoice_) {
+		return;
+	}
+	// DestroyVoiceはコールバックが終わるのを待つので、その後はミキサーに触れない
+	isStopping_ = true;
+	sourceVoice_->Stop();
+	sourceVoice_->FlushSourceBuffers();
+	sourceVoice_->DestroyVoice();
+	sourceVoice_ = nullptr;
+	mixer_ = nullptr;
+}
+
+void XAudio2AudioOutput::SubmitBuffer(uint32_t index)
+{
+	float* samples = buffers_[index].data();
+	mixer_->Mix(samples, kFramesPerBuffer);
+
+	XAUDIO2_BUFFER buffer = {};
+	buffer.AudioBytes = static_cast<UINT32>(sizeof(buffers_[index]));
+	buffer.pAudioData = reinterpret_cast<const BYTE*>(samples);
+	// どのバッファかをコンテキストで受け取る
+	buffer.pContext = reinterpret_cast<void*>(static_cast<uintptr_t>(index));
+	sourceVoice_->SubmitSourceBuffer(&buffer);
+}
+
+void XAudio2AudioOutput::OnBufferEnd(void* bufferContext) noexcept
+{
+	if (isStopping_) {
+		return;
+	}
+	SubmitBuffer(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(bufferContext)));
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "AudioOutput.h"
+#include <Windows.h>
+#include <xAudio2.h>
+#include <array>
+#include <atomic>
+
+// XAudio2に出す出力
+// float/ステレオのソースボイスを1つ作り、バッファを使い終わるたびに(OnBufferEnd)
+// XAudio2のスレッドでミキサーから次の分を取り出して積み直す
+class XAudio2AudioOutput : public AudioOutput, private IXAudio2VoiceCallback
+{
+public:
+	// 1バッファのフレーム数 (48kHzで10ms)
+	static constexpr uint32_t kFramesPerBuffer = 480;
+	// 使い回すバッファの数 (多いほど途切れにくいが遅れる)
+	static constexpr uint32_t kBufferCount = 3;
+
+	explicit XAudio2AudioOutput(IXAudio2* xAudio2);
+	~XAudio2AudioOutput() override;
+
+	XAudio2AudioOutput(const XAudio2AudioOutput&) = delete;
+	XAudio2AudioOutput& operator=(const XAudio2AudioOutput&) = delete;
+
+	bool Start(AudioMixer& mixer) override;
+	void Stop() override;
+
+private:
+	// 指定したバッファにミキサーの続きを入れて積む
+	void SubmitBuffer(uint32_t index);
+
+	// IXAudio2VoiceCallback
+	void __stdcall OnVoiceProcessingPassStart(UINT32) noexcept override {}
+	void __stdcall OnVoiceProcessingPassEnd() noexcept override {}
+	void __stdcall OnStreamEnd() noexcept override {}
+	void __stdcall OnBufferStart(void*) noexcept override {}
+	void __stdcall OnBufferEnd(void* bufferContext) noexcept override;
+	void __stdcall OnLoopEnd(void*) noexcept override {}
+	void __stdcall OnVoiceError(void*, HRESULT) noexcept override {}
+
+	IXAudio2* xAudio2_ = nullptr;
+	IXAudio2SourceVoice* sourceVoice_ = nullptr;
+	AudioMixer* mixer_ = nullptr;
+	std::array<std::array<float, kFramesPerBuffer * 2>, kBufferCount> buffers_ = {};
+	std::atomic<bool> isStopping_ = false;
+};
@@ -2,6 +2,7 @@
 
 void DebugCamera::Initialize()
 {
+	rotation_ = IdentityQuaternion();
 	matRot_ = MakeIdentity4x4();
 }
 
@@ -21,11 +22,13 @@ void DebugCamera::Update()
 			float rotateYaw = static_cast<float>(mousePos.x - preMousePos_.x) * sensitivity;
 			float rotatePitch = static_cast<float>(mousePos.y - preMousePos_.y) * sensitivity;
 
-			Matrix4x4 matRotDelta = MakeIdentity4x4();
-			matRotDelta *= MakeRotateYMatrix(rotateYaw);
-			matRotDelta *= MakeRotateXMatrix(rotatePitch);
-			// 累積回転行列に合成
-			matRot_ = Multiply(matRotDelta, matRot_);
+			// Y軸回転 → X軸回転の順に適用する
+			Quaternion rotateDelta = Multiply(
+				MakeRotateAxisAngleQuaternion({ 1.0f, 0.0f, 0.0f }, rotatePitch),
+				MakeRotateAxisAngleQuaternion({ 0.0f, 1.0f, 0.0f }, rotateYaw));
+			// 累積回転に合成 (差分を先に適用する)
+			rotation_ = Normalize(Multiply(rotation_, rotateDelta));
+			matRot_ = MakeRotateMatrix(rotation_);
 		}
 		isRightDrag_ = true;
 	}
@@ -84,11 +87,9 @@ void DebugCamera::Update()
 		translation_ = translation_ + move;
 	}
 
-	// 移動行列
-	Matrix4x4 matTrans = MakeTranslateMatrix(translation_);
-
 	// ワールド行列
-	Matrix4x4 matWorld = Multiply(matRot_, matTrans);
+	Matrix4x4 matWorld = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotation_, translation_);
 
-	viewMatrix_ = Inverse(matWorld);
+	// 回転と平行移動だけなので転置で逆行列を求める
+	viewMatrix_ = InverseRigid(matWorld);
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Matrix.h"
+#include "Quaternion.h"
 #include <windows.h>
 
 class DebugCamera
@@ -17,9 +18,14 @@ public:
 
 	Matrix4x4 GetViewMatrix() { return viewMatrix_; }
 
+	// ワールド空間のカメラの位置
+	Vector3 GetPosition() { return translation_; }
+
 private:
 	// X,Y,Z軸回りのローカル回転角
 	//Vector3 rotation_ = { 0, 0, 0 };
+	// 累積回転 (行列の積を重ねると誤差で歪むのでクォータニオンで持つ)
+	Quaternion rotation_ = { 0.0f, 0.0f, 0.0f, 1.0f };
 	// 累積回転行列
 	Matrix4x4 matRot_;
 	// ローカル座標
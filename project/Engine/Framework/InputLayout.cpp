@@ -36,3 +36,24 @@ D3D12_INPUT_LAYOUT_DESC InputLayout::CreateInputLayout2D()
 
 	return inputLayoutDesc2D_;
 }
+
+D3D12_INPUT_LAYOUT_DESC InputLayout::CreateInputLayout3DPacked()
+{
+	// 位置はAABB内の0～1、UVは半精度、法線は八面体写像の2成分
+	inputElementDescs3DPacked_[0].SemanticName = "POSITION";
+	inputElementDescs3DPacked_[0].SemanticIndex = 0;
+	inputElementDescs3DPacked_[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+	inputElementDescs3DPacked_[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputElementDescs3DPacked_[1].SemanticName = "TEXCOORD";
+	inputElementDescs3DPacked_[1].SemanticIndex = 0;
+	inputElementDescs3DPacked_[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+	inputElementDescs3DPacked_[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputElementDescs3DPacked_[2].SemanticName = "NORMAL";
+	inputElementDescs3DPacked_[2].SemanticIndex = 0;
+	inputElementDescs3DPacked_[2].Format = DXGI_FORMAT_R16G16_SNORM;
+	inputElementDescs3DPacked_[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+	inputLayoutDesc3DPacked_.pInputElementDescs = inputElementDescs3DPacked_;
+	inputLayoutDesc3DPacked_.NumElements = _countof(inputElementDescs3DPacked_);
+
+	return inputLayoutDesc3DPacked_;
+}
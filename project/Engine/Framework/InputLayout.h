@@ -8,11 +8,15 @@ class InputLayout
 public:
 	D3D12_INPUT_LAYOUT_DESC CreateInputLayout3D();
 	D3D12_INPUT_LAYOUT_DESC CreateInputLayout2D();
+	// PackedVertex用 (Object3dPacked.VS.hlslと組み合わせる)
+	D3D12_INPUT_LAYOUT_DESC CreateInputLayout3DPacked();
 
 private:
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs3D_[3] = {};
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs2D_[2] = {};
+	D3D12_INPUT_ELEMENT_DESC inputElementDescs3DPacked_[3] = {};
 	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc3D_{};
 	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc2D_{};
+	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc3DPacked_{};
 };
 
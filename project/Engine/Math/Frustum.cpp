@@ -0,0 +1,225 @@
+#include "Frustum.h"
+#include "MathConfig.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+
+namespace {
+	// 平面を正規化する
+	Plane NormalizePlane(float a, float b, float c, float d) {
+		float length = std::sqrt(a * a + b * b + c * c);
+		if (length == 0.0f) {
+			return { { 0.0f, 0.0f, 0.0f }, 0.0f };
+		}
+		float invLength = 1.0f / length;
+		return { { a * invLength, b * invLength, c * invLength }, d * invLength };
+	}
+
+	// 中心と半分の大きさで表したAABBが平面の外側に完全に出ているか
+	bool IsOutside(const Plane& plane, const Vector3& center, const Vector3& extent) {
+		float dist = plane.normal.x * center.x + plane.normal.y * center.y + plane.normal.z * center.z + plane.distance;
+		float radius = std::fabs(plane.normal.x) * extent.x + std::fabs(plane.normal.y) * extent.y + std::fabs(plane.normal.z) * extent.z;
+		return dist + radius < 0.0f;
+	}
+
+	bool IsVisibleCenterExtent(const Frustum& frustum, const Vector3& center, const Vector3& extent) {
+		for (const Plane& plane : frustum.planes) {
+			if (IsOutside(plane, center, extent)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+#ifdef MATH_USE_SSE
+	// 6平面の各成分を4レーンに複製したもの
+	struct FrustumSIMD {
+		__m128 nx[6], ny[6], nz[6], d[6];
+		__m128 absNx[6], absNy[6], absNz[6];
+	};
+
+	FrustumSIMD LoadFrustum(const Frustum& frustum) {
+		FrustumSIMD result;
+		for (int i = 0; i < 6; ++i) {
+			const Plane& plane = frustum.planes[i];
+			result.nx[i] = _mm_set1_ps(plane.normal.x);
+			result.ny[i] = _mm_set1_ps(plane.normal.y);
+			result.nz[i] = _mm_set1_ps(plane.normal.z);
+			result.d[i] = _mm_set1_ps(plane.distance);
+			result.absNx[i] = _mm_set1_ps(std::fabs(plane.normal.x));
+			result.absNy[i] = _mm_set1_ps(std::fabs(plane.normal.y));
+			result.absNz[i] = _mm_set1_ps(std::fabs(plane.normal.z));
+		}
+		return result;
+	}
+
+	// 見えている番号を書き出す
+	inline size_t WriteVisible(int visibleMask, size_t base, uint32_t* visibleIndices, size_t visibleCount) {
+		for (int lane = 0; lane < 4; ++lane) {
+			if (visibleMask & (1 << lane)) {
+				visibleIndices[visibleCount++] = static_cast<uint32_t>(base + lane);
+			}
+		}
+		return visibleCount;
+	}
+#endif
+}
+
+AABB MakeAABB(const void* points, size_t count, size_t stride) {
+	if (count == 0) {
+		return { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+	}
+
+	AABB result = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+	const uint8_t* bytes = static_cast<const uint8_t*>(points);
+	for (size_t i = 0; i < count; ++i) {
+		Vector3 p;
+		std::memcpy(&p, bytes + i * stride, sizeof(Vector3));
+		result.min = { (std::min)(result.min.x, p.x), (std::min)(result.min.y, p.y), (std::min)(result.min.z, p.z) };
+		result.max = { (std::max)(result.max.x, p.x), (std::max)(result.max.y, p.y), (std::max)(result.max.z, p.z) };
+	}
+	return result;
+}
+
+Sphere MakeSphere(const AABB& aabb) {
+	Vector3 center = (aabb.min + aabb.max) * 0.5f;
+	return { center, Length(aabb.max - center) };
+}
+
+// 中心を変換し、大きさは行列の絶対値で広げる
+AABB TransformAABB(const AABB& aabb, const Matrix4x4& matrix) {
+	Vector3 center = (aabb.min + aabb.max) * 0.5f;
+	Vector3 extent = (aabb.max - aabb.min) * 0.5f;
+
+	Vector3 newCenter = TransformNormal(center, matrix);
+	newCenter = newCenter + Vector3{ matrix.m[3][0], matrix.m[3][1], matrix.m[3][2] };
+
+	Vector3 newExtent;
+	newExtent.x = std::fabs(matrix.m[0][0]) * extent.x + std::fabs(matrix.m[1][0]) * extent.y + std::fabs(matrix.m[2][0]) * extent.z;
+	newExtent.y = std::fabs(matrix.m[0][1]) * extent.x + std::fabs(matrix.m[1][1]) * extent.y + std::fabs(matrix.m[2][1]) * extent.z;
+	newExtent.z = std::fabs(matrix.m[0][2]) * extent.x + std::fabs(matrix.m[1][2]) * extent.y + std::fabs(matrix.m[2][2]) * extent.z;
+
+	return { newCenter - newExtent, newCenter + newExtent };
+}
+
+// 行ベクトル形式なのでクリップ座標は行列の各列との内積になる
+// 左: w + x, 右: w - x, 下: w + y, 上: w - y, 近: z, 遠: w - z
+Frustum MakeFrustum(const Matrix4x4& viewProjection) {
+	const float(*m)[4] = viewProjection.m;
+	auto column = [&](int j, float sign) {
+		return NormalizePlane(
+			m[0][3] + sign * m[0][j],
+			m[1][3] + sign * m[1][j],
+			m[2][3] + sign * m[2][j],
+			m[3][3] + sign * m[3][j]);
+	};
+
+	Frustum frustum;
+	frustum.planes[0] = column(0, 1.0f);
+	frustum.planes[1] = column(0, -1.0f);
+	frustum.planes[2] = column(1, 1.0f);
+	frustum.planes[3] = column(1, -1.0f);
+	frustum.planes[4] = NormalizePlane(m[0][2], m[1][2], m[2][2], m[3][2]);
+	frustum.planes[5] = column(2, -1.0f);
+	return frustum;
+}
+
+bool IsVisible(const Frustum& frustum, const AABB& aabb) {
+	return IsVisibleCenterExtent(frustum, (aabb.min + aabb.max) * 0.5f, (aabb.max - aabb.min) * 0.5f);
+}
+
+bool IsVisible(const Frustum& frustum, const Sphere& sphere) {
+	for (const Plane& plane : frustum.planes) {
+		float dist = plane.normal.x * sphere.center.x + plane.normal.y * sphere.center.y + plane.normal.z * sphere.center.z + plane.distance;
+		if (dist + sphere.radius < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t CullAABBBatch(const Frustum& frustum, const AABB* boxes, size_t count, uint32_t* visibleIndices) {
+	size_t visibleCount = 0;
+	size_t i = 0;
+
+#ifdef MATH_USE_SSE
+	const FrustumSIMD planes = LoadFrustum(frustum);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	// 4個ずつ要素ごとのレジスタに並べ替えて判定する
+	for (; i + 4 <= count; i += 4) {
+		const AABB* b = boxes + i;
+		const __m128 minX = _mm_setr_ps(b[0].min.x, b[1].min.x, b[2].min.x, b[3].min.x);
+		const __m128 minY = _mm_setr_ps(b[0].min.y, b[1].min.y, b[2].min.y, b[3].min.y);
+		const __m128 minZ = _mm_setr_ps(b[0].min.z, b[1].min.z, b[2].min.z, b[3].min.z);
+		const __m128 maxX = _mm_setr_ps(b[0].max.x, b[1].max.x, b[2].max.x, b[3].max.x);
+		const __m128 maxY = _mm_setr_ps(b[0].max.y, b[1].max.y, b[2].max.y, b[3].max.y);
+		const __m128 maxZ = _mm_setr_ps(b[0].max.z, b[1].max.z, b[2].max.z, b[3].max.z);
+
+		const __m128 centerX = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+		const __m128 centerY = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+		const __m128 centerZ = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+		const __m128 extentX = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+		const __m128 extentY = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+		const __m128 extentZ = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; ++p) {
+			__m128 dist = _mm_add_ps(_mm_mul_ps(planes.nx[p], centerX), _mm_mul_ps(planes.ny[p], centerY));
+			dist = _mm_add_ps(dist, _mm_add_ps(_mm_mul_ps(planes.nz[p], centerZ), planes.d[p]));
+			__m128 radius = _mm_add_ps(_mm_mul_ps(planes.absNx[p], extentX), _mm_mul_ps(planes.absNy[p], extentY));
+			radius = _mm_add_ps(radius, _mm_mul_ps(planes.absNz[p], extentZ));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+		}
+
+		const int visibleMask = ~_mm_movemask_ps(outside) & 0xF;
+		visibleCount = WriteVisible(visibleMask, i, visibleIndices, visibleCount);
+	}
+#endif
+
+	// 残り
+	for (; i < count; ++i) {
+		if (IsVisible(frustum, boxes[i])) {
+			visibleIndices[visibleCount++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	return visibleCount;
+}
+
+size_t CullSphereBatch(const Frustum& frustum, const Sphere* spheres, size_t count, uint32_t* visibleIndices) {
+	size_t visibleCount = 0;
+	size_t i = 0;
+
+#ifdef MATH_USE_SSE
+	const FrustumSIMD planes = LoadFrustum(frustum);
+
+	for (; i + 4 <= count; i += 4) {
+		// Sphereは16バイトなので4つ読んで転置すれば要素ごとに並ぶ
+		__m128 centerX = _mm_loadu_ps(&spheres[i].center.x);
+		__m128 centerY = _mm_loadu_ps(&spheres[i + 1].center.x);
+		__m128 centerZ = _mm_loadu_ps(&spheres[i + 2].center.x);
+		__m128 radius = _mm_loadu_ps(&spheres[i + 3].center.x);
+		_MM_TRANSPOSE4_PS(centerX, centerY, centerZ, radius);
+
+		__m128 outside = _mm_setzero_ps();
+		for (int p = 0; p < 6; ++p) {
+			__m128 dist = _mm_add_ps(_mm_mul_ps(planes.nx[p], centerX), _mm_mul_ps(planes.ny[p], centerY));
+			dist = _mm_add_ps(dist, _mm_add_ps(_mm_mul_ps(planes.nz[p], centerZ), planes.d[p]));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+		}
+
+		const int visibleMask = ~_mm_movemask_ps(outside) & 0xF;
+		visibleCount = WriteVisible(visibleMask, i, visibleIndices, visibleCount);
+	}
+#endif
+
+	for (; i < count; ++i) {
+		if (IsVisible(frustum, spheres[i])) {
+			visibleIndices[visibleCount++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	return visibleCount;
+}
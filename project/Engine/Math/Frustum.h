@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Matrix.h"
+
+// 軸平行境界ボックス
+struct AABB {
+	Vector3 min;
+	Vector3 max;
+};
+
+// 境界球
+struct Sphere {
+	Vector3 center;
+	float radius;
+};
+
+// 平面 (dot(normal, p) + distance >= 0 の側を内側とする)
+struct Plane {
+	Vector3 normal;
+	float distance;
+};
+
+// 視錐台 (左, 右, 下, 上, 近, 遠の6平面)
+struct Frustum {
+	Plane planes[6];
+};
+
+/// <summary>
+/// 点群を囲むAABBを求める
+/// </summary>
+/// <param name="points">先頭の点 (Vector3として読めるデータ)</param>
+/// <param name="count">点の数</param>
+/// <param name="stride">点の間隔 (バイト)</param>
+/// <returns>AABB (点が無ければ大きさ0)</returns>
+AABB MakeAABB(const void* points, size_t count, size_t stride);
+
+// AABBを囲む境界球を求める
+Sphere MakeSphere(const AABB& aabb);
+
+/// <summary>
+/// AABBを行列で変換し、変換後のAABBを求める
+/// </summary>
+/// <param name="aabb">ローカル空間のAABB</param>
+/// <param name="matrix">アフィン変換行列</param>
+/// <returns>変換後の空間のAABB</returns>
+AABB TransformAABB(const AABB& aabb, const Matrix4x4& matrix);
+
+/// <summary>
+/// ビュープロジェクション行列から視錐台の6平面を取り出す
+/// MakePerspectiveFovMatrixと同じく深度は0～1を前提とする
+/// </summary>
+/// <param name="viewProjection">ビュープロジェクション行列</param>
+/// <returns>ワールド空間の視錐台 (法線は正規化済み)</returns>
+Frustum MakeFrustum(const Matrix4x4& viewProjection);
+
+// AABBが視錐台に入っているか (一部でも入っていればtrue)
+bool IsVisible(const Frustum& frustum, const AABB& aabb);
+
+// 球が視錐台に入っているか (一部でも入っていればtrue)
+bool IsVisible(const Frustum& frustum, const Sphere& sphere);
+
+/// <summary>
+/// 大量のAABBをまとめて視錐台カリングする
+/// </summary>
+/// <param name="frustum">視錐台</param>
+/// <param name="boxes">AABBの配列</param>
+/// <param name="count">AABBの数</param>
+/// <param name="visibleIndices">見えているAABBの番号の出力先 (count個分の領域が必要)</param>
+/// <returns>見えているAABBの数</returns>
+size_t CullAABBBatch(const Frustum& frustum, const AABB* boxes, size_t count, uint32_t* visibleIndices);
+
+/// <summary>
+/// 大量の球をまとめて視錐台カリングする
+/// </summary>
+/// <param name="frustum">視錐台</param>
+/// <param name="spheres">球の配列</param>
+/// <param name="count">球の数</param>
+/// <param name="visibleIndices">見えている球の番号の出力先 (count個分の領域が必要)</param>
+/// <returns>見えている球の数</returns>
+size_t CullSphereBatch(const Frustum& frustum, const Sphere* spheres, size_t count, uint32_t* visibleIndices);
@@ -0,0 +1,14 @@
+#pragma once
+
+// 数学ライブラリのSIMD設定
+// プリプロセッサ定義に MATH_FORCE_SCALAR を追加するとスカラー実装でビルドされる
+// x64ではSSE2が常に使えるので既定でSSE実装を使う
+// /arch:AVX 以上でビルドした場合は行列積の一部をAVXで2行ずつ処理する
+#if !defined(MATH_FORCE_SCALAR) && (defined(_M_X64) || defined(__SSE2__))
+#define MATH_USE_SSE 1
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define MATH_USE_AVX 1
+#include <immintrin.h>
+#endif
+#endif
@@ -1,17 +1,92 @@
 #include "Matrix.h"
+#include "MathConfig.h"
 #include <cmath>
 
-// 加算
-Vector3 Add(const Vector3& v1, const Vector3& v2) {
-	Vector3 result;
-	result.x = v1.x + v2.x;
-	result.y = v1.y + v2.y;
-	result.z = v1.z + v2.z;
-	return result;
+#ifdef MATH_USE_SSE
+namespace {
+	// 行列の1行をレジスタに読み込む
+	inline __m128 LoadRow(const Matrix4x4& m, int row) {
+		return _mm_loadu_ps(m.m[row]);
+	}
+
+	// レジスタの内容を行列の1行に書き込む
+	inline void StoreRow(Matrix4x4& m, int row, __m128 v) {
+		_mm_storeu_ps(m.m[row], v);
+	}
+
+	// 行ベクトル(row) × 行列(b0～b3は行列の各行)
+	inline __m128 MultiplyRow(__m128 row, __m128 b0, __m128 b1, __m128 b2, __m128 b3) {
+		// スカラー実装と同じ順番で加算して誤差の出方を揃える
+		__m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+		return result;
+	}
+
+	// 2x2行列を__m128の(a00, a01, a10, a11)として扱う補助関数
+	// 2x2行列の積 A * B
+	inline __m128 Mat2Mul(__m128 a, __m128 b) {
+		return _mm_add_ps(
+			_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	// 余因子行列との積 adj(A) * B
+	inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+		return _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+	}
+
+	// 余因子行列との積 A * adj(B)
+	inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+		return _mm_sub_ps(
+			_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+			_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+	}
+
+	// 外積 (w成分は0になる)
+	inline __m128 Cross(__m128 a, __m128 b) {
+		const __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+		return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+	}
+
+	// 3x3部分を転置した行(rows)と平行移動(t)から逆行列を組み立てる
+	// 平行移動は -t * (3x3の逆行列)
+	inline Matrix4x4 ComposeInverse(__m128 row0, __m128 row1, __m128 row2, __m128 t) {
+		__m128 translate = _mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+		translate = _mm_add_ps(translate, _mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+		translate = _mm_add_ps(translate, _mm_mul_ps(_mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+		// w成分は1にする
+		translate = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translate);
+
+		Matrix4x4 result;
+		StoreRow(result, 0, row0);
+		StoreRow(result, 1, row1);
+		StoreRow(result, 2, row2);
+		StoreRow(result, 3, translate);
+		return result;
+	}
+
+	// 4要素の総和を全レーンに入れる
+	inline __m128 HorizontalSum(__m128 v) {
+		__m128 t = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_add_ps(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 0, 3, 2)));
+	}
 }
+#endif
 
+// 加算
 Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2) {
 	Matrix4x4 result;
+#ifdef MATH_USE_SSE
+	for (int i = 0; i < 4; i++) {
+		StoreRow(result, i, _mm_add_ps(LoadRow(m1, i), LoadRow(m2, i)));
+	}
+#else
 	result.m[0][0] = m1.m[0][0] + m2.m[0][0];
 	result.m[0][1] = m1.m[0][1] + m2.m[0][1];
 	result.m[0][2] = m1.m[0][2] + m2.m[0][2];
@@ -31,21 +106,19 @@ Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2) {
 	result.m[3][1] = m1.m[3][1] + m2.m[3][1];
 	result.m[3][2] = m1.m[3][2] + m2.m[3][2];
 	result.m[3][3] = m1.m[3][3] + m2.m[3][3];
+#endif
 
 	return result;
 }
 
 // 減算
-Vector3 Subtract(const Vector3& v1, const Vector3& v2) {
-	Vector3 result;
-	result.x = v1.x - v2.x;
-	result.y = v1.y - v2.y;
-	result.z = v1.z - v2.z;
-	return result;
-}
-
 Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2) {
 	Matrix4x4 result;
+#ifdef MATH_USE_SSE
+	for (int i = 0; i < 4; i++) {
+		StoreRow(result, i, _mm_sub_ps(LoadRow(m1, i), LoadRow(m2, i)));
+	}
+#else
 	result.m[0][0] = m1.m[0][0] - m2.m[0][0];
 	result.m[0][1] = m1.m[0][1] - m2.m[0][1];
 	result.m[0][2] = m1.m[0][2] - m2.m[0][2];
@@ -65,18 +138,11 @@ Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2) {
 	result.m[3][1] = m1.m[3][1] - m2.m[3][1];
 	result.m[3][2] = m1.m[3][2] - m2.m[3][2];
 	result.m[3][3] = m1.m[3][3] - m2.m[3][3];
+#endif
 
 	return result;
 }
 
-Vector3 Multiply(const float& scalor, const Vector3& v) {
-	Vector3 result{};
-	result.x = v.x * scalor;
-	result.y = v.y * scalor;
-	result.z = v.z * scalor;
-	return result;
-}
-
 // X軸回転行列
 Matrix4x4 MakeRotateXMatrix(float radian) {
 	Matrix4x4 result;
@@ -155,9 +221,32 @@ Matrix4x4 MakeRotateZMatrix(float radian) {
 	return result;
 }
 
-// 行列の積
-Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+// 行列の積 (実行時)
+Matrix4x4 MathDetail::MultiplyRuntime(const Matrix4x4& m1, const Matrix4x4& m2) {
 	Matrix4x4 result;
+#if defined(MATH_USE_AVX)
+	// 右側の行列の各行を上下のレーンに複製しておき、左側の行列を2行ずつ処理する
+	const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[0]));
+	const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[1]));
+	const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[2]));
+	const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[3]));
+	for (int i = 0; i < 4; i += 2) {
+		const __m256 a = _mm256_loadu_ps(m1.m[i]);
+		__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+		_mm256_storeu_ps(result.m[i], r);
+	}
+#elif defined(MATH_USE_SSE)
+	const __m128 b0 = LoadRow(m2, 0);
+	const __m128 b1 = LoadRow(m2, 1);
+	const __m128 b2 = LoadRow(m2, 2);
+	const __m128 b3 = LoadRow(m2, 3);
+	for (int i = 0; i < 4; i++) {
+		StoreRow(result, i, MultiplyRow(LoadRow(m1, i), b0, b1, b2, b3));
+	}
+#else
 	for (int i = 0; i < 4; i++) {
 		for (int j = 0; j < 4; j++) {
 			result.m[j][i] = 0;
@@ -166,43 +255,7 @@ Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
 			}
 		}
 	}
-
-	return result;
-}
-
-// 平行移動行列
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
-	Matrix4x4 result;
-	for (int i = 0; i < 4; i++) {
-		for (int j = 0; j < 4; j++) {
-			result.m[j][i] = 0.0f;
-		}
-	}
-
-	for (int i = 0; i < 4; i++) {
-		result.m[i][i] = 1.0f;
-	}
-
-	result.m[3][0] = translate.x;
-	result.m[3][1] = translate.y;
-	result.m[3][2] = translate.z;
-
-	return result;
-}
-
-// 拡大縮小行列
-Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
-	Matrix4x4 result;
-	for (int i = 0; i < 4; i++) {
-		for (int j = 0; j < 4; j++) {
-			result.m[j][i] = 0.0f;
-		}
-	}
-
-	result.m[0][0] = scale.x;
-	result.m[1][1] = scale.y;
-	result.m[2][2] = scale.z;
-	result.m[3][3] = 1.0f;
+#endif
 
 	return result;
 }
@@ -229,26 +282,103 @@ Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip
 	perspectiveFovMatrix.m[3][0] = 0.0f;
 	perspectiveFovMatrix.m[3][1] = 0.0f;
 	perspectiveFovMatrix.m[3][2] = (-nearClip * farClip) / (farClip - nearClip);
-	perspectiveFovMatrix.m[3][3] = 1.0f;
+	perspectiveFovMatrix.m[3][3] = 0.0f;
 
 	return perspectiveFovMatrix;
 }
 
 // 3次元アフィン変換行列
 Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
-	Matrix4x4 translateMatrix = MakeTranslateMatrix(translate);
-	Matrix4x4 scaleMatrix = MakeScaleMatrix(scale);
-	Matrix4x4 rotateXMatrix = MakeRotateXMatrix(rotate.x);
-	Matrix4x4 rotateYMatrix = MakeRotateYMatrix(rotate.y);
-	Matrix4x4 rotateZMatrix = MakeRotateZMatrix(rotate.z);
-	Matrix4x4 rotateXYZMatrix = Multiply(rotateXMatrix, Multiply(rotateYMatrix, rotateZMatrix));
-	Matrix4x4 scaleRot = Multiply(scaleMatrix, rotateXYZMatrix);
-	Matrix4x4 resultMatrix = Multiply(scaleRot, translateMatrix);
+	// S * Rx * Ry * Rz * T を展開した式で直接求める(行列積を行わない)
+	const float sx = std::sin(rotate.x), cx = std::cos(rotate.x);
+	const float sy = std::sin(rotate.y), cy = std::cos(rotate.y);
+	const float sz = std::sin(rotate.z), cz = std::cos(rotate.z);
+
+	Matrix4x4 resultMatrix;
+	resultMatrix.m[0][0] = scale.x * (cy * cz);
+	resultMatrix.m[0][1] = scale.x * (cy * sz);
+	resultMatrix.m[0][2] = scale.x * (-sy);
+	resultMatrix.m[0][3] = 0.0f;
+
+	resultMatrix.m[1][0] = scale.y * (sx * sy * cz - cx * sz);
+	resultMatrix.m[1][1] = scale.y * (sx * sy * sz + cx * cz);
+	resultMatrix.m[1][2] = scale.y * (sx * cy);
+	resultMatrix.m[1][3] = 0.0f;
+
+	resultMatrix.m[2][0] = scale.z * (cx * sy * cz + sx * sz);
+	resultMatrix.m[2][1] = scale.z * (cx * sy * sz - sx * cz);
+	resultMatrix.m[2][2] = scale.z * (cx * cy);
+	resultMatrix.m[2][3] = 0.0f;
+
+	resultMatrix.m[3][0] = translate.x;
+	resultMatrix.m[3][1] = translate.y;
+	resultMatrix.m[3][2] = translate.z;
+	resultMatrix.m[3][3] = 1.0f;
 
 	return resultMatrix;
 }
 
 Matrix4x4 Inverse(const Matrix4x4& matrix) {
+	// アフィン変換行列なら3x3の逆行列だけで済む
+	if (IsAffine(matrix)) {
+		return InverseAffine(matrix);
+	}
+
+#ifdef MATH_USE_SSE
+	// 2x2のブロックに分けて逆行列を求める
+	// | A B |
+	// | C D |
+	const __m128 r0 = LoadRow(matrix, 0);
+	const __m128 r1 = LoadRow(matrix, 1);
+	const __m128 r2 = LoadRow(matrix, 2);
+	const __m128 r3 = LoadRow(matrix, 3);
+
+	const __m128 a = _mm_movelh_ps(r0, r1);
+	const __m128 b = _mm_movehl_ps(r1, r0);
+	const __m128 c = _mm_movelh_ps(r2, r3);
+	const __m128 d = _mm_movehl_ps(r3, r2);
+
+	// 各ブロックの行列式 (|A|, |B|, |C|, |D|)
+	const __m128 detSub = _mm_sub_ps(
+		_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+		_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+	const __m128 detA = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(0, 0, 0, 0));
+	const __m128 detB = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(1, 1, 1, 1));
+	const __m128 detC = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(2, 2, 2, 2));
+	const __m128 detD = _mm_shuffle_ps(detSub, detSub, _MM_SHUFFLE(3, 3, 3, 3));
+
+	const __m128 adjDC = Mat2AdjMul(d, c);
+	const __m128 adjAB = Mat2AdjMul(a, b);
+
+	// 逆行列の各ブロックの余因子行列
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, adjDC));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, adjAB));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, adjAB));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, adjDC));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 det = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	det = _mm_sub_ps(det, HorizontalSum(_mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)))));
+
+	if (_mm_cvtss_f32(det) == 0.0f) {
+		Matrix4x4 result = { 0 };
+		return result;
+	}
+
+	// 余因子行列の符号と1/|M|をまとめて掛ける
+	const __m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps(x, invDet);
+	y = _mm_mul_ps(y, invDet);
+	z = _mm_mul_ps(z, invDet);
+	w = _mm_mul_ps(w, invDet);
+
+	Matrix4x4 result;
+	StoreRow(result, 0, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+	StoreRow(result, 1, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+	StoreRow(result, 2, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+	StoreRow(result, 3, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+	return result;
+#else
 	Matrix4x4 cofactor; // 余因子行列
 
 	for (int row = 0; row < 4; ++row) {
@@ -297,59 +427,103 @@ Matrix4x4 Inverse(const Matrix4x4& matrix) {
 	}
 
 	return result;
-}
-
-// 単位行列の作成
-Matrix4x4 MakeIdentity4x4() {
-	Matrix4x4 result;
-	for (int i = 0; i < 4; i++) {
-		for (int j = 0; j < 4; j++) {
-			result.m[j][i] = 0.0f;
-		}
+#endif
+}
+
+// アフィン変換行列の逆行列
+Matrix4x4 InverseAffine(const Matrix4x4& matrix) {
+#ifdef MATH_USE_SSE
+	const __m128 wMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 r0 = _mm_and_ps(LoadRow(matrix, 0), wMask);
+	const __m128 r1 = _mm_and_ps(LoadRow(matrix, 1), wMask);
+	const __m128 r2 = _mm_and_ps(LoadRow(matrix, 2), wMask);
+
+	// 3x3の逆行列の各列は行同士の外積 / 行列式
+	__m128 c0 = Cross(r1, r2);
+	__m128 c1 = Cross(r2, r0);
+	__m128 c2 = Cross(r0, r1);
+	const __m128 det = HorizontalSum(_mm_mul_ps(r0, c0));
+	if (_mm_cvtss_f32(det) == 0.0f) {
+		Matrix4x4 result = { 0 };
+		return result;
 	}
 
-	for (int i = 0; i < 4; i++) {
-		result.m[i][i] = 1.0f;
+	const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+	c0 = _mm_mul_ps(c0, invDet);
+	c1 = _mm_mul_ps(c1, invDet);
+	c2 = _mm_mul_ps(c2, invDet);
+	__m128 c3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	return ComposeInverse(c0, c1, c2, LoadRow(matrix, 3));
+#else
+	const float(*m)[4] = matrix.m;
+
+	// 3x3部分の余因子
+	float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+	float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+	float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+	float det = m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02;
+	if (det == 0.0f) {
+		Matrix4x4 result = { 0 };
+		return result;
 	}
+	float invDet = 1.0f / det;
 
-	return result;
-}
+	Matrix4x4 result;
+	result.m[0][0] = c00 * invDet;
+	result.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+	result.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+	result.m[0][3] = 0.0f;
 
-float Determinant3x3(
-	float a11, float a12, float a13,
-	float a21, float a22, float a23,
-	float a31, float a32, float a33) {
-	return
-		a11 * (a22 * a33 - a23 * a32) -
-		a12 * (a21 * a33 - a23 * a31) +
-		a13 * (a21 * a32 - a22 * a31);
-}
+	result.m[1][0] = c01 * invDet;
+	result.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+	result.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+	result.m[1][3] = 0.0f;
 
-// 正射影行列の作成関数
-Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip) {
-	Matrix4x4 orthoMatrix;
+	result.m[2][0] = c02 * invDet;
+	result.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+	result.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+	result.m[2][3] = 0.0f;
 
-	orthoMatrix.m[0][0] = 2.0f / (right - left);
-	orthoMatrix.m[0][1] = 0.0f;
-	orthoMatrix.m[0][2] = 0.0f;
-	orthoMatrix.m[0][3] = 0.0f;
+	// 平行移動は -t * (3x3の逆行列)
+	for (int j = 0; j < 3; ++j) {
+		result.m[3][j] = -(m[3][0] * result.m[0][j] + m[3][1] * result.m[1][j] + m[3][2] * result.m[2][j]);
+	}
+	result.m[3][3] = 1.0f;
 
-	orthoMatrix.m[1][0] = 0.0f;
-	orthoMatrix.m[1][1] = 2.0f / (top - bottom);
-	orthoMatrix.m[1][2] = 0.0f;
-	orthoMatrix.m[1][3] = 0.0f;
+	return result;
+#endif
+}
 
-	orthoMatrix.m[2][0] = 0.0f;
-	orthoMatrix.m[2][1] = 0.0f;
-	orthoMatrix.m[2][2] = 1.0f / (farClip - nearClip);
-	orthoMatrix.m[2][3] = 0.0f;
+// 剛体変換行列の逆行列
+Matrix4x4 InverseRigid(const Matrix4x4& matrix) {
+#ifdef MATH_USE_SSE
+	// 回転部分は転置するだけ
+	__m128 r0 = LoadRow(matrix, 0);
+	__m128 r1 = LoadRow(matrix, 1);
+	__m128 r2 = LoadRow(matrix, 2);
+	__m128 r3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
 
-	orthoMatrix.m[3][0] = (left + right) / (left - right);
-	orthoMatrix.m[3][1] = (top + bottom) / (bottom - top);
-	orthoMatrix.m[3][2] = nearClip / (nearClip - farClip);
-	orthoMatrix.m[3][3] = 1.0f;
+	return ComposeInverse(r0, r1, r2, LoadRow(matrix, 3));
+#else
+	Matrix4x4 result;
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			result.m[i][j] = matrix.m[j][i];
+		}
+		result.m[i][3] = 0.0f;
+	}
+
+	// 平行移動は -t * R^T
+	for (int j = 0; j < 3; ++j) {
+		result.m[3][j] = -(matrix.m[3][0] * result.m[0][j] + matrix.m[3][1] * result.m[1][j] + matrix.m[3][2] * result.m[2][j]);
+	}
+	result.m[3][3] = 1.0f;
 
-	return orthoMatrix;
+	return result;
+#endif
 }
 
 float Length(const Vector3& vector) {
@@ -367,56 +541,21 @@ Vector3 Normalize(const Vector3& normal)
 
 Vector3 TransformNormal(const Vector3& v, const Matrix4x4& m) {
 	Vector3 result;
+#ifdef MATH_USE_SSE
+	__m128 r = _mm_mul_ps(_mm_set1_ps(v.x), LoadRow(m, 0));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.y), LoadRow(m, 1)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v.z), LoadRow(m, 2)));
+	float out[4];
+	_mm_storeu_ps(out, r);
+	result = { out[0], out[1], out[2] };
+#else
 	result.x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0];
 	result.y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1];
 	result.z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2];
+#endif
 	return result;
 }
 
-Vector2& operator+=(Vector2& v1, const Vector2& v2) {
-	v1.x += v2.x;
-	v1.y += v2.y;
-	return v1;
-}
-
-Vector2 operator+(const Vector2& v1, const Vector2& v2) {
-	return { v1.x + v2.x, v1.y + v2.y };
-}
-
-Vector2 operator-(const Vector2& v1, const Vector2& v2) {
-	return { v1.x - v2.x, v1.y - v2.y };
-}
-
-Vector2 operator*(const Vector2& v1, const Vector2& v2) {
-	return { v1.x * v2.x, v1.y * v2.y };
-}
-
-Vector3 operator+(const Vector3& v1, const Vector3& v2) {
-	return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z };
-}
-
-Vector3 operator-(const Vector3& v1, const Vector3& v2) {
-	return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z };
-}
-
-Vector3 operator*(const Vector3& v1, const Vector3& v2) {
-	return { v1.x * v2.x, v1.y * v2.y, v1.z * v2.z };
-}
-
-Vector3 operator*(float s, const Vector3& v)
-{
-	return Multiply(s, v);
-}
-
-Vector3 operator*(const Vector3& v, float s) {
-	return { s * v };
-}
-
-Vector3 operator/(const Vector3& v, float s)
-{
-	return Multiply(1.0f / s, v);
-}
-
 Matrix4x4 operator+(const Matrix4x4& m1, const Matrix4x4& m2)
 {
 	return Add(m1, m2);
@@ -427,18 +566,20 @@ Matrix4x4 operator-(const Matrix4x4& m1, const Matrix4x4& m2)
 	return Subtract(m1, m2);
 }
 
-Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2)
-{
-	return Multiply(m1, m2);
-}
-
 Matrix4x4 operator*(const Matrix4x4& mat, float scalar) {
 	Matrix4x4 result;
+#ifdef MATH_USE_SSE
+	const __m128 s = _mm_set1_ps(scalar);
+	for (int i = 0; i < 4; ++i) {
+		StoreRow(result, i, _mm_mul_ps(LoadRow(mat, i), s));
+	}
+#else
 	for (int i = 0; i < 4; ++i) {
 		for (int j = 0; j < 4; ++j) {
 			result.m[i][j] = mat.m[i][j] * scalar;
 		}
 	}
+#endif
 	return result;
 }
 
@@ -447,27 +588,11 @@ Matrix4x4 operator*(float scalar, const Matrix4x4& mat) {
 }
 
 Matrix4x4& operator*=(Matrix4x4& mat, float scalar) {
-	for (int i = 0; i < 4; ++i) {
-		for (int j = 0; j < 4; ++j) {
-			mat.m[i][j] *= scalar;
-		}
-	}
+	mat = mat * scalar;
 	return mat;
 }
 
 Matrix4x4& operator*=(Matrix4x4& lhs, const Matrix4x4& rhs) {
-	Matrix4x4 result = {};
-
-	for (int i = 0; i < 4; ++i) {
-		for (int j = 0; j < 4; ++j) {
-			result.m[i][j] =
-				lhs.m[i][0] * rhs.m[0][j] +
-				lhs.m[i][1] * rhs.m[1][j] +
-				lhs.m[i][2] * rhs.m[2][j] +
-				lhs.m[i][3] * rhs.m[3][j];
-		}
-	}
-
-	lhs = result;
+	lhs = Multiply(lhs, rhs);
 	return lhs;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <type_traits>
 #include "Vector2.h"
 #include "Vector3.h"
 #include "Vector4.h"
@@ -12,16 +13,30 @@ struct Matrix4x4 {
 	float m[4][4];
 };
 
+// 小さな演算はヘッダーでconstexprとして定義し、翻訳単位をまたいでインライン展開・定数畳み込みできるようにする
+// SIMDを使う行列演算はMatrix.cppで定義する
+
+namespace MathDetail {
+	// 実行時に使う行列の積 (SIMD版)
+	Matrix4x4 MultiplyRuntime(const Matrix4x4& m1, const Matrix4x4& m2);
+}
+
 // 加算
-Vector3 Add(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 Add(const Vector3& v1, const Vector3& v2) {
+	return { v1.x + v2.x, v1.y + v2.y, v1.z + v2.z };
+}
 
 Matrix4x4 Add(const Matrix4x4& m1, const Matrix4x4& m2);
 // 減算
-Vector3 Subtract(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 Subtract(const Vector3& v1, const Vector3& v2) {
+	return { v1.x - v2.x, v1.y - v2.y, v1.z - v2.z };
+}
 
 Matrix4x4 Subtract(const Matrix4x4& m1, const Matrix4x4& m2);
 
-Vector3 Multiply(const float& scalor, const Vector3& v);
+constexpr Vector3 Multiply(const float& scalor, const Vector3& v) {
+	return { v.x * scalor, v.y * scalor, v.z * scalor };
+}
 
 // <summary>
 /// X軸回転行列関数
@@ -50,21 +65,49 @@ Matrix4x4 MakeRotateZMatrix(float radian);
 /// <param name="m1">行列1</param>
 /// <param name="m2">行列2</param>
 /// <returns>行列の積</returns>
-Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+constexpr Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	// コンパイル時はスカラーで計算する
+	if (std::is_constant_evaluated()) {
+		Matrix4x4 result{};
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				for (int k = 0; k < 4; ++k) {
+					result.m[j][i] += m1.m[j][k] * m2.m[k][i];
+				}
+			}
+		}
+		return result;
+	}
+	return MathDetail::MultiplyRuntime(m1, m2);
+}
 
 /// <summary>
 /// 平行移動行列関数
 /// </summary>
 /// <param name="translate">方向</param>
 /// <returns>平行移動行列</returns>
-Matrix4x4 MakeTranslateMatrix(const Vector3& translate);
+constexpr Matrix4x4 MakeTranslateMatrix(const Vector3& translate) {
+	return { {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f },
+		{ translate.x, translate.y, translate.z, 1.0f }
+	} };
+}
 
 /// <summary>
 /// 拡大縮小行列関数
 /// </summary>
 /// <param name="scale">スケール</param>
 /// <returns>拡大縮小行列</returns>
-Matrix4x4 MakeScaleMatrix(const Vector3& scale);
+constexpr Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
+	return { {
+		{ scale.x, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, scale.y, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, scale.z, 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 1.0f }
+	} };
+}
 
 /// <summary>
 /// 透視投影行列の作成関数
@@ -87,18 +130,56 @@ Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Ve
 
 /// <summary>
 /// 逆行列
+/// アフィン変換行列ならInverseAffineで求める
 /// </summary>
 /// <param name="matrix"></param>
 /// <returns></returns>
 Matrix4x4 Inverse(const Matrix4x4& matrix);
 
-// 単位行列の作成
-Matrix4x4 MakeIdentity4x4();
+/// <summary>
+/// アフィン変換行列かどうか (4列目が(0, 0, 0, 1))
+/// </summary>
+/// <param name="matrix"></param>
+/// <returns>アフィン変換行列ならtrue</returns>
+constexpr bool IsAffine(const Matrix4x4& matrix) {
+	return matrix.m[0][3] == 0.0f && matrix.m[1][3] == 0.0f && matrix.m[2][3] == 0.0f && matrix.m[3][3] == 1.0f;
+}
 
-float Determinant3x3(
+/// <summary>
+/// アフィン変換行列の逆行列
+/// 左上3x3の逆行列と平行移動の打ち消しだけで求める
+/// </summary>
+/// <param name="matrix">アフィン変換行列</param>
+/// <returns></returns>
+Matrix4x4 InverseAffine(const Matrix4x4& matrix);
+
+/// <summary>
+/// 回転と平行移動のみの行列(剛体変換)の逆行列
+/// 回転部分を転置するだけなのでカメラのビュー行列に向いている
+/// </summary>
+/// <param name="matrix">剛体変換行列</param>
+/// <returns></returns>
+Matrix4x4 InverseRigid(const Matrix4x4& matrix);
+
+// 単位行列の作成
+constexpr Matrix4x4 MakeIdentity4x4() {
+	return { {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 1.0f }
+	} };
+}
+
+constexpr float Determinant3x3(
 	float a11, float a12, float a13,
 	float a21, float a22, float a23,
-	float a31, float a32, float a33);
+	float a31, float a32, float a33) {
+	return
+		a11 * (a22 * a33 - a23 * a32) -
+		a12 * (a21 * a33 - a23 * a31) +
+		a13 * (a21 * a32 - a22 * a31);
+}
 
 /// <summary>
 /// 正射影行列の作成関数
@@ -108,7 +189,14 @@ float Determinant3x3(
 /// <param name="right">右下のX座標</param>
 /// <param name="bottom">右下のY座標</param>
 /// <returns>正射影行列</returns>
-Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
+constexpr Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip) {
+	return { {
+		{ 2.0f / (right - left), 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 2.0f / (top - bottom), 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f / (farClip - nearClip), 0.0f },
+		{ (left + right) / (left - right), (top + bottom) / (bottom - top), nearClip / (nearClip - farClip), 1.0f }
+	} };
+}
 
 float Length(const Vector3& vector);
 
@@ -117,31 +205,55 @@ Vector3 Normalize(const Vector3& normal);
 Vector3 TransformNormal(const Vector3& v, const Matrix4x4& m);
 
 // オペレーター
-Vector2& operator+=(Vector2& v1, const Vector2& v2);
+constexpr Vector2& operator+=(Vector2& v1, const Vector2& v2) {
+	v1.x += v2.x;
+	v1.y += v2.y;
+	return v1;
+}
 
-Vector2 operator+(const Vector2& v1, const Vector2& v2);
+constexpr Vector2 operator+(const Vector2& v1, const Vector2& v2) {
+	return { v1.x + v2.x, v1.y + v2.y };
+}
 
-Vector2 operator-(const Vector2& v1, const Vector2& v2);
+constexpr Vector2 operator-(const Vector2& v1, const Vector2& v2) {
+	return { v1.x - v2.x, v1.y - v2.y };
+}
 
-Vector2 operator*(const Vector2& v1, const Vector2& v2);
+constexpr Vector2 operator*(const Vector2& v1, const Vector2& v2) {
+	return { v1.x * v2.x, v1.y * v2.y };
+}
 
-Vector3 operator+(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 operator+(const Vector3& v1, const Vector3& v2) {
+	return Add(v1, v2);
+}
 
-Vector3 operator-(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 operator-(const Vector3& v1, const Vector3& v2) {
+	return Subtract(v1, v2);
+}
 
-Vector3 operator*(const Vector3& v1, const Vector3& v2);
+constexpr Vector3 operator*(const Vector3& v1, const Vector3& v2) {
+	return { v1.x * v2.x, v1.y * v2.y, v1.z * v2.z };
+}
 
-Vector3 operator*(float s, const Vector3& v);
+constexpr Vector3 operator*(float s, const Vector3& v) {
+	return Multiply(s, v);
+}
 
-Vector3 operator*(const Vector3& v, float s);
+constexpr Vector3 operator*(const Vector3& v, float s) {
+	return Multiply(s, v);
+}
 
-Vector3 operator/(const Vector3& v, float s);
+constexpr Vector3 operator/(const Vector3& v, float s) {
+	return Multiply(1.0f / s, v);
+}
 
 Matrix4x4 operator+(const Matrix4x4& m1, const Matrix4x4& m2);
 
 Matrix4x4 operator-(const Matrix4x4& m1, const Matrix4x4& m2);
 
-Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2);
+constexpr Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2) {
+	return Multiply(m1, m2);
+}
 
 Matrix4x4 operator*(const Matrix4x4& mat, float scalar);
 
@@ -0,0 +1,213 @@
+#include "Quaternion.h"
+#include <cmath>
+
+namespace {
+	Quaternion Scale(const Quaternion& q, float s) {
+		return { q.x * s, q.y * s, q.z * s, q.w * s };
+	}
+
+	Quaternion AddQuaternion(const Quaternion& q0, const Quaternion& q1) {
+		return { q0.x + q1.x, q0.y + q1.y, q0.z + q1.z, q0.w + q1.w };
+	}
+
+	Vector3 CrossProduct(const Vector3& v1, const Vector3& v2) {
+		return {
+			v1.y * v2.z - v1.z * v2.y,
+			v1.z * v2.x - v1.x * v2.z,
+			v1.x * v2.y - v1.y * v2.x
+		};
+	}
+}
+
+// 単位クォータニオンの作成
+Quaternion IdentityQuaternion() {
+	return { 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+// クォータニオンの積
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs) {
+	Quaternion result;
+	result.x = lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y;
+	result.y = lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x;
+	result.z = lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w;
+	result.w = lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z;
+	return result;
+}
+
+Quaternion Conjugate(const Quaternion& quaternion) {
+	return { -quaternion.x, -quaternion.y, -quaternion.z, quaternion.w };
+}
+
+float Dot(const Quaternion& q0, const Quaternion& q1) {
+	return q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+}
+
+float Norm(const Quaternion& quaternion) {
+	return std::sqrt(Dot(quaternion, quaternion));
+}
+
+Quaternion Normalize(const Quaternion& quaternion) {
+	float norm = Norm(quaternion);
+	if (norm == 0.0f) {
+		return IdentityQuaternion();
+	}
+	return Scale(quaternion, 1.0f / norm);
+}
+
+Quaternion Inverse(const Quaternion& quaternion) {
+	float normSq = Dot(quaternion, quaternion);
+	if (normSq == 0.0f) {
+		return { 0.0f, 0.0f, 0.0f, 0.0f };
+	}
+	return Scale(Conjugate(quaternion), 1.0f / normSq);
+}
+
+// 任意軸回転を表すクォータニオンの作成
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle) {
+	float halfSin = std::sin(angle * 0.5f);
+	return { axis.x * halfSin, axis.y * halfSin, axis.z * halfSin, std::cos(angle * 0.5f) };
+}
+
+// オイラー角からクォータニオンを作成
+Quaternion MakeRotateQuaternion(const Vector3& rotate) {
+	Quaternion qx = MakeRotateAxisAngleQuaternion({ 1.0f, 0.0f, 0.0f }, rotate.x);
+	Quaternion qy = MakeRotateAxisAngleQuaternion({ 0.0f, 1.0f, 0.0f }, rotate.y);
+	Quaternion qz = MakeRotateAxisAngleQuaternion({ 0.0f, 0.0f, 1.0f }, rotate.z);
+	// X → Y → Z の順に適用する
+	return Multiply(qz, Multiply(qy, qx));
+}
+
+// ベクトルの回転
+Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion) {
+	// q * v * q^-1 を展開した式
+	Vector3 axis = { quaternion.x, quaternion.y, quaternion.z };
+	Vector3 t = CrossProduct(axis, vector);
+	t = { t.x * 2.0f, t.y * 2.0f, t.z * 2.0f };
+	Vector3 u = CrossProduct(axis, t);
+	return {
+		vector.x + quaternion.w * t.x + u.x,
+		vector.y + quaternion.w * t.y + u.y,
+		vector.z + quaternion.w * t.z + u.z
+	};
+}
+
+// クォータニオンから回転行列
+Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion) {
+	return MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, quaternion, { 0.0f, 0.0f, 0.0f });
+}
+
+// 球面線形補間
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	Quaternion end = q1;
+	float dot = Dot(q0, q1);
+	// 遠回りしないように反転する
+	if (dot < 0.0f) {
+		end = Scale(q1, -1.0f);
+		dot = -dot;
+	}
+
+	// ほぼ同じ向きなら線形補間で十分
+	if (dot >= 0.9995f) {
+		return Nlerp(q0, end, t);
+	}
+
+	float theta = std::acos(dot);
+	float sinTheta = std::sin(theta);
+	float scale0 = std::sin((1.0f - t) * theta) / sinTheta;
+	float scale1 = std::sin(t * theta) / sinTheta;
+	return AddQuaternion(Scale(q0, scale0), Scale(end, scale1));
+}
+
+// 正規化線形補間
+Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t) {
+	float sign = Dot(q0, q1) < 0.0f ? -1.0f : 1.0f;
+	return Normalize(AddQuaternion(Scale(q0, 1.0f - t), Scale(q1, t * sign)));
+}
+
+// 3次元アフィン変換行列 (クォータニオン)
+Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate) {
+	const float xx = rotate.x * rotate.x, yy = rotate.y * rotate.y, zz = rotate.z * rotate.z;
+	const float xy = rotate.x * rotate.y, xz = rotate.x * rotate.z, yz = rotate.y * rotate.z;
+	const float wx = rotate.w * rotate.x, wy = rotate.w * rotate.y, wz = rotate.w * rotate.z;
+
+	Matrix4x4 result;
+	result.m[0][0] = scale.x * (1.0f - 2.0f * (yy + zz));
+	result.m[0][1] = scale.x * (2.0f * (xy + wz));
+	result.m[0][2] = scale.x * (2.0f * (xz - wy));
+	result.m[0][3] = 0.0f;
+
+	result.m[1][0] = scale.y * (2.0f * (xy - wz));
+	result.m[1][1] = scale.y * (1.0f - 2.0f * (xx + zz));
+	result.m[1][2] = scale.y * (2.0f * (yz + wx));
+	result.m[1][3] = 0.0f;
+
+	result.m[2][0] = scale.z * (2.0f * (xz + wy));
+	result.m[2][1] = scale.z * (2.0f * (yz - wx));
+	result.m[2][2] = scale.z * (1.0f - 2.0f * (xx + yy));
+	result.m[2][3] = 0.0f;
+
+	result.m[3][0] = translate.x;
+	result.m[3][1] = translate.y;
+	result.m[3][2] = translate.z;
+	result.m[3][3] = 1.0f;
+
+	return result;
+}
+
+// デュアルクォータニオンの作成
+DualQuaternion MakeDualQuaternion(const Quaternion& rotate, const Vector3& translate) {
+	DualQuaternion result;
+	result.real = rotate;
+	result.dual = Scale(Multiply({ translate.x, translate.y, translate.z, 0.0f }, rotate), 0.5f);
+	return result;
+}
+
+// デュアルクォータニオンの積
+DualQuaternion Multiply(const DualQuaternion& lhs, const DualQuaternion& rhs) {
+	DualQuaternion result;
+	result.real = Multiply(lhs.real, rhs.real);
+	result.dual = AddQuaternion(Multiply(lhs.real, rhs.dual), Multiply(lhs.dual, rhs.real));
+	return result;
+}
+
+DualQuaternion Normalize(const DualQuaternion& dualQuaternion) {
+	float norm = Norm(dualQuaternion.real);
+	if (norm == 0.0f) {
+		return { IdentityQuaternion(), { 0.0f, 0.0f, 0.0f, 0.0f } };
+	}
+	float invNorm = 1.0f / norm;
+	return { Scale(dualQuaternion.real, invNorm), Scale(dualQuaternion.dual, invNorm) };
+}
+
+Vector3 GetTranslation(const DualQuaternion& dualQuaternion) {
+	// t = 2 * dual * real^*
+	Quaternion t = Multiply(dualQuaternion.dual, Conjugate(dualQuaternion.real));
+	return { t.x * 2.0f, t.y * 2.0f, t.z * 2.0f };
+}
+
+Vector3 TransformPoint(const Vector3& point, const DualQuaternion& dualQuaternion) {
+	Vector3 rotated = RotateVector(point, dualQuaternion.real);
+	Vector3 translate = GetTranslation(dualQuaternion);
+	return { rotated.x + translate.x, rotated.y + translate.y, rotated.z + translate.z };
+}
+
+// デュアルクォータニオンの線形補間
+DualQuaternion Lerp(const DualQuaternion& d0, const DualQuaternion& d1, float t) {
+	float sign = Dot(d0.real, d1.real) < 0.0f ? -1.0f : 1.0f;
+	DualQuaternion result;
+	result.real = AddQuaternion(Scale(d0.real, 1.0f - t), Scale(d1.real, t * sign));
+	result.dual = AddQuaternion(Scale(d0.dual, 1.0f - t), Scale(d1.dual, t * sign));
+	return Normalize(result);
+}
+
+Matrix4x4 MakeAffineMatrix(const DualQuaternion& dualQuaternion) {
+	return MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, dualQuaternion.real, GetTranslation(dualQuaternion));
+}
+
+Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs) {
+	return Multiply(lhs, rhs);
+}
+
+DualQuaternion operator*(const DualQuaternion& lhs, const DualQuaternion& rhs) {
+	return Multiply(lhs, rhs);
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "Vector3.h"
+#include "Matrix.h"
+
+struct Quaternion {
+	float x, y, z, w;
+};
+
+// 回転と平行移動を表すデュアルクォータニオン
+struct DualQuaternion {
+	Quaternion real; // 回転
+	Quaternion dual; // 平行移動 (0.5 * t * real)
+};
+
+// 単位クォータニオンの作成
+Quaternion IdentityQuaternion();
+
+/// <summary>
+/// クォータニオンの積
+/// 回転としては rhs → lhs の順に適用される
+/// </summary>
+/// <param name="lhs">クォータニオン1</param>
+/// <param name="rhs">クォータニオン2</param>
+/// <returns>クォータニオンの積</returns>
+Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs);
+
+// 共役クォータニオン
+Quaternion Conjugate(const Quaternion& quaternion);
+
+// 内積
+float Dot(const Quaternion& q0, const Quaternion& q1);
+
+// ノルム
+float Norm(const Quaternion& quaternion);
+
+// 正規化
+Quaternion Normalize(const Quaternion& quaternion);
+
+// 逆クォータニオン
+Quaternion Inverse(const Quaternion& quaternion);
+
+/// <summary>
+/// 任意軸回転を表すクォータニオンの作成
+/// </summary>
+/// <param name="axis">回転軸 (正規化済み)</param>
+/// <param name="angle">回転角 (ラジアン)</param>
+/// <returns>回転を表すクォータニオン</returns>
+Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+
+/// <summary>
+/// オイラー角からクォータニオンを作成する
+/// MakeAffineMatrixと同じくX→Y→Zの順に回転する
+/// </summary>
+/// <param name="rotate">各軸の回転角 (ラジアン)</param>
+/// <returns>回転を表すクォータニオン</returns>
+Quaternion MakeRotateQuaternion(const Vector3& rotate);
+
+// ベクトルをクォータニオンで回転させる
+Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion);
+
+// クォータニオンから回転行列を求める
+Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion);
+
+/// <summary>
+/// 球面線形補間
+/// </summary>
+/// <param name="q0">開始クォータニオン</param>
+/// <param name="q1">終了クォータニオン</param>
+/// <param name="t">補間係数 (0～1)</param>
+/// <returns>補間したクォータニオン</returns>
+Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+/// <summary>
+/// 正規化線形補間 (Slerpより軽いが角速度は一定にならない)
+/// </summary>
+/// <param name="q0">開始クォータニオン</param>
+/// <param name="q1">終了クォータニオン</param>
+/// <param name="t">補間係数 (0～1)</param>
+/// <returns>補間したクォータニオン</returns>
+Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+/// <summary>
+/// 3次元アフィン変換行列 (回転をクォータニオンで指定)
+/// </summary>
+/// <param name="scale">拡縮</param>
+/// <param name="rotate">回転</param>
+/// <param name="translate">平行移動</param>
+/// <returns>アフィン変換行列</returns>
+Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
+/// <summary>
+/// 回転と平行移動からデュアルクォータニオンを作成する
+/// 回転 → 平行移動の順に適用される
+/// </summary>
+/// <param name="rotate">回転 (正規化済み)</param>
+/// <param name="translate">平行移動</param>
+/// <returns>デュアルクォータニオン</returns>
+DualQuaternion MakeDualQuaternion(const Quaternion& rotate, const Vector3& translate);
+
+// デュアルクォータニオンの積 (rhs → lhs の順に適用される)
+DualQuaternion Multiply(const DualQuaternion& lhs, const DualQuaternion& rhs);
+
+// デュアルクォータニオンの正規化
+DualQuaternion Normalize(const DualQuaternion& dualQuaternion);
+
+// デュアルクォータニオンが表す平行移動を取り出す
+Vector3 GetTranslation(const DualQuaternion& dualQuaternion);
+
+// 点をデュアルクォータニオンで変換する
+Vector3 TransformPoint(const Vector3& point, const DualQuaternion& dualQuaternion);
+
+/// <summary>
+/// デュアルクォータニオンの線形補間 (DLB)
+/// </summary>
+/// <param name="d0">開始</param>
+/// <param name="d1">終了</param>
+/// <param name="t">補間係数 (0～1)</param>
+/// <returns>補間して正規化したデュアルクォータニオン</returns>
+DualQuaternion Lerp(const DualQuaternion& d0, const DualQuaternion& d1, float t);
+
+// デュアルクォータニオンから剛体変換行列を求める
+Matrix4x4 MakeAffineMatrix(const DualQuaternion& dualQuaternion);
+
+// オペレーター
+Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs);
+
+DualQuaternion operator*(const DualQuaternion& lhs, const DualQuaternion& rhs);
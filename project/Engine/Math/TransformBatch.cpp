@@ -0,0 +1,223 @@
+#include "TransformBatch.h"
+#include "MathConfig.h"
+#include "ThreadPool.h"
+#include <cmath>
+
+namespace {
+	// 並列実行する際の1区間の最小要素数
+	constexpr size_t kMinChunkSize = 1024;
+
+	// stride間隔で並んだ出力先のindex番目
+	inline Matrix4x4* At(Matrix4x4* base, size_t stride, size_t index) {
+		return reinterpret_cast<Matrix4x4*>(reinterpret_cast<char*>(base) + stride * index);
+	}
+
+	// 1要素ずつ計算する (端数の処理とスカラー実装)
+	void ComputeScalar(
+		const TransformSoA& t, const Matrix4x4& viewProjection,
+		Matrix4x4* worldOut, size_t worldStride, Matrix4x4* wvpOut, size_t wvpStride,
+		size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			Matrix4x4 world = MakeAffineMatrix(
+				{ t.scaleX[i], t.scaleY[i], t.scaleZ[i] },
+				{ t.rotateX[i], t.rotateY[i], t.rotateZ[i] },
+				{ t.translateX[i], t.translateY[i], t.translateZ[i] });
+			if (worldOut) {
+				*At(worldOut, worldStride, i) = world;
+			}
+			if (wvpOut) {
+				*At(wvpOut, wvpStride, i) = Multiply(world, viewProjection);
+			}
+		}
+	}
+
+#ifdef MATH_USE_SSE
+	// 行ベクトル × 行列 (Matrix.cppのMultiplyと同じ演算順)
+	inline __m128 MultiplyRow(__m128 row, __m128 b0, __m128 b1, __m128 b2, __m128 b3) {
+		__m128 result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+		return result;
+	}
+
+	// 4要素のsinとcosを同時に求める (Cephesのsinf/cosfと同じ多項式近似)
+	// |x| < 8192 程度の範囲で誤差は数ULP以内
+	inline void SinCos(__m128 x, __m128& outSin, __m128& outCos) {
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)));
+		__m128 signSin = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		// π/4単位で象限を求める
+		__m128i quadrant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		quadrant = _mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		const __m128 y = _mm_cvtepi32_ps(quadrant);
+
+		const __m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(4)), 29));
+		const __m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		const __m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_andnot_si128(_mm_sub_epi32(quadrant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		signSin = _mm_xor_ps(signSin, swapSignSin);
+
+		// 3段階に分けて π/4 * y を引き、精度を保つ
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+		const __m128 z = _mm_mul_ps(x, x);
+
+		// cosの多項式
+		__m128 polyCos = _mm_set1_ps(2.443315711809948e-5f);
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(-1.388731625493765e-3f));
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(4.166664568298827e-2f));
+		polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+		polyCos = _mm_sub_ps(polyCos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		polyCos = _mm_add_ps(polyCos, _mm_set1_ps(1.0f));
+
+		// sinの多項式
+		__m128 polySin = _mm_set1_ps(-1.9515295891e-4f);
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(8.3321608736e-3f));
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(-1.6666654611e-1f));
+		polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), x), x);
+
+		// 象限に応じてsin/cosの多項式を入れ替える
+		const __m128 sinValue = _mm_or_ps(_mm_and_ps(polyMask, polySin), _mm_andnot_ps(polyMask, polyCos));
+		const __m128 cosValue = _mm_or_ps(_mm_and_ps(polyMask, polyCos), _mm_andnot_ps(polyMask, polySin));
+		outSin = _mm_xor_ps(sinValue, signSin);
+		outCos = _mm_xor_ps(cosValue, signCos);
+	}
+
+	// 4要素ずつSIMDで計算する
+	// 各レーンが1オブジェクトに対応するので、MakeAffineMatrixの展開式をそのまま4つ同時に計算できる
+	void ComputeSimd(
+		const TransformSoA& t, const Matrix4x4& viewProjection,
+		Matrix4x4* worldOut, size_t worldStride, Matrix4x4* wvpOut, size_t wvpStride,
+		size_t begin, size_t end) {
+		const __m128 vp0 = _mm_loadu_ps(viewProjection.m[0]);
+		const __m128 vp1 = _mm_loadu_ps(viewProjection.m[1]);
+		const __m128 vp2 = _mm_loadu_ps(viewProjection.m[2]);
+		const __m128 vp3 = _mm_loadu_ps(viewProjection.m[3]);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+
+		size_t i = begin;
+		for (; i + 4 <= end; i += 4) {
+			__m128 sx, cx, sy, cy, sz, cz;
+			SinCos(_mm_loadu_ps(&t.rotateX[i]), sx, cx);
+			SinCos(_mm_loadu_ps(&t.rotateY[i]), sy, cy);
+			SinCos(_mm_loadu_ps(&t.rotateZ[i]), sz, cz);
+			const __m128 scaleX = _mm_loadu_ps(&t.scaleX[i]);
+			const __m128 scaleY = _mm_loadu_ps(&t.scaleY[i]);
+			const __m128 scaleZ = _mm_loadu_ps(&t.scaleZ[i]);
+
+			// 行列の各要素 (レーン = オブジェクト)
+			__m128 m00 = _mm_mul_ps(scaleX, _mm_mul_ps(cy, cz));
+			__m128 m01 = _mm_mul_ps(scaleX, _mm_mul_ps(cy, sz));
+			__m128 m02 = _mm_mul_ps(scaleX, _mm_sub_ps(zero, sy));
+			__m128 m03 = zero;
+
+			const __m128 sxsy = _mm_mul_ps(sx, sy);
+			__m128 m10 = _mm_mul_ps(scaleY, _mm_sub_ps(_mm_mul_ps(sxsy, cz), _mm_mul_ps(cx, sz)));
+			__m128 m11 = _mm_mul_ps(scaleY, _mm_add_ps(_mm_mul_ps(sxsy, sz), _mm_mul_ps(cx, cz)));
+			__m128 m12 = _mm_mul_ps(scaleY, _mm_mul_ps(sx, cy));
+			__m128 m13 = zero;
+
+			const __m128 cxsy = _mm_mul_ps(cx, sy);
+			__m128 m20 = _mm_mul_ps(scaleZ, _mm_add_ps(_mm_mul_ps(cxsy, cz), _mm_mul_ps(sx, sz)));
+			__m128 m21 = _mm_mul_ps(scaleZ, _mm_sub_ps(_mm_mul_ps(cxsy, sz), _mm_mul_ps(sx, cz)));
+			__m128 m22 = _mm_mul_ps(scaleZ, _mm_mul_ps(cx, cy));
+			__m128 m23 = zero;
+
+			__m128 m30 = _mm_loadu_ps(&t.translateX[i]);
+			__m128 m31 = _mm_loadu_ps(&t.translateY[i]);
+			__m128 m32 = _mm_loadu_ps(&t.translateZ[i]);
+			__m128 m33 = one;
+
+			// 転置してオブジェクトごとの行に並べ替える
+			_MM_TRANSPOSE4_PS(m00, m01, m02, m03);
+			_MM_TRANSPOSE4_PS(m10, m11, m12, m13);
+			_MM_TRANSPOSE4_PS(m20, m21, m22, m23);
+			_MM_TRANSPOSE4_PS(m30, m31, m32, m33);
+			const __m128 rows[4][4] = {
+				{ m00, m10, m20, m30 },
+				{ m01, m11, m21, m31 },
+				{ m02, m12, m22, m32 },
+				{ m03, m13, m23, m33 },
+			};
+
+			for (size_t k = 0; k < 4; ++k) {
+				if (worldOut) {
+					Matrix4x4* world = At(worldOut, worldStride, i + k);
+					for (int r = 0; r < 4; ++r) {
+						_mm_storeu_ps(world->m[r], rows[k][r]);
+					}
+				}
+				if (wvpOut) {
+					Matrix4x4* wvp = At(wvpOut, wvpStride, i + k);
+					for (int r = 0; r < 4; ++r) {
+						_mm_storeu_ps(wvp->m[r], MultiplyRow(rows[k][r], vp0, vp1, vp2, vp3));
+					}
+				}
+			}
+		}
+
+		// 端数
+		ComputeScalar(t, viewProjection, worldOut, worldStride, wvpOut, wvpStride, i, end);
+	}
+#endif
+
+	void ComputeRange(
+		const TransformSoA& t, const Matrix4x4& viewProjection,
+		Matrix4x4* worldOut, size_t worldStride, Matrix4x4* wvpOut, size_t wvpStride,
+		size_t begin, size_t end) {
+#ifdef MATH_USE_SSE
+		ComputeSimd(t, viewProjection, worldOut, worldStride, wvpOut, wvpStride, begin, end);
+#else
+		ComputeScalar(t, viewProjection, worldOut, worldStride, wvpOut, wvpStride, begin, end);
+#endif
+	}
+}
+
+void TransformSoA::Resize(size_t count)
+{
+	for (std::vector<float>* v : { &scaleX, &scaleY, &scaleZ }) {
+		v->resize(count, 1.0f);
+	}
+	for (std::vector<float>* v : { &rotateX, &rotateY, &rotateZ, &translateX, &translateY, &translateZ }) {
+		v->resize(count, 0.0f);
+	}
+}
+
+void TransformSoA::Set(size_t index, const Vector3& scale, const Vector3& rotate, const Vector3& translate)
+{
+	scaleX[index] = scale.x;
+	scaleY[index] = scale.y;
+	scaleZ[index] = scale.z;
+	rotateX[index] = rotate.x;
+	rotateY[index] = rotate.y;
+	rotateZ[index] = rotate.z;
+	translateX[index] = translate.x;
+	translateY[index] = translate.y;
+	translateZ[index] = translate.z;
+}
+
+void MakeWorldViewProjectionBatch(
+	const TransformSoA& transforms,
+	const Matrix4x4& viewProjection,
+	Matrix4x4* worldOut, size_t worldStride,
+	Matrix4x4* wvpOut, size_t wvpStride,
+	ThreadPool* threadPool)
+{
+	size_t count = transforms.Size();
+	if (count == 0 || (!worldOut && !wvpOut)) {
+		return;
+	}
+
+	if (!threadPool || count < kMinChunkSize * 2) {
+		ComputeRange(transforms, viewProjection, worldOut, worldStride, wvpOut, wvpStride, 0, count);
+		return;
+	}
+
+	threadPool->ParallelFor(count, kMinChunkSize, [&](size_t begin, size_t end) {
+		ComputeRange(transforms, viewProjection, worldOut, worldStride, wvpOut, wvpStride, begin, end);
+	});
+}
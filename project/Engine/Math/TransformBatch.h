@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Matrix.h"
+
+class ThreadPool;
+
+// 大量のオブジェクトのTransformを要素ごとの配列で持つ (Structure of Arrays)
+struct TransformSoA {
+	std::vector<float> scaleX, scaleY, scaleZ;
+	std::vector<float> rotateX, rotateY, rotateZ;
+	std::vector<float> translateX, translateY, translateZ;
+
+	// 要素数を変更する
+	void Resize(size_t count);
+
+	// 要素数
+	size_t Size() const { return translateX.size(); }
+
+	// index番目のTransformを設定する
+	void Set(size_t index, const Vector3& scale, const Vector3& rotate, const Vector3& translate);
+};
+
+/// <summary>
+/// 全オブジェクトのワールド行列とWVP行列をまとめて計算する
+/// 出力先はstride間隔で書き込むので、TransformationMatrixの配列へ直接書き込める
+/// </summary>
+/// <param name="transforms">Transformの配列</param>
+/// <param name="viewProjection">全オブジェクト共通のビュープロジェクション行列</param>
+/// <param name="worldOut">ワールド行列の出力先 (nullptrなら書き込まない)</param>
+/// <param name="worldStride">ワールド行列の出力間隔 (バイト)</param>
+/// <param name="wvpOut">WVP行列の出力先</param>
+/// <param name="wvpStride">WVP行列の出力間隔 (バイト)</param>
+/// <param name="threadPool">並列実行に使うスレッドプール (nullptrなら呼び出しスレッドのみ)</param>
+void MakeWorldViewProjectionBatch(
+	const TransformSoA& transforms,
+	const Matrix4x4& viewProjection,
+	Matrix4x4* worldOut, size_t worldStride,
+	Matrix4x4* wvpOut, size_t wvpStride,
+	ThreadPool* threadPool = nullptr);
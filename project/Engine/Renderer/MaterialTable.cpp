@@ -0,0 +1,86 @@
+#include "MaterialTable.h"
+#include <cassert>
+#include <functional>
+
+namespace {
+	void HashCombine(size_t& seed, size_t value) {
+		seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+	}
+
+	void HashVector3(size_t& seed, const Vector3& v) {
+		HashCombine(seed, std::hash<float>{}(v.x));
+		HashCombine(seed, std::hash<float>{}(v.y));
+		HashCombine(seed, std::hash<float>{}(v.z));
+	}
+
+	bool IsSameVector3(const Vector3& a, const Vector3& b) {
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+
+	// 名前以外の中身のハッシュ
+	size_t HashMaterial(const MaterialData& material) {
+		size_t seed = 0;
+		for (auto path : kMaterialTexturePaths) {
+			HashCombine(seed, std::hash<std::string>{}(material.*path));
+		}
+		const MaterialParams& params = material.params;
+		HashVector3(seed, params.ambient);
+		HashVector3(seed, params.diffuse);
+		HashVector3(seed, params.specular);
+		HashVector3(seed, params.emissive);
+		HashCombine(seed, std::hash<float>{}(params.shininess));
+		HashCombine(seed, std::hash<float>{}(params.alpha));
+		HashCombine(seed, std::hash<uint32_t>{}(params.illum));
+		return seed;
+	}
+
+	// 名前以外の中身が同じか
+	bool IsSameMaterial(const MaterialData& a, const MaterialData& b) {
+		for (auto path : kMaterialTexturePaths) {
+			if (a.*path != b.*path) {
+				return false;
+			}
+		}
+		return IsSameVector3(a.params.ambient, b.params.ambient) &&
+			IsSameVector3(a.params.diffuse, b.params.diffuse) &&
+			IsSameVector3(a.params.specular, b.params.specular) &&
+			IsSameVector3(a.params.emissive, b.params.emissive) &&
+			a.params.shininess == b.params.shininess &&
+			a.params.alpha == b.params.alpha &&
+			a.params.illum == b.params.illum;
+	}
+}
+
+uint32_t MaterialTable::Register(const MaterialData& material) {
+	const size_t hash = HashMaterial(material);
+	auto [begin, end] = hashToId_.equal_range(hash);
+	for (auto it = begin; it != end; ++it) {
+		if (IsSameMaterial(materials_[it->second], material)) {
+			return it->second;
+		}
+	}
+
+	const uint32_t materialId = static_cast<uint32_t>(materials_.size());
+	materials_.push_back(material);
+	hashToId_.emplace(hash, materialId);
+	return materialId;
+}
+
+std::vector<uint32_t> MaterialTable::Register(const ModelData& modelData) {
+	std::vector<uint32_t> materialIds;
+	materialIds.reserve(modelData.materials.size());
+	for (const MaterialData& material : modelData.materials) {
+		materialIds.push_back(Register(material));
+	}
+	return materialIds;
+}
+
+const MaterialData& MaterialTable::Get(uint32_t materialId) const {
+	assert(materialId < materials_.size());
+	return materials_[materialId];
+}
+
+void MaterialTable::Clear() {
+	materials_.clear();
+	hashToId_.clear();
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "ModelData.h"
+
+/// <summary>
+/// 複数のモデルのマテリアルを1つの番号の表にまとめる
+/// 名前が違っても数値とテクスチャが同じなら同じ番号にするので、モデルをまたいでマテリアルの番号ごとにまとめて描画できる
+/// </summary>
+class MaterialTable {
+public:
+	/// <summary>
+	/// マテリアルを登録する
+	/// </summary>
+	/// <param name="material">登録するマテリアル</param>
+	/// <returns>表の番号 (同じ中身が既にあればその番号)</returns>
+	uint32_t Register(const MaterialData& material);
+
+	/// <summary>
+	/// モデルの全マテリアルを登録する
+	/// </summary>
+	/// <param name="modelData">モデル</param>
+	/// <returns>[ModelData::materialsの番号] = 表の番号 (SubMesh::materialIndexの置き換えに使う)</returns>
+	std::vector<uint32_t> Register(const ModelData& modelData);
+
+	// 表の番号からマテリアルを引く
+	const MaterialData& Get(uint32_t materialId) const;
+
+	// 登録されているマテリアルの数
+	uint32_t GetCount() const { return static_cast<uint32_t>(materials_.size()); }
+
+	void Clear();
+
+private:
+	std::vector<MaterialData> materials_;
+	std::unordered_multimap<size_t, uint32_t> hashToId_; // 中身のハッシュ → 表の番号
+};
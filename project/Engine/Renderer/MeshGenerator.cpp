@@ -0,0 +1,311 @@
+#include "MeshGenerator.h"
+#include "Matrix.h"
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+namespace {
+	constexpr double kPi = std::numbers::pi;
+
+	// startからendまでをsegments等分した角度のcos/sin (segments + 1個)
+	struct AngleTable {
+		std::vector<float> cosines;
+		std::vector<float> sines;
+
+		AngleTable(uint32_t segments, double start, double end) : cosines(segments + 1), sines(segments + 1) {
+			for (uint32_t i = 0; i <= segments; ++i) {
+				const double angle = start + (end - start) * i / segments;
+				cosines[i] = static_cast<float>(std::cos(angle));
+				sines[i] = static_cast<float>(std::sin(angle));
+			}
+		}
+	};
+
+	// i / countをfloatで
+	float Ratio(uint32_t i, uint32_t count) {
+		return static_cast<float>(i) / static_cast<float>(count);
+	}
+
+	VertexData MakeVertex(const Vector3& position, const Vector2& texcoord, const Vector3& normal) {
+		return { { position.x, position.y, position.z, 1.0f }, texcoord, normal };
+	}
+
+	/// <summary>
+	/// 平らな格子を書く (originが左上の角で、rightとdownの向きに並べる)
+	/// 表から見てrightが右、downが下になるように渡す
+	/// </summary>
+	void WritePatch(VertexData* vertices, uint32_t* indices, uint32_t baseVertex,
+		const Vector3& origin, const Vector3& right, const Vector3& down, const Vector3& normal,
+		uint32_t divisionX, uint32_t divisionY) {
+		for (uint32_t y = 0; y <= divisionY; ++y) {
+			const float v = Ratio(y, divisionY);
+			for (uint32_t x = 0; x <= divisionX; ++x) {
+				const float u = Ratio(x, divisionX);
+				*vertices++ = MakeVertex(origin + u * right + v * down, { u, v }, normal);
+			}
+		}
+
+		const uint32_t stride = divisionX + 1;
+		for (uint32_t y = 0; y < divisionY; ++y) {
+			for (uint32_t x = 0; x < divisionX; ++x) {
+				const uint32_t lt = baseVertex + y * stride + x;
+				const uint32_t rt = lt + 1;
+				const uint32_t lb = lt + stride;
+				const uint32_t rb = lb + 1;
+				*indices++ = lt;
+				*indices++ = rt;
+				*indices++ = lb;
+
+				*indices++ = lb;
+				*indices++ = rt;
+				*indices++ = rb;
+			}
+		}
+	}
+
+	/// <summary>
+	/// 経度(横)と緯度(縦)で並んだ格子のインデックスを書く (球とトーラスで共通)
+	/// 頂点はrow * (columns + 1) + columnの順、rowが増えると上へ、columnが増えるとXからZへ回る
+	/// </summary>
+	uint32_t* WriteWrappedIndices(uint32_t* indices, uint32_t columns, uint32_t rows, bool skipBottom, bool skipTop) {
+		const uint32_t stride = columns + 1;
+		for (uint32_t row = 0; row < rows; ++row) {
+			for (uint32_t column = 0; column < columns; ++column) {
+				const uint32_t ld = row * stride + column;
+				const uint32_t rd = ld + 1;
+				const uint32_t lt = ld + stride;
+				const uint32_t rt = lt + 1;
+				// 極では片方の三角形がつぶれるので作らない
+				if (!(skipTop && row + 1 == rows)) {
+					*indices++ = rt;
+					*indices++ = ld;
+					*indices++ = lt;
+				}
+				if (!(skipBottom && row == 0)) {
+					*indices++ = rd;
+					*indices++ = ld;
+					*indices++ = rt;
+				}
+			}
+		}
+		return indices;
+	}
+
+	// ModelDataを空にする (配列の容量は残す)
+	void ClearModelData(ModelData& modelData) {
+		modelData.vertices.clear();
+		modelData.indices.clear();
+		modelData.materials.clear();
+		modelData.subMeshes.clear();
+		modelData.lods.clear();
+		modelData.meshlets.clear();
+		modelData.meshletBounds.clear();
+		modelData.meshletVertices.clear();
+		modelData.meshletTriangles.clear();
+		modelData.materialLibraryPath.clear();
+	}
+
+	// Write〇〇でModelDataを作る (マテリアル1つ、SubMesh1つ、LOD1つ)
+	template<class Writer>
+	void GenerateModelData(ModelData& modelData, Writer writer) {
+		ClearModelData(modelData);
+		const MeshSize size = writer(nullptr, nullptr);
+		modelData.vertices.resize(size.vertexCount);
+		modelData.indices.resize(size.indexCount);
+		writer(modelData.vertices.data(), modelData.indices.data());
+
+		modelData.materials.push_back({});
+		modelData.subMeshes.push_back({ 0, size.indexCount, 0, 0, 0 });
+		modelData.lods.push_back({ 0, 1, 0.0f });
+		modelData.bounds = MakeAABB(modelData.vertices.data(), modelData.vertices.size(), sizeof(VertexData));
+		modelData.boundingSphere = MakeSphere(modelData.bounds);
+	}
+}
+
+MeshSize WriteSphere(VertexData* vertices, uint32_t* indices, uint32_t subdivision, float radius) {
+	assert(subdivision >= 2);
+	const MeshSize size = { (subdivision + 1) * (subdivision + 1), 6 * subdivision * (subdivision - 1) };
+	if (!vertices || !indices) {
+		return size;
+	}
+
+	// 経度 0 ~ 2π、緯度 -π/2 ~ π/2
+	const AngleTable lon(subdivision, 0.0, 2.0 * kPi);
+	const AngleTable lat(subdivision, -kPi / 2.0, kPi / 2.0);
+	for (uint32_t latIndex = 0; latIndex <= subdivision; ++latIndex) {
+		const float v = 1.0f - Ratio(latIndex, subdivision);
+		for (uint32_t lonIndex = 0; lonIndex <= subdivision; ++lonIndex) {
+			const Vector3 normal = {
+				lat.cosines[latIndex] * lon.cosines[lonIndex],
+				lat.sines[latIndex],
+				lat.cosines[latIndex] * lon.sines[lonIndex],
+			};
+			*vertices++ = MakeVertex(radius * normal, { Ratio(lonIndex, subdivision), v }, normal);
+		}
+	}
+
+	WriteWrappedIndices(indices, subdivision, subdivision, true, true);
+	return size;
+}
+
+MeshSize WriteCube(VertexData* vertices, uint32_t* indices, float size) {
+	const MeshSize meshSize = { 24, 36 };
+	if (!vertices || !indices) {
+		return meshSize;
+	}
+
+	// 面の向きと、表から見た上の向き (右はnormal×up)
+	struct Face {
+		Vector3 normal;
+		Vector3 up;
+		Vector3 right;
+	};
+	static const Face kFaces[6] = {
+		{ { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+		{ { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }, { -1.0f, 0.0f, 0.0f } },
+		{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+		{ { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+		{ { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f } },
+		{ { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 1.0f, 0.0f, 0.0f } },
+	};
+
+	const float half = size * 0.5f;
+	for (uint32_t i = 0; i < 6; ++i) {
+		const Face& face = kFaces[i];
+		const Vector3 origin = half * (face.normal - face.right + face.up);
+		WritePatch(vertices + i * 4, indices + i * 6, i * 4, origin, size * face.right, -size * face.up, face.normal, 1, 1);
+	}
+	return meshSize;
+}
+
+MeshSize WritePlane(VertexData* vertices, uint32_t* indices, float width, float height) {
+	const MeshSize size = { 4, 6 };
+	if (!vertices || !indices) {
+		return size;
+	}
+
+	WritePatch(vertices, indices, 0, { -width * 0.5f, height * 0.5f, 0.0f }, { width, 0.0f, 0.0f }, { 0.0f, -height, 0.0f }, { 0.0f, 0.0f, -1.0f }, 1, 1);
+	return size;
+}
+
+MeshSize WriteCylinder(VertexData* vertices, uint32_t* indices, uint32_t slices, float radius, float height) {
+	assert(slices >= 3);
+	const MeshSize size = { 4 * (slices + 1), 12 * slices };
+	if (!vertices || !indices) {
+		return size;
+	}
+
+	const AngleTable angle(slices, 0.0, 2.0 * kPi);
+	const float top = height * 0.5f;
+	const float bottom = -top;
+
+	// 側面 (下の輪、上の輪の順)
+	for (uint32_t row = 0; row < 2; ++row) {
+		const float y = row == 0 ? bottom : top;
+		for (uint32_t i = 0; i <= slices; ++i) {
+			const Vector3 normal = { angle.cosines[i], 0.0f, angle.sines[i] };
+			*vertices++ = MakeVertex({ radius * normal.x, y, radius * normal.z }, { Ratio(i, slices), row == 0 ? 1.0f : 0.0f }, normal);
+		}
+	}
+	indices = WriteWrappedIndices(indices, slices, 1, false, false);
+
+	// ふた (中心、周の順。周は継ぎ目がいらないのでslices個)
+	uint32_t base = 2 * (slices + 1);
+	for (uint32_t cap = 0; cap < 2; ++cap) {
+		const bool isTop = cap == 0;
+		const float y = isTop ? top : bottom;
+		const Vector3 normal = { 0.0f, isTop ? 1.0f : -1.0f, 0.0f };
+		// 上のふたは+Z、下のふたは-Zを画像の上にする
+		const float vSign = isTop ? -0.5f : 0.5f;
+		*vertices++ = MakeVertex({ 0.0f, y, 0.0f }, { 0.5f, 0.5f }, normal);
+		for (uint32_t i = 0; i < slices; ++i) {
+			*vertices++ = MakeVertex({ radius * angle.cosines[i], y, radius * angle.sines[i] },
+				{ 0.5f + 0.5f * angle.cosines[i], 0.5f + vSign * angle.sines[i] }, normal);
+		}
+		for (uint32_t i = 0; i < slices; ++i) {
+			const uint32_t current = base + 1 + i;
+			const uint32_t next = base + 1 + (i + 1) % slices;
+			*indices++ = base;
+			*indices++ = isTop ? next : current;
+			*indices++ = isTop ? current : next;
+		}
+		base += slices + 1;
+	}
+	return size;
+}
+
+MeshSize WriteTorus(VertexData* vertices, uint32_t* indices, uint32_t majorSegments, uint32_t minorSegments, float majorRadius, float minorRadius) {
+	assert(majorSegments >= 3 && minorSegments >= 3);
+	const MeshSize size = { (majorSegments + 1) * (minorSegments + 1), 6 * majorSegments * minorSegments };
+	if (!vertices || !indices) {
+		return size;
+	}
+
+	// 輪の周をXからZへ、管の周を外側から上へ回る
+	const AngleTable major(majorSegments, 0.0, 2.0 * kPi);
+	const AngleTable minor(minorSegments, 0.0, 2.0 * kPi);
+	for (uint32_t j = 0; j <= minorSegments; ++j) {
+		const float v = Ratio(j, minorSegments);
+		for (uint32_t i = 0; i <= majorSegments; ++i) {
+			const Vector3 normal = {
+				minor.cosines[j] * major.cosines[i],
+				minor.sines[j],
+				minor.cosines[j] * major.sines[i],
+			};
+			const Vector3 center = { majorRadius * major.cosines[i], 0.0f, majorRadius * major.sines[i] };
+			*vertices++ = MakeVertex(center + minorRadius * normal, { Ratio(i, majorSegments), v }, normal);
+		}
+	}
+
+	WriteWrappedIndices(indices, majorSegments, minorSegments, false, false);
+	return size;
+}
+
+MeshSize WriteGrid(VertexData* vertices, uint32_t* indices, uint32_t divisionX, uint32_t divisionZ, float width, float depth) {
+	assert(divisionX >= 1 && divisionZ >= 1);
+	const MeshSize size = { (divisionX + 1) * (divisionZ + 1), 6 * divisionX * divisionZ };
+	if (!vertices || !indices) {
+		return size;
+	}
+
+	// 上から見て+Zが画像の上
+	WritePatch(vertices, indices, 0, { -width * 0.5f, 0.0f, depth * 0.5f }, { width, 0.0f, 0.0f }, { 0.0f, 0.0f, -depth }, { 0.0f, 1.0f, 0.0f }, divisionX, divisionZ);
+	return size;
+}
+
+void GenerateSphere(ModelData& modelData, uint32_t subdivision, float radius) {
+	GenerateModelData(modelData, [&](VertexData* vertices, uint32_t* indices) {
+		return WriteSphere(vertices, indices, subdivision, radius);
+	});
+}
+
+void GenerateCube(ModelData& modelData, float size) {
+	GenerateModelData(modelData, [&](VertexData* vertices, uint32_t* indices) {
+		return WriteCube(vertices, indices, size);
+	});
+}
+
+void GeneratePlane(ModelData& modelData, float width, float height) {
+	GenerateModelData(modelData, [&](VertexData* vertices, uint32_t* indices) {
+		return WritePlane(vertices, indices, width, height);
+	});
+}
+
+void GenerateCylinder(ModelData& modelData, uint32_t slices, float radius, float height) {
+	GenerateModelData(modelData, [&](VertexData* vertices, uint32_t* indices) {
+		return WriteCylinder(vertices, indices, slices, radius, height);
+	});
+}
+
+void GenerateTorus(ModelData& modelData, uint32_t majorSegments, uint32_t minorSegments, float majorRadius, float minorRadius) {
+	GenerateModelData(modelData, [&](VertexData* vertices, uint32_t* indices) {
+		return WriteTorus(vertices, indices, majorSegments, minorSegments, majorRadius, minorRadius);
+	});
+}
+
+void GenerateGrid(ModelData& modelData, uint32_t divisionX, uint32_t divisionZ, float width, float depth) {
+	GenerateModelData(modelData, [&](VertexData* vertices, uint32_t* indices) {
+		return WriteGrid(vertices, indices, divisionX, divisionZ, width, depth);
+	});
+}
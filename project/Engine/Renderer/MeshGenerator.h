@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include "ModelData.h"
+
+// 生成する形の頂点数とインデックス数
+struct MeshSize {
+	uint32_t vertexCount;
+	uint32_t indexCount;
+};
+
+// Write〇〇は呼び出し側が用意したバッファ(Mapしたアップロード用リソースなど)に直接書き込む
+// verticesとindicesをnullptrにすると書き込まずに必要な数だけ返す
+// Generate〇〇はModelDataに書き込む (配列の容量は使い回すので、同じModelDataで作り直しても確保し直さない)
+// どれも左手系で時計回りが表、法線は外向き、インデックスは0始まり
+// sin/cosは分割数ごとに表にして1回だけ計算する
+
+/// <summary>
+/// UV球 (Y軸が極、経度はXからZへ回る)
+/// 頂点は(subdivision + 1)^2個、極の縮退した三角形は作らないのでインデックスは6 * subdivision * (subdivision - 1)個
+/// </summary>
+/// <param name="vertices">頂点の書き込み先</param>
+/// <param name="indices">インデックスの書き込み先</param>
+/// <param name="subdivision">緯度・経度の分割数 (2以上)</param>
+/// <param name="radius">半径</param>
+/// <returns>頂点数とインデックス数</returns>
+MeshSize WriteSphere(VertexData* vertices, uint32_t* indices, uint32_t subdivision, float radius = 1.0f);
+void GenerateSphere(ModelData& modelData, uint32_t subdivision, float radius = 1.0f);
+
+/// <summary>
+/// 立方体 (面ごとに頂点を分けるので頂点24個、インデックス36個)
+/// </summary>
+/// <param name="size">1辺の長さ</param>
+MeshSize WriteCube(VertexData* vertices, uint32_t* indices, float size = 1.0f);
+void GenerateCube(ModelData& modelData, float size = 1.0f);
+
+/// <summary>
+/// XY平面上の四角形 (-Z向き、スプライトと同じくカメラの方を向く)
+/// 頂点4個、インデックス6個
+/// </summary>
+/// <param name="width">幅 (X)</param>
+/// <param name="height">高さ (Y)</param>
+MeshSize WritePlane(VertexData* vertices, uint32_t* indices, float width = 1.0f, float height = 1.0f);
+void GeneratePlane(ModelData& modelData, float width = 1.0f, float height = 1.0f);
+
+/// <summary>
+/// Y軸に沿った円柱 (ふた付き)
+/// 頂点は4 * (slices + 1)個、インデックスは12 * slices個
+/// </summary>
+/// <param name="slices">周の分割数 (3以上)</param>
+/// <param name="radius">半径</param>
+/// <param name="height">高さ (原点が中心)</param>
+MeshSize WriteCylinder(VertexData* vertices, uint32_t* indices, uint32_t slices, float radius = 0.5f, float height = 1.0f);
+void GenerateCylinder(ModelData& modelData, uint32_t slices, float radius = 0.5f, float height = 1.0f);
+
+/// <summary>
+/// XZ平面に寝かせたトーラス
+/// 頂点は(majorSegments + 1) * (minorSegments + 1)個、インデックスは6 * majorSegments * minorSegments個
+/// </summary>
+/// <param name="majorSegments">輪の周の分割数 (3以上)</param>
+/// <param name="minorSegments">管の周の分割数 (3以上)</param>
+/// <param name="majorRadius">中心から管の中心までの半径</param>
+/// <param name="minorRadius">管の半径</param>
+MeshSize WriteTorus(VertexData* vertices, uint32_t* indices, uint32_t majorSegments, uint32_t minorSegments, float majorRadius = 1.0f, float minorRadius = 0.25f);
+void GenerateTorus(ModelData& modelData, uint32_t majorSegments, uint32_t minorSegments, float majorRadius = 1.0f, float minorRadius = 0.25f);
+
+/// <summary>
+/// XZ平面上の分割された地面 (+Y向き、UVは全体で0～1)
+/// 頂点は(divisionX + 1) * (divisionZ + 1)個、インデックスは6 * divisionX * divisionZ個
+/// </summary>
+/// <param name="divisionX">X方向の分割数 (1以上)</param>
+/// <param name="divisionZ">Z方向の分割数 (1以上)</param>
+/// <param name="width">幅 (X)</param>
+/// <param name="depth">奥行き (Z)</param>
+MeshSize WriteGrid(VertexData* vertices, uint32_t* indices, uint32_t divisionX, uint32_t divisionZ, float width = 1.0f, float depth = 1.0f);
+void GenerateGrid(ModelData& modelData, uint32_t divisionX, uint32_t divisionZ, float width = 1.0f, float depth = 1.0f);
@@ -0,0 +1,104 @@
+#include "MeshLod.h"
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	// これ以上三角形が減らないLODは作らない
+	constexpr float kMinReduction = 0.95f;
+
+	size_t CountLodIndices(const ModelData& modelData, const MeshLod& lod) {
+		size_t count = 0;
+		for (uint32_t i = 0; i < lod.subMeshCount; ++i) {
+			count += modelData.subMeshes[lod.subMeshOffset + i].indexCount;
+		}
+		return count;
+	}
+}
+
+void GenerateLods(ModelData& modelData, uint32_t maxLodCount, float reduction, float maxError) {
+	if (modelData.lods.empty()) {
+		modelData.lods.push_back({ 0, static_cast<uint32_t>(modelData.subMeshes.size()), 0.0f });
+	}
+
+	// 元のメッシュだけに戻す
+	const MeshLod baseLod = modelData.lods[0];
+	size_t baseIndexCount = 0;
+	for (uint32_t i = 0; i < baseLod.subMeshCount; ++i) {
+		const SubMesh& subMesh = modelData.subMeshes[baseLod.subMeshOffset + i];
+		baseIndexCount = (std::max)(baseIndexCount, static_cast<size_t>(subMesh.indexOffset) + subMesh.indexCount);
+	}
+	modelData.lods.resize(1);
+	modelData.subMeshes.resize(baseLod.subMeshOffset + baseLod.subMeshCount);
+	modelData.indices.resize(baseIndexCount);
+
+	const float errorLimit = maxError * modelData.boundingSphere.radius;
+	size_t previousIndexCount = CountLodIndices(modelData, baseLod);
+	float previousError = 0.0f;
+	std::vector<uint32_t> lodIndices;
+	for (uint32_t level = 1; level < maxLodCount; ++level) {
+		const float ratio = std::pow(reduction, static_cast<float>(level));
+		MeshLod lod{ static_cast<uint32_t>(modelData.subMeshes.size()), 0, previousError };
+		size_t lodIndexCount = 0;
+
+		// 元のメッシュからSubMeshごとに簡略化する (マテリアルの境目はまたがない)
+		for (uint32_t i = 0; i < baseLod.subMeshCount; ++i) {
+			const SubMesh subMesh = modelData.subMeshes[baseLod.subMeshOffset + i];
+			const size_t targetIndexCount = static_cast<size_t>(static_cast<float>(subMesh.indexCount) * ratio) / 3 * 3;
+			lodIndices.resize(subMesh.indexCount);
+			float error = 0.0f;
+			size_t count = SimplifyMesh(lodIndices.data(), modelData.indices.data() + subMesh.indexOffset, subMesh.indexCount,
+				modelData.vertices.data(), modelData.vertices.size(), targetIndexCount, errorLimit, &error);
+			if (count == 0) {
+				continue;
+			}
+
+			modelData.subMeshes.push_back({ static_cast<uint32_t>(modelData.indices.size()), static_cast<uint32_t>(count), subMesh.materialIndex, 0, 0 });
+			modelData.indices.insert(modelData.indices.end(), lodIndices.begin(), lodIndices.begin() + count);
+			lod.error = (std::max)(lod.error, error);
+			lodIndexCount += count;
+			++lod.subMeshCount;
+		}
+
+		// 前のLODからほとんど減っていなければ取り消して終わる
+		if (static_cast<float>(lodIndexCount) > static_cast<float>(previousIndexCount) * kMinReduction) {
+			modelData.indices.resize(modelData.indices.size() - lodIndexCount);
+			modelData.subMeshes.resize(lod.subMeshOffset);
+			break;
+		}
+
+		modelData.lods.push_back(lod);
+		previousIndexCount = lodIndexCount;
+		previousError = lod.error;
+	}
+}
+
+uint32_t SelectLod(const ModelData& modelData, const Matrix4x4& worldMatrix, const Vector3& cameraPosition, float fovY, float screenHeight, float pixelError) {
+	if (modelData.lods.size() <= 1) {
+		return 0;
+	}
+
+	// 境界球をワールド空間へ (拡縮は一番大きい軸で見る)
+	const Vector3 translate = { worldMatrix.m[3][0], worldMatrix.m[3][1], worldMatrix.m[3][2] };
+	const Vector3 center = TransformNormal(modelData.boundingSphere.center, worldMatrix) + translate;
+	const float scale = (std::max)({
+		Length({ worldMatrix.m[0][0], worldMatrix.m[0][1], worldMatrix.m[0][2] }),
+		Length({ worldMatrix.m[1][0], worldMatrix.m[1][1], worldMatrix.m[1][2] }),
+		Length({ worldMatrix.m[2][0], worldMatrix.m[2][1], worldMatrix.m[2][2] }),
+	});
+
+	// 球の中にカメラがあれば一番細かいLOD
+	const float distance = Length(center - cameraPosition) - modelData.boundingSphere.radius * scale;
+	if (distance <= 0.0f) {
+		return 0;
+	}
+
+	// その距離でモデル空間の1がおよそ何ピクセルになるか
+	const float pixelsPerUnit = scale * screenHeight / (2.0f * std::tan(fovY * 0.5f) * distance);
+	for (uint32_t lod = static_cast<uint32_t>(modelData.lods.size()) - 1; lod > 0; --lod) {
+		if (modelData.lods[lod].error * pixelsPerUnit <= pixelError) {
+			return lod;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include "ModelData.h"
+
+/// <summary>
+/// 元のメッシュ(lods[0])を簡略化してLODを作り、ModelDataの後ろに追加する
+/// 頂点は全LODで共有し、インデックスとSubMeshだけが増える
+/// 三角形が減らなくなったらmaxLodCountに届かなくても打ち切る
+/// </summary>
+/// <param name="modelData">LODを追加するモデル (既にあるLODは作り直す)</param>
+/// <param name="maxLodCount">元のメッシュを含めたLODの最大数</param>
+/// <param name="reduction">1段階ごとに残す三角形の割合</param>
+/// <param name="maxError">許す誤差 (境界球の半径に対する割合)</param>
+void GenerateLods(ModelData& modelData, uint32_t maxLodCount = 4, float reduction = 0.5f, float maxError = 0.05f);
+
+/// <summary>
+/// 画面上の大きさからLODを選ぶ
+/// 誤差を画面に投影した時にpixelError以下になる一番粗いLODを返す
+/// </summary>
+/// <param name="modelData">モデル</param>
+/// <param name="worldMatrix">ワールド行列</param>
+/// <param name="cameraPosition">カメラのワールド座標 (DebugCamera::GetPosition)</param>
+/// <param name="fovY">縦の画角 (ラジアン、射影行列と同じ値)</param>
+/// <param name="screenHeight">画面の高さ (ピクセル)</param>
+/// <param name="pixelError">許す誤差 (ピクセル)</param>
+/// <returns>lodsの番号</returns>
+uint32_t SelectLod(const ModelData& modelData, const Matrix4x4& worldMatrix, const Vector3& cameraPosition, float fovY, float screenHeight, float pixelError = 1.0f);
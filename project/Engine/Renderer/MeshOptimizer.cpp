@@ -0,0 +1,303 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+	// 頂点ごとの周りの三角形 (offsets[v]～offsets[v+1]がtrianglesの範囲)
+	struct Adjacency {
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+	};
+
+	Adjacency BuildAdjacency(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+		Adjacency adjacency;
+		adjacency.offsets.assign(vertexCount + 1, 0);
+		for (size_t i = 0; i < indexCount; ++i) {
+			++adjacency.offsets[indices[i] + 1];
+		}
+		for (size_t v = 0; v < vertexCount; ++v) {
+			adjacency.offsets[v + 1] += adjacency.offsets[v];
+		}
+
+		adjacency.triangles.resize(indexCount);
+		std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+		for (size_t i = 0; i < indexCount; ++i) {
+			adjacency.triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+		return adjacency;
+	}
+
+	// FIFOキャッシュ
+	// ミスした時だけ時刻を進め、頂点が入った時刻との差がキャッシュサイズ未満なら残っている
+	class FifoCache {
+	public:
+		FifoCache(size_t vertexCount, uint32_t cacheSize)
+			: timestamps_(vertexCount, 0), time_(cacheSize + 1), cacheSize_(cacheSize) {}
+
+		// 頂点を使う (ミスならtrue)
+		bool Access(uint32_t vertex) {
+			if (time_ - timestamps_[vertex] > cacheSize_) {
+				timestamps_[vertex] = time_++;
+				return true;
+			}
+			return false;
+		}
+
+		// 全部追い出す
+		void Flush() {
+			time_ += cacheSize_ + 1;
+		}
+
+	private:
+		std::vector<uint32_t> timestamps_;
+		uint32_t time_;
+		uint32_t cacheSize_;
+	};
+
+	// 三角形ごとのミス数を求める
+	uint32_t AccessTriangle(FifoCache& cache, const uint32_t* triangle) {
+		return static_cast<uint32_t>(cache.Access(triangle[0])) + cache.Access(triangle[1]) + cache.Access(triangle[2]);
+	}
+
+	// 行き止まりになった時の次の中心頂点
+	// 最近使った頂点から探し、無ければ番号順に残っている頂点を探す
+	int64_t SkipDeadEnd(const std::vector<uint32_t>& liveCounts, std::vector<uint32_t>& deadEnd, size_t& cursor) {
+		while (!deadEnd.empty()) {
+			uint32_t vertex = deadEnd.back();
+			deadEnd.pop_back();
+			if (liveCounts[vertex] > 0) {
+				return vertex;
+			}
+		}
+		while (cursor < liveCounts.size()) {
+			if (liveCounts[cursor] > 0) {
+				return static_cast<int64_t>(cursor);
+			}
+			++cursor;
+		}
+		return -1;
+	}
+
+	// 三角形のまとまりの境目を求める
+	// キャッシュが空になる所(全部ミスする三角形)で切り、その中をACMRがthreshold倍以内に収まる所でさらに切る
+	std::vector<size_t> BuildClusters(const uint32_t* indices, size_t triangleCount, size_t vertexCount, uint32_t cacheSize, float threshold) {
+		std::vector<size_t> hardBoundaries;
+		{
+			FifoCache cache(vertexCount, cacheSize);
+			for (size_t t = 0; t < triangleCount; ++t) {
+				if (AccessTriangle(cache, indices + t * 3) == 3) {
+					hardBoundaries.push_back(t);
+				}
+			}
+		}
+		hardBoundaries.push_back(triangleCount);
+
+		std::vector<size_t> clusters;
+		FifoCache cache(vertexCount, cacheSize);
+		for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h) {
+			const size_t start = hardBoundaries[h];
+			const size_t end = hardBoundaries[h + 1];
+
+			// まとまり全体のACMR
+			cache.Flush();
+			uint32_t totalMisses = 0;
+			for (size_t t = start; t < end; ++t) {
+				totalMisses += AccessTriangle(cache, indices + t * 3);
+			}
+			const float clusterThreshold = threshold * static_cast<float>(totalMisses) / static_cast<float>(end - start);
+
+			// 先頭からミスを数え、ACMRが許容範囲に入ったら切る
+			cache.Flush();
+			clusters.push_back(start);
+			size_t clusterStart = start;
+			uint32_t misses = 0;
+			for (size_t t = start; t < end; ++t) {
+				misses += AccessTriangle(cache, indices + t * 3);
+				if (t + 1 < end && static_cast<float>(misses) <= clusterThreshold * static_cast<float>(t + 1 - clusterStart)) {
+					clusters.push_back(t + 1);
+					clusterStart = t + 1;
+					misses = 0;
+					cache.Flush();
+				}
+			}
+		}
+		return clusters;
+	}
+}
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	VertexCacheStats stats{};
+	FifoCache cache(vertexCount, cacheSize);
+	std::vector<bool> isReferenced(vertexCount, false);
+	for (size_t i = 0; i < indexCount; ++i) {
+		stats.vertexShaded += cache.Access(indices[i]);
+		if (!isReferenced[indices[i]]) {
+			isReferenced[indices[i]] = true;
+			++stats.vertexCount;
+		}
+	}
+	stats.triangleCount = static_cast<uint32_t>(indexCount / 3);
+	stats.acmr = stats.triangleCount ? static_cast<float>(stats.vertexShaded) / static_cast<float>(stats.triangleCount) : 0.0f;
+	stats.atvr = stats.vertexCount ? static_cast<float>(stats.vertexShaded) / static_cast<float>(stats.vertexCount) : 0.0f;
+	return stats;
+}
+
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	const Adjacency adjacency = BuildAdjacency(indices, indexCount, vertexCount);
+	std::vector<uint32_t> liveCounts(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		liveCounts[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+	}
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	std::vector<bool> isEmitted(triangleCount, false);
+	std::vector<uint32_t> deadEnd; // 最近使った頂点
+	std::vector<uint32_t> candidates; // 次の中心の候補
+	std::vector<uint32_t> result;
+	result.reserve(indexCount);
+
+	uint32_t time = cacheSize + 1;
+	size_t cursor = 0;
+	int64_t fanning = SkipDeadEnd(liveCounts, deadEnd, cursor);
+	while (fanning >= 0) {
+		// 中心頂点の周りのまだ描いていない三角形を全部出す
+		candidates.clear();
+		for (uint32_t a = adjacency.offsets[fanning]; a < adjacency.offsets[fanning + 1]; ++a) {
+			uint32_t triangle = adjacency.triangles[a];
+			if (isEmitted[triangle]) {
+				continue;
+			}
+			isEmitted[triangle] = true;
+			for (size_t k = 0; k < 3; ++k) {
+				uint32_t vertex = indices[triangle * 3 + k];
+				result.push_back(vertex);
+				deadEnd.push_back(vertex);
+				candidates.push_back(vertex);
+				--liveCounts[vertex];
+				if (time - timestamps[vertex] > cacheSize) {
+					timestamps[vertex] = time++;
+				}
+			}
+		}
+
+		// 残りの三角形を描き終えるまでキャッシュに残っていそうな頂点のうち、一番古いものを選ぶ
+		int64_t next = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t vertex : candidates) {
+			if (liveCounts[vertex] == 0) {
+				continue;
+			}
+			int64_t priority = 0;
+			if (time - timestamps[vertex] + 2 * liveCounts[vertex] <= cacheSize) {
+				priority = time - timestamps[vertex];
+			}
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				next = vertex;
+			}
+		}
+		fanning = next >= 0 ? next : SkipDeadEnd(liveCounts, deadEnd, cursor);
+	}
+
+	std::copy(result.begin(), result.end(), indices);
+}
+
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount, uint32_t cacheSize, float threshold) {
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	const std::vector<size_t> clusters = BuildClusters(indices, triangleCount, vertexCount, cacheSize, threshold);
+	const size_t clusterCount = clusters.size();
+	if (clusterCount <= 1) {
+		return;
+	}
+
+	// まとまりごとの面積で重み付けした中心と法線
+	std::vector<Vector3> centroids(clusterCount, { 0.0f, 0.0f, 0.0f });
+	std::vector<Vector3> normals(clusterCount, { 0.0f, 0.0f, 0.0f });
+	std::vector<float> areas(clusterCount, 0.0f);
+	Vector3 meshCentroid = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+	for (size_t c = 0; c < clusterCount; ++c) {
+		const size_t end = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+		for (size_t t = clusters[c]; t < end; ++t) {
+			const Vector4& p0 = vertices[indices[t * 3 + 0]].position;
+			const Vector4& p1 = vertices[indices[t * 3 + 1]].position;
+			const Vector4& p2 = vertices[indices[t * 3 + 2]].position;
+			Vector3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+			Vector3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+			// 左手系で時計回りが表なので e1×e2 が表向きの法線 (長さは面積の2倍)
+			Vector3 normal = {
+				e1.y * e2.z - e1.z * e2.y,
+				e1.z * e2.x - e1.x * e2.z,
+				e1.x * e2.y - e1.y * e2.x,
+			};
+			float area = Length(normal);
+			Vector3 center = { (p0.x + p1.x + p2.x) / 3.0f, (p0.y + p1.y + p2.y) / 3.0f, (p0.z + p1.z + p2.z) / 3.0f };
+
+			centroids[c] = Add(centroids[c], Multiply(area, center));
+			normals[c] = Add(normals[c], normal);
+			areas[c] += area;
+		}
+		meshCentroid = Add(meshCentroid, centroids[c]);
+		meshArea += areas[c];
+		if (areas[c] > 0.0f) {
+			centroids[c] = Multiply(1.0f / areas[c], centroids[c]);
+		}
+	}
+	if (meshArea > 0.0f) {
+		meshCentroid = Multiply(1.0f / meshArea, meshCentroid);
+	}
+
+	// 外側を向いているまとまりほど手前の物を隠しやすいので先に描く
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t c = 0; c < clusterCount; ++c) {
+		Vector3 offset = Subtract(centroids[c], meshCentroid);
+		float length = Length(normals[c]);
+		sortKeys[c] = length > 0.0f
+			? (offset.x * normals[c].x + offset.y * normals[c].y + offset.z * normals[c].z) / length
+			: 0.0f;
+	}
+	std::vector<size_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+	std::vector<uint32_t> result;
+	result.reserve(indexCount);
+	for (size_t c : order) {
+		const size_t end = c + 1 < clusterCount ? clusters[c + 1] : triangleCount;
+		result.insert(result.end(), indices + clusters[c] * 3, indices + end * 3);
+	}
+	std::copy(result.begin(), result.end(), indices);
+}
+
+void OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices) {
+	constexpr uint32_t kUnused = UINT32_MAX;
+	std::vector<uint32_t> remap(vertices.size(), kUnused);
+	std::vector<VertexData> result;
+	result.reserve(vertices.size());
+	for (uint32_t& index : indices) {
+		if (remap[index] == kUnused) {
+			remap[index] = static_cast<uint32_t>(result.size());
+			result.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices = std::move(result);
+}
+
+void OptimizeModel(ModelData& modelData) {
+	const size_t vertexCount = modelData.vertices.size();
+	for (const SubMesh& subMesh : modelData.subMeshes) {
+		uint32_t* indices = modelData.indices.data() + subMesh.indexOffset;
+		OptimizeVertexCache(indices, subMesh.indexCount, vertexCount);
+		OptimizeOverdraw(indices, subMesh.indexCount, modelData.vertices.data(), vertexCount);
+	}
+	OptimizeVertexFetch(modelData.vertices, modelData.indices);
+}
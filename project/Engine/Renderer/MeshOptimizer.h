@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ModelData.h"
+
+// GPUの頂点キャッシュ(変換後の頂点を使い回す仕組み)を効かせるためのメッシュ最適化
+// インデックスの並べ替えだけなので描画結果は変わらない
+
+// 一般的なGPUを想定したキャッシュサイズ
+constexpr uint32_t kVertexCacheSize = 16;
+
+// 頂点キャッシュの効率
+struct VertexCacheStats {
+	uint32_t vertexShaded; // 頂点シェーダーが走った回数 (キャッシュミスの数)
+	uint32_t triangleCount; // 三角形の数
+	uint32_t vertexCount; // 参照されている頂点の数
+	float acmr; // 三角形あたりのミス数 (0.5～3、小さいほど良い)
+	float atvr; // 頂点あたりのミス数 (1が理想)
+};
+
+/// <summary>
+/// FIFOの頂点キャッシュを真似て、インデックスを描いた時のミス数を数える
+/// </summary>
+/// <param name="indices">インデックス (3つで1三角形)</param>
+/// <param name="indexCount">インデックス数</param>
+/// <param name="vertexCount">頂点数 (インデックスの最大値+1以上)</param>
+/// <param name="cacheSize">キャッシュに入る頂点数</param>
+/// <returns>キャッシュの効率</returns>
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kVertexCacheSize);
+
+/// <summary>
+/// Tipsify(Sander 2007)で三角形の順を並べ替え、頂点キャッシュのミスを減らす
+/// 頂点の周りの三角形をまとめて描き、キャッシュに残っている頂点を次の中心に選ぶ
+/// </summary>
+/// <param name="indices">並べ替えるインデックス (3つで1三角形)</param>
+/// <param name="indexCount">インデックス数</param>
+/// <param name="vertexCount">頂点数 (インデックスの最大値+1以上)</param>
+/// <param name="cacheSize">キャッシュに入る頂点数</param>
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kVertexCacheSize);
+
+/// <summary>
+/// OptimizeVertexCacheの後に呼び、外側を向いた三角形のまとまりから先に描くよう並べ替える
+/// キャッシュ効率がthreshold倍まで落ちるのを許してまとまりを細かく分ける
+/// </summary>
+/// <param name="indices">並べ替えるインデックス (3つで1三角形)</param>
+/// <param name="indexCount">インデックス数</param>
+/// <param name="vertices">頂点 (位置だけ使う)</param>
+/// <param name="vertexCount">頂点数</param>
+/// <param name="cacheSize">キャッシュに入る頂点数</param>
+/// <param name="threshold">許すACMRの悪化 (1.05なら5%まで)</param>
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount, uint32_t cacheSize = kVertexCacheSize, float threshold = 1.05f);
+
+/// <summary>
+/// 頂点をインデックスで最初に使われる順に並べ直し、インデックスを付け替える
+/// 頂点の読み込みがメモリ上で前から順になる。使われていない頂点は取り除く
+/// </summary>
+/// <param name="vertices">並べ替える頂点</param>
+/// <param name="indices">付け替えるインデックス</param>
+void OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices);
+
+/// <summary>
+/// モデルをまとめて最適化する
+/// SubMeshごとに三角形の順を並べ替え (範囲は変えない)、最後に頂点の順を並べ替える
+/// </summary>
+/// <param name="modelData">最適化するモデル</param>
+void OptimizeModel(ModelData& modelData);
@@ -0,0 +1,313 @@
+#include "MeshSimplifier.h"
+#include "Matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+	// 平面からの距離の二乗の和を表す二次式 (面積で重み付け)
+	// E(p) = pᵀAp + 2bᵀp + c
+	struct Quadric {
+		double a00, a11, a22, a01, a02, a12;
+		double b0, b1, b2;
+		double c;
+		double weight;
+	};
+
+	void AddQuadric(Quadric& q, const Quadric& other) {
+		q.a00 += other.a00;
+		q.a11 += other.a11;
+		q.a22 += other.a22;
+		q.a01 += other.a01;
+		q.a02 += other.a02;
+		q.a12 += other.a12;
+		q.b0 += other.b0;
+		q.b1 += other.b1;
+		q.b2 += other.b2;
+		q.c += other.c;
+		q.weight += other.weight;
+	}
+
+	// 三角形の平面の二次式
+	Quadric MakePlaneQuadric(const Vector4& p0, const Vector4& p1, const Vector4& p2) {
+		const double e1[3] = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		const double e2[3] = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		double n[3] = {
+			e1[1] * e2[2] - e1[2] * e2[1],
+			e1[2] * e2[0] - e1[0] * e2[2],
+			e1[0] * e2[1] - e1[1] * e2[0],
+		};
+		const double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length == 0.0) {
+			return {};
+		}
+		n[0] /= length;
+		n[1] /= length;
+		n[2] /= length;
+		const double d = -(n[0] * p0.x + n[1] * p0.y + n[2] * p0.z);
+		const double area = length * 0.5;
+
+		Quadric q;
+		q.a00 = area * n[0] * n[0];
+		q.a11 = area * n[1] * n[1];
+		q.a22 = area * n[2] * n[2];
+		q.a01 = area * n[0] * n[1];
+		q.a02 = area * n[0] * n[2];
+		q.a12 = area * n[1] * n[2];
+		q.b0 = area * n[0] * d;
+		q.b1 = area * n[1] * d;
+		q.b2 = area * n[2] * d;
+		q.c = area * d * d;
+		q.weight = area;
+		return q;
+	}
+
+	// 点での誤差 (平面からの距離の二乗の面積平均)
+	double EvaluateQuadric(const Quadric& q, const Vector4& p) {
+		if (q.weight <= 0.0) {
+			return 0.0;
+		}
+		const double x = p.x;
+		const double y = p.y;
+		const double z = p.z;
+		double error =
+			q.a00 * x * x + q.a11 * y * y + q.a22 * z * z +
+			2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+			2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+		return (std::max)(error, 0.0) / q.weight;
+	}
+
+	// 位置のビット列のハッシュ (同じ位置の頂点をまとめる用)
+	struct PositionKey {
+		uint32_t x, y, z;
+		bool operator == (const PositionKey&) const = default;
+	};
+
+	struct PositionHash {
+		size_t operator()(const PositionKey& k) const noexcept {
+			size_t h = k.x;
+			h = h * 0x9e3779b97f4a7c15ULL ^ k.y;
+			h = h * 0x9e3779b97f4a7c15ULL ^ k.z;
+			return h;
+		}
+	};
+
+	PositionKey MakePositionKey(const Vector4& p) {
+		PositionKey key;
+		std::memcpy(&key.x, &p.x, sizeof(float));
+		std::memcpy(&key.y, &p.y, sizeof(float));
+		std::memcpy(&key.z, &p.z, sizeof(float));
+		return key;
+	}
+
+	// つぶす辺の候補 (from を to に寄せる)
+	struct Collapse {
+		uint32_t from;
+		uint32_t to;
+		double error;
+	};
+
+	Vector3 TriangleNormal(const Vector4& p0, const Vector4& p1, const Vector4& p2) {
+		Vector3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		Vector3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		return { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+	}
+
+	float Dot(const Vector3& a, const Vector3& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+}
+
+size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount,
+	size_t targetIndexCount, float maxError, float* resultError) {
+	std::vector<uint32_t> result(indices, indices + indexCount);
+	double appliedError = 0.0;
+
+	// 同じ位置の頂点を1つにまとめた番号 (継ぎ目をまたいだつながりを見るため)
+	std::vector<uint32_t> positionIds(vertexCount);
+	{
+		std::unordered_map<PositionKey, uint32_t, PositionHash> positionMap;
+		positionMap.reserve(vertexCount);
+		for (size_t v = 0; v < vertexCount; ++v) {
+			positionIds[v] = positionMap.try_emplace(MakePositionKey(vertices[v].position), static_cast<uint32_t>(v)).first->second;
+		}
+	}
+
+	// 動かせない頂点 (継ぎ目と縁)
+	std::vector<bool> isLocked(vertexCount, false);
+	{
+		constexpr uint32_t kUnused = UINT32_MAX;
+		std::vector<uint32_t> firstVertex(vertexCount, kUnused);
+		std::unordered_set<uint64_t> edges;
+		edges.reserve(indexCount);
+		auto edgeKey = [](uint32_t a, uint32_t b) { return (static_cast<uint64_t>(a) << 32) | b; };
+		for (size_t i = 0; i < indexCount; ++i) {
+			const uint32_t vertex = indices[i];
+			uint32_t& first = firstVertex[positionIds[vertex]];
+			if (first == kUnused) {
+				first = vertex;
+			} else if (first != vertex) {
+				isLocked[positionIds[vertex]] = true;
+			}
+			const uint32_t next = indices[i % 3 == 2 ? i - 2 : i + 1];
+			edges.insert(edgeKey(positionIds[vertex], positionIds[next]));
+		}
+		// 逆向きの辺が無ければ縁
+		for (uint64_t edge : edges) {
+			const uint32_t a = static_cast<uint32_t>(edge >> 32);
+			const uint32_t b = static_cast<uint32_t>(edge);
+			if (!edges.contains(edgeKey(b, a))) {
+				isLocked[a] = true;
+				isLocked[b] = true;
+			}
+		}
+	}
+
+	// 位置ごとの二次式
+	std::vector<Quadric> quadrics(vertexCount, Quadric{});
+	for (size_t i = 0; i + 2 < indexCount; i += 3) {
+		Quadric q = MakePlaneQuadric(vertices[indices[i]].position, vertices[indices[i + 1]].position, vertices[indices[i + 2]].position);
+		for (size_t k = 0; k < 3; ++k) {
+			AddQuadric(quadrics[positionIds[indices[i + k]]], q);
+		}
+	}
+
+	const double maxErrorSquared = static_cast<double>(maxError) * maxError;
+	std::vector<uint32_t> remap(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		remap[v] = static_cast<uint32_t>(v);
+	}
+	std::vector<bool> isTouched(vertexCount, false);
+	std::vector<uint32_t> adjacencyOffsets;
+	std::vector<uint32_t> adjacency;
+	std::vector<Collapse> collapses;
+
+	while (result.size() > targetIndexCount) {
+		const size_t triangleCount = result.size() / 3;
+
+		// 頂点ごとの周りの三角形
+		adjacencyOffsets.assign(vertexCount + 1, 0);
+		for (uint32_t vertex : result) {
+			++adjacencyOffsets[vertex + 1];
+		}
+		for (size_t v = 0; v < vertexCount; ++v) {
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+		adjacency.resize(result.size());
+		{
+			std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i) {
+				adjacency[cursor[result[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		// 辺ごとに両方向の候補を作り、誤差の小さい順に並べる
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); ++i) {
+			const uint32_t a = result[i];
+			const uint32_t b = result[i % 3 == 2 ? i - 2 : i + 1];
+			for (auto [from, to] : { std::pair{ a, b }, std::pair{ b, a } }) {
+				const uint32_t fromId = positionIds[from];
+				const uint32_t toId = positionIds[to];
+				if (isLocked[fromId] || fromId == toId) {
+					continue;
+				}
+				Quadric q = quadrics[fromId];
+				AddQuadric(q, quadrics[toId]);
+				const double error = EvaluateQuadric(q, vertices[to].position);
+				if (error <= maxErrorSquared) {
+					collapses.push_back({ from, to, error });
+				}
+			}
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+		// 互いに影響しない辺だけを1回分としてまとめてつぶす
+		std::fill(isTouched.begin(), isTouched.end(), false);
+		const size_t targetTriangleCount = targetIndexCount / 3;
+		size_t removedCount = 0;
+		size_t appliedCount = 0;
+		for (const Collapse& collapse : collapses) {
+			if (triangleCount - removedCount <= targetTriangleCount) {
+				break;
+			}
+			const uint32_t fromId = positionIds[collapse.from];
+			const uint32_t toId = positionIds[collapse.to];
+			if (isTouched[fromId] || isTouched[toId]) {
+				continue;
+			}
+
+			// 寄せた後に裏返る三角形があればやめる
+			bool isFlipped = false;
+			size_t sharedCount = 0;
+			const Vector4& target = vertices[collapse.to].position;
+			for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; ++a) {
+				const uint32_t* triangle = &result[adjacency[a] * 3];
+				if (positionIds[triangle[0]] == toId || positionIds[triangle[1]] == toId || positionIds[triangle[2]] == toId) {
+					++sharedCount;
+					continue;
+				}
+				Vector4 p[3] = { vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position };
+				Vector3 before = TriangleNormal(p[0], p[1], p[2]);
+				for (size_t k = 0; k < 3; ++k) {
+					if (triangle[k] == collapse.from) {
+						p[k] = target;
+					}
+				}
+				Vector3 after = TriangleNormal(p[0], p[1], p[2]);
+				if (Dot(before, after) <= 0.25f * Length(before) * Length(after)) {
+					isFlipped = true;
+					break;
+				}
+			}
+			if (isFlipped) {
+				continue;
+			}
+
+			// 周りの頂点もこの回は動かさない (裏返りの判定が崩れないように)
+			for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; ++a) {
+				const uint32_t* triangle = &result[adjacency[a] * 3];
+				for (size_t k = 0; k < 3; ++k) {
+					isTouched[positionIds[triangle[k]]] = true;
+				}
+			}
+			isTouched[toId] = true;
+
+			remap[collapse.from] = collapse.to;
+			AddQuadric(quadrics[toId], quadrics[fromId]);
+			appliedError = (std::max)(appliedError, collapse.error);
+			removedCount += sharedCount;
+			++appliedCount;
+		}
+		if (appliedCount == 0) {
+			break;
+		}
+
+		// 付け替えてつぶれた三角形を取り除く
+		size_t writeCount = 0;
+		for (size_t i = 0; i < result.size(); i += 3) {
+			const uint32_t v0 = remap[result[i]];
+			const uint32_t v1 = remap[result[i + 1]];
+			const uint32_t v2 = remap[result[i + 2]];
+			if (positionIds[v0] == positionIds[v1] || positionIds[v1] == positionIds[v2] || positionIds[v2] == positionIds[v0]) {
+				continue;
+			}
+			result[writeCount++] = v0;
+			result[writeCount++] = v1;
+			result[writeCount++] = v2;
+		}
+		result.resize(writeCount);
+		for (const Collapse& collapse : collapses) {
+			remap[collapse.from] = collapse.from;
+		}
+	}
+
+	if (resultError) {
+		*resultError = static_cast<float>(std::sqrt(appliedError));
+	}
+	std::copy(result.begin(), result.end(), destination);
+	return result.size();
+}
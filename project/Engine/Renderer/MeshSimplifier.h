@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "VertexData.h"
+
+/// <summary>
+/// 二次誤差(QEM, Garland 1997)で辺をつぶして三角形を減らす
+/// 頂点を隣の頂点に寄せるだけなので頂点バッファはそのまま使え、インデックスだけが変わる
+/// UVや法線の継ぎ目(同じ位置の別頂点)と穴の縁の頂点は動かさない
+/// </summary>
+/// <param name="destination">書き込み先 (indexCount個分の領域が必要)</param>
+/// <param name="indices">元のインデックス (3つで1三角形)</param>
+/// <param name="indexCount">インデックス数</param>
+/// <param name="vertices">頂点 (位置だけ使う)</param>
+/// <param name="vertexCount">頂点数</param>
+/// <param name="targetIndexCount">目標のインデックス数</param>
+/// <param name="maxError">許す誤差 (モデル空間の距離)</param>
+/// <param name="resultError">実際の誤差の書き込み先 (nullptrなら書き込まない)</param>
+/// <returns>書き込んだインデックス数 (目標に届かないこともある)</returns>
+size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const VertexData* vertices, size_t vertexCount,
+	size_t targetIndexCount, float maxError, float* resultError = nullptr);
@@ -0,0 +1,205 @@
+#include "MeshletBuilder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	Vector3 ToVector3(const Vector4& v) {
+		return { v.x, v.y, v.z };
+	}
+
+	float Dot(const Vector3& a, const Vector3& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	// メッシュレットの境界球とコーンを求める
+	MeshletBounds ComputeMeshletBounds(const ModelData& modelData, const Meshlet& meshlet) {
+		const uint32_t* vertexIds = modelData.meshletVertices.data() + meshlet.vertexOffset;
+		const uint8_t* triangles = modelData.meshletTriangles.data() + meshlet.triangleOffset;
+
+		MeshletBounds bounds{};
+		const Vector3 first = ToVector3(modelData.vertices[vertexIds[0]].position);
+		AABB aabb = { first, first };
+		for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+			const Vector4& p = modelData.vertices[vertexIds[i]].position;
+			aabb.min = { (std::min)(aabb.min.x, p.x), (std::min)(aabb.min.y, p.y), (std::min)(aabb.min.z, p.z) };
+			aabb.max = { (std::max)(aabb.max.x, p.x), (std::max)(aabb.max.y, p.y), (std::max)(aabb.max.z, p.z) };
+		}
+		bounds.sphere.center = Multiply(0.5f, Add(aabb.min, aabb.max));
+		for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+			const Vector3 p = ToVector3(modelData.vertices[vertexIds[i]].position);
+			bounds.sphere.radius = (std::max)(bounds.sphere.radius, Length(Subtract(p, bounds.sphere.center)));
+		}
+
+		// 三角形の法線 (左手系で時計回りが表なので e1×e2 が表向き)
+		std::vector<Vector3> normals;
+		normals.reserve(meshlet.triangleCount);
+		Vector3 axis = { 0.0f, 0.0f, 0.0f };
+		for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+			const Vector3 p0 = ToVector3(modelData.vertices[vertexIds[triangles[t * 3 + 0]]].position);
+			const Vector3 p1 = ToVector3(modelData.vertices[vertexIds[triangles[t * 3 + 1]]].position);
+			const Vector3 p2 = ToVector3(modelData.vertices[vertexIds[triangles[t * 3 + 2]]].position);
+			const Vector3 e1 = Subtract(p1, p0);
+			const Vector3 e2 = Subtract(p2, p0);
+			const Vector3 normal = { e1.y * e2.z - e1.z * e2.y, e1.z * e2.x - e1.x * e2.z, e1.x * e2.y - e1.y * e2.x };
+			const float length = Length(normal);
+			if (length == 0.0f) {
+				continue;
+			}
+			normals.push_back(Multiply(1.0f / length, normal));
+			axis = Add(axis, normals.back());
+		}
+
+		// 法線がばらばらなら裏面カリングはしない
+		const float axisLength = Length(axis);
+		if (normals.empty() || axisLength < 1e-6f) {
+			bounds.coneAxis = { 0.0f, 0.0f, 0.0f };
+			bounds.coneCutoff = -1.0f;
+			return bounds;
+		}
+		bounds.coneAxis = Multiply(1.0f / axisLength, axis);
+		bounds.coneCutoff = 1.0f;
+		for (const Vector3& normal : normals) {
+			bounds.coneCutoff = (std::min)(bounds.coneCutoff, Dot(bounds.coneAxis, normal));
+		}
+		return bounds;
+	}
+
+	// SubMesh1つ分のメッシュレットを作る
+	// インデックスはOptimizeModelで頂点キャッシュ向けに並べた順のまま触らない
+	void BuildSubMeshMeshlets(ModelData& modelData, SubMesh& subMesh) {
+		const size_t vertexCount = modelData.vertices.size();
+		const uint32_t* indices = modelData.indices.data() + subMesh.indexOffset;
+		const uint32_t triangleCount = subMesh.indexCount / 3;
+		subMesh.meshletOffset = static_cast<uint32_t>(modelData.meshlets.size());
+		subMesh.meshletCount = 0;
+		if (triangleCount == 0) {
+			return;
+		}
+
+		// 頂点ごとの周りの三角形
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+			++adjacencyOffsets[indices[i] + 1];
+		}
+		for (size_t v = 0; v < vertexCount; ++v) {
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		}
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		{
+			std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+				adjacency[cursor[indices[i]]++] = i / 3;
+			}
+		}
+
+		// 何番目のメッシュレットで使ったかの印 (0は未使用)
+		std::vector<uint32_t> vertexStamps(vertexCount, 0);
+		std::vector<uint8_t> localIndices(vertexCount, 0);
+		std::vector<uint32_t> candidateStamps(triangleCount, 0);
+		std::vector<bool> isEmitted(triangleCount, false);
+		std::vector<uint32_t> candidates;
+
+		uint32_t seed = 0;
+		uint32_t emittedCount = 0;
+		for (uint32_t stamp = 1; emittedCount < triangleCount; ++stamp) {
+			Meshlet meshlet{};
+			meshlet.vertexOffset = static_cast<uint32_t>(modelData.meshletVertices.size());
+			meshlet.triangleOffset = static_cast<uint32_t>(modelData.meshletTriangles.size());
+			candidates.clear();
+
+			auto addTriangle = [&](uint32_t triangle) {
+				isEmitted[triangle] = true;
+				++emittedCount;
+				++meshlet.triangleCount;
+				for (uint32_t k = 0; k < 3; ++k) {
+					const uint32_t vertex = indices[triangle * 3 + k];
+					if (vertexStamps[vertex] != stamp) {
+						vertexStamps[vertex] = stamp;
+						localIndices[vertex] = static_cast<uint8_t>(meshlet.vertexCount++);
+						modelData.meshletVertices.push_back(vertex);
+						// 新しい頂点につながる三角形を候補にする
+						for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a) {
+							const uint32_t neighbor = adjacency[a];
+							if (!isEmitted[neighbor] && candidateStamps[neighbor] != stamp) {
+								candidateStamps[neighbor] = stamp;
+								candidates.push_back(neighbor);
+							}
+						}
+					}
+					modelData.meshletTriangles.push_back(localIndices[vertex]);
+				}
+			};
+
+			// まだ使っていない最初の三角形から始める
+			while (isEmitted[seed]) {
+				++seed;
+			}
+			addTriangle(seed);
+
+			// 新しい頂点が一番少ない候補を足していく (同じなら元の並びで先のもの)
+			while (meshlet.triangleCount < kMeshletMaxTriangles) {
+				int64_t best = -1;
+				uint32_t bestNewCount = 4;
+				size_t writeCount = 0;
+				for (uint32_t triangle : candidates) {
+					if (isEmitted[triangle]) {
+						continue;
+					}
+					candidates[writeCount++] = triangle;
+					uint32_t newCount = 0;
+					for (uint32_t k = 0; k < 3; ++k) {
+						newCount += vertexStamps[indices[triangle * 3 + k]] != stamp;
+					}
+					if (meshlet.vertexCount + newCount > kMeshletMaxVertices) {
+						continue;
+					}
+					if (newCount < bestNewCount || (newCount == bestNewCount && triangle < best)) {
+						best = triangle;
+						bestNewCount = newCount;
+					}
+				}
+				candidates.resize(writeCount);
+				if (best < 0) {
+					break;
+				}
+				addTriangle(static_cast<uint32_t>(best));
+			}
+
+			modelData.meshlets.push_back(meshlet);
+			modelData.meshletBounds.push_back(ComputeMeshletBounds(modelData, meshlet));
+			++subMesh.meshletCount;
+		}
+	}
+}
+
+void BuildMeshlets(ModelData& modelData) {
+	modelData.meshlets.clear();
+	modelData.meshletBounds.clear();
+	modelData.meshletVertices.clear();
+	modelData.meshletTriangles.clear();
+	for (SubMesh& subMesh : modelData.subMeshes) {
+		BuildSubMeshMeshlets(modelData, subMesh);
+	}
+}
+
+bool IsMeshletVisible(const MeshletBounds& bounds, const Frustum& frustum, const Vector3& cameraPosition) {
+	if (!IsVisible(frustum, bounds.sphere)) {
+		return false;
+	}
+	if (bounds.coneCutoff <= 0.0f) {
+		return true;
+	}
+
+	// カメラから見た向きとコーンの軸の角度をφ、コーンの広がりをθとすると
+	// 距離×cos(φ+θ)が半径以上なら、球の中のどの点でもどの法線もカメラから遠ざかる向き
+	const Vector3 toCenter = Subtract(bounds.sphere.center, cameraPosition);
+	const float distance = Length(toCenter);
+	if (distance <= bounds.sphere.radius) {
+		return true;
+	}
+	const float cosPhi = Dot(toCenter, bounds.coneAxis) / distance;
+	const float sinPhi = std::sqrt((std::max)(1.0f - cosPhi * cosPhi, 0.0f));
+	const float cosTheta = bounds.coneCutoff;
+	const float sinTheta = std::sqrt((std::max)(1.0f - cosTheta * cosTheta, 0.0f));
+	return distance * (cosPhi * cosTheta - sinPhi * sinTheta) < bounds.sphere.radius;
+}
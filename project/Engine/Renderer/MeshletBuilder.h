@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include "ModelData.h"
+
+// メッシュレット1つあたりの上限 (メッシュシェーダーの出力の上限に合わせる)
+constexpr uint32_t kMeshletMaxVertices = 64;
+constexpr uint32_t kMeshletMaxTriangles = 124;
+
+/// <summary>
+/// SubMeshごとに三角形をメッシュレットに分け、境界球と法線の向きの範囲(コーン)を求める
+/// つながった三角形のうち新しい頂点が少ないものから順に足していく
+/// インデックスは並べ替えないので、OptimizeModelの後に呼んでも頂点キャッシュ向けの並びはそのまま残る
+/// メッシュレットごとに描く時はmeshletVertices/meshletTrianglesを使う
+/// </summary>
+/// <param name="modelData">メッシュレットを作るモデル (既にあるメッシュレットは作り直す)</param>
+void BuildMeshlets(ModelData& modelData);
+
+/// <summary>
+/// メッシュレットが見えるかどうか
+/// 視錐台の外にあるか、全部の三角形がカメラに裏を向けていれば見えない
+/// </summary>
+/// <param name="bounds">メッシュレットの境界</param>
+/// <param name="frustum">モデル空間の視錐台 (MakeFrustum(world * viewProjection)で作る)</param>
+/// <param name="cameraPosition">モデル空間のカメラの位置</param>
+/// <returns>見える可能性があればtrue</returns>
+bool IsMeshletVisible(const MeshletBounds& bounds, const Frustum& frustum, const Vector3& cameraPosition);
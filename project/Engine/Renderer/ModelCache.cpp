@@ -0,0 +1,317 @@
+#include "ModelCache.h"
+#include "ObjLoader.h"
+#include "MeshOptimizer.h"
+#include "MeshLod.h"
+#include "MeshletBuilder.h"
+#include "MappedFile.h"
+#include "Logger.h"
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <system_error>
+
+namespace {
+	constexpr uint32_t kModelCacheMagic = 0x4D324743; // "CG2M"
+	constexpr uint32_t kModelCacheVersion = 7;
+
+	// ファイルの同一性を確かめるための情報
+	struct FileStamp {
+		uint64_t size;
+		int64_t time;
+	};
+
+	// ファイルの先頭に置くヘッダー
+	// この後に 文字列 (mtlパス, マテリアルごとの名前とテクスチャパス), (16バイト境界),
+	// SubMesh, LOD, マテリアルの数値, 頂点, インデックス, メッシュレット, メッシュレットの境界, メッシュレットの頂点, メッシュレットの三角形 の順に並ぶ
+	struct ModelCacheHeader {
+		uint32_t magic;
+		uint32_t version;
+		FileStamp source; // objファイル
+		FileStamp material; // mtlファイル
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t materialCount;
+		uint32_t subMeshCount;
+		uint32_t stringBytes; // 文字列部分のバイト数
+		uint32_t lodCount;
+		uint32_t meshletCount;
+		uint32_t meshletVertexCount;
+		uint32_t meshletTriangleBytes;
+		uint32_t padding;
+		AABB bounds;
+		Sphere boundingSphere;
+	};
+
+	// 文字列部分の書き込み (長さ → 中身)
+	void AppendString(std::string& out, const std::string& str) {
+		uint32_t length = static_cast<uint32_t>(str.size());
+		out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+		out.append(str);
+	}
+
+	// 文字列部分の読み込み (範囲外ならfalse)
+	bool ReadString(const char*& p, const char* end, std::string& str) {
+		uint32_t length = 0;
+		if (end - p < static_cast<ptrdiff_t>(sizeof(length))) {
+			return false;
+		}
+		std::memcpy(&length, p, sizeof(length));
+		p += sizeof(length);
+		if (static_cast<size_t>(end - p) < length) {
+			return false;
+		}
+		str.assign(p, length);
+		p += length;
+		return true;
+	}
+
+	// ファイルが無ければサイズは0、日時は-1にする
+	FileStamp GetFileStamp(const std::string& path) {
+		if (path.empty()) {
+			return { 0, 0 };
+		}
+		std::error_code ec;
+		uint64_t size = std::filesystem::file_size(path, ec);
+		if (ec) {
+			return { 0, -1 };
+		}
+		auto time = std::filesystem::last_write_time(path, ec);
+		if (ec) {
+			return { 0, -1 };
+		}
+		return { size, static_cast<int64_t>(time.time_since_epoch().count()) };
+	}
+
+	bool operator==(const FileStamp& lhs, const FileStamp& rhs) {
+		return lhs.size == rhs.size && lhs.time == rhs.time;
+	}
+
+	constexpr size_t AlignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	size_t GetDataOffset(const ModelCacheHeader& header) {
+		return AlignUp(sizeof(ModelCacheHeader) + header.stringBytes, 16);
+	}
+
+	// objを読んでキャッシュに入れる前にLODを作って最適化する (効果をログに残す)
+	ModelData LoadOptimizedObjFile(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool) {
+		ModelData modelData = LoadObjFile(directoryPath, filename, threadPool);
+		GenerateLods(modelData);
+		uint32_t baseIndexCount = 0;
+		for (size_t i = 0; i < modelData.lods.size(); ++i) {
+			const MeshLod& lod = modelData.lods[i];
+			uint32_t indexCount = 0;
+			for (uint32_t s = 0; s < lod.subMeshCount; ++s) {
+				indexCount += modelData.subMeshes[lod.subMeshOffset + s].indexCount;
+			}
+			if (i == 0) {
+				baseIndexCount = indexCount;
+			}
+			// 三角形の無いモデルは割合を0%とする
+			const float ratio = baseIndexCount > 0 ? 100.0f * static_cast<float>(indexCount) / static_cast<float>(baseIndexCount) : 0.0f;
+			Logger::Write(std::format("{} LOD{}: 三角形 {} ({:.1f}%), 誤差 {:.5f}",
+				filename, i, indexCount / 3, ratio, lod.error));
+		}
+		VertexCacheStats before = AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+		OptimizeModel(modelData);
+
+		// メッシュレットは並べ替えた後の順で作る (詰まり具合も残す)
+		BuildMeshlets(modelData);
+
+		// キャッシュに書くインデックスの最終的な並びで効果を測る
+		VertexCacheStats after = AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+		Logger::Write(std::format("メッシュ最適化: {} ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+			filename, before.acmr, after.acmr, before.atvr, after.atvr));
+		if (!modelData.meshlets.empty()) {
+			const float meshletCount = static_cast<float>(modelData.meshlets.size());
+			Logger::Write(std::format("メッシュレット: {} {}個, 頂点 {:.1f}%, 三角形 {:.1f}%",
+				filename, modelData.meshlets.size(),
+				100.0f * static_cast<float>(modelData.meshletVertices.size()) / (meshletCount * kMeshletMaxVertices),
+				100.0f * static_cast<float>(modelData.meshletTriangles.size() / 3) / (meshletCount * kMeshletMaxTriangles)));
+		}
+		return modelData;
+	}
+}
+
+std::string GetModelCachePath(const std::string& directoryPath, const std::string& filename) {
+	return directoryPath + "/" + filename + ".mdlcache";
+}
+
+bool LoadModelCache(const std::string& cachePath, const std::string& sourcePath, ModelData& modelData) {
+	MappedFile file;
+	if (!file.Open(cachePath) || file.Size() < sizeof(ModelCacheHeader)) {
+		return false;
+	}
+
+	ModelCacheHeader header;
+	std::memcpy(&header, file.Data(), sizeof(header));
+	if (header.magic != kModelCacheMagic || header.version != kModelCacheVersion) {
+		return false;
+	}
+
+	// 元のファイルが変わっていたら使わない
+	if (!(header.source == GetFileStamp(sourcePath))) {
+		return false;
+	}
+
+	const size_t dataOffset = GetDataOffset(header);
+	const size_t subMeshBytes = sizeof(SubMesh) * header.subMeshCount;
+	const size_t lodBytes = sizeof(MeshLod) * header.lodCount;
+	const size_t materialParamsBytes = sizeof(MaterialParams) * header.materialCount;
+	const size_t vertexBytes = sizeof(VertexData) * header.vertexCount;
+	const size_t indexBytes = sizeof(uint32_t) * header.indexCount;
+	const size_t meshletBytes = sizeof(Meshlet) * header.meshletCount;
+	const size_t meshletBoundsBytes = sizeof(MeshletBounds) * header.meshletCount;
+	const size_t meshletVertexBytes = sizeof(uint32_t) * header.meshletVertexCount;
+	const size_t meshletTriangleBytes = header.meshletTriangleBytes;
+	if (file.Size() != dataOffset + subMeshBytes + lodBytes + materialParamsBytes + vertexBytes + indexBytes +
+		meshletBytes + meshletBoundsBytes + meshletVertexBytes + meshletTriangleBytes) {
+		return false;
+	}
+
+	const char* p = file.Data() + sizeof(ModelCacheHeader);
+	const char* stringEnd = p + header.stringBytes;
+	std::string materialLibraryPath;
+	if (!ReadString(p, stringEnd, materialLibraryPath) || !(header.material == GetFileStamp(materialLibraryPath))) {
+		return false;
+	}
+	std::vector<MaterialData> materials(header.materialCount);
+	for (MaterialData& material : materials) {
+		if (!ReadString(p, stringEnd, material.name)) {
+			return false;
+		}
+		for (auto path : kMaterialTexturePaths) {
+			if (!ReadString(p, stringEnd, material.*path)) {
+				return false;
+			}
+		}
+	}
+
+	// 中身はそのままの並びなのでコピーするだけ
+	const char* data = file.Data() + dataOffset;
+	modelData.materialLibraryPath = std::move(materialLibraryPath);
+	modelData.materials = std::move(materials);
+	modelData.subMeshes.resize(header.subMeshCount);
+	std::memcpy(modelData.subMeshes.data(), data, subMeshBytes);
+	data += subMeshBytes;
+	modelData.lods.resize(header.lodCount);
+	std::memcpy(modelData.lods.data(), data, lodBytes);
+	data += lodBytes;
+	for (MaterialData& material : modelData.materials) {
+		std::memcpy(&material.params, data, sizeof(MaterialParams));
+		data += sizeof(MaterialParams);
+	}
+	modelData.vertices.resize(header.vertexCount);
+	std::memcpy(modelData.vertices.data(), data, vertexBytes);
+	data += vertexBytes;
+	modelData.indices.resize(header.indexCount);
+	std::memcpy(modelData.indices.data(), data, indexBytes);
+	data += indexBytes;
+	modelData.meshlets.resize(header.meshletCount);
+	std::memcpy(modelData.meshlets.data(), data, meshletBytes);
+	data += meshletBytes;
+	modelData.meshletBounds.resize(header.meshletCount);
+	std::memcpy(modelData.meshletBounds.data(), data, meshletBoundsBytes);
+	data += meshletBoundsBytes;
+	modelData.meshletVertices.resize(header.meshletVertexCount);
+	std::memcpy(modelData.meshletVertices.data(), data, meshletVertexBytes);
+	data += meshletVertexBytes;
+	modelData.meshletTriangles.resize(header.meshletTriangleBytes);
+	std::memcpy(modelData.meshletTriangles.data(), data, meshletTriangleBytes);
+	modelData.bounds = header.bounds;
+	modelData.boundingSphere = header.boundingSphere;
+
+	return true;
+}
+
+bool SaveModelCache(const std::string& cachePath, const std::string& sourcePath, const ModelData& modelData) {
+	ModelCacheHeader header{};
+	header.magic = kModelCacheMagic;
+	header.version = kModelCacheVersion;
+	header.source = GetFileStamp(sourcePath);
+	header.material = GetFileStamp(modelData.materialLibraryPath);
+	header.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+	header.indexCount = static_cast<uint32_t>(modelData.indices.size());
+	header.materialCount = static_cast<uint32_t>(modelData.materials.size());
+	header.subMeshCount = static_cast<uint32_t>(modelData.subMeshes.size());
+	header.lodCount = static_cast<uint32_t>(modelData.lods.size());
+	header.meshletCount = static_cast<uint32_t>(modelData.meshlets.size());
+	header.meshletVertexCount = static_cast<uint32_t>(modelData.meshletVertices.size());
+	header.meshletTriangleBytes = static_cast<uint32_t>(modelData.meshletTriangles.size());
+	header.bounds = modelData.bounds;
+	header.boundingSphere = modelData.boundingSphere;
+
+	std::string strings;
+	AppendString(strings, modelData.materialLibraryPath);
+	for (const MaterialData& material : modelData.materials) {
+		AppendString(strings, material.name);
+		for (auto path : kMaterialTexturePaths) {
+			AppendString(strings, material.*path);
+		}
+	}
+	header.stringBytes = static_cast<uint32_t>(strings.size());
+
+	// 書きかけのファイルを読まないように一時ファイルに書いてから置き換える
+	const std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(strings.data(), strings.size());
+
+		const char padding[16] = {};
+		file.write(padding, GetDataOffset(header) - (sizeof(header) + strings.size()));
+
+		file.write(reinterpret_cast<const char*>(modelData.subMeshes.data()), sizeof(SubMesh) * modelData.subMeshes.size());
+		file.write(reinterpret_cast<const char*>(modelData.lods.data()), sizeof(MeshLod) * modelData.lods.size());
+		for (const MaterialData& material : modelData.materials) {
+			file.write(reinterpret_cast<const char*>(&material.params), sizeof(MaterialParams));
+		}
+
+		file.write(reinterpret_cast<const char*>(modelData.vertices.data()), sizeof(VertexData) * modelData.vertices.size());
+		file.write(reinterpret_cast<const char*>(modelData.indices.data()), sizeof(uint32_t) * modelData.indices.size());
+		file.write(reinterpret_cast<const char*>(modelData.meshlets.data()), sizeof(Meshlet) * modelData.meshlets.size());
+		file.write(reinterpret_cast<const char*>(modelData.meshletBounds.data()), sizeof(MeshletBounds) * modelData.meshletBounds.size());
+		file.write(reinterpret_cast<const char*>(modelData.meshletVertices.data()), sizeof(uint32_t) * modelData.meshletVertices.size());
+		file.write(reinterpret_cast<const char*>(modelData.meshletTriangles.data()), modelData.meshletTriangles.size());
+		if (!file.good()) {
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(tempPath, cachePath, ec);
+	if (ec) {
+		std::filesystem::remove(tempPath, ec);
+		return false;
+	}
+	return true;
+}
+
+ModelData LoadObjFileCached(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool) {
+	const std::string sourcePath = directoryPath + "/" + filename;
+	const std::string cachePath = GetModelCachePath(directoryPath, filename);
+
+	ModelData modelData;
+	if (LoadModelCache(cachePath, sourcePath, modelData)) {
+		return modelData;
+	}
+
+	modelData = LoadOptimizedObjFile(directoryPath, filename, threadPool);
+	if (SaveModelCache(cachePath, sourcePath, modelData)) {
+		Logger::Write("モデルキャッシュ作成: " + cachePath);
+	} else {
+		Logger::Write("モデルキャッシュ作成失敗: " + cachePath);
+	}
+	return modelData;
+}
+
+bool BakeModelCache(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool) {
+	ModelData modelData = LoadOptimizedObjFile(directoryPath, filename, threadPool);
+	return SaveModelCache(GetModelCachePath(directoryPath, filename), directoryPath + "/" + filename, modelData);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include "ModelData.h"
+
+class ThreadPool;
+
+// objファイルの読み込み結果をそのままの並びで保存したバイナリキャッシュ
+// キャッシュはobjファイルの隣に「ファイル名.mdlcache」として置く
+// obj/mtlのサイズと更新日時が変わっていたら使わずに作り直す
+// キャッシュに入れるモデルはGenerateLodsでLODを作り、OptimizeModelで頂点キャッシュ向けに並べ替え、BuildMeshletsでメッシュレットに分けておく
+
+// キャッシュファイルのパス
+std::string GetModelCachePath(const std::string& directoryPath, const std::string& filename);
+
+/// <summary>
+/// キャッシュを読み込む
+/// </summary>
+/// <param name="cachePath">キャッシュファイルのパス</param>
+/// <param name="sourcePath">元のobjファイルのパス</param>
+/// <param name="modelData">読み込み先</param>
+/// <returns>キャッシュが有効で読み込めたらtrue</returns>
+bool LoadModelCache(const std::string& cachePath, const std::string& sourcePath, ModelData& modelData);
+
+/// <summary>
+/// キャッシュを書き出す
+/// </summary>
+/// <param name="cachePath">キャッシュファイルのパス</param>
+/// <param name="sourcePath">元のobjファイルのパス</param>
+/// <param name="modelData">保存するモデル</param>
+/// <returns>書き出せたらtrue</returns>
+bool SaveModelCache(const std::string& cachePath, const std::string& sourcePath, const ModelData& modelData);
+
+/// <summary>
+/// objファイルをキャッシュ経由で読み込む
+/// 有効なキャッシュがあればそれを使い、無ければobjを読んでキャッシュを作る
+/// </summary>
+/// <param name="directoryPath">objファイルのあるディレクトリ</param>
+/// <param name="filename">objファイル名</param>
+/// <param name="threadPool">objを読む時に使うスレッドプール (nullptrなら呼び出しスレッドのみ)</param>
+/// <returns>モデルデータ</returns>
+ModelData LoadObjFileCached(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool = nullptr);
+
+/// <summary>
+/// objファイルを読み直してキャッシュを作り直す (事前にまとめて作っておく用)
+/// </summary>
+/// <param name="directoryPath">objファイルのあるディレクトリ</param>
+/// <param name="filename">objファイル名</param>
+/// <param name="threadPool">objを読む時に使うスレッドプール (nullptrなら呼び出しスレッドのみ)</param>
+/// <returns>書き出せたらtrue</returns>
+bool BakeModelCache(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool = nullptr);
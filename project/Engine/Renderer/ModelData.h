@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "VertexData.h"
+#include "Frustum.h"
+
+// マテリアルの数値部分 (mtlに無い項目はこの値のまま、キャッシュにはこのまま書く)
+struct MaterialParams {
+	Vector3 ambient = { 0.0f, 0.0f, 0.0f }; // Ka
+	Vector3 diffuse = { 1.0f, 1.0f, 1.0f }; // Kd
+	Vector3 specular = { 0.0f, 0.0f, 0.0f }; // Ks
+	Vector3 emissive = { 0.0f, 0.0f, 0.0f }; // Ke
+	float shininess = 0.0f; // Ns
+	float alpha = 1.0f; // d (Trの時は1 - Tr)
+	uint32_t illum = 2; // 照明モデルの番号
+};
+
+struct MaterialData {
+	std::string name; // mtlのnewmtlで付けられた名前
+	std::string textureFilePath; // map_Kd
+	std::string ambientTexturePath; // map_Ka
+	std::string specularTexturePath; // map_Ks
+	std::string emissiveTexturePath; // map_Ke
+	std::string shininessTexturePath; // map_Ns
+	std::string alphaTexturePath; // map_d
+	std::string bumpTexturePath; // map_Bump, bump, norm
+	MaterialParams params;
+};
+
+// テクスチャパスのメンバー (読み書きや比較で同じ並びを使う)
+inline constexpr std::string MaterialData::* kMaterialTexturePaths[] = {
+	&MaterialData::textureFilePath,
+	&MaterialData::ambientTexturePath,
+	&MaterialData::specularTexturePath,
+	&MaterialData::emissiveTexturePath,
+	&MaterialData::shininessTexturePath,
+	&MaterialData::alphaTexturePath,
+	&MaterialData::bumpTexturePath,
+};
+
+// 同じマテリアルで描画するインデックスの範囲
+struct SubMesh {
+	uint32_t indexOffset; // 開始インデックス
+	uint32_t indexCount; // インデックス数
+	uint32_t materialIndex; // ModelData::materialsの番号
+	uint32_t meshletOffset; // 開始メッシュレット (BuildMeshletsの後で有効)
+	uint32_t meshletCount; // メッシュレット数
+};
+
+// 頂点と三角形の数を絞った三角形のまとまり (カリングの単位、メッシュシェーダーの1グループ分)
+struct Meshlet {
+	uint32_t vertexOffset; // ModelData::meshletVerticesの開始
+	uint32_t vertexCount;
+	uint32_t triangleOffset; // ModelData::meshletTrianglesの開始 (3つで1三角形)
+	uint32_t triangleCount;
+};
+
+// メッシュレットのカリング用の情報
+struct MeshletBounds {
+	Sphere sphere; // 境界球
+	Vector3 coneAxis; // 法線の平均の向き
+	float coneCutoff; // 法線と平均の向きの最大の角度のcos (0以下なら裏面カリングしない)
+};
+
+// LODの1段階 (ModelData::subMeshesの中の範囲)
+struct MeshLod {
+	uint32_t subMeshOffset; // 開始SubMesh
+	uint32_t subMeshCount; // SubMesh数
+	float error; // 元の形からのずれ (モデル空間の距離)
+};
+
+// モデル関係の構造体
+// 頂点・インデックスはモデル全体(全LOD)で1つにまとめ、マテリアルごとにSubMeshで描き分ける
+struct ModelData {
+	std::vector<VertexData> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<MaterialData> materials;
+	std::vector<SubMesh> subMeshes; // LODの順に並び、LODの中ではマテリアルの順に1マテリアルにつき1つ
+	std::vector<MeshLod> lods; // 0番が元のメッシュ、後ろほど三角形が少ない
+	std::vector<Meshlet> meshlets; // SubMeshの順に並ぶ
+	std::vector<MeshletBounds> meshletBounds; // meshletsと同じ並び
+	std::vector<uint32_t> meshletVertices; // メッシュレットが使う頂点の番号
+	std::vector<uint8_t> meshletTriangles; // メッシュレット内の頂点の番号
+	std::string materialLibraryPath; // 参照しているmtlファイルのパス (無ければ空)
+	AABB bounds; // ローカル空間の境界ボックス
+	Sphere boundingSphere; // ローカル空間の境界球
+};
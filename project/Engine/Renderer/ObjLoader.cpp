@@ -0,0 +1,586 @@
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "TripletTable.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <utility>
+
+namespace {
+	using ObjDetail::TripletKey;
+	using ObjDetail::TripletTable;
+
+	// 省略されたインデックス
+	constexpr uint32_t kMissingIndex = UINT32_MAX;
+
+	// usemtlで切り替わったマテリアルの範囲
+	struct MaterialRange {
+		size_t cornerBegin; // 切り替わった位置 (cornersの番号)
+		std::string_view name; // マテリアル名
+	};
+
+	// objから読んだままのデータ
+	struct ObjRawData {
+		std::vector<Vector4> positions; // 位置
+		std::vector<Vector2> texcoords; // テクスチャ座標
+		std::vector<Vector3> normals; // 法線
+		std::vector<TripletKey> corners; // 三角形の頂点 (ファイルの順で3つずつ)
+		std::vector<MaterialRange> materialRanges; // usemtlの位置
+		std::string_view materialLibrary; // mtllibで指定されたファイル名
+	};
+
+	inline bool IsSpace(char c) {
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline const char* SkipSpaces(const char* p, const char* end) {
+		while (p < end && IsSpace(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	// 行末 ('\n'の位置かend)
+	inline const char* FindLineEnd(const char* p, const char* end) {
+		const void* found = std::memchr(p, '\n', static_cast<size_t>(end - p));
+		return found ? static_cast<const char*>(found) : end;
+	}
+
+	// 空白区切りのトークンを1つ読む
+	inline std::string_view ReadToken(const char*& p, const char* end) {
+		p = SkipSpaces(p, end);
+		const char* begin = p;
+		while (p < end && !IsSpace(*p)) {
+			++p;
+		}
+		return std::string_view(begin, static_cast<size_t>(p - begin));
+	}
+
+	// 行の残りを前後の空白を除いて読む (名前に空白を含められるもの用)
+	inline std::string_view ReadRestOfLine(const char* p, const char* end) {
+		p = SkipSpaces(p, end);
+		while (end > p && IsSpace(end[-1])) {
+			--end;
+		}
+		return std::string_view(p, static_cast<size_t>(end - p));
+	}
+
+	// 浮動小数を読む (読めなければ0)
+	inline float ReadFloat(const char*& p, const char* end) {
+		p = SkipSpaces(p, end);
+		if (p < end && *p == '+') {
+			++p;
+		}
+		float value = 0.0f;
+		auto [next, ec] = std::from_chars(p, end, value);
+		if (ec != std::errc()) {
+			ReadToken(p, end);
+			return 0.0f;
+		}
+		p = next;
+		return value;
+	}
+
+	// 1始まりのインデックスを読んで0始まりにする (省略されていればkMissingIndex)
+	inline uint32_t ReadIndex(const char*& p, const char* end) {
+		uint32_t value = 0;
+		auto [next, ec] = std::from_chars(p, end, value);
+		if (ec != std::errc() || value == 0) {
+			return kMissingIndex;
+		}
+		p = next;
+		return value - 1;
+	}
+
+	// 面の頂点 「位置/UV/法線」 を読む (UVと法線は省略可)
+	inline TripletKey ReadFaceVertex(const char*& p, const char* end) {
+		TripletKey key{ kMissingIndex, kMissingIndex, kMissingIndex };
+		key.v = ReadIndex(p, end);
+		if (p < end && *p == '/') {
+			++p;
+			key.vt = ReadIndex(p, end);
+			if (p < end && *p == '/') {
+				++p;
+				key.vn = ReadIndex(p, end);
+			}
+		}
+		// 読めなかった残りは飛ばす
+		while (p < end && !IsSpace(*p)) {
+			++p;
+		}
+		return key;
+	}
+
+	// 先頭2文字で行の種類を見分けて要素数を数え、配列を確保しておく
+	void ReserveRawData(const char* begin, const char* end, ObjRawData& raw) {
+		size_t positionCount = 0, texcoordCount = 0, normalCount = 0, faceCount = 0;
+		for (const char* p = begin; p < end;) {
+			const char* lineEnd = FindLineEnd(p, end);
+			p = SkipSpaces(p, lineEnd);
+			if (lineEnd - p >= 2) {
+				if (p[0] == 'v') {
+					if (IsSpace(p[1])) {
+						++positionCount;
+					} else if (p[1] == 't') {
+						++texcoordCount;
+					} else if (p[1] == 'n') {
+						++normalCount;
+					}
+				} else if (p[0] == 'f' && IsSpace(p[1])) {
+					++faceCount;
+				}
+			}
+			p = lineEnd + 1;
+		}
+
+		raw.positions.reserve(positionCount);
+		raw.texcoords.reserve(texcoordCount);
+		raw.normals.reserve(normalCount);
+		raw.corners.reserve(faceCount * 3);
+	}
+
+	// [begin, end) の行を読む
+	void ParseObjRange(const char* begin, const char* end, ObjRawData& raw) {
+		for (const char* p = begin; p < end;) {
+			const char* lineEnd = FindLineEnd(p, end);
+			std::string_view identifier = ReadToken(p, lineEnd); // 先頭の識別子を読む
+
+			if (identifier == "v") {
+				Vector4 position;
+				position.x = ReadFloat(p, lineEnd);
+				position.y = ReadFloat(p, lineEnd);
+				position.z = ReadFloat(p, lineEnd);
+				position.w = 1.0f;
+				raw.positions.push_back(position);
+			} else if (identifier == "vt") {
+				Vector2 texcoord;
+				texcoord.x = ReadFloat(p, lineEnd);
+				texcoord.y = ReadFloat(p, lineEnd);
+				raw.texcoords.push_back(texcoord);
+			} else if (identifier == "vn") {
+				Vector3 normal;
+				normal.x = ReadFloat(p, lineEnd);
+				normal.y = ReadFloat(p, lineEnd);
+				normal.z = ReadFloat(p, lineEnd);
+				raw.normals.push_back(normal);
+			} else if (identifier == "f") {
+				// 多角形は最初の頂点を中心に扇状に三角形へ分割する
+				TripletKey first{}, previous{};
+				int32_t vertexCount = 0;
+				while ((p = SkipSpaces(p, lineEnd)) < lineEnd) {
+					TripletKey key = ReadFaceVertex(p, lineEnd);
+					if (vertexCount == 0) {
+						first = key;
+					} else if (vertexCount >= 2) {
+						raw.corners.push_back(first);
+						raw.corners.push_back(previous);
+						raw.corners.push_back(key);
+					}
+					previous = key;
+					++vertexCount;
+				}
+			} else if (identifier == "usemtl") {
+				// 以降の面のマテリアルを切り替える
+				// o/gをまたいでも切り替わらないので、オブジェクトやグループの区切りは見なくて良い
+				raw.materialRanges.push_back({ raw.corners.size(), ReadRestOfLine(p, lineEnd) });
+			} else if (identifier == "mtllib") {
+				// materialTemplateLibraryファイルの名前を取得する
+				raw.materialLibrary = ReadToken(p, lineEnd);
+			}
+
+			p = lineEnd + 1;
+		}
+	}
+
+	// 分割して読む1区間分のデータ
+	struct ObjChunk {
+		const char* begin = nullptr;
+		const char* end = nullptr;
+		ObjRawData raw;
+		std::vector<TripletKey> uniqueKeys; // 区間内で初めて出てきた順の三つ組
+		std::vector<uint32_t> localIndices; // uniqueKeysへのインデックス
+		std::vector<uint32_t> remap; // uniqueKeysの番号 → モデル全体の頂点番号
+		size_t indexOffset = 0; // モデル全体のインデックス配列での開始位置
+	};
+
+	// 1区間の最小サイズ (これより小さいファイルは分割しない)
+	constexpr size_t kMinChunkBytes = 1 << 20;
+
+	// ファイルを行の境目で区間に分ける
+	std::vector<ObjChunk> SplitChunks(const char* begin, const char* end, size_t chunkCount) {
+		const size_t size = static_cast<size_t>(end - begin);
+		chunkCount = (std::max)(size_t(1), (std::min)(chunkCount, size / kMinChunkBytes));
+
+		std::vector<ObjChunk> chunks(chunkCount);
+		const char* chunkBegin = begin;
+		for (size_t i = 0; i < chunkCount; ++i) {
+			const char* chunkEnd = end;
+			if (i + 1 < chunkCount) {
+				const char* target = (std::max)(chunkBegin, begin + size * (i + 1) / chunkCount);
+				chunkEnd = FindLineEnd(target, end);
+				chunkEnd = chunkEnd < end ? chunkEnd + 1 : end;
+			}
+			chunks[i].begin = chunkBegin;
+			chunks[i].end = chunkEnd;
+			chunkBegin = chunkEnd;
+		}
+		return chunks;
+	}
+
+	// 区間内で三つ組の重複を除く (巻き順はここで反転する)
+	void DeduplicateChunk(ObjChunk& chunk) {
+		const std::vector<TripletKey>& corners = chunk.raw.corners;
+		chunk.localIndices.reserve(corners.size());
+		// 閉じた三角形メッシュなら頂点数は面数のおよそ半分
+		const size_t faceCount = corners.size() / 3;
+		chunk.uniqueKeys.reserve(faceCount / 2);
+
+		TripletTable lut(faceCount / 2);
+
+		for (size_t face = 0; face + 3 <= corners.size(); face += 3) {
+			// 左手系にするため巻き順を反転する
+			for (int order : {2, 1, 0}) {
+				const TripletKey& key = corners[face + order];
+				auto [index, isInserted] = lut.TryEmplace(key, static_cast<uint32_t>(chunk.uniqueKeys.size()));
+				if (isInserted) {
+					chunk.uniqueKeys.push_back(key);
+				}
+				chunk.localIndices.push_back(index);
+			}
+		}
+	}
+
+	// 頂点生成
+	VertexData MakeVertex(const ObjRawData& raw, const TripletKey& key) {
+		Vector4 p = key.v < raw.positions.size() ? raw.positions[key.v] : Vector4{ 0.0f, 0.0f, 0.0f, 1.0f };
+		Vector2 t = key.vt < raw.texcoords.size() ? raw.texcoords[key.vt] : Vector2{ 0.0f, 0.0f };
+		Vector3 n = key.vn < raw.normals.size() ? raw.normals[key.vn] : Vector3{ 0.0f, 0.0f, 0.0f };
+
+		p.x *= -1.0f;
+		t.y = 1.0f - t.y;
+		n.x *= -1.0f;
+
+		return { p, t, n };
+	}
+
+	// 区間ごとの結果をファイルの順にまとめてModelDataを作る
+	// 頂点番号は初めて出てきた順に振るので、区間の分け方によらず同じ結果になる
+	// 戻り値はインデックス配列上でのマテリアルの切り替わり位置
+	std::vector<MaterialRange> BuildModelData(std::vector<ObjChunk>& chunks, ModelData& modelData, ThreadPool* threadPool) {
+		auto parallelFor = [&](const std::function<void(size_t)>& func) {
+			if (threadPool && chunks.size() > 1) {
+				threadPool->ParallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+					for (size_t i = begin; i < end; ++i) {
+						func(i);
+					}
+				});
+			} else {
+				for (size_t i = 0; i < chunks.size(); ++i) {
+					func(i);
+				}
+			}
+		};
+
+		// 各区間を読む
+		parallelFor([&](size_t i) {
+			ReserveRawData(chunks[i].begin, chunks[i].end, chunks[i].raw);
+			ParseObjRange(chunks[i].begin, chunks[i].end, chunks[i].raw);
+		});
+
+		// 頂点要素はファイル全体の通し番号で参照されるので先頭の区間にまとめる
+		ObjRawData& raw = chunks[0].raw;
+		for (size_t i = 1; i < chunks.size(); ++i) {
+			ObjRawData& other = chunks[i].raw;
+			raw.positions.insert(raw.positions.end(), other.positions.begin(), other.positions.end());
+			raw.texcoords.insert(raw.texcoords.end(), other.texcoords.begin(), other.texcoords.end());
+			raw.normals.insert(raw.normals.end(), other.normals.begin(), other.normals.end());
+			if (!other.materialLibrary.empty()) {
+				raw.materialLibrary = other.materialLibrary;
+			}
+			other.positions = {};
+			other.texcoords = {};
+			other.normals = {};
+		}
+
+		parallelFor([&](size_t i) { DeduplicateChunk(chunks[i]); });
+
+		// 区間をまたいだ重複をファイルの順に除く
+		size_t indexCount = 0;
+		if (chunks.size() == 1) {
+			ObjChunk& chunk = chunks[0];
+			modelData.vertices.reserve(chunk.uniqueKeys.size());
+			for (const TripletKey& key : chunk.uniqueKeys) {
+				modelData.vertices.push_back(MakeVertex(raw, key));
+			}
+			modelData.indices = std::move(chunk.localIndices);
+			chunk.indexOffset = 0;
+		} else {
+			size_t uniqueCount = 0;
+			for (const ObjChunk& chunk : chunks) {
+				uniqueCount += chunk.uniqueKeys.size();
+			}
+			TripletTable lut(uniqueCount);
+			for (ObjChunk& chunk : chunks) {
+				chunk.remap.resize(chunk.uniqueKeys.size());
+				for (size_t k = 0; k < chunk.uniqueKeys.size(); ++k) {
+					const TripletKey& key = chunk.uniqueKeys[k];
+					auto [index, isInserted] = lut.TryEmplace(key, static_cast<uint32_t>(modelData.vertices.size()));
+					if (isInserted) {
+						modelData.vertices.push_back(MakeVertex(raw, key));
+					}
+					chunk.remap[k] = index;
+				}
+				chunk.indexOffset = indexCount;
+				indexCount += chunk.localIndices.size();
+			}
+
+			modelData.indices.resize(indexCount);
+			parallelFor([&](size_t i) {
+				const ObjChunk& chunk = chunks[i];
+				uint32_t* out = modelData.indices.data() + chunk.indexOffset;
+				for (size_t k = 0; k < chunk.localIndices.size(); ++k) {
+					out[k] = chunk.remap[chunk.localIndices[k]];
+				}
+			});
+		}
+
+		// マテリアルの範囲を全体の位置に直す
+		// 区間の先頭でusemtlが出てくるまでは前の区間のマテリアルが続く
+		std::vector<MaterialRange> ranges;
+		std::string_view currentName;
+		for (const ObjChunk& chunk : chunks) {
+			const std::vector<MaterialRange>& local = chunk.raw.materialRanges;
+			if (!chunk.raw.corners.empty() && (local.empty() || local.front().cornerBegin > 0)) {
+				ranges.push_back({ chunk.indexOffset, currentName });
+			}
+			for (const MaterialRange& range : local) {
+				ranges.push_back({ chunk.indexOffset + range.cornerBegin, range.name });
+				currentName = range.name;
+			}
+		}
+		return ranges;
+	}
+
+	// 色を読む (値が1つだけなら3つとも同じ値)
+	Vector3 ReadColor(const char*& p, const char* end) {
+		Vector3 color{};
+		color.x = ReadFloat(p, end);
+		if (SkipSpaces(p, end) == end) {
+			color.y = color.x;
+			color.z = color.x;
+			return color;
+		}
+		color.y = ReadFloat(p, end);
+		color.z = ReadFloat(p, end);
+		return color;
+	}
+
+	inline bool IsNumber(std::string_view token) {
+		float value = 0.0f;
+		auto [next, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+		return ec == std::errc() && next == token.data() + token.size();
+	}
+
+	// map_〇〇の 「-s 1 1 1」 のようなオプションを飛ばしてファイル名を読む
+	std::string_view ReadTextureFilename(const char* p, const char* end) {
+		for (;;) {
+			p = SkipSpaces(p, end);
+			if (p >= end || *p != '-') {
+				break;
+			}
+			std::string_view option = ReadToken(p, end);
+			// -o/-s/-tは数値を1～3個、-mmは2個、それ以外は1個取る
+			const bool isVector = option == "-o" || option == "-s" || option == "-t";
+			const size_t argumentCount = isVector ? 3 : (option == "-mm" ? 2 : 1);
+			for (size_t i = 0; i < argumentCount; ++i) {
+				const char* next = p;
+				std::string_view argument = ReadToken(next, end);
+				if (argument.empty() || (isVector && !IsNumber(argument))) {
+					break;
+				}
+				p = next;
+			}
+		}
+		return ReadRestOfLine(p, end);
+	}
+
+	// テクスチャを指定する命令と入れ先
+	struct TextureKey {
+		std::string_view identifier;
+		std::string MaterialData::* path;
+	};
+
+	constexpr TextureKey kTextureKeys[] = {
+		{ "map_Kd", &MaterialData::textureFilePath },
+		{ "map_Ka", &MaterialData::ambientTexturePath },
+		{ "map_Ks", &MaterialData::specularTexturePath },
+		{ "map_Ke", &MaterialData::emissiveTexturePath },
+		{ "map_Ns", &MaterialData::shininessTexturePath },
+		{ "map_d", &MaterialData::alphaTexturePath },
+		{ "map_Bump", &MaterialData::bumpTexturePath },
+		{ "map_bump", &MaterialData::bumpTexturePath },
+		{ "bump", &MaterialData::bumpTexturePath },
+		{ "norm", &MaterialData::bumpTexturePath },
+	};
+
+	// 名前からマテリアル番号を引く (mtlに無い名前は追加する)
+	uint32_t FindMaterialIndex(std::vector<MaterialData>& materials, std::string_view name) {
+		for (size_t i = 0; i < materials.size(); ++i) {
+			if (materials[i].name == name) {
+				return static_cast<uint32_t>(i);
+			}
+		}
+		MaterialData material;
+		material.name = std::string(name);
+		materials.push_back(std::move(material));
+		return static_cast<uint32_t>(materials.size() - 1);
+	}
+
+	// インデックスをマテリアルの順に並べ替えてSubMeshを作る
+	void BuildSubMeshes(const std::vector<MaterialRange>& ranges, ModelData& modelData) {
+		const size_t indexCount = modelData.indices.size();
+		if (indexCount == 0) {
+			return;
+		}
+
+		// 範囲ごとのマテリアル番号 (usemtlが無ければ先頭のマテリアル)
+		std::vector<uint32_t> rangeMaterials(ranges.size());
+		for (size_t i = 0; i < ranges.size(); ++i) {
+			rangeMaterials[i] = (ranges[i].name.empty() && !modelData.materials.empty())
+				? 0 : FindMaterialIndex(modelData.materials, ranges[i].name);
+		}
+		if (modelData.materials.empty()) {
+			modelData.materials.push_back({});
+		}
+
+		// マテリアルごとのインデックス数
+		const size_t materialCount = modelData.materials.size();
+		std::vector<size_t> counts(materialCount, 0);
+		auto rangeEnd = [&](size_t i) { return i + 1 < ranges.size() ? ranges[i + 1].cornerBegin : indexCount; };
+		size_t head = ranges.empty() ? indexCount : ranges.front().cornerBegin;
+		counts[0] += head;
+		for (size_t i = 0; i < ranges.size(); ++i) {
+			counts[rangeMaterials[i]] += rangeEnd(i) - ranges[i].cornerBegin;
+		}
+
+		// マテリアルの順に詰め直す (同じマテリアル内はファイルの順のまま)
+		std::vector<size_t> offsets(materialCount, 0);
+		for (size_t m = 1; m < materialCount; ++m) {
+			offsets[m] = offsets[m - 1] + counts[m - 1];
+		}
+		for (size_t m = 0; m < materialCount; ++m) {
+			if (counts[m] > 0) {
+				modelData.subMeshes.push_back({ static_cast<uint32_t>(offsets[m]), static_cast<uint32_t>(counts[m]), static_cast<uint32_t>(m), 0, 0 });
+			}
+		}
+
+		// 1マテリアルだけなら並べ替え不要
+		if (modelData.subMeshes.size() == 1) {
+			return;
+		}
+
+		std::vector<uint32_t> sorted(indexCount);
+		auto copyRange = [&](size_t begin, size_t end, uint32_t material) {
+			std::copy(modelData.indices.begin() + begin, modelData.indices.begin() + end, sorted.begin() + offsets[material]);
+			offsets[material] += end - begin;
+		};
+		copyRange(0, head, 0);
+		for (size_t i = 0; i < ranges.size(); ++i) {
+			copyRange(ranges[i].cornerBegin, rangeEnd(i), rangeMaterials[i]);
+		}
+		modelData.indices = std::move(sorted);
+	}
+}
+
+std::vector<MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
+	std::vector<MaterialData> materials; // 構築するMaterialData
+	MappedFile file;
+	bool isOpened = file.Open(directoryPath + "/" + filename); // ファイルを開く
+	assert(isOpened); // 開けなかったら止める
+	(void)isOpened;
+
+	const char* end = file.Data() + file.Size();
+	for (const char* p = file.Data(); p < end;) {
+		const char* lineEnd = FindLineEnd(p, end);
+		std::string_view identifier = ReadToken(p, lineEnd);
+
+		// identifierに応じた処理 (newmtlより前の行は無視する)
+		if (identifier == "newmtl") {
+			MaterialData materialData;
+			materialData.name = std::string(ReadRestOfLine(p, lineEnd));
+			materials.push_back(std::move(materialData));
+		} else if (!materials.empty() && !identifier.empty()) {
+			MaterialParams& params = materials.back().params;
+			if (identifier == "Ka") {
+				params.ambient = ReadColor(p, lineEnd);
+			} else if (identifier == "Kd") {
+				params.diffuse = ReadColor(p, lineEnd);
+			} else if (identifier == "Ks") {
+				params.specular = ReadColor(p, lineEnd);
+			} else if (identifier == "Ke") {
+				params.emissive = ReadColor(p, lineEnd);
+			} else if (identifier == "Ns") {
+				params.shininess = ReadFloat(p, lineEnd);
+			} else if (identifier == "d") {
+				params.alpha = ReadFloat(p, lineEnd);
+			} else if (identifier == "Tr") {
+				params.alpha = 1.0f - ReadFloat(p, lineEnd);
+			} else if (identifier == "illum") {
+				std::string_view token = ReadToken(p, lineEnd);
+				std::from_chars(token.data(), token.data() + token.size(), params.illum);
+			} else {
+				for (const TextureKey& key : kTextureKeys) {
+					if (identifier == key.identifier) {
+						std::string_view textureFilename = ReadTextureFilename(p, lineEnd);
+						// 連結してファイルパスにする
+						if (!textureFilename.empty()) {
+							materials.back().*key.path = directoryPath + "/" + std::string(textureFilename);
+						}
+						break;
+					}
+				}
+			}
+		}
+
+		p = lineEnd + 1;
+	}
+
+	return materials;
+}
+
+ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool) {
+	ModelData modelData;
+	MappedFile file;
+	bool isOpened = file.Open(directoryPath + "/" + filename); // ファイルを開く
+	assert(isOpened);
+	(void)isOpened;
+
+	const char* begin = file.Data();
+	const char* end = begin + file.Size();
+
+	// スレッドプールがあればファイルを分割して並列に読む
+	size_t chunkCount = threadPool ? (threadPool->GetThreadCount() + 1) * 4 : 1;
+	std::vector<ObjChunk> chunks = SplitChunks(begin, end, chunkCount);
+	std::vector<MaterialRange> materialRanges = BuildModelData(chunks, modelData, threadPool);
+
+	const ObjRawData& raw = chunks[0].raw;
+	if (!raw.materialLibrary.empty()) {
+		// 基本的にobjファイルと同一層にmtlは存在させるので、ディレクトリ名とファイル名を残す
+		modelData.materialLibraryPath = directoryPath + "/" + std::string(raw.materialLibrary);
+		modelData.materials = LoadMaterialTemplateFile(directoryPath, std::string(raw.materialLibrary));
+	}
+
+	// マテリアルごとの描画範囲を作る
+	BuildSubMeshes(materialRanges, modelData);
+	modelData.lods.push_back({ 0, static_cast<uint32_t>(modelData.subMeshes.size()), 0.0f });
+
+	// カリング用の境界を求めておく
+	modelData.bounds = MakeAABB(modelData.vertices.data(), modelData.vertices.size(), sizeof(VertexData));
+	modelData.boundingSphere = MakeSphere(modelData.bounds);
+
+	return modelData;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+#include "ModelData.h"
+
+class ThreadPool;
+
+/// <summary>
+/// mtlファイルを読み込む
+/// objと同じくファイルをメモリにマップして直接読む
+/// Ka/Kd/Ks/Ke/Ns/d/Tr/illumとmap_〇〇(オプションは読み飛ばす)に対応し、それ以外の行は無視する
+/// </summary>
+/// <param name="directoryPath">mtlファイルのあるディレクトリ</param>
+/// <param name="filename">mtlファイル名</param>
+/// <returns>newmtlの順に並んだマテリアルデータ</returns>
+std::vector<MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
+
+/// <summary>
+/// objファイルを読み込む
+/// ファイルをメモリにマップし、行ごとの文字列を作らずに直接数値を読む
+/// 右手系から左手系への変換(X反転・V反転・巻き順反転)も行う
+/// スレッドプールを渡すと行の境目で分割して並列に読む (結果は1スレッドの時と同じ)
+/// インデックスはusemtlのマテリアルごとにまとめて並べ替え、SubMeshに範囲を入れる
+/// </summary>
+/// <param name="directoryPath">objファイルのあるディレクトリ</param>
+/// <param name="filename">objファイル名</param>
+/// <param name="threadPool">並列読み込みに使うスレッドプール (nullptrなら呼び出しスレッドのみ)</param>
+/// <returns>モデルデータ</returns>
+ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool = nullptr);
@@ -0,0 +1,176 @@
+#include "PackedVertex.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+	constexpr float kUnorm16Max = 65535.0f;
+	constexpr float kSnorm16Max = 32767.0f;
+
+	// AABBの1軸の大きさ (潰れている軸は0で割らないように0を返す)
+	float GetExtent(float min, float max) {
+		return max > min ? max - min : 0.0f;
+	}
+
+	uint16_t QuantizeUnorm16(float value, float min, float extent) {
+		if (extent == 0.0f) {
+			return 0;
+		}
+		float normalized = (std::clamp)((value - min) / extent, 0.0f, 1.0f);
+		return static_cast<uint16_t>(std::lround(normalized * kUnorm16Max));
+	}
+
+	int16_t QuantizeSnorm16(float value) {
+		return static_cast<int16_t>(std::lround((std::clamp)(value, -1.0f, 1.0f) * kSnorm16Max));
+	}
+
+	// 0を正とみなした符号
+	float SignNotZero(float value) {
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+}
+
+uint16_t FloatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = (bits >> 16) & 0x8000u;
+	const uint32_t exponent = (bits >> 23) & 0xFFu;
+	uint32_t mantissa = bits & 0x7FFFFFu;
+
+	// NaN・無限大
+	if (exponent == 0xFFu) {
+		return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+	}
+
+	const int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+	// 大きすぎる値は無限大
+	if (halfExponent >= 0x1F) {
+		return static_cast<uint16_t>(sign | 0x7C00u);
+	}
+	// 非正規化数 (小さすぎる値は0)
+	if (halfExponent <= 0) {
+		if (halfExponent < -10) {
+			return static_cast<uint16_t>(sign);
+		}
+		mantissa |= 0x800000u;
+		const uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+		uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+		const uint32_t halfway = 1u << (shift - 1u);
+		if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+			++half;
+		}
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	// 正規化数 (繰り上がりで指数が増えても正しい並びになる)
+	uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+	const uint32_t remainder = mantissa & 0x1FFFu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+		++half;
+	}
+	return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t value) {
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1Fu;
+	uint32_t mantissa = value & 0x3FFu;
+
+	uint32_t bits;
+	if (exponent == 0x1Fu) {
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	} else if (exponent != 0) {
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	} else if (mantissa == 0) {
+		bits = sign;
+	} else {
+		// 非正規化数は正規化し直す
+		uint32_t shiftedExponent = 127 - 15 + 1;
+		while ((mantissa & 0x400u) == 0) {
+			mantissa <<= 1;
+			--shiftedExponent;
+		}
+		bits = sign | (shiftedExponent << 23) | ((mantissa & 0x3FFu) << 13);
+	}
+
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]) {
+	const float length = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	if (length == 0.0f) {
+		encoded[0] = 0;
+		encoded[1] = 0;
+		return;
+	}
+
+	float x = normal.x / length;
+	float y = normal.y / length;
+	if (normal.z < 0.0f) {
+		const float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		const float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+	encoded[0] = QuantizeSnorm16(x);
+	encoded[1] = QuantizeSnorm16(y);
+}
+
+Vector3 DecodeOctahedral(const int16_t encoded[2]) {
+	// シェーダーのSNORMと同じく-32768は-1にする
+	const float x = (std::max)(static_cast<float>(encoded[0]) / kSnorm16Max, -1.0f);
+	const float y = (std::max)(static_cast<float>(encoded[1]) / kSnorm16Max, -1.0f);
+
+	Vector3 normal = { x, y, 1.0f - std::fabs(x) - std::fabs(y) };
+	const float fold = (std::max)(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+	return Normalize(normal);
+}
+
+PackedVertex PackVertex(const VertexData& vertex, const AABB& bounds) {
+	PackedVertex packed{};
+	packed.position[0] = QuantizeUnorm16(vertex.position.x, bounds.min.x, GetExtent(bounds.min.x, bounds.max.x));
+	packed.position[1] = QuantizeUnorm16(vertex.position.y, bounds.min.y, GetExtent(bounds.min.y, bounds.max.y));
+	packed.position[2] = QuantizeUnorm16(vertex.position.z, bounds.min.z, GetExtent(bounds.min.z, bounds.max.z));
+	packed.position[3] = UINT16_MAX;
+	packed.texcoord[0] = FloatToHalf(vertex.texcoord.x);
+	packed.texcoord[1] = FloatToHalf(vertex.texcoord.y);
+	EncodeOctahedral(vertex.normal, packed.normal);
+	return packed;
+}
+
+VertexData UnpackVertex(const PackedVertex& vertex, const AABB& bounds) {
+	VertexData unpacked{};
+	unpacked.position.x = bounds.min.x + static_cast<float>(vertex.position[0]) / kUnorm16Max * GetExtent(bounds.min.x, bounds.max.x);
+	unpacked.position.y = bounds.min.y + static_cast<float>(vertex.position[1]) / kUnorm16Max * GetExtent(bounds.min.y, bounds.max.y);
+	unpacked.position.z = bounds.min.z + static_cast<float>(vertex.position[2]) / kUnorm16Max * GetExtent(bounds.min.z, bounds.max.z);
+	unpacked.position.w = 1.0f;
+	unpacked.texcoord.x = HalfToFloat(vertex.texcoord[0]);
+	unpacked.texcoord.y = HalfToFloat(vertex.texcoord[1]);
+	unpacked.normal = DecodeOctahedral(vertex.normal);
+	return unpacked;
+}
+
+std::vector<PackedVertex> PackVertices(const std::vector<VertexData>& vertices, const AABB& bounds) {
+	std::vector<PackedVertex> packed(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		packed[i] = PackVertex(vertices[i], bounds);
+	}
+	return packed;
+}
+
+Matrix4x4 MakeDequantizeMatrix(const AABB& bounds) {
+	Matrix4x4 matrix = MakeScaleMatrix({
+		GetExtent(bounds.min.x, bounds.max.x),
+		GetExtent(bounds.min.y, bounds.max.y),
+		GetExtent(bounds.min.z, bounds.max.z),
+	});
+	matrix.m[3][0] = bounds.min.x;
+	matrix.m[3][1] = bounds.min.y;
+	matrix.m[3][2] = bounds.min.z;
+	return matrix;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "VertexData.h"
+#include "Frustum.h"
+
+// 圧縮した頂点データ (16バイト、VertexDataの36バイトの半分以下)
+// InputLayout::CreateInputLayout3DPackedとObject3dPacked.VS.hlslの入力と同じ並び
+struct PackedVertex {
+	uint16_t position[4]; // メッシュのAABB内の位置を0～65535にしたもの (wは常に65535 = 1.0)
+	uint16_t texcoord[2]; // 半精度浮動小数点数
+	int16_t normal[2]; // 八面体写像した法線 (-32767～32767)
+};
+static_assert(sizeof(PackedVertex) == 16);
+
+// 単精度→半精度 (最近接偶数丸め)
+uint16_t FloatToHalf(float value);
+
+// 半精度→単精度
+float HalfToFloat(uint16_t value);
+
+/// <summary>
+/// 単位ベクトルを八面体写像で2成分にする
+/// </summary>
+/// <param name="normal">法線 (長さ0なら(0,0,1)として扱う)</param>
+/// <param name="encoded">書き込み先 (-32767～32767の2成分)</param>
+void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]);
+
+// 八面体写像した法線を元に戻す (正規化済み)
+Vector3 DecodeOctahedral(const int16_t encoded[2]);
+
+/// <summary>
+/// 頂点を圧縮する
+/// </summary>
+/// <param name="vertex">元の頂点 (position.wは1とみなす)</param>
+/// <param name="bounds">メッシュ全体のAABB (位置の量子化の範囲)</param>
+/// <returns>圧縮した頂点</returns>
+PackedVertex PackVertex(const VertexData& vertex, const AABB& bounds);
+
+// 圧縮した頂点を元に戻す
+VertexData UnpackVertex(const PackedVertex& vertex, const AABB& bounds);
+
+// 頂点をまとめて圧縮する
+std::vector<PackedVertex> PackVertices(const std::vector<VertexData>& vertices, const AABB& bounds);
+
+/// <summary>
+/// 量子化した位置(0～1)をAABBの中の位置に戻す行列
+/// ワールド行列の前に掛けてWVPに含めれば、シェーダーで位置を戻す計算がいらない
+/// </summary>
+/// <param name="bounds">量子化に使ったAABB</param>
+/// <returns>スケールと平行移動の行列</returns>
+Matrix4x4 MakeDequantizeMatrix(const AABB& bounds);
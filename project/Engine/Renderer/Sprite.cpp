@@ -1,5 +1,6 @@
 #include "Sprite.h"
 #include "SpriteCommon.h"
+#include <algorithm>
 
 void Sprite::Init() {
 	cmdList_ = Graphics::GetCmdList();
@@ -126,18 +127,31 @@ void Sprite::Update()
 	materialData->uvTransform = uvTransformMatrix;
 
 	// Sprite用のWorldViewProjectionMatrixを作る
+	// ビュー行列は単位行列なので掛けずに済ませ、射影行列は画面サイズが変わった時だけ作り直す
+	if (width != projectionWidth_ || height != projectionHeight_) {
+		projectionMatrix_ = MakeOrthographicMatrix(0.0f, 0.0f, float(width), float(height), 0.1f, 100.0f);
+		projectionWidth_ = width;
+		projectionHeight_ = height;
+	}
 	Matrix4x4 worldMatrix = MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
-	Matrix4x4 viewMatrix = MakeIdentity4x4();
-	Matrix4x4 projectionMatrix = MakeOrthographicMatrix(0.0f, 0.0f, float(width), float(height), 0.1f, 100.0f);
-	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, Multiply(viewMatrix, projectionMatrix));
+	Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, projectionMatrix_);
 	transformationMatrixData->World = worldMatrix;
 	transformationMatrixData->WVP = worldViewProjectionMatrix;
+
+	// 画面外なら描画しない
+	AABB screenRect = TransformAABB({ { (std::min)(left, right), (std::min)(top, bottom), 0.0f }, { (std::max)(left, right), (std::max)(top, bottom), 0.0f } }, worldMatrix);
+	isVisible_ = screenRect.max.x >= 0.0f && screenRect.min.x <= float(width) &&
+		screenRect.max.y >= 0.0f && screenRect.min.y <= float(height);
 }
 
 void Sprite::Draw()
 {
 	assert(textureSrvHandleGPU_.ptr != 0 && "Sprite texture not set!");
 
+	if (!isVisible_) {
+		return;
+	}
+
 	cmdList_->IASetVertexBuffers(0, 1, &vertexBufferView); // VBVを設定
 
 	cmdList_->IASetIndexBuffer(&indexBufferView);// IBV設定
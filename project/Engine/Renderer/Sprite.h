@@ -5,6 +5,8 @@
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix.h"
+#include "Frustum.h"
+#include "VertexData.h"
 #include "Graphics.h"
 #include "TextureManager.h"
 #include "Color.h"
@@ -17,12 +19,6 @@ struct Transform {
 	Vector3 translate;
 };
 
-struct VertexData {
-	Vector4 position;
-	Vector2 texcoord;
-	Vector3 normal;
-};
-
 struct Material {
 	Vector4 color;
 	uint32_t enableLighting;
@@ -60,6 +56,8 @@ public:
 	const Vector2& GetAnchorPoint() const { return anchorPoint_; }
 	bool GetFlipX() const { return isFlipX_; }
 	bool GetFlipY() const { return isFlipY_; }
+	// 最後のUpdateで画面内にあったか
+	bool IsVisible() const { return isVisible_; }
 	const Vector2& GetTextureLeftTop() const { return textureLeftTop_; }
 	const Vector2& GetTextureSize() const { return textureSize_; }
 
@@ -130,6 +128,14 @@ private:
 	// テクスチャ番号
 	uint32_t textureIndex_ = 0;
 
+	// 正射影行列のキャッシュ (作成時の画面サイズ)
+	Matrix4x4 projectionMatrix_ = MakeIdentity4x4();
+	uint32_t projectionWidth_ = 0;
+	uint32_t projectionHeight_ = 0;
+
+	// 画面内にあるか (画面外ならDrawを省略する)
+	bool isVisible_ = true;
+
 	// テクスチャサイズをイメージに合わせる
 	void AdjustTextureSize();
 };
@@ -0,0 +1,108 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// objの頂点の重複除去に使う表 (ObjLoader.cppの中だけで使う)
+// std::unordered_mapと比べるベンチマークのためにヘッダーに出している
+
+namespace ObjDetail {
+	// 三つ組のキー
+	struct TripletKey {
+		uint32_t v, vt, vn;
+		bool operator == (const TripletKey&) const = default;
+	};
+
+	// 三つ組を64bitにまとめてからかき混ぜる (近い番号どうしでも散らばるように)
+	inline uint64_t HashTriplet(const TripletKey& k) {
+		uint64_t h = (static_cast<uint64_t>(k.v) << 32 | k.vt) ^ (static_cast<uint64_t>(k.vn) * 0x9e3779b97f4a7c15ULL);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return h;
+	}
+
+	// 三つ組 → 頂点番号の表 (オープンアドレス法、線形探索)
+	// キーと値を1つの配列に並べるので、追加のたびにメモリを確保しない
+	class TripletTable {
+	public:
+		// expectedCountは入りそうな要素数の見込み (超えたら広げる)
+		explicit TripletTable(size_t expectedCount) {
+			size_t capacity = 16;
+			while (capacity < expectedCount * 2) {
+				capacity *= 2;
+			}
+			slots_.resize(capacity, Slot{ {}, kEmpty });
+			mask_ = capacity - 1;
+		}
+
+		// 無ければvalueで追加する。戻り値は表の値と追加したかどうか
+		std::pair<uint32_t, bool> TryEmplace(const TripletKey& key, uint32_t value) {
+			assert(value != kEmpty);
+			// 使用率を1/2以下に保つ
+			if ((count_ + 1) * 2 > slots_.size()) {
+				Grow();
+			}
+			size_t i = static_cast<size_t>(HashTriplet(key)) & mask_;
+			while (slots_[i].value != kEmpty) {
+				if (slots_[i].key == key) {
+					return { slots_[i].value, false };
+				}
+				i = (i + 1) & mask_;
+			}
+			slots_[i] = { key, value };
+			++count_;
+			return { value, true };
+		}
+
+		// 値を探す (無ければnullptr)
+		const uint32_t* Find(const TripletKey& key) const {
+			size_t i = static_cast<size_t>(HashTriplet(key)) & mask_;
+			while (slots_[i].value != kEmpty) {
+				if (slots_[i].key == key) {
+					return &slots_[i].value;
+				}
+				i = (i + 1) & mask_;
+			}
+			return nullptr;
+		}
+
+		// 入っている要素数
+		size_t Size() const { return count_; }
+
+		// 確保しているメモリ (バイト)
+		size_t GetMemoryBytes() const { return slots_.capacity() * sizeof(Slot); }
+
+	private:
+		static constexpr uint32_t kEmpty = UINT32_MAX;
+
+		struct Slot {
+			TripletKey key;
+			uint32_t value;
+		};
+
+		void Grow() {
+			std::vector<Slot> old = std::move(slots_);
+			slots_.assign(old.size() * 2, Slot{ {}, kEmpty });
+			mask_ = slots_.size() - 1;
+			for (const Slot& slot : old) {
+				if (slot.value == kEmpty) {
+					continue;
+				}
+				size_t i = static_cast<size_t>(HashTriplet(slot.key)) & mask_;
+				while (slots_[i].value != kEmpty) {
+					i = (i + 1) & mask_;
+				}
+				slots_[i] = slot;
+			}
+		}
+
+		std::vector<Slot> slots_;
+		size_t mask_ = 0;
+		size_t count_ = 0;
+	};
+}
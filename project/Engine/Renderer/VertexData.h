@@ -0,0 +1,11 @@
+#pragma once
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+// 頂点データ (Object3d/Object2dシェーダーの入力と同じ並び)
+struct VertexData {
+	Vector4 position;
+	Vector2 texcoord;
+	Vector3 normal;
+};
@@ -0,0 +1,135 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other) {
+		Close();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		isOpen_ = std::exchange(other.isOpen_, false);
+#ifdef _WIN32
+		fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+		mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#else
+		fileDescriptor_ = std::exchange(other.fileDescriptor_, -1);
+#endif
+	}
+	return *this;
+}
+
+bool MappedFile::Open(const std::string& filePath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle_ = file;
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+	isOpen_ = true;
+
+	// 空のファイルはマップできないので開いただけにする
+	if (size_ == 0) {
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		Close();
+		return false;
+	}
+	mappingHandle_ = mapping;
+
+	data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (data_ == nullptr) {
+		Close();
+		return false;
+	}
+#else
+	int fd = open(filePath.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat status {};
+	if (fstat(fd, &status) != 0) {
+		close(fd);
+		return false;
+	}
+	fileDescriptor_ = fd;
+	size_ = static_cast<size_t>(status.st_size);
+	isOpen_ = true;
+
+	if (size_ == 0) {
+		return true;
+	}
+
+	void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapped == MAP_FAILED) {
+		Close();
+		return false;
+	}
+	data_ = static_cast<const char*>(mapped);
+	// 先頭から順に読むことを伝えておく
+	madvise(mapped, size_, MADV_SEQUENTIAL);
+#endif
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (data_ != nullptr) {
+		UnmapViewOfFile(data_);
+	}
+	if (mappingHandle_ != nullptr) {
+		CloseHandle(mappingHandle_);
+		mappingHandle_ = nullptr;
+	}
+	if (fileHandle_ != nullptr) {
+		CloseHandle(fileHandle_);
+		fileHandle_ = nullptr;
+	}
+#else
+	if (data_ != nullptr) {
+		munmap(const_cast<char*>(data_), size_);
+	}
+	if (fileDescriptor_ >= 0) {
+		close(fileDescriptor_);
+		fileDescriptor_ = -1;
+	}
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+}
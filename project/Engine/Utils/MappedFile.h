@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// ファイルをメモリにマップして読み取り専用で参照する
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	/// <summary>
+	/// ファイルを開いてマップする
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>成功したらtrue</returns>
+	bool Open(const std::string& filePath);
+
+	// マップを解除してファイルを閉じる
+	void Close();
+
+	bool IsOpen() const { return isOpen_; }
+
+	// 先頭アドレス (空のファイルならnullptr)
+	const char* Data() const { return data_; }
+
+	// ファイルサイズ (バイト)
+	size_t Size() const { return size_; }
+
+private:
+	const char* data_ = nullptr;
+	size_t size_ = 0;
+	bool isOpen_ = false;
+
+#ifdef _WIN32
+	void* fileHandle_ = nullptr;
+	void* mappingHandle_ = nullptr;
+#else
+	int fileDescriptor_ = -1;
+#endif
+};
@@ -0,0 +1,120 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+	// ParallelFor 1回分の共有状態
+	// 遅れて起動したワーカーが参照しても良いようにshared_ptrで持つ
+	struct ParallelForState {
+		std::function<void(size_t, size_t)> func;
+		size_t count = 0;
+		size_t chunkSize = 0;
+		size_t chunkCount = 0;
+		std::atomic<size_t> nextChunk = 0;
+		std::atomic<size_t> doneChunk = 0;
+		std::mutex mutex;
+		std::condition_variable cv;
+
+		// 区間を取り出せる限り処理する
+		void Run() {
+			while (true) {
+				size_t chunk = nextChunk.fetch_add(1);
+				if (chunk >= chunkCount) {
+					return;
+				}
+				size_t begin = chunk * chunkSize;
+				size_t end = (std::min)(begin + chunkSize, count);
+				func(begin, end);
+
+				if (doneChunk.fetch_add(1) + 1 == chunkCount) {
+					std::lock_guard<std::mutex> lock(mutex);
+					cv.notify_all();
+				}
+			}
+		}
+	};
+}
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if (threadCount == 0) {
+		uint32_t hardware = std::thread::hardware_concurrency();
+		threadCount = hardware > 1 ? hardware - 1 : 1;
+	}
+
+	workers_.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		workers_.emplace_back([this]() { WorkerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isStopping_ = true;
+	}
+	cv_.notify_all();
+
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t minChunk, const std::function<void(size_t begin, size_t end)>& func)
+{
+	if (count == 0) {
+		return;
+	}
+
+	// 参加スレッド数に合わせて区間数を決める (少し細かく分けて偏りを抑える)
+	size_t participants = workers_.size() + 1;
+	size_t chunkSize = (std::max)((std::max)(minChunk, size_t(1)), (count + participants * 4 - 1) / (participants * 4));
+	size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+	// 1区間しかないなら直接実行
+	if (chunkCount == 1 || workers_.empty()) {
+		func(0, count);
+		return;
+	}
+
+	auto state = std::make_shared<ParallelForState>();
+	state->func = func;
+	state->count = count;
+	state->chunkSize = chunkSize;
+	state->chunkCount = chunkCount;
+
+	// 区間数-1だけワーカーを起こす (残りは呼び出し元が処理する)
+	size_t helperCount = (std::min)(workers_.size(), chunkCount - 1);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (size_t i = 0; i < helperCount; ++i) {
+			tasks_.push_back([state]() { state->Run(); });
+		}
+	}
+	cv_.notify_all();
+
+	state->Run();
+
+	// 他スレッドが処理中の区間の完了を待つ
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->cv.wait(lock, [&]() { return state->doneChunk.load() == state->chunkCount; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			cv_.wait(lock, [this]() { return isStopping_ || !tasks_.empty(); });
+			if (isStopping_ && tasks_.empty()) {
+				return;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+		task();
+	}
+}
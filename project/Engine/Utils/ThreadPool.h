@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+class ThreadPool
+{
+public:
+	/// <summary>
+	/// コンストラクタ
+	/// </summary>
+	/// <param name="threadCount">ワーカースレッド数 (0なら論理コア数-1)</param>
+	explicit ThreadPool(uint32_t threadCount = 0);
+
+	/// <summary>
+	/// デストラクタ (全ワーカーの終了を待つ)
+	/// </summary>
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// [0, count) をminChunk以上の区間に分割して並列実行する
+	/// 呼び出し元スレッドも処理に参加し、全区間の完了まで戻らない
+	/// </summary>
+	/// <param name="count">要素数</param>
+	/// <param name="minChunk">1区間の最小要素数</param>
+	/// <param name="func">区間 [begin, end) を処理する関数</param>
+	void ParallelFor(size_t count, size_t minChunk, const std::function<void(size_t begin, size_t end)>& func);
+
+	// ワーカースレッド数 (呼び出し元スレッドは含まない)
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+	void WorkerLoop();
+
+	std::vector<std::thread> workers_;
+	std::deque<std::function<void()>> tasks_;
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	bool isStopping_ = false;
+};
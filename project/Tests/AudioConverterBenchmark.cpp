@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "AudioConverter.h"
+
+// 読み込んだ音をミキシング形式にそろえる変換の速さ (変換元のサンプル数/秒) を測るベンチマーク
+// 1秒分の波形を48000Hzステレオのfloatにする
+
+namespace {
+	constexpr AudioMixFormat kMixFormat = { 48000, 2 };
+
+	WaveFormat MakeFormat(uint32_t sampleRate, uint16_t channelCount, uint16_t bitsPerSample) {
+		WaveFormat format;
+		format.sampleType = WaveSampleType::Pcm;
+		format.channelCount = channelCount;
+		format.sampleRate = sampleRate;
+		format.bitsPerSample = bitsPerSample;
+		format.validBitsPerSample = bitsPerSample;
+		format.blockAlign = static_cast<uint16_t>(channelCount * bitsPerSample / 8);
+		return format;
+	}
+
+	// ランダムなバイト列 (どのビット数でも有効なPCMになる)
+	std::vector<uint8_t> MakeRandomData(const WaveFormat& format) {
+		std::mt19937 random(24);
+		std::vector<uint8_t> data(size_t(format.sampleRate) * format.blockAlign);
+		for (uint8_t& value : data) {
+			value = static_cast<uint8_t>(random());
+		}
+		return data;
+	}
+
+	// 引数はサンプリングレート、チャンネル数、ビット数
+	void BM_ConvertToMixFormat(benchmark::State& state) {
+		const WaveFormat format = MakeFormat(static_cast<uint32_t>(state.range(0)),
+			static_cast<uint16_t>(state.range(1)), static_cast<uint16_t>(state.range(2)));
+		const std::vector<uint8_t> data = MakeRandomData(format);
+		std::vector<float> output;
+		for (auto _ : state) {
+			ConvertToMixFormat(format, data.data(), data.size(), kMixFormat, output);
+			benchmark::DoNotOptimize(output.data());
+		}
+		const int64_t sampleCount = int64_t(format.sampleRate) * format.channelCount;
+		state.SetItemsProcessed(state.iterations() * sampleCount);
+		state.SetBytesProcessed(state.iterations() * int64_t(data.size()));
+	}
+	BENCHMARK(BM_ConvertToMixFormat)
+		->Args({ 48000, 2, 16 }) // 変換だけ
+		->Args({ 44100, 2, 16 }) // CDの音源
+		->Args({ 22050, 1, 16 }) // 軽い効果音
+		->Args({ 96000, 2, 24 }) // ハイレゾ
+		->Args({ 48000, 6, 16 }) // 5.1chからステレオにまとめる
+		->Unit(benchmark::kMillisecond);
+
+	void BM_ConvertSamplesToFloat(benchmark::State& state) {
+		const WaveFormat format = MakeFormat(48000, 2, static_cast<uint16_t>(state.range(0)));
+		const std::vector<uint8_t> data = MakeRandomData(format);
+		const size_t sampleCount = size_t(format.sampleRate) * format.channelCount;
+		std::vector<float> output(sampleCount);
+		for (auto _ : state) {
+			ConvertSamplesToFloat(data.data(), format, sampleCount, output.data());
+			benchmark::DoNotOptimize(output.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * int64_t(sampleCount));
+	}
+	BENCHMARK(BM_ConvertSamplesToFloat)->Arg(8)->Arg(16)->Arg(24)->Arg(32)->Unit(benchmark::kMicrosecond);
+}
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "AudioMixer.h"
+#include "AudioOutput.h"
+
+// ソフトウェアミキサーの1ブロック(48000Hzの10ms)あたりの時間を測るベンチマーク
+// 引数はボイス数と、音量を大きくして切り詰めが起きるようにするか (0/1)
+// realtimeは1秒で何秒分の音を作れたか、clippedは1ブロックあたりの切り詰めたサンプル数
+
+namespace {
+	constexpr uint32_t kSampleRate = 48000;
+	constexpr uint32_t kBlockFrameCount = 480;
+
+	struct BenchmarkSource {
+		std::vector<int16_t> int16Samples;
+		std::vector<float> floatSamples;
+		AudioBufferView view;
+	};
+
+	// ゲームの効果音に近い、モノラル/ステレオとサンプリングレートが混ざった1秒ほどの波形
+	std::vector<BenchmarkSource> MakeSources(uint32_t count) {
+		std::mt19937 random(24);
+		std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+		constexpr uint32_t kSampleRates[] = { 48000, 44100, 22050 };
+		std::vector<BenchmarkSource> sources(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			BenchmarkSource& source = sources[i];
+			source.view.channelCount = static_cast<uint16_t>(i % 2 + 1);
+			source.view.sampleRate = kSampleRates[i % std::size(kSampleRates)];
+			source.view.frameCount = source.view.sampleRate;
+			const size_t sampleCount = size_t(source.view.frameCount) * source.view.channelCount;
+			if (i % 4 < 3) {
+				source.view.format = AudioSampleFormat::Int16;
+				source.int16Samples.resize(sampleCount);
+				for (int16_t& s : source.int16Samples) {
+					s = static_cast<int16_t>(sample(random) * 32767.0f);
+				}
+				source.view.data = source.int16Samples.data();
+			} else {
+				source.view.format = AudioSampleFormat::Float32;
+				source.floatSamples.resize(sampleCount);
+				for (float& s : source.floatSamples) {
+					s = sample(random);
+				}
+				source.view.data = source.floatSamples.data();
+			}
+		}
+		return sources;
+	}
+
+	void BM_MixBlock(benchmark::State& state) {
+		const uint32_t voiceCount = static_cast<uint32_t>(state.range(0));
+		const bool isLoud = state.range(1) != 0;
+		const std::vector<BenchmarkSource> sources = MakeSources(voiceCount);
+		AudioMixer mixer(kSampleRate, voiceCount);
+		std::mt19937 random(25);
+		std::uniform_real_distribution<float> pan(-1.0f, 1.0f);
+		// 小さい音量なら全部足しても収まる、大きい音量なら切り詰めが起きる
+		const float gain = isLoud ? 0.5f : 1.0f / static_cast<float>(voiceCount);
+		for (const BenchmarkSource& source : sources) {
+			mixer.Play(source.view, gain, pan(random), true);
+		}
+
+		NullAudioOutput output;
+		output.Start(mixer);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(output.Render(kBlockFrameCount));
+		}
+		state.SetItemsProcessed(state.iterations() * kBlockFrameCount * voiceCount);
+		state.counters["voices"] = static_cast<double>(mixer.GetActiveVoiceCount());
+		state.counters["realtime"] = benchmark::Counter(
+			static_cast<double>(state.iterations()) * kBlockFrameCount / kSampleRate, benchmark::Counter::kIsRate);
+		state.counters["clipped"] = benchmark::Counter(
+			static_cast<double>(mixer.GetClippedSampleCount()), benchmark::Counter::kAvgIterations);
+	}
+	BENCHMARK(BM_MixBlock)->ArgsProduct({ { 64, 320, 512 }, { 0, 1 } })->Unit(benchmark::kMicrosecond);
+}
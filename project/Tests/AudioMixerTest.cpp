@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+#include "AudioMixer.h"
+#include "AudioOutput.h"
+
+// 300以上のボイスを同時に鳴らした時に、ミキサーの結果がボイスごとに足した参照値とそろうか、
+// 切り詰めたサンプル数を正しく数えるかを確かめる (NullAudioOutputで進める)
+
+namespace {
+	constexpr uint32_t kSampleRate = 48000;
+	constexpr uint32_t kVoiceCount = 320;
+	constexpr uint32_t kBlockFrameCount = 480; // 48000Hzの10ms
+
+	// ボイスに渡す波形 (AudioBufferViewが指すので鳴らしている間は持っておく)
+	struct TestSource {
+		std::vector<int16_t> int16Samples;
+		std::vector<float> floatSamples;
+		AudioBufferView view;
+		float gain = 1.0f;
+		float pan = 0.0f;
+		bool isLoop = false;
+	};
+
+	// モノラル/ステレオ、int16/float、サンプリングレートの違う波形を混ぜて作る
+	std::vector<TestSource> MakeSources(uint32_t count, float gain) {
+		std::mt19937 random(19);
+		std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> pan(-1.0f, 1.0f);
+		std::uniform_int_distribution<uint32_t> frameCount(100, 3000);
+		constexpr uint32_t kSampleRates[] = { 48000, 44100, 22050, 96000 };
+		std::vector<TestSource> sources(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			TestSource& source = sources[i];
+			source.view.channelCount = static_cast<uint16_t>(i % 2 + 1);
+			source.view.frameCount = frameCount(random);
+			source.view.sampleRate = kSampleRates[i / 2 % std::size(kSampleRates)];
+			const size_t sampleCount = size_t(source.view.frameCount) * source.view.channelCount;
+			if (i / 8 % 2 == 0) {
+				source.view.format = AudioSampleFormat::Int16;
+				for (size_t s = 0; s < sampleCount; ++s) {
+					source.int16Samples.push_back(static_cast<int16_t>(sample(random) * 32767.0f));
+				}
+				source.view.data = source.int16Samples.data();
+			} else {
+				source.view.format = AudioSampleFormat::Float32;
+				for (size_t s = 0; s < sampleCount; ++s) {
+					source.floatSamples.push_back(sample(random));
+				}
+				source.view.data = source.floatSamples.data();
+			}
+			source.gain = gain;
+			source.pan = pan(random);
+			source.isLoop = i % 3 == 0;
+		}
+		return sources;
+	}
+
+	double LoadReferenceSample(const TestSource& source, uint32_t frame, uint32_t channel) {
+		const size_t index = size_t(frame) * source.view.channelCount + channel;
+		if (source.view.format == AudioSampleFormat::Int16) {
+			return source.int16Samples[index] / 32768.0;
+		}
+		return source.floatSamples[index];
+	}
+
+	// 1ボイス分をdoubleで足す参照実装 (位置はミキサーと同じ32.32の固定小数で進める)
+	void MixReference(const TestSource& source, uint64_t& position, bool& isActive, std::vector<double>& bus) {
+		const uint32_t frameCount = source.view.frameCount;
+		const uint64_t step = (uint64_t(source.view.sampleRate) << 32) / kSampleRate;
+		const uint64_t end = uint64_t(frameCount) << 32;
+		double leftGain = 0.0;
+		double rightGain = 0.0;
+		if (source.view.channelCount == 1) {
+			const double angle = (source.pan + 1.0) * std::numbers::pi * 0.25;
+			leftGain = source.gain * std::cos(angle);
+			rightGain = source.gain * std::sin(angle);
+		} else {
+			leftGain = source.gain * (std::min)(1.0, 1.0 - source.pan);
+			rightGain = source.gain * (std::min)(1.0, 1.0 + source.pan);
+		}
+		for (uint32_t i = 0; i < kBlockFrameCount && isActive; ++i) {
+			if (position >= end) {
+				if (!source.isLoop) {
+					isActive = false;
+					break;
+				}
+				position %= end;
+			}
+			const uint32_t index = static_cast<uint32_t>(position >> 32);
+			const uint32_t next = index + 1 < frameCount ? index + 1 : (source.isLoop ? 0 : index);
+			const double t = static_cast<uint32_t>(position) / 4294967296.0;
+			for (uint32_t c = 0; c < 2; ++c) {
+				const uint32_t channel = (std::min)(c, uint32_t(source.view.channelCount - 1));
+				const double a = LoadReferenceSample(source, index, channel);
+				const double b = LoadReferenceSample(source, next, channel);
+				bus[i * 2 + c] += (a + (b - a) * t) * (c == 0 ? leftGain : rightGain);
+			}
+			position += step;
+		}
+		if (position >= end && !source.isLoop) {
+			isActive = false;
+		}
+	}
+}
+
+TEST(AudioMixerTest, ManyVoicesMatchReference) {
+	// 全部足しても[-1, 1]に収まる音量にする
+	const std::vector<TestSource> sources = MakeSources(kVoiceCount, 1.0f / kVoiceCount);
+	AudioMixer mixer(kSampleRate, kVoiceCount);
+	for (const TestSource& source : sources) {
+		ASSERT_NE(mixer.Play(source.view, source.gain, source.pan, source.isLoop), kInvalidVoiceId);
+	}
+	EXPECT_EQ(mixer.GetActiveVoiceCount(), kVoiceCount);
+
+	NullAudioOutput output;
+	ASSERT_TRUE(output.Start(mixer));
+	std::vector<uint64_t> positions(sources.size(), 0);
+	std::vector<char> isActive(sources.size(), 1);
+	// ループしない波形が途中で終わるところも含むように進める
+	for (int block = 0; block < 20; ++block) {
+		std::vector<double> reference(kBlockFrameCount * 2, 0.0);
+		for (size_t v = 0; v < sources.size(); ++v) {
+			bool active = isActive[v] != 0;
+			if (active) {
+				MixReference(sources[v], positions[v], active, reference);
+			}
+			isActive[v] = active;
+		}
+		const float* mixed = output.Render(kBlockFrameCount);
+		ASSERT_NE(mixed, nullptr);
+		for (uint32_t i = 0; i < kBlockFrameCount * 2; ++i) {
+			ASSERT_NEAR(mixed[i], reference[i], 1e-4) << "block " << block << " sample " << i;
+		}
+		const uint32_t expectedActive = static_cast<uint32_t>(std::count(isActive.begin(), isActive.end(), 1));
+		EXPECT_EQ(mixer.GetActiveVoiceCount(), expectedActive) << "block " << block;
+	}
+	EXPECT_EQ(mixer.GetClippedSampleCount(), 0u);
+	EXPECT_EQ(output.GetRenderedFrameCount(), uint64_t(kBlockFrameCount) * 20);
+}
+
+TEST(AudioMixerTest, CountsClippedSamples) {
+	// 0.5の直流を300個重ねると全サンプルが1を超える
+	constexpr uint32_t kLoudVoiceCount = 300;
+	const std::vector<float> dc(64 * 2, 0.5f);
+	AudioBufferView view;
+	view.data = dc.data();
+	view.frameCount = 64;
+	view.channelCount = 2;
+	view.sampleRate = kSampleRate;
+	view.format = AudioSampleFormat::Float32;
+	AudioMixer mixer(kSampleRate, kLoudVoiceCount);
+	for (uint32_t i = 0; i < kLoudVoiceCount; ++i) {
+		ASSERT_NE(mixer.Play(view, 1.0f, 0.0f, true), kInvalidVoiceId);
+	}
+
+	NullAudioOutput output;
+	ASSERT_TRUE(output.Start(mixer));
+	const float* mixed = output.Render(kBlockFrameCount);
+	for (uint32_t i = 0; i < kBlockFrameCount * 2; ++i) {
+		ASSERT_EQ(mixed[i], 1.0f);
+	}
+	EXPECT_EQ(mixer.GetClippedSampleCount(), uint64_t(kBlockFrameCount) * 2);
+
+	// マスター音量で下げれば切り詰めは増えない (300 * 0.5 * 0.006 = 0.9)
+	mixer.SetMasterGain(0.006f);
+	mixed = output.Render(kBlockFrameCount);
+	EXPECT_NEAR(mixed[0], 0.9f, 1e-4f);
+	EXPECT_EQ(mixer.GetClippedSampleCount(), uint64_t(kBlockFrameCount) * 2);
+}
+
+TEST(AudioMixerTest, RejectsPlayBeyondMaxVoiceCount) {
+	const std::vector<TestSource> sources = MakeSources(kVoiceCount + 1, 0.0f);
+	AudioMixer mixer(kSampleRate, kVoiceCount);
+	for (uint32_t i = 0; i < kVoiceCount; ++i) {
+		ASSERT_NE(mixer.Play(sources[i].view), kInvalidVoiceId);
+	}
+	EXPECT_EQ(mixer.Play(sources[kVoiceCount].view), kInvalidVoiceId);
+	mixer.StopAll();
+	EXPECT_EQ(mixer.GetActiveVoiceCount(), 0u);
+	EXPECT_NE(mixer.Play(sources[kVoiceCount].view), kInvalidVoiceId);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "AudioRingBuffer.h"
+
+// StreamingSoundが使うリングバッファの読み書きを確かめる
+// 容量は2の累乗に切り上げないので、フレームの倍数にした時に領域が途中で折り返さないことも見る
+
+TEST(AudioRingBufferTest, KeepsCapacityAsGiven) {
+	AudioRingBuffer ring(3000);
+	EXPECT_EQ(ring.GetCapacity(), 3000u);
+	EXPECT_EQ(ring.GetWritableSize(), 3000u);
+	EXPECT_EQ(ring.GetReadableSize(), 0u);
+}
+
+TEST(AudioRingBufferTest, WrapsAroundNonPowerOfTwoCapacity) {
+	AudioRingBuffer ring(10);
+	std::vector<uint8_t> output(10);
+	uint8_t next = 0;
+	uint8_t expected = 0;
+	// 7バイトずつ書いて読むと、毎回違う位置で折り返す
+	for (int round = 0; round < 20; ++round) {
+		uint8_t input[7];
+		for (uint8_t& value : input) {
+			value = next++;
+		}
+		ASSERT_EQ(ring.Write(input, sizeof(input)), sizeof(input));
+		ASSERT_EQ(ring.GetReadableSize(), sizeof(input));
+		ASSERT_EQ(ring.Read(output.data(), output.size()), sizeof(input));
+		for (size_t i = 0; i < sizeof(input); ++i) {
+			ASSERT_EQ(output[i], expected++);
+		}
+	}
+}
+
+TEST(AudioRingBufferTest, WriteStopsWhenFull) {
+	AudioRingBuffer ring(6);
+	const uint8_t input[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	EXPECT_EQ(ring.Write(input, sizeof(input)), 6u);
+	EXPECT_EQ(ring.GetWritableSize(), 0u);
+	size_t size = 0;
+	EXPECT_NE(ring.AcquireWrite(size), nullptr);
+	EXPECT_EQ(size, 0u);
+}
+
+TEST(AudioRingBufferTest, FrameMultipleCapacityDoesNotSplitRegions) {
+	// StreamingSoundと同じく、1バッファ分ずつAcquireWrite/AcquireReadする
+	constexpr size_t kBufferSize = 1764; // 44100Hz、16bitステレオの10ms
+	constexpr size_t kBufferCount = 3;
+	AudioRingBuffer ring(kBufferSize * kBufferCount);
+	for (int round = 0; round < 10; ++round) {
+		size_t writeSize = 0;
+		uint8_t* write = ring.AcquireWrite(writeSize);
+		ASSERT_NE(write, nullptr);
+		ASSERT_GE(writeSize, kBufferSize);
+		std::memset(write, round, kBufferSize);
+		ring.CommitWrite(kBufferSize);
+
+		size_t readSize = 0;
+		const uint8_t* read = ring.AcquireRead(readSize);
+		ASSERT_EQ(readSize, kBufferSize);
+		EXPECT_EQ(read[0], round);
+		EXPECT_EQ(read[kBufferSize - 1], round);
+		ring.CommitRead(readSize);
+	}
+}
+
+TEST(AudioRingBufferTest, SingleProducerSingleConsumer) {
+	constexpr uint32_t kValueCount = 1 << 20;
+	AudioRingBuffer ring(1000 * sizeof(uint32_t) + 2); // 要素の途中で折り返す容量
+	std::thread producer([&ring] {
+		uint32_t value = 0;
+		size_t offset = 0; // 書きかけの要素の何バイト目か
+		while (value < kValueCount) {
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+			offset += ring.Write(bytes + offset, sizeof(value) - offset);
+			if (offset == sizeof(value)) {
+				offset = 0;
+				++value;
+			}
+		}
+	});
+
+	uint32_t expected = 0;
+	uint32_t value = 0;
+	size_t offset = 0;
+	bool isOrdered = true;
+	while (expected < kValueCount) {
+		offset += ring.Read(reinterpret_cast<uint8_t*>(&value) + offset, sizeof(value) - offset);
+		if (offset == sizeof(value)) {
+			isOrdered = isOrdered && value == expected;
+			offset = 0;
+			++expected;
+		}
+	}
+	producer.join();
+	EXPECT_TRUE(isOrdered);
+	EXPECT_EQ(ring.GetReadableSize(), 0u);
+}
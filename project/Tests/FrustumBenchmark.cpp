@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "Frustum.h"
+
+// 視錐台カリングのベンチマーク
+// 10万個をまとめて判定するバッチ版と、IsVisibleで1つずつ判定する場合を比べる
+
+namespace {
+	constexpr size_t kObjectCount = 100000;
+
+	Frustum MakeBenchmarkFrustum() {
+		const Matrix4x4 camera = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.5f, 0.0f }, { 0.0f, 0.0f, -20.0f });
+		const Matrix4x4 projection = MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+		return MakeFrustum(Multiply(InverseRigid(camera), projection));
+	}
+
+	std::vector<AABB> MakeRandomBoxes(size_t count) {
+		std::mt19937 random(30);
+		std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> extent(0.1f, 3.0f);
+		std::vector<AABB> boxes(count);
+		for (AABB& box : boxes) {
+			const Vector3 center = { position(random), position(random), position(random) };
+			const Vector3 half = { extent(random), extent(random), extent(random) };
+			box = { center - half, center + half };
+		}
+		return boxes;
+	}
+
+	std::vector<Sphere> MakeRandomSpheres(size_t count) {
+		const std::vector<AABB> boxes = MakeRandomBoxes(count);
+		std::vector<Sphere> spheres(count);
+		for (size_t i = 0; i < count; ++i) {
+			spheres[i] = MakeSphere(boxes[i]);
+		}
+		return spheres;
+	}
+
+	void BM_CullAABBBatch(benchmark::State& state) {
+		const Frustum frustum = MakeBenchmarkFrustum();
+		const std::vector<AABB> boxes = MakeRandomBoxes(kObjectCount);
+		std::vector<uint32_t> visibleIndices(kObjectCount);
+		size_t visibleCount = 0;
+		for (auto _ : state) {
+			visibleCount = CullAABBBatch(frustum, boxes.data(), boxes.size(), visibleIndices.data());
+			benchmark::DoNotOptimize(visibleIndices.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+		state.counters["visible"] = static_cast<double>(visibleCount);
+	}
+	BENCHMARK(BM_CullAABBBatch);
+
+	void BM_CullAABBLoop(benchmark::State& state) {
+		const Frustum frustum = MakeBenchmarkFrustum();
+		const std::vector<AABB> boxes = MakeRandomBoxes(kObjectCount);
+		std::vector<uint32_t> visibleIndices(kObjectCount);
+		size_t visibleCount = 0;
+		for (auto _ : state) {
+			visibleCount = 0;
+			for (size_t i = 0; i < boxes.size(); ++i) {
+				if (IsVisible(frustum, boxes[i])) {
+					visibleIndices[visibleCount++] = static_cast<uint32_t>(i);
+				}
+			}
+			benchmark::DoNotOptimize(visibleIndices.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+		state.counters["visible"] = static_cast<double>(visibleCount);
+	}
+	BENCHMARK(BM_CullAABBLoop);
+
+	void BM_CullSphereBatch(benchmark::State& state) {
+		const Frustum frustum = MakeBenchmarkFrustum();
+		const std::vector<Sphere> spheres = MakeRandomSpheres(kObjectCount);
+		std::vector<uint32_t> visibleIndices(kObjectCount);
+		size_t visibleCount = 0;
+		for (auto _ : state) {
+			visibleCount = CullSphereBatch(frustum, spheres.data(), spheres.size(), visibleIndices.data());
+			benchmark::DoNotOptimize(visibleIndices.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+		state.counters["visible"] = static_cast<double>(visibleCount);
+	}
+	BENCHMARK(BM_CullSphereBatch);
+
+	void BM_CullSphereLoop(benchmark::State& state) {
+		const Frustum frustum = MakeBenchmarkFrustum();
+		const std::vector<Sphere> spheres = MakeRandomSpheres(kObjectCount);
+		std::vector<uint32_t> visibleIndices(kObjectCount);
+		size_t visibleCount = 0;
+		for (auto _ : state) {
+			visibleCount = 0;
+			for (size_t i = 0; i < spheres.size(); ++i) {
+				if (IsVisible(frustum, spheres[i])) {
+					visibleIndices[visibleCount++] = static_cast<uint32_t>(i);
+				}
+			}
+			benchmark::DoNotOptimize(visibleIndices.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+		state.counters["visible"] = static_cast<double>(visibleCount);
+	}
+	BENCHMARK(BM_CullSphereLoop);
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "Frustum.h"
+
+// CullAABBBatch/CullSphereBatchが、doubleで1つずつ判定した結果と同じ番号を返すかを確かめる
+// 平面ぎりぎりの物はfloatの丸めでどちらにもなり得るので、判定から外す
+
+namespace {
+	// 平面からの距離がこれより近い物は判定しない
+	constexpr double kBoundaryMargin = 1e-3;
+
+	// 判定の結果 (平面ぎりぎりならAmbiguous)
+	enum class Visibility {
+		Visible,
+		Culled,
+		Ambiguous,
+	};
+
+	double PlaneDistance(const Plane& plane, double x, double y, double z) {
+		return double(plane.normal.x) * x + double(plane.normal.y) * y + double(plane.normal.z) * z + double(plane.distance);
+	}
+
+	// 平面ごとに、内側へ一番出ている頂点(p-vertex)が外側なら見えない
+	Visibility ReferenceVisibility(const Frustum& frustum, const AABB& box) {
+		Visibility result = Visibility::Visible;
+		for (const Plane& plane : frustum.planes) {
+			const double x = plane.normal.x >= 0.0f ? box.max.x : box.min.x;
+			const double y = plane.normal.y >= 0.0f ? box.max.y : box.min.y;
+			const double z = plane.normal.z >= 0.0f ? box.max.z : box.min.z;
+			const double distance = PlaneDistance(plane, x, y, z);
+			if (distance < -kBoundaryMargin) {
+				return Visibility::Culled;
+			}
+			if (distance < kBoundaryMargin) {
+				result = Visibility::Ambiguous;
+			}
+		}
+		return result;
+	}
+
+	Visibility ReferenceVisibility(const Frustum& frustum, const Sphere& sphere) {
+		Visibility result = Visibility::Visible;
+		for (const Plane& plane : frustum.planes) {
+			const double distance = PlaneDistance(plane, sphere.center.x, sphere.center.y, sphere.center.z) + sphere.radius;
+			if (distance < -kBoundaryMargin) {
+				return Visibility::Culled;
+			}
+			if (distance < kBoundaryMargin) {
+				result = Visibility::Ambiguous;
+			}
+		}
+		return result;
+	}
+
+	// 少し傾けたカメラの視錐台
+	Frustum MakeTestFrustum() {
+		const Matrix4x4 camera = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.5f, 0.0f }, { 0.0f, 0.0f, -20.0f });
+		const Matrix4x4 projection = MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+		return MakeFrustum(Multiply(InverseRigid(camera), projection));
+	}
+
+	std::vector<AABB> MakeRandomBoxes(size_t count, uint32_t seed) {
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> extent(0.1f, 3.0f);
+		std::vector<AABB> boxes(count);
+		for (AABB& box : boxes) {
+			const Vector3 center = { position(random), position(random), position(random) };
+			const Vector3 half = { extent(random), extent(random), extent(random) };
+			box = { center - half, center + half };
+		}
+		return boxes;
+	}
+
+	std::vector<Sphere> MakeRandomSpheres(size_t count, uint32_t seed) {
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> radius(0.1f, 3.0f);
+		std::vector<Sphere> spheres(count);
+		for (Sphere& sphere : spheres) {
+			sphere = { { position(random), position(random), position(random) }, radius(random) };
+		}
+		return spheres;
+	}
+
+	// バッチの結果を基準と比べる (番号は昇順で、見えている物は全部入り、見えない物は入らない)
+	template <typename Shape>
+	void ExpectMatchesReference(const Frustum& frustum, const std::vector<Shape>& shapes, const std::vector<uint32_t>& visibleIndices) {
+		ASSERT_TRUE(std::is_sorted(visibleIndices.begin(), visibleIndices.end()));
+		ASSERT_EQ(std::adjacent_find(visibleIndices.begin(), visibleIndices.end()), visibleIndices.end());
+		std::vector<bool> isVisible(shapes.size(), false);
+		for (uint32_t index : visibleIndices) {
+			ASSERT_LT(index, shapes.size());
+			isVisible[index] = true;
+		}
+		size_t checkedCount = 0;
+		for (size_t i = 0; i < shapes.size(); ++i) {
+			const Visibility expected = ReferenceVisibility(frustum, shapes[i]);
+			if (expected == Visibility::Ambiguous) {
+				continue;
+			}
+			++checkedCount;
+			EXPECT_EQ(isVisible[i], expected == Visibility::Visible) << "index " << i;
+		}
+		// ほとんどが判定の対象になっていること
+		EXPECT_GT(checkedCount, shapes.size() * 99 / 100);
+	}
+}
+
+TEST(FrustumTest, CullAABBBatchMatchesReference) {
+	const Frustum frustum = MakeTestFrustum();
+	// 4の倍数でない数にして、端数の処理も通す
+	const std::vector<AABB> boxes = MakeRandomBoxes(100003, 20);
+	std::vector<uint32_t> visibleIndices(boxes.size());
+	visibleIndices.resize(CullAABBBatch(frustum, boxes.data(), boxes.size(), visibleIndices.data()));
+	EXPECT_GT(visibleIndices.size(), 0u);
+	EXPECT_LT(visibleIndices.size(), boxes.size());
+	ExpectMatchesReference(frustum, boxes, visibleIndices);
+}
+
+TEST(FrustumTest, CullSphereBatchMatchesReference) {
+	const Frustum frustum = MakeTestFrustum();
+	const std::vector<Sphere> spheres = MakeRandomSpheres(100003, 21);
+	std::vector<uint32_t> visibleIndices(spheres.size());
+	visibleIndices.resize(CullSphereBatch(frustum, spheres.data(), spheres.size(), visibleIndices.data()));
+	EXPECT_GT(visibleIndices.size(), 0u);
+	EXPECT_LT(visibleIndices.size(), spheres.size());
+	ExpectMatchesReference(frustum, spheres, visibleIndices);
+}
+
+TEST(FrustumTest, BatchMatchesIsVisibleForEveryCount) {
+	// 0～4つ分+端数の全ての数で、1つずつ判定した結果と合うか
+	const Frustum frustum = MakeTestFrustum();
+	const std::vector<AABB> boxes = MakeRandomBoxes(64, 22);
+	std::vector<Sphere> spheres(boxes.size());
+	std::transform(boxes.begin(), boxes.end(), spheres.begin(), MakeSphere);
+	for (size_t count = 0; count <= boxes.size(); ++count) {
+		std::vector<uint32_t> expectedBoxes, expectedSpheres;
+		for (uint32_t i = 0; i < count; ++i) {
+			if (ReferenceVisibility(frustum, boxes[i]) != Visibility::Culled) {
+				expectedBoxes.push_back(i);
+			}
+			if (ReferenceVisibility(frustum, spheres[i]) != Visibility::Culled) {
+				expectedSpheres.push_back(i);
+			}
+		}
+		std::vector<uint32_t> visibleIndices(count + 1, UINT32_MAX);
+		const size_t boxCount = CullAABBBatch(frustum, boxes.data(), count, visibleIndices.data());
+		EXPECT_EQ(std::vector<uint32_t>(visibleIndices.begin(), visibleIndices.begin() + boxCount), expectedBoxes) << "count " << count;
+		// 出力先は見えている数より先に書き込まない
+		EXPECT_EQ(visibleIndices[count], UINT32_MAX);
+		const size_t sphereCount = CullSphereBatch(frustum, spheres.data(), count, visibleIndices.data());
+		EXPECT_EQ(std::vector<uint32_t>(visibleIndices.begin(), visibleIndices.begin() + sphereCount), expectedSpheres) << "count " << count;
+	}
+}
+
+TEST(FrustumTest, KnownCases) {
+	// カメラは原点から+Zを向いている
+	const Frustum frustum = MakeFrustum(MakePerspectiveFovMatrix(0.45f, 1.0f, 0.1f, 100.0f));
+	const AABB boxes[] = {
+		{ { -1.0f, -1.0f, 9.0f }, { 1.0f, 1.0f, 11.0f } }, // 正面
+		{ { -1.0f, -1.0f, -11.0f }, { 1.0f, 1.0f, -9.0f } }, // 後ろ
+		{ { -1.0f, -1.0f, 110.0f }, { 1.0f, 1.0f, 120.0f } }, // 遠平面より奥
+		{ { 30.0f, -1.0f, 9.0f }, { 32.0f, 1.0f, 11.0f } }, // 右の外
+		{ { -1.0f, -1.0f, 99.0f }, { 1.0f, 1.0f, 101.0f } }, // 遠平面をまたぐ
+	};
+	const bool expected[] = { true, false, false, false, true };
+	uint32_t visibleIndices[5];
+	const size_t visibleCount = CullAABBBatch(frustum, boxes, 5, visibleIndices);
+	std::vector<bool> isVisible(5, false);
+	for (size_t i = 0; i < visibleCount; ++i) {
+		isVisible[visibleIndices[i]] = true;
+	}
+	for (size_t i = 0; i < 5; ++i) {
+		EXPECT_EQ(isVisible[i], expected[i]) << "index " << i;
+		EXPECT_EQ(IsVisible(frustum, boxes[i]), expected[i]) << "index " << i;
+	}
+}
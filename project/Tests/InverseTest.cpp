@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "Matrix.h"
+
+// Inverse/InverseAffine/InverseRigidが、doubleの掃き出し法で求めた逆行列と合うかを確かめる
+// MatrixTestと同じく、CG2Tests(既定)、CG2TestsScalar、CG2TestsAvxのどれでも通る必要がある
+
+namespace {
+	// doubleの掃き出し法(部分ピボット選択)で求めた逆行列
+	bool ReferenceInverse(const Matrix4x4& matrix, double result[4][4]) {
+		double a[4][8] = {};
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				a[i][j] = matrix.m[i][j];
+			}
+			a[i][4 + i] = 1.0;
+		}
+		for (int col = 0; col < 4; ++col) {
+			int pivot = col;
+			for (int row = col + 1; row < 4; ++row) {
+				if (std::abs(a[row][col]) > std::abs(a[pivot][col])) {
+					pivot = row;
+				}
+			}
+			if (a[pivot][col] == 0.0) {
+				return false;
+			}
+			for (int j = 0; j < 8; ++j) {
+				std::swap(a[col][j], a[pivot][j]);
+			}
+			const double inv = 1.0 / a[col][col];
+			for (int j = 0; j < 8; ++j) {
+				a[col][j] *= inv;
+			}
+			for (int row = 0; row < 4; ++row) {
+				if (row == col) {
+					continue;
+				}
+				const double factor = a[row][col];
+				for (int j = 0; j < 8; ++j) {
+					a[row][j] -= factor * a[col][j];
+				}
+			}
+		}
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				result[i][j] = a[i][4 + j];
+			}
+		}
+		return true;
+	}
+
+	// 対角が大きい行列 (条件数が小さいので、floatでも誤差の上限をはっきり決められる)
+	Matrix4x4 RandomWellConditionedMatrix(std::mt19937& random) {
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		Matrix4x4 result;
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				result.m[i][j] = distribution(random);
+			}
+			result.m[i][i] += distribution(random) < 0.0f ? -5.0f : 5.0f;
+		}
+		return result;
+	}
+
+	Vector3 RandomVector(std::mt19937& random, float min, float max) {
+		std::uniform_real_distribution<float> distribution(min, max);
+		return { distribution(random), distribution(random), distribution(random) };
+	}
+
+	// 逆行列の各要素がdoubleの結果と合うか (誤差は最大要素に対する相対値で見る)
+	void ExpectNearReference(const Matrix4x4& actual, const Matrix4x4& matrix, double relativeTolerance) {
+		double expected[4][4];
+		ASSERT_TRUE(ReferenceInverse(matrix, expected));
+		double maxElement = 0.0;
+		for (const auto& row : expected) {
+			for (double value : row) {
+				maxElement = (std::max)(maxElement, std::abs(value));
+			}
+		}
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_NEAR(actual.m[i][j], expected[i][j], relativeTolerance * maxElement) << "m[" << i << "][" << j << "]";
+			}
+		}
+	}
+
+	// 元の行列に掛けると単位行列になるか
+	void ExpectIdentityProduct(const Matrix4x4& matrix, const Matrix4x4& inverse, float tolerance) {
+		const Matrix4x4 product = Multiply(matrix, inverse);
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_NEAR(product.m[i][j], i == j ? 1.0f : 0.0f, tolerance) << "m[" << i << "][" << j << "]";
+			}
+		}
+	}
+
+	// 4列目が厳密に(0, 0, 0, 1)か
+	void ExpectAffineColumn(const Matrix4x4& matrix) {
+		EXPECT_EQ(matrix.m[0][3], 0.0f);
+		EXPECT_EQ(matrix.m[1][3], 0.0f);
+		EXPECT_EQ(matrix.m[2][3], 0.0f);
+		EXPECT_EQ(matrix.m[3][3], 1.0f);
+	}
+}
+
+TEST(InverseTest, GeneralMatchesReference) {
+	std::mt19937 random(10);
+	for (int n = 0; n < 1000; ++n) {
+		const Matrix4x4 matrix = RandomWellConditionedMatrix(random);
+		ASSERT_FALSE(IsAffine(matrix));
+		const Matrix4x4 inverse = Inverse(matrix);
+		ExpectNearReference(inverse, matrix, 1e-5);
+		ExpectIdentityProduct(matrix, inverse, 1e-5f);
+	}
+}
+
+TEST(InverseTest, PerspectiveMatchesReference) {
+	// 射影行列はアフィンではないので4x4の一般解の方を通る
+	for (float fovY : { 0.3f, 0.45f, 1.2f }) {
+		for (float aspect : { 1.0f, 16.0f / 9.0f }) {
+			const Matrix4x4 projection = MakePerspectiveFovMatrix(fovY, aspect, 0.1f, 100.0f);
+			ASSERT_FALSE(IsAffine(projection));
+			ExpectNearReference(Inverse(projection), projection, 1e-5);
+		}
+	}
+}
+
+TEST(InverseTest, AffineMatchesReference) {
+	std::mt19937 random(11);
+	for (int n = 0; n < 1000; ++n) {
+		const Matrix4x4 matrix = MakeAffineMatrix(RandomVector(random, 0.1f, 4.0f), RandomVector(random, -3.14159f, 3.14159f), RandomVector(random, -100.0f, 100.0f));
+		const Matrix4x4 inverseAffine = InverseAffine(matrix);
+		ExpectNearReference(inverseAffine, matrix, 1e-5);
+		ExpectAffineColumn(inverseAffine);
+		// Inverseはアフィン変換行列をInverseAffineに回す
+		const Matrix4x4 inverse = Inverse(matrix);
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_EQ(inverse.m[i][j], inverseAffine.m[i][j]);
+			}
+		}
+	}
+}
+
+TEST(InverseTest, RigidMatchesReference) {
+	std::mt19937 random(12);
+	for (int n = 0; n < 1000; ++n) {
+		const Matrix4x4 matrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, RandomVector(random, -3.14159f, 3.14159f), RandomVector(random, -100.0f, 100.0f));
+		const Matrix4x4 inverse = InverseRigid(matrix);
+		ExpectNearReference(inverse, matrix, 1e-5);
+		ExpectAffineColumn(inverse);
+		ExpectIdentityProduct(matrix, inverse, 1e-4f);
+	}
+}
+
+TEST(InverseTest, RigidMatchesAffineForViewMatrix) {
+	// カメラのビュー行列 (ワールド行列の逆) はどちらで求めても同じになる
+	std::mt19937 random(13);
+	for (int n = 0; n < 100; ++n) {
+		const Matrix4x4 camera = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, RandomVector(random, -3.14159f, 3.14159f), RandomVector(random, -50.0f, 50.0f));
+		const Matrix4x4 rigid = InverseRigid(camera);
+		const Matrix4x4 affine = InverseAffine(camera);
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_NEAR(rigid.m[i][j], affine.m[i][j], 1e-4f * (1.0f + std::abs(affine.m[i][j])));
+			}
+		}
+	}
+}
+
+TEST(InverseTest, SingularReturnsZero) {
+	// 3行目が0なので行列式は0 (4列目が(0, 0, 0, 1)でないので一般解の方)
+	const Matrix4x4 general = { {
+		{ 1.0f, 2.0f, 3.0f, 1.0f },
+		{ 4.0f, 5.0f, 6.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 0.0f },
+		{ 7.0f, 8.0f, 9.0f, 2.0f },
+	} };
+	// 拡縮が0のアフィン変換行列
+	const Matrix4x4 affine = MakeAffineMatrix({ 1.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 2.0f, 3.0f });
+	for (const Matrix4x4& result : { Inverse(general), Inverse(affine), InverseAffine(affine) }) {
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_EQ(result.m[i][j], 0.0f);
+			}
+		}
+	}
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "MaterialTable.h"
+#include "ObjLoader.h"
+
+// Data/materials.mtlを読み、次を確かめる
+//  map_〇〇のオプション (-s, -o, -bm, -clamp, -mm, -blendu) を飛ばしてファイル名だけを読む (空白を含む名前も残す)
+//  Ka/Kd/Ksの値が1つだけなら3成分とも同じ値にする
+//  Trはd = 1 - Trとして読む
+//  MaterialTableは名前が違っても中身が同じなら同じ番号にまとめる
+
+namespace {
+	const std::string kDataDirectory = CG2_TEST_DATA_DIR;
+
+	void ExpectVector3(const Vector3& actual, float x, float y, float z) {
+		EXPECT_FLOAT_EQ(actual.x, x);
+		EXPECT_FLOAT_EQ(actual.y, y);
+		EXPECT_FLOAT_EQ(actual.z, z);
+	}
+
+	std::string DataPath(const std::string& filename) {
+		return kDataDirectory + "/" + filename;
+	}
+
+	std::vector<MaterialData> LoadFixture() {
+		return LoadMaterialTemplateFile(kDataDirectory, "materials.mtl");
+	}
+}
+
+TEST(MaterialTest, ReadsParamsAndTextureOptions) {
+	const std::vector<MaterialData> materials = LoadFixture();
+	ASSERT_EQ(materials.size(), 4u);
+	const MaterialData& material = materials[0];
+	EXPECT_EQ(material.name, "options");
+
+	const MaterialParams& params = material.params;
+	ExpectVector3(params.ambient, 0.2f, 0.2f, 0.2f);
+	ExpectVector3(params.diffuse, 0.5f, 0.25f, 0.125f);
+	ExpectVector3(params.specular, 0.75f, 0.75f, 0.75f);
+	ExpectVector3(params.emissive, 0.0f, 0.5f, 1.0f);
+	EXPECT_FLOAT_EQ(params.shininess, 32.0f);
+	EXPECT_FLOAT_EQ(params.alpha, 0.75f);
+	EXPECT_EQ(params.illum, 1u);
+
+	EXPECT_EQ(material.textureFilePath, DataPath("albedo.png"));
+	EXPECT_EQ(material.specularTexturePath, DataPath("specular map.png"));
+	EXPECT_EQ(material.bumpTexturePath, DataPath("normal.png"));
+	EXPECT_EQ(material.alphaTexturePath, DataPath("alpha.png"));
+	EXPECT_TRUE(material.ambientTexturePath.empty());
+	EXPECT_TRUE(material.emissiveTexturePath.empty());
+	EXPECT_TRUE(material.shininessTexturePath.empty());
+}
+
+TEST(MaterialTest, ShorthandMatchesFullForm) {
+	// 1つ目は省略形とオプション付き、2つ目は3成分・d・オプション無しで同じ中身を書いている
+	const std::vector<MaterialData> materials = LoadFixture();
+	ASSERT_EQ(materials.size(), 4u);
+	const MaterialData& shorthand = materials[0];
+	const MaterialData& full = materials[1];
+	EXPECT_EQ(full.name, "options_copy");
+	for (auto path : kMaterialTexturePaths) {
+		EXPECT_EQ(shorthand.*path, full.*path);
+	}
+	ExpectVector3(full.params.ambient, shorthand.params.ambient.x, shorthand.params.ambient.y, shorthand.params.ambient.z);
+	ExpectVector3(full.params.specular, shorthand.params.specular.x, shorthand.params.specular.y, shorthand.params.specular.z);
+	EXPECT_EQ(full.params.alpha, shorthand.params.alpha);
+}
+
+TEST(MaterialTest, KeepsDefaultsForMissingLines) {
+	// newmtlより前の行は無視し、何も書かれていない項目は既定値のまま
+	const std::vector<MaterialData> materials = LoadFixture();
+	ASSERT_EQ(materials.size(), 4u);
+	const MaterialData& material = materials[3];
+	EXPECT_EQ(material.name, "defaults");
+	const MaterialParams defaults;
+	ExpectVector3(material.params.diffuse, defaults.diffuse.x, defaults.diffuse.y, defaults.diffuse.z);
+	ExpectVector3(material.params.ambient, defaults.ambient.x, defaults.ambient.y, defaults.ambient.z);
+	EXPECT_EQ(material.params.alpha, defaults.alpha);
+	EXPECT_EQ(material.params.illum, defaults.illum);
+	for (auto path : kMaterialTexturePaths) {
+		EXPECT_TRUE((material.*path).empty());
+	}
+}
+
+TEST(MaterialTest, TableMergesSameContent) {
+	const std::vector<MaterialData> materials = LoadFixture();
+	ASSERT_EQ(materials.size(), 4u);
+
+	ModelData modelData;
+	modelData.materials = materials;
+	MaterialTable table;
+	const std::vector<uint32_t> ids = table.Register(modelData);
+	ASSERT_EQ(ids.size(), 4u);
+	// optionsとoptions_copyは名前だけが違う、other_textureはmap_Kdだけが違う
+	EXPECT_EQ(ids[0], ids[1]);
+	EXPECT_NE(ids[0], ids[2]);
+	EXPECT_NE(ids[0], ids[3]);
+	EXPECT_NE(ids[2], ids[3]);
+	EXPECT_EQ(table.GetCount(), 3u);
+	EXPECT_EQ(table.Get(ids[1]).name, "options");
+
+	// 別のモデルから同じ中身を登録しても増えない
+	MaterialData copy = materials[2];
+	copy.name = "from_another_model";
+	EXPECT_EQ(table.Register(copy), ids[2]);
+	EXPECT_EQ(table.GetCount(), 3u);
+
+	// 数値が1つ違えば別の番号
+	copy.params.shininess = 33.0f;
+	EXPECT_EQ(table.Register(copy), 3u);
+	EXPECT_EQ(table.GetCount(), 4u);
+}
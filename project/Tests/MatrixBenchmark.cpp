@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "Matrix.h"
+
+// 行列演算のマイクロベンチマーク
+// CG2Benchmarks(既定)、CG2BenchmarksScalar、CG2BenchmarksAvxの結果を並べるとSIMDの効果が分かる
+
+namespace {
+	constexpr size_t kMatrixCount = 1024;
+
+	std::vector<Matrix4x4> MakeRandomMatrices(size_t count, uint32_t seed) {
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+		std::vector<Matrix4x4> matrices(count);
+		for (Matrix4x4& matrix : matrices) {
+			for (auto& row : matrix.m) {
+				for (float& value : row) {
+					value = distribution(random);
+				}
+			}
+		}
+		return matrices;
+	}
+
+	// 1024組の行列の積
+	void BM_MatrixMultiply(benchmark::State& state) {
+		const std::vector<Matrix4x4> a = MakeRandomMatrices(kMatrixCount, 1);
+		const std::vector<Matrix4x4> b = MakeRandomMatrices(kMatrixCount, 2);
+		std::vector<Matrix4x4> result(kMatrixCount);
+		for (auto _ : state) {
+			for (size_t i = 0; i < kMatrixCount; ++i) {
+				result[i] = Multiply(a[i], b[i]);
+			}
+			benchmark::DoNotOptimize(result.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kMatrixCount);
+	}
+	BENCHMARK(BM_MatrixMultiply);
+
+	// 前の結果に掛けていく (依存があるので遅延が見える)
+	void BM_MatrixMultiplyChain(benchmark::State& state) {
+		const std::vector<Matrix4x4> b = MakeRandomMatrices(kMatrixCount, 3);
+		Matrix4x4 result = MakeIdentity4x4();
+		for (auto _ : state) {
+			for (size_t i = 0; i < kMatrixCount; ++i) {
+				result = Multiply(result, b[i]);
+			}
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetItemsProcessed(state.iterations() * kMatrixCount);
+	}
+	BENCHMARK(BM_MatrixMultiplyChain);
+
+	void BM_MatrixAdd(benchmark::State& state) {
+		const std::vector<Matrix4x4> a = MakeRandomMatrices(kMatrixCount, 4);
+		const std::vector<Matrix4x4> b = MakeRandomMatrices(kMatrixCount, 5);
+		std::vector<Matrix4x4> result(kMatrixCount);
+		for (auto _ : state) {
+			for (size_t i = 0; i < kMatrixCount; ++i) {
+				result[i] = Add(a[i], b[i]);
+			}
+			benchmark::DoNotOptimize(result.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kMatrixCount);
+	}
+	BENCHMARK(BM_MatrixAdd);
+
+	void BM_TransformNormal(benchmark::State& state) {
+		const std::vector<Matrix4x4> m = MakeRandomMatrices(kMatrixCount, 6);
+		std::vector<Vector3> result(kMatrixCount);
+		for (auto _ : state) {
+			for (size_t i = 0; i < kMatrixCount; ++i) {
+				result[i] = TransformNormal({ 0.3f, -0.5f, 0.8f }, m[i]);
+			}
+			benchmark::DoNotOptimize(result.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kMatrixCount);
+	}
+	BENCHMARK(BM_TransformNormal);
+
+	// ワールド行列とWVPを作る (毎フレームのオブジェクトごとの処理)
+	void BM_MakeAffineAndWorldViewProjection(benchmark::State& state) {
+		const Matrix4x4 viewProjection = Multiply(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.2f, 0.3f, 0.0f }, { 0.0f, 0.0f, -10.0f }),
+			MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+		std::vector<Matrix4x4> result(kMatrixCount);
+		for (auto _ : state) {
+			for (size_t i = 0; i < kMatrixCount; ++i) {
+				const float t = static_cast<float>(i) * 0.01f;
+				result[i] = Multiply(MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { t, t * 0.5f, 0.0f }, { t, 0.0f, -t }), viewProjection);
+			}
+			benchmark::DoNotOptimize(result.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kMatrixCount);
+	}
+	BENCHMARK(BM_MakeAffineAndWorldViewProjection);
+
+	// 逆行列 (4x4の一般解、アフィン、剛体変換)
+	// 入力はそれぞれの関数が受け付ける形の行列にする
+	std::vector<Matrix4x4> MakeInverseInputs(int kind) {
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+		std::vector<Matrix4x4> matrices = MakeRandomMatrices(kMatrixCount, 8);
+		for (Matrix4x4& matrix : matrices) {
+			if (kind == 0) {
+				// 対角を大きくして正則にする
+				for (int i = 0; i < 4; ++i) {
+					matrix.m[i][i] += 4.0f;
+				}
+			} else {
+				const Vector3 s = kind == 1 ? Vector3{ scale(random), scale(random), scale(random) } : Vector3{ 1.0f, 1.0f, 1.0f };
+				matrix = MakeAffineMatrix(s, { angle(random), angle(random), angle(random) }, { matrix.m[0][0], matrix.m[1][1], matrix.m[2][2] });
+			}
+		}
+		return matrices;
+	}
+
+	template <Matrix4x4 (*InverseFunction)(const Matrix4x4&)>
+	void BM_Inverse(benchmark::State& state) {
+		const std::vector<Matrix4x4> m = MakeInverseInputs(static_cast<int>(state.range(0)));
+		std::vector<Matrix4x4> result(kMatrixCount);
+		for (auto _ : state) {
+			for (size_t i = 0; i < kMatrixCount; ++i) {
+				result[i] = InverseFunction(m[i]);
+			}
+			benchmark::DoNotOptimize(result.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kMatrixCount);
+	}
+	// 引数は入力の種類 (0: 一般, 1: アフィン, 2: 剛体変換)
+	BENCHMARK(BM_Inverse<Inverse>)->Arg(0)->Arg(1);
+	BENCHMARK(BM_Inverse<InverseAffine>)->Arg(1);
+	BENCHMARK(BM_Inverse<InverseRigid>)->Arg(2);
+}
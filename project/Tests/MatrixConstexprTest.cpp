@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "Matrix.h"
+
+// Matrix.hのconstexprの演算がコンパイル時に計算できることをstatic_assertで確かめる
+// (constexprでなくなったり、コンパイル時に呼べない処理が入ったりするとビルドが通らなくなる)
+// 実行時のSIMD版と同じ結果になるかはTESTで確かめる
+
+namespace {
+	constexpr float kScreenWidth = 1280.0f;
+	constexpr float kScreenHeight = 720.0f;
+
+	constexpr bool NearlyEqual(float a, float b, float tolerance = 1e-6f) {
+		return (a > b ? a - b : b - a) <= tolerance;
+	}
+
+	constexpr bool MatrixEqual(const Matrix4x4& a, const Matrix4x4& b) {
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				if (a.m[i][j] != b.m[i][j]) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	// 単位行列
+	constexpr Matrix4x4 kIdentity = MakeIdentity4x4();
+	static_assert(kIdentity.m[0][0] == 1.0f && kIdentity.m[1][1] == 1.0f && kIdentity.m[2][2] == 1.0f && kIdentity.m[3][3] == 1.0f);
+	static_assert(kIdentity.m[0][1] == 0.0f && kIdentity.m[3][0] == 0.0f);
+	static_assert(IsAffine(kIdentity));
+
+	// Sprite::Updateが作る正射影行列 (左上が(0, 0)、右下が画面サイズ)
+	constexpr Matrix4x4 kSpriteProjection = MakeOrthographicMatrix(0.0f, 0.0f, kScreenWidth, kScreenHeight, 0.1f, 100.0f);
+	static_assert(kSpriteProjection.m[0][0] == 2.0f / kScreenWidth);
+	static_assert(kSpriteProjection.m[1][1] == -2.0f / kScreenHeight);
+	static_assert(kSpriteProjection.m[3][0] == -1.0f && kSpriteProjection.m[3][1] == 1.0f);
+	static_assert(kSpriteProjection.m[2][2] == 1.0f / (100.0f - 0.1f));
+	static_assert(IsAffine(kSpriteProjection));
+
+	// 画面の中央に置いたスプライトのWVPもコンパイル時に求まり、NDCの原点に来る
+	constexpr Matrix4x4 kCenterWorld = MakeTranslateMatrix({ kScreenWidth * 0.5f, kScreenHeight * 0.5f, 0.0f });
+	constexpr Matrix4x4 kCenterWvp = Multiply(kCenterWorld, kSpriteProjection);
+	static_assert(NearlyEqual(kCenterWvp.m[3][0], 0.0f) && NearlyEqual(kCenterWvp.m[3][1], 0.0f));
+	static_assert(MatrixEqual(Multiply(kIdentity, kSpriteProjection), kSpriteProjection));
+	static_assert(MatrixEqual(kIdentity * kSpriteProjection, kSpriteProjection));
+
+	constexpr Matrix4x4 kScaleTranslate = MakeScaleMatrix({ 2.0f, 3.0f, 4.0f }) * MakeTranslateMatrix({ 1.0f, 2.0f, 3.0f });
+	static_assert(kScaleTranslate.m[0][0] == 2.0f && kScaleTranslate.m[1][1] == 3.0f && kScaleTranslate.m[2][2] == 4.0f);
+	static_assert(kScaleTranslate.m[3][0] == 1.0f && kScaleTranslate.m[3][1] == 2.0f && kScaleTranslate.m[3][2] == 3.0f);
+
+	// ベクトルの小さな演算
+	constexpr Vector3 kSum = Vector3{ 1.0f, 2.0f, 3.0f } + Vector3{ 4.0f, 5.0f, 6.0f };
+	static_assert(kSum.x == 5.0f && kSum.y == 7.0f && kSum.z == 9.0f);
+	constexpr Vector3 kScaled = Multiply(2.0f, Subtract(Vector3{ 4.0f, 5.0f, 6.0f }, Vector3{ 1.0f, 1.0f, 1.0f })) / 2.0f;
+	static_assert(kScaled.x == 3.0f && kScaled.y == 4.0f && kScaled.z == 5.0f);
+	constexpr Vector2 kUv = Vector2{ 0.25f, 0.5f } * Vector2{ 2.0f, 2.0f } - Vector2{ 0.5f, 0.5f };
+	static_assert(kUv.x == 0.0f && kUv.y == 0.5f);
+	static_assert(Determinant3x3(1.0f, 0.0f, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f, 3.0f) == 6.0f);
+}
+
+TEST(MatrixConstexprTest, ConstantMatchesRuntimeMultiply) {
+	// 実行時はMathDetail::MultiplyRuntime(SIMD版)を通るので、コンパイル時の結果と比べる
+	volatile float width = kScreenWidth;
+	volatile float height = kScreenHeight;
+	const Matrix4x4 projection = MakeOrthographicMatrix(0.0f, 0.0f, width, height, 0.1f, 100.0f);
+	const Matrix4x4 world = MakeTranslateMatrix({ width * 0.5f, height * 0.5f, 0.0f });
+	const Matrix4x4 wvp = Multiply(world, projection);
+	for (int i = 0; i < 4; ++i) {
+		for (int j = 0; j < 4; ++j) {
+			EXPECT_EQ(projection.m[i][j], kSpriteProjection.m[i][j]);
+			EXPECT_NEAR(wvp.m[i][j], kCenterWvp.m[i][j], 1e-6f);
+		}
+	}
+}
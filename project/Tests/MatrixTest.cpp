@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include "Matrix.h"
+#include "MathConfig.h"
+
+// Matrix.cppのSIMD実装(SSE/AVX)とスカラー実装が、doubleで素直に計算した結果と合うかを確かめる
+// 同じテストをCG2Tests(既定)、CG2TestsScalar、CG2TestsAvxでビルドするので、どの実装でも通る必要がある
+
+namespace {
+	// doubleの4x4行列 (テストの基準)
+	struct ReferenceMatrix {
+		double m[4][4];
+	};
+
+	ReferenceMatrix ToReference(const Matrix4x4& matrix) {
+		ReferenceMatrix result{};
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				result.m[i][j] = matrix.m[i][j];
+			}
+		}
+		return result;
+	}
+
+	ReferenceMatrix ReferenceMultiply(const ReferenceMatrix& a, const ReferenceMatrix& b) {
+		ReferenceMatrix result{};
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				for (int k = 0; k < 4; ++k) {
+					result.m[i][j] += a.m[i][k] * b.m[k][j];
+				}
+			}
+		}
+		return result;
+	}
+
+	// 積の各要素の誤差の上限 (|a||b|の和に比例する)
+	ReferenceMatrix MultiplyErrorScale(const Matrix4x4& a, const Matrix4x4& b) {
+		ReferenceMatrix result{};
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				for (int k = 0; k < 4; ++k) {
+					result.m[i][j] += std::abs(double(a.m[i][k]) * double(b.m[k][j]));
+				}
+			}
+		}
+		return result;
+	}
+
+	Matrix4x4 RandomMatrix(std::mt19937& random, float range = 10.0f) {
+		std::uniform_real_distribution<float> distribution(-range, range);
+		Matrix4x4 result;
+		for (auto& row : result.m) {
+			for (float& value : row) {
+				value = distribution(random);
+			}
+		}
+		return result;
+	}
+
+	// 誤差なしで一致するか (要素ごとの演算は1回の丸めなのでSIMDでも同じになる)
+	void ExpectEqual(const Matrix4x4& actual, const Matrix4x4& expected) {
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_EQ(actual.m[i][j], expected.m[i][j]) << "m[" << i << "][" << j << "]";
+			}
+		}
+	}
+
+	void ExpectNear(const Matrix4x4& actual, const ReferenceMatrix& expected, const ReferenceMatrix& errorScale) {
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				// 4回の積和の丸め + 最後の丸め
+				const double tolerance = 5.0 * FLT_EPSILON * errorScale.m[i][j] + FLT_MIN;
+				EXPECT_NEAR(actual.m[i][j], expected.m[i][j], tolerance) << "m[" << i << "][" << j << "]";
+			}
+		}
+	}
+
+	constexpr Matrix4x4 kConstantA = { {
+		{ 1.0f, 2.0f, 3.0f, 4.0f },
+		{ -5.0f, 6.0f, -7.0f, 8.0f },
+		{ 0.5f, 0.25f, -0.125f, 2.0f },
+		{ 9.0f, -10.0f, 11.0f, 1.0f },
+	} };
+	constexpr Matrix4x4 kConstantB = { {
+		{ 0.0f, 1.0f, -1.0f, 2.0f },
+		{ 3.0f, -0.5f, 4.0f, 0.0f },
+		{ 1.5f, 2.0f, 0.0f, -3.0f },
+		{ -2.0f, 0.0f, 1.0f, 1.0f },
+	} };
+}
+
+TEST(MatrixTest, MultiplyMatchesReference) {
+	std::mt19937 random(1);
+	for (int n = 0; n < 1000; ++n) {
+		const Matrix4x4 a = RandomMatrix(random);
+		const Matrix4x4 b = RandomMatrix(random);
+		ExpectNear(Multiply(a, b), ReferenceMultiply(ToReference(a), ToReference(b)), MultiplyErrorScale(a, b));
+	}
+}
+
+TEST(MatrixTest, MultiplyRuntimeMatchesConstexpr) {
+	// コンパイル時はスカラーで計算される。小さな整数と2のべき乗の分数なので丸め誤差も出ない
+	constexpr Matrix4x4 expected = Multiply(kConstantA, kConstantB);
+	volatile float scale = 1.0f;
+	Matrix4x4 a = kConstantA;
+	a.m[0][0] *= scale;
+	ExpectEqual(Multiply(a, kConstantB), expected);
+	ExpectEqual(a * kConstantB, expected);
+}
+
+TEST(MatrixTest, MultiplyAssignMatchesMultiply) {
+	std::mt19937 random(2);
+	for (int n = 0; n < 100; ++n) {
+		const Matrix4x4 a = RandomMatrix(random);
+		const Matrix4x4 b = RandomMatrix(random);
+		Matrix4x4 c = a;
+		c *= b;
+		ExpectEqual(c, Multiply(a, b));
+	}
+}
+
+TEST(MatrixTest, ElementwiseOperationsAreExact) {
+	std::mt19937 random(3);
+	for (int n = 0; n < 100; ++n) {
+		const Matrix4x4 a = RandomMatrix(random);
+		const Matrix4x4 b = RandomMatrix(random);
+		const float s = std::uniform_real_distribution<float>(-4.0f, 4.0f)(random);
+		Matrix4x4 sum, difference, scaled;
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				sum.m[i][j] = a.m[i][j] + b.m[i][j];
+				difference.m[i][j] = a.m[i][j] - b.m[i][j];
+				scaled.m[i][j] = a.m[i][j] * s;
+			}
+		}
+		ExpectEqual(Add(a, b), sum);
+		ExpectEqual(a + b, sum);
+		ExpectEqual(Subtract(a, b), difference);
+		ExpectEqual(a - b, difference);
+		ExpectEqual(a * s, scaled);
+		ExpectEqual(s * a, scaled);
+		Matrix4x4 c = a;
+		c *= s;
+		ExpectEqual(c, scaled);
+	}
+}
+
+TEST(MatrixTest, TransformNormalMatchesReference) {
+	std::mt19937 random(4);
+	std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+	for (int n = 0; n < 1000; ++n) {
+		const Matrix4x4 m = RandomMatrix(random);
+		const Vector3 v = { distribution(random), distribution(random), distribution(random) };
+		const Vector3 result = TransformNormal(v, m);
+		const float actual[3] = { result.x, result.y, result.z };
+		for (int j = 0; j < 3; ++j) {
+			const double expected = double(v.x) * m.m[0][j] + double(v.y) * m.m[1][j] + double(v.z) * m.m[2][j];
+			const double scale = std::abs(double(v.x) * m.m[0][j]) + std::abs(double(v.y) * m.m[1][j]) + std::abs(double(v.z) * m.m[2][j]);
+			EXPECT_NEAR(actual[j], expected, 4.0 * FLT_EPSILON * scale + FLT_MIN);
+		}
+	}
+}
+
+TEST(MatrixTest, AffineMatchesScaleRotateTranslateProduct) {
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+	std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+	std::uniform_real_distribution<float> translate(-100.0f, 100.0f);
+	for (int n = 0; n < 1000; ++n) {
+		const Vector3 s = { scale(random), scale(random), scale(random) };
+		const Vector3 r = { angle(random), angle(random), angle(random) };
+		const Vector3 t = { translate(random), translate(random), translate(random) };
+		// S * Rx * Ry * Rz * T をdoubleで掛けたもの
+		ReferenceMatrix expected = ToReference(MakeScaleMatrix(s));
+		expected = ReferenceMultiply(expected, ToReference(MakeRotateXMatrix(r.x)));
+		expected = ReferenceMultiply(expected, ToReference(MakeRotateYMatrix(r.y)));
+		expected = ReferenceMultiply(expected, ToReference(MakeRotateZMatrix(r.z)));
+		expected = ReferenceMultiply(expected, ToReference(MakeTranslateMatrix(t)));
+		const Matrix4x4 actual = MakeAffineMatrix(s, r, t);
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_NEAR(actual.m[i][j], expected.m[i][j], 1e-5 * (1.0 + std::abs(expected.m[i][j])));
+			}
+		}
+		EXPECT_TRUE(IsAffine(actual));
+	}
+}
+
+TEST(MatrixTest, ReportsSimdPath) {
+#if defined(MATH_USE_AVX)
+	RecordProperty("MathPath", "AVX");
+#elif defined(MATH_USE_SSE)
+	RecordProperty("MathPath", "SSE");
+#else
+	RecordProperty("MathPath", "Scalar");
+#endif
+#if defined(MATH_FORCE_SCALAR) && defined(MATH_USE_SSE)
+	FAIL() << "MATH_FORCE_SCALARなのにSSE実装が有効になっている";
+#endif
+}
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <vector>
+#include "MeshGenerator.h"
+
+// 形ごとに次を確かめる
+//  頂点数・インデックス数がヘッダーに書いた式どおりで、nullptrで問い合わせた数とも一致する
+//  インデックスが頂点数の範囲内で、つぶれた三角形が無い
+//  法線の長さが1
+//  時計回りが表 (左手系で辺の外積が法線と同じ向き = 外向き)
+//  閉じた形は同じ位置の頂点をまとめると、どの辺も逆向きの辺とちょうど1回ずつ組になる (穴や裏返った面が無い)
+
+namespace {
+	using Writer = std::function<MeshSize(VertexData*, uint32_t*)>;
+
+	struct Mesh {
+		std::vector<VertexData> vertices;
+		std::vector<uint32_t> indices;
+	};
+
+	Vector3 ToVector3(const Vector4& position) {
+		return { position.x, position.y, position.z };
+	}
+
+	float Dot(const Vector3& a, const Vector3& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	Vector3 Cross(const Vector3& a, const Vector3& b) {
+		return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	Mesh WriteMesh(const Writer& writer, const MeshSize& expected) {
+		const MeshSize size = writer(nullptr, nullptr);
+		EXPECT_EQ(size.vertexCount, expected.vertexCount);
+		EXPECT_EQ(size.indexCount, expected.indexCount);
+		Mesh mesh;
+		mesh.vertices.resize(size.vertexCount);
+		mesh.indices.resize(size.indexCount);
+		const MeshSize written = writer(mesh.vertices.data(), mesh.indices.data());
+		EXPECT_EQ(written.vertexCount, size.vertexCount);
+		EXPECT_EQ(written.indexCount, size.indexCount);
+		return mesh;
+	}
+
+	// インデックスの範囲、法線の長さ、巻き順を確かめる
+	void ExpectValidMesh(const Mesh& mesh) {
+		ASSERT_EQ(mesh.indices.size() % 3, 0u);
+		for (uint32_t index : mesh.indices) {
+			ASSERT_LT(index, mesh.vertices.size());
+		}
+		for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+			ASSERT_NEAR(Length(mesh.vertices[i].normal), 1.0f, 1e-5f) << "vertex " << i;
+			ASSERT_EQ(mesh.vertices[i].position.w, 1.0f) << "vertex " << i;
+		}
+		for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+			const VertexData& a = mesh.vertices[mesh.indices[t]];
+			const VertexData& b = mesh.vertices[mesh.indices[t + 1]];
+			const VertexData& c = mesh.vertices[mesh.indices[t + 2]];
+			const Vector3 pa = ToVector3(a.position);
+			const Vector3 faceNormal = Cross(ToVector3(b.position) - pa, ToVector3(c.position) - pa);
+			ASSERT_GT(Length(faceNormal), 0.0f) << "triangle " << t / 3;
+			const Vector3 vertexNormal = a.normal + b.normal + c.normal;
+			ASSERT_GT(Dot(Normalize(faceNormal), Normalize(vertexNormal)), 0.5f) << "triangle " << t / 3;
+		}
+	}
+
+	// 同じ位置の頂点 (UVの継ぎ目や面ごとに分けた頂点) をまとめた番号
+	std::vector<uint32_t> WeldPositions(const Mesh& mesh) {
+		std::map<std::tuple<long, long, long>, uint32_t> ids;
+		std::vector<uint32_t> welded(mesh.vertices.size());
+		for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+			const Vector4& p = mesh.vertices[i].position;
+			const auto key = std::make_tuple(std::lround(p.x * 1e4f), std::lround(p.y * 1e4f), std::lround(p.z * 1e4f));
+			welded[i] = ids.emplace(key, static_cast<uint32_t>(ids.size())).first->second;
+		}
+		return welded;
+	}
+
+	// 閉じた形は、向きのある辺a→bがちょうど1回、その逆b→aもちょうど1回ずつ現れる
+	void ExpectClosed(const Mesh& mesh) {
+		const std::vector<uint32_t> welded = WeldPositions(mesh);
+		std::map<std::pair<uint32_t, uint32_t>, int> edges;
+		for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+			for (size_t k = 0; k < 3; ++k) {
+				const uint32_t from = welded[mesh.indices[t + k]];
+				const uint32_t to = welded[mesh.indices[t + (k + 1) % 3]];
+				++edges[{ from, to }];
+			}
+		}
+		for (const auto& [edge, count] : edges) {
+			ASSERT_EQ(count, 1) << "edge " << edge.first << "->" << edge.second;
+			const auto reverse = edges.find({ edge.second, edge.first });
+			ASSERT_NE(reverse, edges.end()) << "edge " << edge.first << "->" << edge.second;
+		}
+	}
+}
+
+TEST(MeshGeneratorTest, Sphere) {
+	// 分割2は経度が2本しかなく、表と裏が重なった板になるので数だけ確かめる
+	const MeshSize minimum = WriteSphere(nullptr, nullptr, 2);
+	EXPECT_EQ(minimum.vertexCount, 9u);
+	EXPECT_EQ(minimum.indexCount, 12u);
+
+	for (uint32_t subdivision : { 3u, 16u, 33u }) {
+		SCOPED_TRACE(subdivision);
+		const float radius = 1.5f;
+		const Mesh mesh = WriteMesh([&](VertexData* v, uint32_t* i) { return WriteSphere(v, i, subdivision, radius); },
+			{ (subdivision + 1) * (subdivision + 1), 6 * subdivision * (subdivision - 1) });
+		ExpectValidMesh(mesh);
+		ExpectClosed(mesh);
+		// 位置は半径の球面上、法線は中心からの向き
+		for (const VertexData& vertex : mesh.vertices) {
+			const Vector3 position = ToVector3(vertex.position);
+			EXPECT_NEAR(Length(position), radius, 1e-5f);
+			EXPECT_NEAR(Dot(Normalize(position), vertex.normal), 1.0f, 1e-5f);
+		}
+	}
+}
+
+TEST(MeshGeneratorTest, Cube) {
+	const float size = 2.0f;
+	const Mesh mesh = WriteMesh([&](VertexData* v, uint32_t* i) { return WriteCube(v, i, size); }, { 24, 36 });
+	ExpectValidMesh(mesh);
+	ExpectClosed(mesh);
+	// 頂点は角にあり、法線の向きの座標が半分の大きさ
+	for (const VertexData& vertex : mesh.vertices) {
+		EXPECT_FLOAT_EQ(std::fabs(vertex.position.x), size * 0.5f);
+		EXPECT_FLOAT_EQ(std::fabs(vertex.position.y), size * 0.5f);
+		EXPECT_FLOAT_EQ(std::fabs(vertex.position.z), size * 0.5f);
+		EXPECT_FLOAT_EQ(Dot(ToVector3(vertex.position), vertex.normal), size * 0.5f);
+	}
+}
+
+TEST(MeshGeneratorTest, Plane) {
+	const Mesh mesh = WriteMesh([](VertexData* v, uint32_t* i) { return WritePlane(v, i, 3.0f, 2.0f); }, { 4, 6 });
+	ExpectValidMesh(mesh);
+	for (const VertexData& vertex : mesh.vertices) {
+		EXPECT_EQ(vertex.normal.z, -1.0f);
+		EXPECT_EQ(vertex.position.z, 0.0f);
+		EXPECT_FLOAT_EQ(std::fabs(vertex.position.x), 1.5f);
+		EXPECT_FLOAT_EQ(std::fabs(vertex.position.y), 1.0f);
+	}
+	// 左上がUV(0,0)
+	EXPECT_EQ(mesh.vertices[0].position.x, -1.5f);
+	EXPECT_EQ(mesh.vertices[0].position.y, 1.0f);
+	EXPECT_EQ(mesh.vertices[0].texcoord.x, 0.0f);
+	EXPECT_EQ(mesh.vertices[0].texcoord.y, 0.0f);
+}
+
+TEST(MeshGeneratorTest, Cylinder) {
+	for (uint32_t slices : { 3u, 4u, 32u }) {
+		SCOPED_TRACE(slices);
+		const float radius = 0.75f;
+		const float height = 2.0f;
+		const Mesh mesh = WriteMesh([&](VertexData* v, uint32_t* i) { return WriteCylinder(v, i, slices, radius, height); },
+			{ 4 * (slices + 1), 12 * slices });
+		ExpectValidMesh(mesh);
+		ExpectClosed(mesh);
+		for (const VertexData& vertex : mesh.vertices) {
+			EXPECT_FLOAT_EQ(std::fabs(vertex.position.y), height * 0.5f);
+			// 側面は周の上、ふたは中心か周の上
+			const float distance = std::hypot(vertex.position.x, vertex.position.z);
+			if (vertex.normal.y == 0.0f) {
+				EXPECT_NEAR(distance, radius, 1e-6f);
+			} else {
+				EXPECT_TRUE(distance == 0.0f || std::fabs(distance - radius) < 1e-6f) << distance;
+				EXPECT_EQ(vertex.normal.y, vertex.position.y > 0.0f ? 1.0f : -1.0f);
+			}
+		}
+	}
+}
+
+TEST(MeshGeneratorTest, Torus) {
+	for (auto [majorSegments, minorSegments] : { std::pair{ 3u, 3u }, std::pair{ 48u, 24u }, std::pair{ 7u, 31u } }) {
+		SCOPED_TRACE(testing::Message() << majorSegments << "x" << minorSegments);
+		const float majorRadius = 2.0f;
+		const float minorRadius = 0.5f;
+		const Mesh mesh = WriteMesh([&](VertexData* v, uint32_t* i) { return WriteTorus(v, i, majorSegments, minorSegments, majorRadius, minorRadius); },
+			{ (majorSegments + 1) * (minorSegments + 1), 6 * majorSegments * minorSegments });
+		ExpectValidMesh(mesh);
+		ExpectClosed(mesh);
+		// 位置から法線の向きに管の半径だけ戻ると、輪の上 (XZ平面、中心から輪の半径) に来る
+		for (const VertexData& vertex : mesh.vertices) {
+			const Vector3 center = ToVector3(vertex.position) - minorRadius * vertex.normal;
+			EXPECT_NEAR(center.y, 0.0f, 1e-5f);
+			EXPECT_NEAR(std::hypot(center.x, center.z), majorRadius, 1e-5f);
+		}
+	}
+}
+
+TEST(MeshGeneratorTest, Grid) {
+	for (auto [divisionX, divisionZ] : { std::pair{ 1u, 1u }, std::pair{ 4u, 3u }, std::pair{ 64u, 17u } }) {
+		SCOPED_TRACE(testing::Message() << divisionX << "x" << divisionZ);
+		const Mesh mesh = WriteMesh([&](VertexData* v, uint32_t* i) { return WriteGrid(v, i, divisionX, divisionZ, 4.0f, 2.0f); },
+			{ (divisionX + 1) * (divisionZ + 1), 6 * divisionX * divisionZ });
+		ExpectValidMesh(mesh);
+		for (const VertexData& vertex : mesh.vertices) {
+			EXPECT_EQ(vertex.normal.y, 1.0f);
+			EXPECT_EQ(vertex.position.y, 0.0f);
+			EXPECT_LE(std::fabs(vertex.position.x), 2.0f);
+			EXPECT_LE(std::fabs(vertex.position.z), 1.0f);
+			EXPECT_GE(vertex.texcoord.x, 0.0f);
+			EXPECT_LE(vertex.texcoord.x, 1.0f);
+			EXPECT_GE(vertex.texcoord.y, 0.0f);
+			EXPECT_LE(vertex.texcoord.y, 1.0f);
+		}
+		// 上から見て+Zが画像の上 (左奥がUV(0,0)、右手前が(1,1))
+		EXPECT_EQ(mesh.vertices.front().position.x, -2.0f);
+		EXPECT_EQ(mesh.vertices.front().position.z, 1.0f);
+		EXPECT_EQ(mesh.vertices.back().texcoord.x, 1.0f);
+		EXPECT_EQ(mesh.vertices.back().texcoord.y, 1.0f);
+	}
+}
+
+TEST(MeshGeneratorTest, GenerateFillsModelData) {
+	ModelData modelData;
+	GenerateTorus(modelData, 12, 8);
+	EXPECT_EQ(modelData.vertices.size(), 13u * 9u);
+	EXPECT_EQ(modelData.indices.size(), 6u * 12u * 8u);
+	ASSERT_EQ(modelData.materials.size(), 1u);
+	ASSERT_EQ(modelData.subMeshes.size(), 1u);
+	EXPECT_EQ(modelData.subMeshes[0].indexOffset, 0u);
+	EXPECT_EQ(modelData.subMeshes[0].indexCount, modelData.indices.size());
+	ASSERT_EQ(modelData.lods.size(), 1u);
+	EXPECT_NEAR(modelData.bounds.max.x, 1.25f, 1e-5f);
+	EXPECT_NEAR(modelData.bounds.min.y, -0.25f, 1e-5f);
+
+	// 作り直すと前の形は残らず、配列の容量は使い回す
+	const VertexData* vertexBuffer = modelData.vertices.data();
+	GenerateCube(modelData);
+	EXPECT_EQ(modelData.vertices.size(), 24u);
+	EXPECT_EQ(modelData.indices.size(), 36u);
+	EXPECT_EQ(modelData.vertices.data(), vertexBuffer);
+	EXPECT_EQ(modelData.subMeshes.size(), 1u);
+	EXPECT_EQ(modelData.subMeshes[0].indexCount, 36u);
+}
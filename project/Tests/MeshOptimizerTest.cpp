@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "MeshGenerator.h"
+#include "MeshOptimizer.h"
+
+// 三角形と頂点の順をばらばらにしたメッシュをOptimizeModelに通し、
+// ACMR/ATVRが下がること、SubMeshごとの三角形の集まり(巻き順を含む)が変わらないことを確かめる
+
+namespace {
+	// 頂点の中身をバイト列で比べる (並べ替えで番号が変わっても同じ頂点として扱う)
+	using VertexBytes = std::array<unsigned char, sizeof(VertexData)>;
+	using Triangle = std::array<VertexBytes, 3>;
+
+	VertexBytes ToBytes(const VertexData& vertex) {
+		VertexBytes bytes;
+		std::memcpy(bytes.data(), &vertex, sizeof(VertexData));
+		return bytes;
+	}
+
+	// 巻き順を保ったまま、一番小さい頂点が先頭になるよう回す
+	Triangle Canonical(const VertexBytes& a, const VertexBytes& b, const VertexBytes& c) {
+		if (b < a && b < c) {
+			return { b, c, a };
+		}
+		if (c < a && c < b) {
+			return { c, a, b };
+		}
+		return { a, b, c };
+	}
+
+	// SubMeshごとの三角形を並びによらない形で取り出す
+	std::vector<std::vector<Triangle>> CollectTriangles(const ModelData& modelData) {
+		std::vector<std::vector<Triangle>> result;
+		for (const SubMesh& subMesh : modelData.subMeshes) {
+			std::vector<Triangle> triangles;
+			for (uint32_t i = 0; i + 2 < subMesh.indexCount; i += 3) {
+				const uint32_t* t = modelData.indices.data() + subMesh.indexOffset + i;
+				triangles.push_back(Canonical(ToBytes(modelData.vertices[t[0]]), ToBytes(modelData.vertices[t[1]]), ToBytes(modelData.vertices[t[2]])));
+			}
+			std::sort(triangles.begin(), triangles.end());
+			result.push_back(std::move(triangles));
+		}
+		return result;
+	}
+
+	// 三角形の順、三角形内の頂点の回し方、頂点の並びをばらばらにする
+	void Shuffle(ModelData& modelData, uint32_t seed) {
+		std::mt19937 random(seed);
+		const size_t triangleCount = modelData.indices.size() / 3;
+		std::vector<size_t> order(triangleCount);
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::shuffle(order.begin(), order.end(), random);
+		std::vector<uint32_t> indices(modelData.indices.size());
+		for (size_t t = 0; t < triangleCount; ++t) {
+			const uint32_t* source = modelData.indices.data() + order[t] * 3;
+			const uint32_t rotate = random() % 3;
+			for (uint32_t k = 0; k < 3; ++k) {
+				indices[t * 3 + k] = source[(k + rotate) % 3];
+			}
+		}
+
+		std::vector<uint32_t> permutation(modelData.vertices.size());
+		std::iota(permutation.begin(), permutation.end(), 0u);
+		std::shuffle(permutation.begin(), permutation.end(), random);
+		std::vector<VertexData> vertices(modelData.vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			vertices[permutation[i]] = modelData.vertices[i];
+		}
+		for (uint32_t& index : indices) {
+			index = permutation[index];
+		}
+		modelData.vertices = std::move(vertices);
+		modelData.indices = std::move(indices);
+	}
+
+	// 1つのSubMeshを2つに分けて、マテリアルごとに並べ替えられることも確かめる
+	void SplitSubMesh(ModelData& modelData) {
+		const uint32_t indexCount = static_cast<uint32_t>(modelData.indices.size());
+		const uint32_t half = indexCount / 6 * 3;
+		modelData.materials.resize(2);
+		modelData.subMeshes = {
+			{ 0, half, 0, 0, 0 },
+			{ half, indexCount - half, 1, 0, 0 },
+		};
+	}
+
+	VertexCacheStats Analyze(const ModelData& modelData) {
+		return AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+	}
+
+	void ExpectOptimized(ModelData modelData) {
+		const std::vector<std::vector<Triangle>> expected = CollectTriangles(modelData);
+		const std::vector<SubMesh> subMeshes = modelData.subMeshes;
+		const VertexCacheStats before = Analyze(modelData);
+
+		OptimizeModel(modelData);
+
+		const VertexCacheStats after = Analyze(modelData);
+		EXPECT_LT(after.acmr, before.acmr);
+		EXPECT_LT(after.atvr, before.atvr);
+		EXPECT_EQ(after.triangleCount, before.triangleCount);
+		EXPECT_EQ(after.vertexCount, before.vertexCount);
+		// 使われていない頂点 (球の極の余りなど) だけ取り除かれる
+		EXPECT_EQ(modelData.vertices.size(), before.vertexCount);
+
+		// SubMeshの範囲は変えず、範囲内の三角形も巻き順ごと同じ
+		ASSERT_EQ(modelData.subMeshes.size(), subMeshes.size());
+		for (size_t i = 0; i < subMeshes.size(); ++i) {
+			EXPECT_EQ(modelData.subMeshes[i].indexOffset, subMeshes[i].indexOffset);
+			EXPECT_EQ(modelData.subMeshes[i].indexCount, subMeshes[i].indexCount);
+		}
+		EXPECT_EQ(CollectTriangles(modelData), expected);
+
+		// 頂点はインデックスで最初に使われる順に並ぶ
+		uint32_t nextVertex = 0;
+		for (uint32_t index : modelData.indices) {
+			ASSERT_LE(index, nextVertex);
+			if (index == nextVertex) {
+				++nextVertex;
+			}
+		}
+	}
+}
+
+TEST(MeshOptimizerTest, ImprovesShuffledGrid) {
+	ModelData modelData;
+	GenerateGrid(modelData, 64, 64);
+	Shuffle(modelData, 11);
+	ExpectOptimized(modelData);
+
+	// キャッシュ16の格子なら、並べ替え後は三角形あたりのミスが1を十分に下回る
+	OptimizeModel(modelData);
+	EXPECT_LT(Analyze(modelData).acmr, 0.9f);
+}
+
+TEST(MeshOptimizerTest, ImprovesShuffledSphere) {
+	ModelData modelData;
+	GenerateSphere(modelData, 48);
+	Shuffle(modelData, 12);
+	ExpectOptimized(modelData);
+}
+
+TEST(MeshOptimizerTest, KeepsSubMeshRanges) {
+	ModelData modelData;
+	GenerateTorus(modelData, 48, 24);
+	Shuffle(modelData, 13);
+	SplitSubMesh(modelData);
+	ExpectOptimized(modelData);
+}
+
+TEST(MeshOptimizerTest, AnalyzeCountsFifoMisses) {
+	// 2つの三角形が辺を共有すると、2つ目は新しい頂点1つだけがミスになる
+	const uint32_t indices[] = { 0, 1, 2, 2, 1, 3 };
+	const VertexCacheStats stats = AnalyzeVertexCache(indices, 6, 4);
+	EXPECT_EQ(stats.vertexShaded, 4u);
+	EXPECT_EQ(stats.triangleCount, 2u);
+	EXPECT_EQ(stats.vertexCount, 4u);
+	EXPECT_FLOAT_EQ(stats.acmr, 2.0f);
+	EXPECT_FLOAT_EQ(stats.atvr, 1.0f);
+
+	// キャッシュに2つしか入らなければ、0は押し出されてもう一度ミスになる
+	const uint32_t again[] = { 0, 1, 2, 0, 1, 2 };
+	EXPECT_EQ(AnalyzeVertexCache(again, 6, 3, 2).vertexShaded, 6u);
+	EXPECT_EQ(AnalyzeVertexCache(again, 6, 3, 3).vertexShaded, 3u);
+}
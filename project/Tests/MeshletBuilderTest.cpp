@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "MeshGenerator.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+
+// BuildMeshletsがOptimizeModelで並べたインデックスを崩さず、全部の三角形をメッシュレットに入れるかを確かめる
+
+namespace {
+	using Triangle = std::array<uint32_t, 3>;
+
+	// 巻き順を保ったまま、一番小さい頂点番号が先頭になるよう回す (並びによらず比べられるように)
+	Triangle Canonical(uint32_t a, uint32_t b, uint32_t c) {
+		if (b < a && b < c) {
+			return { b, c, a };
+		}
+		if (c < a && c < b) {
+			return { c, a, b };
+		}
+		return { a, b, c };
+	}
+
+	ModelData MakeOptimizedSphere() {
+		ModelData modelData;
+		GenerateSphere(modelData, 32);
+		OptimizeModel(modelData);
+		return modelData;
+	}
+}
+
+TEST(MeshletBuilderTest, KeepsOptimizedIndexOrder) {
+	ModelData modelData = MakeOptimizedSphere();
+	const std::vector<uint32_t> optimizedIndices = modelData.indices;
+	const VertexCacheStats before = AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+	BuildMeshlets(modelData);
+	EXPECT_EQ(modelData.indices, optimizedIndices);
+	const VertexCacheStats after = AnalyzeVertexCache(modelData.indices.data(), modelData.indices.size(), modelData.vertices.size());
+	EXPECT_EQ(after.acmr, before.acmr);
+}
+
+TEST(MeshletBuilderTest, MeshletsCoverEverySubMeshTriangle) {
+	ModelData modelData = MakeOptimizedSphere();
+	BuildMeshlets(modelData);
+	ASSERT_FALSE(modelData.meshlets.empty());
+	ASSERT_EQ(modelData.meshletBounds.size(), modelData.meshlets.size());
+	for (const SubMesh& subMesh : modelData.subMeshes) {
+		std::vector<Triangle> expected;
+		for (uint32_t i = 0; i + 2 < subMesh.indexCount; i += 3) {
+			const uint32_t* t = modelData.indices.data() + subMesh.indexOffset + i;
+			expected.push_back(Canonical(t[0], t[1], t[2]));
+		}
+		std::vector<Triangle> actual;
+		for (uint32_t m = 0; m < subMesh.meshletCount; ++m) {
+			const Meshlet& meshlet = modelData.meshlets[subMesh.meshletOffset + m];
+			EXPECT_LE(meshlet.vertexCount, kMeshletMaxVertices);
+			EXPECT_LE(meshlet.triangleCount, kMeshletMaxTriangles);
+			for (uint32_t i = 0; i < meshlet.triangleCount; ++i) {
+				const uint8_t* local = modelData.meshletTriangles.data() + meshlet.triangleOffset + i * 3;
+				ASSERT_LT(std::max({ local[0], local[1], local[2] }), meshlet.vertexCount);
+				const uint32_t* vertices = modelData.meshletVertices.data() + meshlet.vertexOffset;
+				actual.push_back(Canonical(vertices[local[0]], vertices[local[1]], vertices[local[2]]));
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+		std::sort(actual.begin(), actual.end());
+		EXPECT_EQ(actual, expected);
+	}
+}
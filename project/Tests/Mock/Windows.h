@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+// テスト用のWindows.hの代わり
+// Windows以外でSourceVoicePoolとSpatialAudioをビルドするのに要る分だけを定義する
+
+using BYTE = uint8_t;
+using WORD = uint16_t;
+using DWORD = uint32_t;
+using UINT32 = uint32_t;
+using HRESULT = int32_t;
+
+#define __stdcall
+#define S_OK HRESULT(0)
+#define E_FAIL HRESULT(0x80004005u)
+#define SUCCEEDED(hr) (HRESULT(hr) >= 0)
+#define FAILED(hr) (HRESULT(hr) < 0)
+
+struct GUID {
+	uint32_t Data1;
+	uint16_t Data2;
+	uint16_t Data3;
+	uint8_t Data4[8];
+};
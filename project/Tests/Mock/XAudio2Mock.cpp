@@ -0,0 +1,133 @@
+#include <xAudio2.h>
+#include <algorithm>
+
+IXAudio2SourceVoice::IXAudio2SourceVoice(IXAudio2& owner, const WAVEFORMATEX& format, IXAudio2VoiceCallback* callback)
+	: owner_(owner), format_(format), callback_(callback)
+{
+}
+
+HRESULT IXAudio2SourceVoice::Start(UINT32, UINT32)
+{
+	isStarted_ = true;
+	return S_OK;
+}
+
+HRESULT IXAudio2SourceVoice::Stop(UINT32, UINT32)
+{
+	isStarted_ = false;
+	return S_OK;
+}
+
+HRESULT IXAudio2SourceVoice::SubmitSourceBuffer(const XAUDIO2_BUFFER* buffer, const void*)
+{
+	if (!buffer || !buffer->pAudioData || buffer->AudioBytes == 0) {
+		return E_FAIL;
+	}
+	queued_.push_back(*buffer);
+	return S_OK;
+}
+
+HRESULT IXAudio2SourceVoice::FlushSourceBuffers()
+{
+	// 捨てたバッファのOnBufferEndは、次の処理で呼ばれる
+	for (const XAUDIO2_BUFFER& buffer : queued_) {
+		flushedContexts_.push_back(buffer.pContext);
+	}
+	queued_.clear();
+	return S_OK;
+}
+
+HRESULT IXAudio2SourceVoice::Discontinuity()
+{
+	if (!queued_.empty()) {
+		queued_.back().Flags |= XAUDIO2_END_OF_STREAM;
+	}
+	return S_OK;
+}
+
+HRESULT IXAudio2SourceVoice::SetVolume(float volume, UINT32)
+{
+	volume_ = volume;
+	return S_OK;
+}
+
+HRESULT IXAudio2SourceVoice::SetFrequencyRatio(float ratio, UINT32)
+{
+	frequencyRatio_ = ratio;
+	return S_OK;
+}
+
+HRESULT IXAudio2SourceVoice::SetOutputMatrix(IXAudio2Voice*, UINT32 sourceChannels, UINT32 destinationChannels,
+	const float* levelMatrix, UINT32)
+{
+	if (!levelMatrix || sourceChannels != format_.nChannels) {
+		return E_FAIL;
+	}
+	outputMatrix_.assign(levelMatrix, levelMatrix + size_t(sourceChannels) * destinationChannels);
+	return S_OK;
+}
+
+void IXAudio2SourceVoice::DestroyVoice()
+{
+	owner_.RemoveVoice(this);
+	delete this;
+}
+
+void IXAudio2SourceVoice::Process()
+{
+	std::vector<void*> flushed;
+	flushed.swap(flushedContexts_);
+	for (void* context : flushed) {
+		if (callback_) {
+			callback_->OnBufferEnd(context);
+		}
+	}
+	if (!isStarted_ || queued_.empty()) {
+		return;
+	}
+	const XAUDIO2_BUFFER buffer = queued_.front();
+	queued_.pop_front();
+	if (callback_) {
+		callback_->OnBufferEnd(buffer.pContext);
+		if (buffer.Flags & XAUDIO2_END_OF_STREAM) {
+			callback_->OnStreamEnd();
+		}
+	}
+}
+
+IXAudio2::~IXAudio2()
+{
+	// テストで壊し忘れたボイスも片付ける
+	while (!voices_.empty()) {
+		voices_.back()->DestroyVoice();
+	}
+}
+
+HRESULT IXAudio2::CreateSourceVoice(IXAudio2SourceVoice** sourceVoice, const WAVEFORMATEX* format, UINT32,
+	float, IXAudio2VoiceCallback* callback, const void*, const void*)
+{
+	if (!sourceVoice || !format || isNextCreateFailed_) {
+		isNextCreateFailed_ = false;
+		return E_FAIL;
+	}
+	*sourceVoice = new IXAudio2SourceVoice(*this, *format, callback);
+	voices_.push_back(*sourceVoice);
+	++createdVoiceCount_;
+	return S_OK;
+}
+
+void IXAudio2::Process()
+{
+	// コールバックの中でボイスが増減しても大丈夫なように写してから回す
+	const std::vector<IXAudio2SourceVoice*> voices = voices_;
+	for (IXAudio2SourceVoice* voice : voices) {
+		if (std::find(voices_.begin(), voices_.end(), voice) != voices_.end()) {
+			voice->Process();
+		}
+	}
+}
+
+void IXAudio2::RemoveVoice(IXAudio2SourceVoice* voice)
+{
+	voices_.erase(std::remove(voices_.begin(), voices_.end(), voice), voices_.end());
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <Windows.h>
+#include <mmreg.h>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+// テスト用のxAudio2.hの代わり
+// ボイスは音を出さず、積まれたバッファをIXAudio2::Processで1つずつ終わらせてコールバックを呼ぶ
+// (XAudio2のスレッドの代わりに、テストのスレッドから決まった順番で呼ぶ)
+
+#define XAUDIO2_COMMIT_NOW 0
+#define XAUDIO2_END_OF_STREAM 0x0040
+#define XAUDIO2_DEFAULT_FREQ_RATIO 2.0f
+#define XAUDIO2_MIN_FREQ_RATIO (1.0f / 1024.0f)
+
+struct XAUDIO2_BUFFER {
+	UINT32 Flags;
+	UINT32 AudioBytes;
+	const BYTE* pAudioData;
+	UINT32 PlayBegin;
+	UINT32 PlayLength;
+	UINT32 LoopBegin;
+	UINT32 LoopLength;
+	UINT32 LoopCount;
+	void* pContext;
+};
+
+class IXAudio2VoiceCallback
+{
+public:
+	virtual void __stdcall OnVoiceProcessingPassStart(UINT32 bytesRequired) = 0;
+	virtual void __stdcall OnVoiceProcessingPassEnd() = 0;
+	virtual void __stdcall OnStreamEnd() = 0;
+	virtual void __stdcall OnBufferStart(void* bufferContext) = 0;
+	virtual void __stdcall OnBufferEnd(void* bufferContext) = 0;
+	virtual void __stdcall OnLoopEnd(void* bufferContext) = 0;
+	virtual void __stdcall OnVoiceError(void* bufferContext, HRESULT error) = 0;
+
+protected:
+	~IXAudio2VoiceCallback() = default;
+};
+
+class IXAudio2;
+class IXAudio2Voice;
+
+class IXAudio2SourceVoice
+{
+public:
+	IXAudio2SourceVoice(IXAudio2& owner, const WAVEFORMATEX& format, IXAudio2VoiceCallback* callback);
+
+	HRESULT Start(UINT32 flags = 0, UINT32 operationSet = XAUDIO2_COMMIT_NOW);
+	HRESULT Stop(UINT32 flags = 0, UINT32 operationSet = XAUDIO2_COMMIT_NOW);
+	HRESULT SubmitSourceBuffer(const XAUDIO2_BUFFER* buffer, const void* bufferWma = nullptr);
+	HRESULT FlushSourceBuffers();
+	HRESULT Discontinuity();
+	HRESULT SetVolume(float volume, UINT32 operationSet = XAUDIO2_COMMIT_NOW);
+	HRESULT SetFrequencyRatio(float ratio, UINT32 operationSet = XAUDIO2_COMMIT_NOW);
+	HRESULT SetOutputMatrix(IXAudio2Voice* destination, UINT32 sourceChannels, UINT32 destinationChannels,
+		const float* levelMatrix, UINT32 operationSet = XAUDIO2_COMMIT_NOW);
+	// 積んであったバッファのコールバックは呼ばずに消える
+	void DestroyVoice();
+
+	// ---- テスト用 ----
+
+	// 捨てたバッファを全部、鳴っていれば先頭のバッファを1つ終わらせる
+	void Process();
+	const WAVEFORMATEX& GetFormat() const { return format_; }
+	bool IsStarted() const { return isStarted_; }
+	size_t GetQueuedCount() const { return queued_.size(); }
+	float GetVolume() const { return volume_; }
+	float GetFrequencyRatio() const { return frequencyRatio_; }
+	// level[出力 * 入力の数 + 入力]
+	const std::vector<float>& GetOutputMatrix() const { return outputMatrix_; }
+
+private:
+	IXAudio2& owner_;
+	WAVEFORMATEX format_;
+	IXAudio2VoiceCallback* callback_;
+	std::deque<XAUDIO2_BUFFER> queued_;
+	std::vector<void*> flushedContexts_;
+	std::vector<float> outputMatrix_;
+	float volume_ = 1.0f;
+	float frequencyRatio_ = 1.0f;
+	bool isStarted_ = false;
+};
+
+class IXAudio2
+{
+public:
+	IXAudio2() = default;
+	~IXAudio2();
+	IXAudio2(const IXAudio2&) = delete;
+	IXAudio2& operator=(const IXAudio2&) = delete;
+
+	HRESULT CreateSourceVoice(IXAudio2SourceVoice** sourceVoice, const WAVEFORMATEX* format, UINT32 flags = 0,
+		float maxFrequencyRatio = XAUDIO2_DEFAULT_FREQ_RATIO, IXAudio2VoiceCallback* callback = nullptr,
+		const void* sendList = nullptr, const void* effectChain = nullptr);
+
+	// ---- テスト用 ----
+
+	// 全ボイスを1回ずつ進める (XAudio2の処理1回分)
+	void Process();
+	// 生きているボイス
+	const std::vector<IXAudio2SourceVoice*>& GetVoices() const { return voices_; }
+	// これまでに作ったボイスの数
+	size_t GetCreatedVoiceCount() const { return createdVoiceCount_; }
+	// 次のCreateSourceVoiceを失敗させる
+	void FailNextCreate() { isNextCreateFailed_ = true; }
+
+private:
+	friend class IXAudio2SourceVoice;
+	void RemoveVoice(IXAudio2SourceVoice* voice);
+
+	std::vector<IXAudio2SourceVoice*> voices_;
+	size_t createdVoiceCount_ = 0;
+	bool isNextCreateFailed_ = false;
+};
@@ -0,0 +1,259 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MappedFile.h"
+#include "ObjLoader.h"
+#include "ThreadPool.h"
+
+// objファイルの読み込み速度 (MB/s) を測るベンチマーク
+// 格子状のメッシュのobjを一時ディレクトリに書き出して、それを読む
+// 引数は格子の1辺の頂点数 (128で約3MB、384で約29MB)
+// BM_LoadObjFileIstreamは置き換える前のmain.cppの読み込み (getline + istringstream) をそのまま移したもの
+
+namespace {
+	const std::filesystem::path& GetBenchmarkDirectory() {
+		static const std::filesystem::path directory = std::filesystem::temp_directory_path() / "CG2ObjLoaderBenchmark";
+		return directory;
+	}
+
+	std::string GetObjFilename(int gridSize) {
+		return std::format("grid{}.obj", gridSize);
+	}
+
+	// gridSize x gridSizeの頂点を持つ波打った格子のobjを書き出す (既にあれば何もしない)
+	void WriteGridObj(int gridSize) {
+		std::filesystem::create_directories(GetBenchmarkDirectory());
+		const std::filesystem::path path = GetBenchmarkDirectory() / GetObjFilename(gridSize);
+		if (std::filesystem::exists(path)) {
+			return;
+		}
+		std::string text = "# CG2ObjLoaderBenchmark\no grid\n";
+		const float step = 1.0f / float(gridSize - 1);
+		for (int z = 0; z < gridSize; ++z) {
+			for (int x = 0; x < gridSize; ++x) {
+				const float u = float(x) * step;
+				const float v = float(z) * step;
+				text += std::format("v {:.6f} {:.6f} {:.6f}\n", u * 2.0f - 1.0f, 0.1f * (u * v - 0.5f), v * 2.0f - 1.0f);
+				text += std::format("vt {:.6f} {:.6f}\n", u, v);
+				text += std::format("vn {:.6f} {:.6f} {:.6f}\n", 0.0f, 1.0f, 0.0f);
+			}
+		}
+		for (int z = 0; z + 1 < gridSize; ++z) {
+			for (int x = 0; x + 1 < gridSize; ++x) {
+				const int i0 = z * gridSize + x + 1;
+				const int i1 = i0 + 1;
+				const int i2 = i0 + gridSize;
+				const int i3 = i2 + 1;
+				text += std::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", i0, i2, i1);
+				text += std::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", i1, i2, i3);
+			}
+		}
+		FILE* file = std::fopen(path.string().c_str(), "wb");
+		if (file) {
+			std::fwrite(text.data(), 1, text.size(), file);
+			std::fclose(file);
+		}
+	}
+
+	size_t GetObjFileSize(int gridSize) {
+		return static_cast<size_t>(std::filesystem::file_size(GetBenchmarkDirectory() / GetObjFilename(gridSize)));
+	}
+
+	// 置き換える前のmain.cppの三つ組のキーとハッシュ
+	struct TripletKey {
+		uint32_t v, vt, vn;
+		bool operator == (const TripletKey&) const = default;
+	};
+
+	struct TripletHash {
+		size_t operator()(const TripletKey& k) const noexcept {
+			size_t h = 0;
+			auto mix = [&](uint32_t x) {
+				h ^= std::hash<uint32_t>{}(x)+0x9e3779b97f4a7c15ULL + (h << 5) + (h >> 2);
+				};
+
+			mix(k.v);
+			mix(k.vt);
+			mix(k.vn);
+			return h;
+		}
+	};
+
+	struct IstreamModelData {
+		std::vector<VertexData> vertices;
+		std::vector<uint32_t> indices;
+		std::string textureFilePath;
+	};
+
+	// 置き換える前のmain.cppのLoadMaterialTemplateFile (map_Kdだけ読む)
+	std::string LoadMaterialTemplateFileIstream(const std::string& directoryPath, const std::string& filename) {
+		std::string textureFilePath;
+		std::string line;
+		std::ifstream file(directoryPath + "/" + filename);
+		assert(file.is_open());
+
+		while (std::getline(file, line)) {
+			std::string identifier;
+			std::istringstream s(line);
+			s >> identifier;
+
+			if (identifier == "map_Kd") {
+				std::string textureFilename;
+				s >> textureFilename;
+				textureFilePath = directoryPath + "/" + textureFilename;
+			}
+		}
+
+		return textureFilePath;
+	}
+
+	// 置き換える前のmain.cppのLoadObjFile (比べるために手を加えていない)
+	IstreamModelData LoadObjFileIstream(const std::string& directoryPath, const std::string& filename) {
+		IstreamModelData modelData;
+		std::vector<Vector4> positions;
+		std::vector<Vector3> normals;
+		std::vector<Vector2> texcoords;
+		std::string line;
+		std::ifstream file(directoryPath + "/" + filename);
+		assert(file.is_open());
+
+		std::unordered_map<TripletKey, uint32_t, TripletHash> lut;
+
+		while (std::getline(file, line)) {
+			std::string identifier;
+			std::istringstream s(line);
+			s >> identifier;
+
+			if (identifier == "v") {
+				Vector4 position;
+				s >> position.x >> position.y >> position.z;
+				position.w = 1.0f;
+				positions.push_back(position);
+			} else if (identifier == "vt") {
+				Vector2 texcoord;
+				s >> texcoord.x >> texcoord.y;
+				texcoords.push_back(texcoord);
+			} else if (identifier == "vn") {
+				Vector3 normal;
+				s >> normal.x >> normal.y >> normal.z;
+				normals.push_back(normal);
+			} else if (identifier == "f") {
+				struct FaceElm { uint32_t v, t, n; } f[3]{};
+
+				for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
+					std::string vertexDefinition;
+					s >> vertexDefinition;
+					std::replace(vertexDefinition.begin(), vertexDefinition.end(), '/', ' ');
+					std::istringstream v(vertexDefinition);
+
+					v >> f[faceVertex].v >> f[faceVertex].t >> f[faceVertex].n;
+					f[faceVertex].v--;
+					f[faceVertex].t--;
+					f[faceVertex].n--;
+				}
+
+				for (int order : {2, 1, 0}) {
+					TripletKey key{ f[order].v, f[order].t, f[order].n };
+					auto it = lut.find(key);
+					uint32_t idx;
+					if (it == lut.end()) {
+						Vector4 p = positions[key.v];
+						Vector2 t = texcoords[key.vt];
+						Vector3 n = normals[key.vn];
+
+						p.x *= -1.0f;
+						t.y = 1.0f - t.y;
+						n.x *= -1.0f;
+
+						VertexData vtx{ p, t, n };
+						idx = (uint32_t)modelData.vertices.size();
+						modelData.vertices.push_back(vtx);
+						lut.emplace(key, idx);
+					} else {
+						idx = it->second;
+					}
+					modelData.indices.push_back(idx);
+				}
+
+			} else if (identifier == "mtllib") {
+				std::string materialFilename;
+				s >> materialFilename;
+				modelData.textureFilePath = LoadMaterialTemplateFileIstream(directoryPath, materialFilename);
+			}
+		}
+
+		return modelData;
+	}
+
+	// ファイルをマップして全バイトを触るだけ (読み込みの上限の目安)
+	void BM_MappedFileScan(benchmark::State& state) {
+		const int gridSize = static_cast<int>(state.range(0));
+		WriteGridObj(gridSize);
+		const std::string path = (GetBenchmarkDirectory() / GetObjFilename(gridSize)).string();
+		for (auto _ : state) {
+			MappedFile file;
+			if (!file.Open(path)) {
+				state.SkipWithError("objファイルを開けない");
+				return;
+			}
+			size_t lineCount = 0;
+			for (size_t i = 0; i < file.Size(); ++i) {
+				lineCount += file.Data()[i] == '\n';
+			}
+			benchmark::DoNotOptimize(lineCount);
+		}
+		state.SetBytesProcessed(state.iterations() * GetObjFileSize(gridSize));
+	}
+	BENCHMARK(BM_MappedFileScan)->Arg(128)->Arg(384)->Unit(benchmark::kMillisecond);
+
+	void BM_LoadObjFile(benchmark::State& state) {
+		const int gridSize = static_cast<int>(state.range(0));
+		WriteGridObj(gridSize);
+		const std::string directory = GetBenchmarkDirectory().string();
+		const std::string filename = GetObjFilename(gridSize);
+		for (auto _ : state) {
+			ModelData modelData = LoadObjFile(directory, filename);
+			benchmark::DoNotOptimize(modelData.vertices.data());
+		}
+		state.SetBytesProcessed(state.iterations() * GetObjFileSize(gridSize));
+	}
+	BENCHMARK(BM_LoadObjFile)->Arg(128)->Arg(384)->Unit(benchmark::kMillisecond);
+
+	// 置き換える前の読み込み (BM_LoadObjFileとのbytes_per_secondの比が改善の度合い)
+	void BM_LoadObjFileIstream(benchmark::State& state) {
+		const int gridSize = static_cast<int>(state.range(0));
+		WriteGridObj(gridSize);
+		const std::string directory = GetBenchmarkDirectory().string();
+		const std::string filename = GetObjFilename(gridSize);
+		for (auto _ : state) {
+			IstreamModelData modelData = LoadObjFileIstream(directory, filename);
+			benchmark::DoNotOptimize(modelData.vertices.data());
+		}
+		state.SetBytesProcessed(state.iterations() * GetObjFileSize(gridSize));
+	}
+	BENCHMARK(BM_LoadObjFileIstream)->Arg(128)->Arg(384)->Unit(benchmark::kMillisecond);
+
+	// スレッドプールで行を分割して並列に読む (ワーカーの時間も入るよう実時間で測る)
+	void BM_LoadObjFileParallel(benchmark::State& state) {
+		const int gridSize = static_cast<int>(state.range(0));
+		WriteGridObj(gridSize);
+		const std::string directory = GetBenchmarkDirectory().string();
+		const std::string filename = GetObjFilename(gridSize);
+		ThreadPool threadPool;
+		for (auto _ : state) {
+			ModelData modelData = LoadObjFile(directory, filename, &threadPool);
+			benchmark::DoNotOptimize(modelData.vertices.data());
+		}
+		state.SetBytesProcessed(state.iterations() * GetObjFileSize(gridSize));
+		state.counters["threads"] = static_cast<double>(threadPool.GetThreadCount());
+	}
+	BENCHMARK(BM_LoadObjFileParallel)->Arg(128)->Arg(384)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <string>
+#include "ObjLoader.h"
+#include "ThreadPool.h"
+
+// スレッドプールで分割して読んだ結果が、1スレッドで読んだ結果と完全に同じになるかを確かめる
+// 区間は1MB以上ずつに分けるので、数MBのobjを書き出して区間をまたぐ頂点の共有やusemtlの切り替えを起こす
+
+namespace {
+	constexpr int kGridSize = 220; // 1辺の頂点数 (objは約7MBになる)
+	constexpr int kRowsPerMaterial = 37; // 区間の境目とずれるように切り替える
+
+	const std::filesystem::path& GetTestDirectory() {
+		static const std::filesystem::path directory = std::filesystem::temp_directory_path() / "CG2ObjLoaderTest";
+		return directory;
+	}
+
+	void WriteTextFile(const std::filesystem::path& path, const std::string& text) {
+		FILE* file = std::fopen(path.string().c_str(), "wb");
+		ASSERT_NE(file, nullptr) << path;
+		std::fwrite(text.data(), 1, text.size(), file);
+		std::fclose(file);
+	}
+
+	// 行ごとに頂点を書いてから、その行と前の行をつなぐ面を書く (面は前の区間の頂点も参照する)
+	// マテリアルは数行ごとに切り替え、mtlに無い名前や四角形の面も混ぜる
+	std::string MakeMultiMaterialObj() {
+		std::string text = "# CG2ObjLoaderTest\nmtllib multi.mtl\no grid\n";
+		const char* materialNames[] = { "red", "green", "blue", "green", "missing" };
+		const float step = 1.0f / float(kGridSize - 1);
+		int material = -1;
+		for (int z = 0; z < kGridSize; ++z) {
+			for (int x = 0; x < kGridSize; ++x) {
+				const float u = float(x) * step;
+				const float v = float(z) * step;
+				text += std::format("v {:.6f} {:.6f} {:.6f}\n", u * 2.0f - 1.0f, 0.25f * (u - 0.5f) * (v - 0.5f), v * 2.0f - 1.0f);
+				text += std::format("vt {:.6f} {:.6f}\n", u, v);
+			}
+			text += std::format("vn {:.6f} {:.6f} {:.6f}\n", 0.0f, 1.0f, float(z) * step);
+			if (z == 0) {
+				continue;
+			}
+			if ((z - 1) % kRowsPerMaterial == 0) {
+				material = (material + 1) % static_cast<int>(std::size(materialNames));
+				text += std::format("usemtl {}\n", materialNames[material]);
+			}
+			// 法線は行ごとに1つ (同じ位置でも行が違えば別の頂点になる)
+			const int n0 = z;
+			const int n1 = z + 1;
+			for (int x = 0; x + 1 < kGridSize; ++x) {
+				const int i0 = (z - 1) * kGridSize + x + 1;
+				const int i1 = i0 + 1;
+				const int i2 = i0 + kGridSize;
+				const int i3 = i2 + 1;
+				if (x % 5 == 0) {
+					text += std::format("f {0}/{0}/{4} {1}/{1}/{5} {3}/{3}/{5} {2}/{2}/{4}\n", i0, i2, i1, i3, n0, n1);
+				} else {
+					text += std::format("f {0}/{0}/{3} {1}/{1}/{4} {2}/{2}/{3}\n", i0, i2, i1, n0, n1);
+					text += std::format("f {0}/{0}/{3} {1}/{1}/{4} {2}/{2}/{4}\n", i1, i2, i3, n0, n1);
+				}
+			}
+		}
+		return text;
+	}
+
+	const char kMultiMaterialMtl[] =
+		"newmtl red\nKd 1 0 0\n"
+		"newmtl green\nKd 0 1 0\n"
+		"newmtl blue\nKd 0 0 1\n";
+}
+
+TEST(ObjLoaderTest, ParallelLoadMatchesSingleThread) {
+	std::filesystem::create_directories(GetTestDirectory());
+	const std::string text = MakeMultiMaterialObj();
+	WriteTextFile(GetTestDirectory() / "multi.obj", text);
+	WriteTextFile(GetTestDirectory() / "multi.mtl", kMultiMaterialMtl);
+	// 1区間は1MB以上なので、4区間以上に分かれる大きさにする
+	ASSERT_GT(text.size(), size_t(4) << 20);
+
+	const std::string directory = GetTestDirectory().string();
+	const ModelData single = LoadObjFile(directory, "multi.obj");
+	ThreadPool threadPool(3);
+	const ModelData parallel = LoadObjFile(directory, "multi.obj", &threadPool);
+
+	ASSERT_FALSE(single.vertices.empty());
+	ASSERT_EQ(parallel.vertices.size(), single.vertices.size());
+	for (size_t i = 0; i < single.vertices.size(); ++i) {
+		const VertexData& a = parallel.vertices[i];
+		const VertexData& b = single.vertices[i];
+		ASSERT_TRUE(a.position.x == b.position.x && a.position.y == b.position.y && a.position.z == b.position.z && a.position.w == b.position.w
+			&& a.texcoord.x == b.texcoord.x && a.texcoord.y == b.texcoord.y
+			&& a.normal.x == b.normal.x && a.normal.y == b.normal.y && a.normal.z == b.normal.z) << "vertex " << i;
+	}
+	ASSERT_EQ(parallel.indices, single.indices);
+
+	// red/green/blueとmtlに無いmissingの4つ
+	ASSERT_EQ(single.materials.size(), 4u);
+	ASSERT_EQ(parallel.materials.size(), single.materials.size());
+	for (size_t i = 0; i < single.materials.size(); ++i) {
+		EXPECT_EQ(parallel.materials[i].name, single.materials[i].name);
+	}
+	ASSERT_EQ(single.subMeshes.size(), 4u);
+	ASSERT_EQ(parallel.subMeshes.size(), single.subMeshes.size());
+	for (size_t i = 0; i < single.subMeshes.size(); ++i) {
+		const SubMesh& a = parallel.subMeshes[i];
+		const SubMesh& b = single.subMeshes[i];
+		EXPECT_EQ(a.indexOffset, b.indexOffset) << "subMesh " << i;
+		EXPECT_EQ(a.indexCount, b.indexCount) << "subMesh " << i;
+		EXPECT_EQ(a.materialIndex, b.materialIndex) << "subMesh " << i;
+	}
+	EXPECT_EQ(parallel.materialLibraryPath, single.materialLibraryPath);
+
+	// 四角形の面も扇状に2つの三角形になるので、どのマスも三角形2つ
+	const size_t triangleCount = size_t(kGridSize - 1) * (kGridSize - 1) * 2;
+	EXPECT_EQ(single.indices.size(), triangleCount * 3);
+}
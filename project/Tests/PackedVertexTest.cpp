@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include "PackedVertex.h"
+
+// 圧縮した頂点を戻した時の誤差を確かめる
+//  半精度: 有限の全ての値がビット単位で往復し、floatからは最近接に丸める
+//  法線: 八面体写像(16bit x 2)で戻した向きの角度の誤差がkMaxNormalErrorDegrees以下
+//  位置: AABB内の位置を戻した誤差が量子化の1段の半分以下 (floatの計算誤差の分だけ余裕を持たせる)
+
+namespace {
+	// 16bitの八面体写像の最大角度誤差の上限 (実測は約0.004度)
+	constexpr double kMaxNormalErrorDegrees = 0.005;
+
+	bool IsFiniteHalf(uint16_t half) {
+		return ((half >> 10) & 0x1Fu) != 0x1Fu;
+	}
+
+	// 半精度の値をdoubleで素直に計算する
+	double ReferenceHalfToDouble(uint16_t half) {
+		const double sign = (half & 0x8000u) ? -1.0 : 1.0;
+		const int exponent = (half >> 10) & 0x1F;
+		const int mantissa = half & 0x3FF;
+		if (exponent == 0) {
+			return sign * std::ldexp(mantissa, -24);
+		}
+		return sign * std::ldexp(mantissa + 1024, exponent - 25);
+	}
+
+	// 2つの向きの角度 (度)
+	double AngleDegrees(const Vector3& a, const Vector3& b) {
+		const double ax = a.x, ay = a.y, az = a.z;
+		const double bx = b.x, by = b.y, bz = b.z;
+		const double cx = ay * bz - az * by;
+		const double cy = az * bx - ax * bz;
+		const double cz = ax * by - ay * bx;
+		const double cross = std::sqrt(cx * cx + cy * cy + cz * cz);
+		const double dot = ax * bx + ay * by + az * bz;
+		return std::atan2(cross, dot) * 180.0 / std::numbers::pi;
+	}
+
+	Vector3 RoundTripNormal(const Vector3& normal) {
+		int16_t encoded[2];
+		EncodeOctahedral(normal, encoded);
+		return DecodeOctahedral(encoded);
+	}
+}
+
+TEST(PackedVertexTest, HalfRoundTripsEveryFiniteValue) {
+	int finiteCount = 0;
+	for (uint32_t bits = 0; bits <= 0xFFFFu; ++bits) {
+		const uint16_t half = static_cast<uint16_t>(bits);
+		if (!IsFiniteHalf(half)) {
+			continue;
+		}
+		++finiteCount;
+		const float value = HalfToFloat(half);
+		ASSERT_EQ(static_cast<double>(value), ReferenceHalfToDouble(half)) << std::hex << bits;
+		ASSERT_EQ(FloatToHalf(value), half) << std::hex << bits;
+	}
+	// 符号2 x 指数31 x 仮数1024
+	EXPECT_EQ(finiteCount, 2 * 31 * 1024);
+}
+
+TEST(PackedVertexTest, FloatToHalfRoundsToNearestEven) {
+	// 隣り合う半精度の値の間の点は近い方、ちょうど中間は仮数が偶数の方に丸める
+	for (uint32_t bits = 0; bits < 0x7BFFu; ++bits) {
+		const uint16_t lower = static_cast<uint16_t>(bits);
+		const uint16_t upper = static_cast<uint16_t>(bits + 1);
+		const double a = ReferenceHalfToDouble(lower);
+		const double b = ReferenceHalfToDouble(upper);
+		const float middle = static_cast<float>((a + b) * 0.5);
+		ASSERT_EQ(FloatToHalf(middle), (lower & 1u) ? upper : lower) << std::hex << bits;
+		ASSERT_EQ(FloatToHalf(std::nextafter(middle, 0.0f)), lower) << std::hex << bits;
+		ASSERT_EQ(FloatToHalf(std::nextafter(middle, FLT_MAX)), upper) << std::hex << bits;
+		ASSERT_EQ(FloatToHalf(-middle), static_cast<uint16_t>(((lower & 1u) ? upper : lower) | 0x8000u)) << std::hex << bits;
+	}
+
+	// 範囲外は無限大、小さすぎる値は符号付きの0、NaNはNaNのまま
+	EXPECT_EQ(FloatToHalf(65520.0f), 0x7C00u);
+	EXPECT_EQ(FloatToHalf(65519.0f), 0x7BFFu);
+	EXPECT_EQ(FloatToHalf(-1e10f), 0xFC00u);
+	EXPECT_EQ(FloatToHalf(1e-10f), 0x0000u);
+	EXPECT_EQ(FloatToHalf(-1e-10f), 0x8000u);
+	EXPECT_TRUE(std::isnan(HalfToFloat(FloatToHalf(std::nanf("")))));
+	EXPECT_TRUE(std::isinf(HalfToFloat(FloatToHalf(INFINITY))));
+}
+
+TEST(PackedVertexTest, OctahedralNormalErrorIsBounded) {
+	// 球面をほぼ均等に覆う点 (フィボナッチ格子) と、折り返しの境目になる軸や面の上の向きで調べる
+	double worst = 0.0;
+	constexpr int kSampleCount = 200000;
+	const double goldenAngle = std::numbers::pi * (3.0 - std::sqrt(5.0));
+	for (int i = 0; i < kSampleCount; ++i) {
+		const double z = 1.0 - 2.0 * (i + 0.5) / kSampleCount;
+		const double radius = std::sqrt(1.0 - z * z);
+		const double angle = goldenAngle * i;
+		const Vector3 normal = { float(radius * std::cos(angle)), float(radius * std::sin(angle)), float(z) };
+		const Vector3 decoded = RoundTripNormal(normal);
+		ASSERT_NEAR(Length(decoded), 1.0f, 1e-6f);
+		worst = (std::max)(worst, AngleDegrees(normal, decoded));
+	}
+	const Vector3 edges[] = {
+		{ 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }, { 0.6f, 0.8f, 0.0f }, { -0.6f, 0.0f, -0.8f },
+		{ 0.577350f, -0.577350f, -0.577350f }, { 0.0f, 0.707107f, -0.707107f },
+	};
+	for (const Vector3& normal : edges) {
+		const Vector3 decoded = RoundTripNormal(normal);
+		EXPECT_LT(AngleDegrees(normal, decoded), kMaxNormalErrorDegrees) << normal.x << " " << normal.y << " " << normal.z;
+		worst = (std::max)(worst, AngleDegrees(normal, decoded));
+	}
+	EXPECT_LT(worst, kMaxNormalErrorDegrees);
+	RecordProperty("WorstNormalErrorMicroDegrees", static_cast<int>(worst * 1e6));
+
+	// 長さが1でなくても向きだけを残す
+	EXPECT_LT(AngleDegrees(RoundTripNormal({ 0.0f, 3.0f, -4.0f }), { 0.0f, 0.6f, -0.8f }), kMaxNormalErrorDegrees);
+}
+
+TEST(PackedVertexTest, PositionErrorIsWithinHalfStep) {
+	const AABB bounds = { { -3.5f, 0.25f, -120.0f }, { 12.0f, 0.75f, 80.0f } };
+	const float mins[3] = { bounds.min.x, bounds.min.y, bounds.min.z };
+	const float maxs[3] = { bounds.max.x, bounds.max.y, bounds.max.z };
+	float tolerances[3];
+	for (int axis = 0; axis < 3; ++axis) {
+		const float extent = maxs[axis] - mins[axis];
+		// 量子化の1段の半分 + 戻す時のfloatの丸め誤差 (値の大きさの数ulp)
+		const float magnitude = (std::max)(std::fabs(mins[axis]), std::fabs(maxs[axis]));
+		tolerances[axis] = 0.5f * extent / 65535.0f + 4.0f * magnitude * FLT_EPSILON;
+	}
+
+	std::mt19937 random(12);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	for (int i = 0; i < 100000; ++i) {
+		VertexData vertex{};
+		float* position = &vertex.position.x;
+		for (int axis = 0; axis < 3; ++axis) {
+			position[axis] = mins[axis] + unit(random) * (maxs[axis] - mins[axis]);
+		}
+		vertex.position.w = 1.0f;
+		vertex.normal = { 0.0f, 1.0f, 0.0f };
+		const PackedVertex packed = PackVertex(vertex, bounds);
+		EXPECT_EQ(packed.position[3], 65535u);
+		const VertexData unpacked = UnpackVertex(packed, bounds);
+		const float* restored = &unpacked.position.x;
+		for (int axis = 0; axis < 3; ++axis) {
+			ASSERT_LE(std::fabs(restored[axis] - position[axis]), tolerances[axis]) << "axis " << axis << " value " << position[axis];
+		}
+		EXPECT_EQ(unpacked.position.w, 1.0f);
+	}
+
+	// AABBの角はちょうど0と65535になり、外側の点は境界に寄せる
+	VertexData corner{};
+	corner.position = { bounds.max.x, bounds.min.y, bounds.max.z + 10.0f, 1.0f };
+	const PackedVertex packedCorner = PackVertex(corner, bounds);
+	EXPECT_EQ(packedCorner.position[0], 65535u);
+	EXPECT_EQ(packedCorner.position[1], 0u);
+	EXPECT_EQ(packedCorner.position[2], 65535u);
+	EXPECT_EQ(UnpackVertex(packedCorner, bounds).position.y, bounds.min.y);
+}
+
+TEST(PackedVertexTest, DequantizeMatrixMatchesUnpack) {
+	// 厚みの無い軸 (平面のY) は常に最小値に戻る
+	const AABB bounds = { { -1.0f, 2.0f, -5.0f }, { 1.0f, 2.0f, 5.0f } };
+	std::mt19937 random(13);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	const Matrix4x4 dequantize = MakeDequantizeMatrix(bounds);
+	for (int i = 0; i < 1000; ++i) {
+		VertexData vertex{};
+		vertex.position = { -1.0f + 2.0f * unit(random), 2.0f, -5.0f + 10.0f * unit(random), 1.0f };
+		vertex.texcoord = { unit(random), unit(random) };
+		vertex.normal = { 0.0f, 1.0f, 0.0f };
+		const PackedVertex packed = PackVertex(vertex, bounds);
+		const VertexData unpacked = UnpackVertex(packed, bounds);
+		EXPECT_EQ(unpacked.position.y, 2.0f);
+
+		// シェーダーと同じく、UNORMの位置(0～1)に行列を掛ける
+		float normalized[3];
+		for (int axis = 0; axis < 3; ++axis) {
+			normalized[axis] = static_cast<float>(packed.position[axis]) / 65535.0f;
+		}
+		for (int axis = 0; axis < 3; ++axis) {
+			const float transformed = normalized[0] * dequantize.m[0][axis] + normalized[1] * dequantize.m[1][axis]
+				+ normalized[2] * dequantize.m[2][axis] + dequantize.m[3][axis];
+			EXPECT_NEAR(transformed, (&unpacked.position.x)[axis], 1e-5f);
+		}
+
+		// UVは半精度の丸めの分だけずれる (0～1なら2^-11以下)
+		EXPECT_NEAR(unpacked.texcoord.x, vertex.texcoord.x, 1.0f / 2048.0f);
+		EXPECT_NEAR(unpacked.texcoord.y, vertex.texcoord.y, 1.0f / 2048.0f);
+	}
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include "Quaternion.h"
+
+// クォータニオン版のMakeAffineMatrixがオイラー角版と合うか、Slerp/Nlerpの両端と中間、
+// 回転の合成、デュアルクォータニオンの行列が回転と平行移動の行列と合うかを確かめる
+
+namespace {
+	// 行列の要素ごとの許容誤差
+	constexpr float kMatrixTolerance = 1e-6f;
+
+	void ExpectMatrixNear(const Matrix4x4& actual, const Matrix4x4& expected, float tolerance) {
+		for (int i = 0; i < 4; ++i) {
+			for (int j = 0; j < 4; ++j) {
+				EXPECT_NEAR(actual.m[i][j], expected.m[i][j], tolerance) << "m[" << i << "][" << j << "]";
+			}
+		}
+	}
+
+	// qと-qは同じ回転なので、符号をそろえて比べる
+	void ExpectSameRotation(const Quaternion& actual, const Quaternion& expected, float tolerance) {
+		const float sign = Dot(actual, expected) < 0.0f ? -1.0f : 1.0f;
+		EXPECT_NEAR(actual.x * sign, expected.x, tolerance);
+		EXPECT_NEAR(actual.y * sign, expected.y, tolerance);
+		EXPECT_NEAR(actual.z * sign, expected.z, tolerance);
+		EXPECT_NEAR(actual.w * sign, expected.w, tolerance);
+	}
+
+	// 行ベクトルの点をアフィン行列で変換する
+	Vector3 TransformAffine(const Vector3& v, const Matrix4x4& m) {
+		return {
+			v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0],
+			v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1],
+			v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2]
+		};
+	}
+
+	Vector3 RandomEuler(std::mt19937& random) {
+		std::uniform_real_distribution<float> angle(-std::numbers::pi_v<float>, std::numbers::pi_v<float>);
+		return { angle(random), angle(random), angle(random) };
+	}
+
+	Vector3 RandomTranslate(std::mt19937& random) {
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+		return { distribution(random), distribution(random), distribution(random) };
+	}
+}
+
+TEST(QuaternionTest, AffineMatrixMatchesEulerPath) {
+	std::mt19937 random(3);
+	for (int i = 0; i < 1000; ++i) {
+		const Vector3 rotate = RandomEuler(random);
+		const Vector3 translate = RandomTranslate(random);
+		const Matrix4x4 expected = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate, translate);
+		const Matrix4x4 actual = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, MakeRotateQuaternion(rotate), translate);
+		ExpectMatrixNear(actual, expected, kMatrixTolerance);
+		ExpectMatrixNear(MakeRotateMatrix(MakeRotateQuaternion(rotate)),
+			MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate, { 0.0f, 0.0f, 0.0f }), kMatrixTolerance);
+	}
+
+	// 拡縮はどちらも行にかけるだけなので、誤差は拡縮の大きさに比例する
+	std::uniform_real_distribution<float> scaleDistribution(0.25f, 4.0f);
+	for (int i = 0; i < 1000; ++i) {
+		const Vector3 scale = { scaleDistribution(random), scaleDistribution(random), scaleDistribution(random) };
+		const Vector3 rotate = RandomEuler(random);
+		const Vector3 translate = RandomTranslate(random);
+		const Matrix4x4 expected = MakeAffineMatrix(scale, rotate, translate);
+		const Matrix4x4 actual = MakeAffineMatrix(scale, MakeRotateQuaternion(rotate), translate);
+		const float rowScales[4] = { scale.x, scale.y, scale.z, 1.0f };
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				EXPECT_NEAR(actual.m[row][col], expected.m[row][col], kMatrixTolerance * rowScales[row]);
+			}
+		}
+	}
+}
+
+TEST(QuaternionTest, ComposeMatchesMatrixProduct) {
+	std::mt19937 random(4);
+	for (int i = 0; i < 1000; ++i) {
+		const Quaternion q0 = MakeRotateQuaternion(RandomEuler(random));
+		const Quaternion q1 = MakeRotateQuaternion(RandomEuler(random));
+		// q1 * q0 は q0 → q1 の順 (行ベクトルなので行列は R(q0) * R(q1))
+		ExpectMatrixNear(MakeRotateMatrix(q1 * q0), Multiply(MakeRotateMatrix(q0), MakeRotateMatrix(q1)), kMatrixTolerance);
+		ExpectSameRotation(q0 * Inverse(q0), IdentityQuaternion(), kMatrixTolerance);
+
+		const Vector3 vector = RandomTranslate(random);
+		const Vector3 rotated = RotateVector(vector, q0);
+		const Vector3 expected = TransformAffine(vector, MakeRotateMatrix(q0));
+		EXPECT_NEAR(rotated.x, expected.x, 1e-5f);
+		EXPECT_NEAR(rotated.y, expected.y, 1e-5f);
+		EXPECT_NEAR(rotated.z, expected.z, 1e-5f);
+	}
+}
+
+TEST(QuaternionTest, SlerpEndpointsAndMidpoint) {
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> axisDistribution(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> angleDistribution(0.1f, 3.0f);
+	for (int i = 0; i < 1000; ++i) {
+		Vector3 axis = { axisDistribution(random), axisDistribution(random), axisDistribution(random) };
+		const float length = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+		if (length < 0.1f) {
+			continue;
+		}
+		axis = { axis.x / length, axis.y / length, axis.z / length };
+		const float angle = angleDistribution(random);
+		const Quaternion q0 = MakeRotateQuaternion(RandomEuler(random));
+		// q0から同じ軸でangle回した先 (中間はangle/2回した所)
+		const Quaternion q1 = MakeRotateAxisAngleQuaternion(axis, angle) * q0;
+		const Quaternion middle = MakeRotateAxisAngleQuaternion(axis, angle * 0.5f) * q0;
+		const Quaternion quarter = MakeRotateAxisAngleQuaternion(axis, angle * 0.25f) * q0;
+
+		ExpectSameRotation(Slerp(q0, q1, 0.0f), q0, 1e-6f);
+		ExpectSameRotation(Slerp(q0, q1, 1.0f), q1, 1e-6f);
+		ExpectSameRotation(Slerp(q0, q1, 0.5f), middle, 1e-5f);
+		ExpectSameRotation(Slerp(q0, q1, 0.25f), quarter, 1e-5f);
+		// 反対の符号のq1を渡しても近い方を回る
+		const Quaternion negated = { -q1.x, -q1.y, -q1.z, -q1.w };
+		ExpectSameRotation(Slerp(q0, negated, 0.5f), middle, 1e-5f);
+
+		ExpectSameRotation(Nlerp(q0, q1, 0.0f), q0, 1e-6f);
+		ExpectSameRotation(Nlerp(q0, q1, 1.0f), q1, 1e-6f);
+		// 中間はSlerpと同じ所を通る (それ以外は角速度が違うのでずれる)
+		ExpectSameRotation(Nlerp(q0, q1, 0.5f), middle, 1e-5f);
+		ExpectSameRotation(Nlerp(q0, negated, 0.5f), middle, 1e-5f);
+		EXPECT_NEAR(Norm(Nlerp(q0, q1, 0.3f)), 1.0f, 1e-6f);
+	}
+}
+
+TEST(QuaternionTest, DualQuaternionMatrixMatchesRigidTransform) {
+	std::mt19937 random(6);
+	for (int i = 0; i < 1000; ++i) {
+		const Vector3 rotate = RandomEuler(random);
+		const Vector3 translate = RandomTranslate(random);
+		const DualQuaternion dual = MakeDualQuaternion(MakeRotateQuaternion(rotate), translate);
+		const Matrix4x4 expected = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate, translate);
+		// 平行移動はdualから取り出し直すので、大きさ10程度の値の丸め誤差が乗る
+		ExpectMatrixNear(MakeAffineMatrix(dual), expected, 1e-5f);
+
+		const Vector3 point = RandomTranslate(random);
+		const Vector3 transformed = TransformPoint(point, dual);
+		const Vector3 expectedPoint = TransformAffine(point, expected);
+		EXPECT_NEAR(transformed.x, expectedPoint.x, 1e-5f);
+		EXPECT_NEAR(transformed.y, expectedPoint.y, 1e-5f);
+		EXPECT_NEAR(transformed.z, expectedPoint.z, 1e-5f);
+
+		// 合成は dual1 * dual0 で dual0 → dual1 の順
+		const Vector3 rotate1 = RandomEuler(random);
+		const Vector3 translate1 = RandomTranslate(random);
+		const DualQuaternion dual1 = MakeDualQuaternion(MakeRotateQuaternion(rotate1), translate1);
+		const Matrix4x4 expectedComposed = Multiply(expected, MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotate1, translate1));
+		ExpectMatrixNear(MakeAffineMatrix(dual1 * dual), expectedComposed, 2e-5f);
+	}
+
+	// 両端の補間は元の変換と同じ
+	const DualQuaternion d0 = MakeDualQuaternion(MakeRotateQuaternion({ 0.1f, 0.2f, 0.3f }), { 1.0f, 2.0f, 3.0f });
+	const DualQuaternion d1 = MakeDualQuaternion(MakeRotateQuaternion({ -0.4f, 0.5f, 1.2f }), { -3.0f, 0.5f, 4.0f });
+	ExpectMatrixNear(MakeAffineMatrix(Lerp(d0, d1, 0.0f)), MakeAffineMatrix(d0), 1e-6f);
+	ExpectMatrixNear(MakeAffineMatrix(Lerp(d0, d1, 1.0f)), MakeAffineMatrix(d1), 1e-6f);
+}
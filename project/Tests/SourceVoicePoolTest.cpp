@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include "SourceVoicePool.h"
+
+// ソースボイスの使い回し、上限での盗み、再生中の音声データの持ち方を確かめる
+// XAudio2はTests/Mockの代わりのものを使い、IXAudio2::Processでバッファを終わらせる
+
+namespace {
+	WAVEFORMATEX MakeFormat(WORD channelCount, DWORD sampleRate) {
+		WAVEFORMATEX format = {};
+		format.wFormatTag = WAVE_FORMAT_PCM;
+		format.nChannels = channelCount;
+		format.nSamplesPerSec = sampleRate;
+		format.wBitsPerSample = 16;
+		format.nBlockAlign = static_cast<WORD>(channelCount * 2);
+		format.nAvgBytesPerSec = sampleRate * format.nBlockAlign;
+		return format;
+	}
+
+	SoundHandle MakeSound(WORD channelCount = 2, DWORD sampleRate = 48000) {
+		auto asset = std::make_shared<SoundAsset>();
+		asset->wfex = {};
+		asset->wfex.Format = MakeFormat(channelCount, sampleRate);
+		asset->buffer.resize(64);
+		return asset;
+	}
+}
+
+TEST(SourceVoicePoolTest, ReusesFinishedVoices) {
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2, 4);
+	const WAVEFORMATEX format = MakeFormat(2, 48000);
+	const BYTE data[8] = {};
+	// 1フレームに1回鳴らして、次のフレームまでに鳴り終わる
+	for (int i = 0; i < 1000; ++i) {
+		ASSERT_NE(pool.Play(format, data, sizeof(data)), kInvalidSourceVoiceId);
+		xAudio2.Process();
+		pool.Update();
+	}
+	EXPECT_EQ(xAudio2.GetCreatedVoiceCount(), 1u);
+	EXPECT_EQ(pool.GetActiveVoiceCount(), 0u);
+	EXPECT_EQ(pool.GetFreeVoiceCount(), 1u);
+}
+
+TEST(SourceVoicePoolTest, StealsOldestLowestPriority) {
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2, 4);
+	const WAVEFORMATEX format = MakeFormat(2, 48000);
+	const BYTE data[8] = {};
+	const SourceVoiceId ids[4] = {
+		pool.Play(format, data, sizeof(data), 1),
+		pool.Play(format, data, sizeof(data), 0),
+		pool.Play(format, data, sizeof(data), 0),
+		pool.Play(format, data, sizeof(data), 2),
+	};
+	EXPECT_EQ(pool.GetActiveVoiceCount(), 4u);
+
+	// 優先度0の古い方から止める
+	EXPECT_NE(pool.Play(format, data, sizeof(data), 0), kInvalidSourceVoiceId);
+	EXPECT_FALSE(pool.IsPlaying(ids[1]));
+	EXPECT_TRUE(pool.IsPlaying(ids[2]));
+	EXPECT_EQ(pool.GetStolenCount(), 1u);
+	// それより低い優先度の音は鳴らせない
+	EXPECT_EQ(pool.Play(format, data, sizeof(data), -1), kInvalidSourceVoiceId);
+	EXPECT_EQ(xAudio2.GetVoices().size(), 4u);
+
+	// 止めた音は、捨てたバッファが戻ってくるまで使わない
+	pool.Stop(ids[3]);
+	EXPECT_FALSE(pool.IsPlaying(ids[3]));
+	EXPECT_EQ(pool.GetFreeVoiceCount(), 0u);
+	pool.StopAll();
+	xAudio2.Process();
+	pool.Update();
+	EXPECT_EQ(pool.GetActiveVoiceCount(), 0u);
+	EXPECT_EQ(pool.GetFreeVoiceCount(), 4u);
+
+	pool.Shutdown();
+	EXPECT_TRUE(xAudio2.GetVoices().empty());
+}
+
+TEST(SourceVoicePoolTest, SeparatesExtensibleFormats) {
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2, 4);
+	const BYTE data[24] = {};
+	WAVEFORMATEXTENSIBLE surround = {};
+	surround.Format = MakeFormat(6, 48000);
+	surround.Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+	surround.Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+	surround.Samples.wValidBitsPerSample = 16;
+	surround.dwChannelMask = 0x3F;
+	WAVEFORMATEXTENSIBLE otherMask = surround;
+	otherMask.dwChannelMask = 0x60F;
+
+	ASSERT_NE(pool.Play(surround.Format, data, sizeof(data)), kInvalidSourceVoiceId);
+	xAudio2.Process();
+	pool.Update();
+	// スピーカーの割り当てが違えば、空いているボイスがあっても使い回さない
+	ASSERT_NE(pool.Play(otherMask.Format, data, sizeof(data)), kInvalidSourceVoiceId);
+	EXPECT_EQ(xAudio2.GetCreatedVoiceCount(), 2u);
+	xAudio2.Process();
+	pool.Update();
+	ASSERT_NE(pool.Play(surround.Format, data, sizeof(data)), kInvalidSourceVoiceId);
+	EXPECT_EQ(xAudio2.GetCreatedVoiceCount(), 2u);
+}
+
+TEST(SourceVoicePoolTest, KeepsSoundHandleUntilVoiceIsFree) {
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2, 2);
+
+	// 鳴り終わってUpdateで回収されるまでは、呼び出し側が離しても消えない
+	SoundHandle sound = MakeSound();
+	std::weak_ptr<const SoundAsset> weak = sound;
+	ASSERT_NE(pool.Play(sound), kInvalidSourceVoiceId);
+	sound.reset();
+	EXPECT_FALSE(weak.expired());
+	xAudio2.Process();
+	EXPECT_FALSE(weak.expired());
+	pool.Update();
+	EXPECT_TRUE(weak.expired());
+
+	// 止めた音は、捨てたバッファが戻ってくるまで持っておく
+	sound = MakeSound();
+	weak = sound;
+	const SourceVoiceId stopped = pool.Play(sound);
+	sound.reset();
+	pool.Stop(stopped);
+	pool.Update();
+	EXPECT_FALSE(weak.expired());
+	xAudio2.Process();
+	pool.Update();
+	EXPECT_TRUE(weak.expired());
+
+	// 盗まれた音とShutdownで壊した音も離す
+	SoundHandle first = MakeSound();
+	SoundHandle second = MakeSound();
+	std::weak_ptr<const SoundAsset> weakFirst = first;
+	std::weak_ptr<const SoundAsset> weakSecond = second;
+	pool.Play(first, 0);
+	pool.Play(second, 0);
+	first.reset();
+	second.reset();
+	ASSERT_NE(pool.Play(MakeSound(), 1), kInvalidSourceVoiceId);
+	EXPECT_TRUE(weakFirst.expired());
+	EXPECT_FALSE(weakSecond.expired());
+	pool.Shutdown();
+	EXPECT_TRUE(weakSecond.expired());
+
+	EXPECT_EQ(pool.Play(SoundHandle()), kInvalidSourceVoiceId);
+}
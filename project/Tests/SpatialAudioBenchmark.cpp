@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "SpatialAudio.h"
+
+// 全エミッターの減衰・パン・ドップラーを求めて鳴っている音に反映する、SpatialAudio::Updateの1回あたりの時間を測るベンチマーク
+// 引数はエミッター数と、鳴らしておく音の数 (0なら計算だけ、32ならプールの上限まで鳴らして反映も含む)
+// XAudio2はTests/Mockの代わりのものを使うので、鳴っている音への反映はXAudio2の呼び出しの分を含まない
+
+namespace {
+	SoundHandle MakeMonoSound() {
+		auto asset = std::make_shared<SoundAsset>();
+		asset->wfex = {};
+		WAVEFORMATEX& format = asset->wfex.Format;
+		format.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+		format.nChannels = 1;
+		format.nSamplesPerSec = 48000;
+		format.wBitsPerSample = 32;
+		format.nBlockAlign = 4;
+		format.nAvgBytesPerSec = 48000 * 4;
+		asset->buffer.resize(4800 * 4);
+		return asset;
+	}
+
+	void BM_SpatialAudioUpdate(benchmark::State& state) {
+		const uint32_t emitterCount = static_cast<uint32_t>(state.range(0));
+		const uint32_t playingCount = static_cast<uint32_t>(state.range(1));
+		IXAudio2 xAudio2;
+		SourceVoicePool pool;
+		pool.Init(&xAudio2, 32);
+		SpatialAudio spatialAudio(pool);
+
+		// 200m四方に散らばって動き回るエミッター
+		std::mt19937 random(25);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> velocity(-20.0f, 20.0f);
+		std::vector<EmitterId> ids;
+		for (uint32_t i = 0; i < emitterCount; ++i) {
+			const EmitterId id = spatialAudio.CreateEmitter({ position(random), position(random), position(random) }, 1.0f, 80.0f);
+			spatialAudio.SetEmitterVelocity(id, { velocity(random), velocity(random), velocity(random) });
+			ids.push_back(id);
+		}
+		const SoundHandle sound = MakeMonoSound();
+		for (uint32_t i = 0; i < playingCount; ++i) {
+			spatialAudio.Play(ids[i * emitterCount / playingCount], sound);
+		}
+
+		// カメラが回りながら動く毎フレームの更新
+		int frame = 0;
+		for (auto _ : state) {
+			const Vector3 listener = { std::cos(frame * 0.05f) * 10.0f, 0.0f, std::sin(frame * 0.05f) * 10.0f };
+			spatialAudio.SetListener(listener, MakeRotateYMatrix(frame * 0.01f), 1.0f / 60.0f);
+			spatialAudio.Update();
+			++frame;
+		}
+		state.SetItemsProcessed(state.iterations() * int64_t(emitterCount));
+		benchmark::DoNotOptimize(spatialAudio.GetOutput(ids.back()));
+	}
+	BENCHMARK(BM_SpatialAudioUpdate)->ArgsProduct({ { 64, 512, 4096 }, { 0, 32 } })->Unit(benchmark::kMicrosecond);
+}
@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "SpatialAudio.h"
+
+// 3Dの音源の減衰・パン・ドップラーと、500個以上のエミッターをまとめてUpdateした結果を確かめる
+// XAudio2はTests/Mockの代わりのものを使う (Updateの時間はSpatialAudioBenchmarkで測る)
+
+namespace {
+	constexpr uint32_t kEmitterCount = 512;
+
+	SoundHandle MakeMonoSound() {
+		auto asset = std::make_shared<SoundAsset>();
+		asset->wfex = {};
+		WAVEFORMATEX& format = asset->wfex.Format;
+		format.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+		format.nChannels = 1;
+		format.nSamplesPerSec = 48000;
+		format.wBitsPerSample = 32;
+		format.nBlockAlign = 4;
+		format.nAvgBytesPerSec = 48000 * 4;
+		asset->buffer.resize(4800 * 4);
+		return asset;
+	}
+
+	// 原点でZ+を向いたリスナー (右はX+)
+	void SetDefaultListener(SpatialAudio& spatialAudio) {
+		spatialAudio.SetListener({ 0.0f, 0.0f, 0.0f }, MakeIdentity4x4(), 0.0f);
+	}
+}
+
+TEST(SpatialAudioTest, AttenuatesPansAndShiftsPitch) {
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2);
+	SpatialAudio spatialAudio(pool);
+	SetDefaultListener(spatialAudio);
+
+	const EmitterId right = spatialAudio.CreateEmitter({ 10.0f, 0.0f, 0.0f }, 2.0f, 50.0f);
+	const EmitterId left = spatialAudio.CreateEmitter({ -3.0f, 0.0f, 0.0f }, 2.0f, 50.0f);
+	const EmitterId near = spatialAudio.CreateEmitter({ 0.0f, 0.0f, 1.0f }, 2.0f, 50.0f);
+	const EmitterId far = spatialAudio.CreateEmitter({ 0.0f, 0.0f, 200.0f }, 2.0f, 50.0f);
+	const EmitterId approaching = spatialAudio.CreateEmitter({ 0.0f, 0.0f, 20.0f });
+	spatialAudio.SetEmitterVelocity(approaching, { 0.0f, 0.0f, -34.3f });
+	spatialAudio.Update();
+
+	// 減衰は min / (min + (clamp(距離, min, max) - min))
+	EXPECT_NEAR(spatialAudio.GetOutput(right).volume, 2.0f / 10.0f, 1e-5f);
+	EXPECT_NEAR(spatialAudio.GetOutput(near).volume, 1.0f, 1e-5f);
+	EXPECT_NEAR(spatialAudio.GetOutput(far).volume, 2.0f / 50.0f, 1e-5f);
+	EXPECT_NEAR(spatialAudio.GetOutput(right).pan, 1.0f, 1e-5f);
+	EXPECT_NEAR(spatialAudio.GetOutput(left).pan, -1.0f, 1e-5f);
+	EXPECT_NEAR(spatialAudio.GetOutput(near).pan, 0.0f, 1e-5f);
+	// 音速の1/10で近づくと 343 / (343 - 34.3) 倍
+	EXPECT_NEAR(spatialAudio.GetOutput(approaching).frequencyRatio, 343.0f / (343.0f - 34.3f), 1e-4f);
+	EXPECT_NEAR(spatialAudio.GetOutput(right).frequencyRatio, 1.0f, 1e-5f);
+}
+
+TEST(SpatialAudioTest, MatchesScalarTailForEveryEmitter) {
+	// SSEの4つずつの計算と端数のスカラー計算が同じ値になるか (同じ置き方のエミッターを位置をずらして並べる)
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2);
+	SpatialAudio spatialAudio(pool);
+	SetDefaultListener(spatialAudio);
+	std::vector<EmitterId> ids;
+	for (int i = 0; i < 7; ++i) {
+		ids.push_back(spatialAudio.CreateEmitter({ 5.0f, 2.0f, -7.0f }, 1.5f, 40.0f));
+		spatialAudio.SetEmitterVelocity(ids.back(), { -3.0f, 1.0f, 9.0f });
+		spatialAudio.SetEmitterVolume(ids.back(), 0.8f);
+	}
+	spatialAudio.Update();
+	const SpatialOutput expected = spatialAudio.GetOutput(ids.back());
+	for (EmitterId id : ids) {
+		const SpatialOutput output = spatialAudio.GetOutput(id);
+		EXPECT_NEAR(output.volume, expected.volume, 1e-6f);
+		EXPECT_NEAR(output.pan, expected.pan, 1e-6f);
+		EXPECT_NEAR(output.frequencyRatio, expected.frequencyRatio, 1e-6f);
+	}
+}
+
+TEST(SpatialAudioTest, AppliesOutputsToPlayingVoices) {
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2);
+	SpatialAudio spatialAudio(pool);
+	SetDefaultListener(spatialAudio);
+
+	const EmitterId emitter = spatialAudio.CreateEmitter({ 4.0f, 0.0f, 0.0f }, 1.0f, 100.0f);
+	SoundHandle sound = MakeMonoSound();
+	std::weak_ptr<const SoundAsset> weak = sound;
+	ASSERT_NE(spatialAudio.Play(emitter, sound), kInvalidSourceVoiceId);
+	sound.reset();
+	ASSERT_EQ(xAudio2.GetVoices().size(), 1u);
+	const IXAudio2SourceVoice* voice = xAudio2.GetVoices()[0];
+	EXPECT_NEAR(voice->GetVolume(), 0.25f, 1e-5f);
+	// 右端にあるので左には出さない
+	ASSERT_EQ(voice->GetOutputMatrix().size(), 2u);
+	EXPECT_NEAR(voice->GetOutputMatrix()[0], 0.0f, 1e-5f);
+	EXPECT_NEAR(voice->GetOutputMatrix()[1], 1.0f, 1e-5f);
+
+	spatialAudio.SetEmitterPosition(emitter, { 0.0f, 0.0f, 2.0f });
+	spatialAudio.Update();
+	EXPECT_NEAR(voice->GetVolume(), 0.5f, 1e-5f);
+
+	// エミッターを消すと音も止まり、捨てたバッファが戻ったら音声データを離す
+	spatialAudio.DestroyEmitter(emitter);
+	EXPECT_EQ(pool.GetActiveVoiceCount(), 0u);
+	EXPECT_FALSE(weak.expired());
+	xAudio2.Process();
+	pool.Update();
+	EXPECT_TRUE(weak.expired());
+}
+
+TEST(SpatialAudioTest, UpdatesManyEmitters) {
+	IXAudio2 xAudio2;
+	SourceVoicePool pool;
+	pool.Init(&xAudio2, 32);
+	SpatialAudio spatialAudio(pool);
+
+	std::mt19937 random(25);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> velocity(-20.0f, 20.0f);
+	std::vector<EmitterId> ids;
+	std::vector<Vector3> positions;
+	for (uint32_t i = 0; i < kEmitterCount; ++i) {
+		positions.push_back({ position(random), position(random), position(random) });
+		const EmitterId id = spatialAudio.CreateEmitter(positions.back(), 1.0f, 80.0f);
+		ASSERT_NE(id, kInvalidEmitterId);
+		spatialAudio.SetEmitterVelocity(id, { velocity(random), velocity(random), velocity(random) });
+		ids.push_back(id);
+	}
+	EXPECT_EQ(spatialAudio.GetEmitterCount(), kEmitterCount);
+	// プールの上限まで鳴らす
+	const SoundHandle sound = MakeMonoSound();
+	for (uint32_t i = 0; i < pool.GetMaxVoiceCount(); ++i) {
+		ASSERT_NE(spatialAudio.Play(ids[i * 7], sound), kInvalidSourceVoiceId);
+	}
+
+	// リスナーを回しながら何フレームか更新する
+	Vector3 listener = {};
+	for (int frame = 0; frame < 60; ++frame) {
+		listener = { std::cos(frame * 0.05f) * 10.0f, 0.0f, std::sin(frame * 0.05f) * 10.0f };
+		spatialAudio.SetListener(listener, MakeRotateYMatrix(frame * 0.01f), 1.0f / 60.0f);
+		spatialAudio.Update();
+	}
+
+	// 全エミッターの減衰が最後のリスナーの位置からの距離どおりで、パンと再生速度は範囲内
+	for (uint32_t i = 0; i < kEmitterCount; ++i) {
+		const SpatialOutput output = spatialAudio.GetOutput(ids[i]);
+		const Vector3 offset = positions[i] - listener;
+		const float distance = std::clamp(Length(offset), 1.0f, 80.0f);
+		EXPECT_NEAR(output.volume, 1.0f / distance, 1e-5f) << "emitter " << i;
+		EXPECT_GE(output.pan, -1.0f);
+		EXPECT_LE(output.pan, 1.0f);
+		EXPECT_GT(output.frequencyRatio, 0.0f);
+		EXPECT_TRUE(std::isfinite(output.frequencyRatio));
+	}
+
+	// 鳴っている音には最後のUpdateの値が入っている
+	EXPECT_EQ(pool.GetActiveVoiceCount(), pool.GetMaxVoiceCount());
+	ASSERT_EQ(xAudio2.GetVoices().size(), pool.GetMaxVoiceCount());
+	for (uint32_t i = 0; i < pool.GetMaxVoiceCount(); ++i) {
+		const SpatialOutput output = spatialAudio.GetOutput(ids[i * 7]);
+		const IXAudio2SourceVoice* voice = xAudio2.GetVoices()[i];
+		EXPECT_NEAR(voice->GetVolume(), output.volume, 1e-6f) << "voice " << i;
+		EXPECT_NEAR(voice->GetFrequencyRatio(), output.frequencyRatio, 1e-6f) << "voice " << i;
+	}
+}
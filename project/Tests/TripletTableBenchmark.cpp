@@ -0,0 +1,172 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "TripletTable.h"
+
+// objの頂点の重複除去に使うTripletTableと、置き換える前のstd::unordered_mapの速さとメモリを比べるベンチマーク
+// キーは格子状のメッシュの面の頂点をファイルの順に並べたもの (1つの頂点を平均6回引く)
+// 引数は格子の1辺の頂点数と、キーの並びをばらばらにするか (0/1)
+// memoryは表が確保したバイト数、bytesPerEntryは要素1つあたりのバイト数
+
+namespace {
+	using ObjDetail::TripletKey;
+	using ObjDetail::TripletTable;
+
+	// 置き換える前のmain.cppのハッシュ
+	struct TripletHash {
+		size_t operator()(const TripletKey& k) const noexcept {
+			size_t h = 0;
+			auto mix = [&](uint32_t x) {
+				h ^= std::hash<uint32_t>{}(x)+0x9e3779b97f4a7c15ULL + (h << 5) + (h >> 2);
+				};
+
+			mix(k.v);
+			mix(k.vt);
+			mix(k.vn);
+			return h;
+		}
+	};
+
+	// 確保したバイト数を数えるアロケーター (unordered_mapのノードとバケットの分)
+	template<class T>
+	struct CountingAllocator {
+		using value_type = T;
+
+		size_t* allocatedBytes;
+
+		explicit CountingAllocator(size_t* bytes) : allocatedBytes(bytes) {}
+		template<class U>
+		CountingAllocator(const CountingAllocator<U>& other) : allocatedBytes(other.allocatedBytes) {}
+
+		T* allocate(size_t n) {
+			*allocatedBytes += n * sizeof(T);
+			return std::allocator<T>().allocate(n);
+		}
+		void deallocate(T* p, size_t n) {
+			*allocatedBytes -= n * sizeof(T);
+			std::allocator<T>().deallocate(p, n);
+		}
+
+		template<class U>
+		bool operator==(const CountingAllocator<U>& other) const { return allocatedBytes == other.allocatedBytes; }
+	};
+
+	using TripletMap = std::unordered_map<TripletKey, uint32_t, TripletHash, std::equal_to<TripletKey>,
+		CountingAllocator<std::pair<const TripletKey, uint32_t>>>;
+
+	// gridSize x gridSizeの格子の三角形の頂点 (位置・UV・法線の番号は同じ)
+	std::vector<TripletKey> MakeCornerKeys(int gridSize, bool isShuffled) {
+		std::vector<TripletKey> corners;
+		corners.reserve(size_t(gridSize - 1) * (gridSize - 1) * 6);
+		for (int z = 0; z + 1 < gridSize; ++z) {
+			for (int x = 0; x + 1 < gridSize; ++x) {
+				const uint32_t i0 = static_cast<uint32_t>(z * gridSize + x);
+				const uint32_t i1 = i0 + 1;
+				const uint32_t i2 = i0 + gridSize;
+				const uint32_t i3 = i2 + 1;
+				for (uint32_t i : { i0, i2, i1, i1, i2, i3 }) {
+					corners.push_back({ i, i, i });
+				}
+			}
+		}
+		if (isShuffled) {
+			std::mt19937 random(15);
+			std::shuffle(corners.begin(), corners.end(), random);
+		}
+		return corners;
+	}
+
+	void SetCounters(benchmark::State& state, size_t cornerCount, size_t entryCount, size_t memoryBytes) {
+		state.SetItemsProcessed(state.iterations() * int64_t(cornerCount));
+		state.counters["memory"] = benchmark::Counter(static_cast<double>(memoryBytes), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+		state.counters["bytesPerEntry"] = static_cast<double>(memoryBytes) / static_cast<double>(entryCount);
+	}
+
+	// ObjLoaderと同じく、面の数から見込みを立てて追加していく
+	void BM_TripletTableInsert(benchmark::State& state) {
+		const std::vector<TripletKey> corners = MakeCornerKeys(static_cast<int>(state.range(0)), state.range(1) != 0);
+		size_t entryCount = 0;
+		size_t memoryBytes = 0;
+		for (auto _ : state) {
+			TripletTable table(corners.size() / 3 / 2);
+			uint32_t next = 0;
+			for (const TripletKey& key : corners) {
+				auto [index, isInserted] = table.TryEmplace(key, next);
+				next += isInserted;
+				benchmark::DoNotOptimize(index);
+			}
+			entryCount = table.Size();
+			memoryBytes = table.GetMemoryBytes();
+		}
+		SetCounters(state, corners.size(), entryCount, memoryBytes);
+	}
+	BENCHMARK(BM_TripletTableInsert)->ArgsProduct({ { 128, 512 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+	// 置き換える前と同じく、findしてから無ければemplaceする (reserveしない)
+	void BM_UnorderedMapInsert(benchmark::State& state) {
+		const std::vector<TripletKey> corners = MakeCornerKeys(static_cast<int>(state.range(0)), state.range(1) != 0);
+		size_t entryCount = 0;
+		size_t memoryBytes = 0;
+		for (auto _ : state) {
+			size_t allocatedBytes = 0;
+			TripletMap map(0, TripletHash{}, std::equal_to<TripletKey>{}, TripletMap::allocator_type(&allocatedBytes));
+			uint32_t next = 0;
+			for (const TripletKey& key : corners) {
+				auto it = map.find(key);
+				uint32_t index;
+				if (it == map.end()) {
+					index = next++;
+					map.emplace(key, index);
+				} else {
+					index = it->second;
+				}
+				benchmark::DoNotOptimize(index);
+			}
+			entryCount = map.size();
+			memoryBytes = allocatedBytes;
+		}
+		SetCounters(state, corners.size(), entryCount, memoryBytes);
+	}
+	BENCHMARK(BM_UnorderedMapInsert)->ArgsProduct({ { 128, 512 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+	// 全部入った表を同じキーの並びで引く
+	void BM_TripletTableLookup(benchmark::State& state) {
+		const std::vector<TripletKey> corners = MakeCornerKeys(static_cast<int>(state.range(0)), state.range(1) != 0);
+		TripletTable table(corners.size() / 3 / 2);
+		uint32_t next = 0;
+		for (const TripletKey& key : corners) {
+			next += table.TryEmplace(key, next).second;
+		}
+		for (auto _ : state) {
+			uint32_t sum = 0;
+			for (const TripletKey& key : corners) {
+				sum += *table.Find(key);
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		SetCounters(state, corners.size(), table.Size(), table.GetMemoryBytes());
+	}
+	BENCHMARK(BM_TripletTableLookup)->ArgsProduct({ { 128, 512 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+	void BM_UnorderedMapLookup(benchmark::State& state) {
+		const std::vector<TripletKey> corners = MakeCornerKeys(static_cast<int>(state.range(0)), state.range(1) != 0);
+		size_t allocatedBytes = 0;
+		TripletMap map(0, TripletHash{}, std::equal_to<TripletKey>{}, TripletMap::allocator_type(&allocatedBytes));
+		uint32_t next = 0;
+		for (const TripletKey& key : corners) {
+			next += map.emplace(key, next).second;
+		}
+		for (auto _ : state) {
+			uint32_t sum = 0;
+			for (const TripletKey& key : corners) {
+				sum += map.find(key)->second;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		SetCounters(state, corners.size(), map.size(), allocatedBytes);
+	}
+	BENCHMARK(BM_UnorderedMapLookup)->ArgsProduct({ { 128, 512 }, { 0, 1 } })->Unit(benchmark::kMillisecond);
+}
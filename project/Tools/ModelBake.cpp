@@ -0,0 +1,82 @@
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Logger.h"
+#include "ModelCache.h"
+#include "ThreadPool.h"
+
+// objファイルのキャッシュ(.mdlcache)を事前に作るツール
+// ゲームを起動しなくても、ビルドやリソースの更新のついでにまとめて焼いておける
+//
+// 使い方: ModelBake [-j スレッド数] objファイル...
+//   -j Nは呼び出しスレッドも含めてN本で読む (ワーカーはN-1本、-j 1なら呼び出しスレッドのみ)
+//   -j 0で論理コア数と同じ本数 (既定は0)
+// 全部書き出せたら0、1つでも失敗したら1を返す
+
+namespace {
+	void PrintUsage() {
+		std::fputs("使い方: ModelBake [-j スレッド数] objファイル...\n"
+			"  -j N  呼び出しスレッドを含めてN本で読む (0で論理コア数、既定は0)\n", stderr);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t threadCount = 0;
+	std::vector<std::filesystem::path> sources;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		if (arg == "-j") {
+			if (i + 1 >= argc) {
+				PrintUsage();
+				return 1;
+			}
+			const std::string_view value = argv[++i];
+			if (std::from_chars(value.data(), value.data() + value.size(), threadCount).ec != std::errc()) {
+				PrintUsage();
+				return 1;
+			}
+		} else if (arg == "-h" || arg == "--help") {
+			PrintUsage();
+			return 0;
+		} else {
+			sources.emplace_back(arg);
+		}
+	}
+	if (sources.empty()) {
+		PrintUsage();
+		return 1;
+	}
+
+	// 呼び出しスレッドも読むので、ワーカーは1本少なくする (0ならプールに任せて論理コア数-1本)
+	// 1スレッドならプールを作らずに呼び出しスレッドで読む
+	std::unique_ptr<ThreadPool> threadPool;
+	if (threadCount != 1) {
+		threadPool = std::make_unique<ThreadPool>(threadCount == 0 ? 0 : threadCount - 1);
+	}
+
+	int failedCount = 0;
+	for (const std::filesystem::path& source : sources) {
+		if (!std::filesystem::is_regular_file(source)) {
+			Logger::Write(std::format("ModelBake: {} が見つからない", source.string()));
+			++failedCount;
+			continue;
+		}
+		std::string directory = source.parent_path().string();
+		if (directory.empty()) {
+			directory = ".";
+		}
+		const std::string filename = source.filename().string();
+		if (BakeModelCache(directory, filename, threadPool.get())) {
+			Logger::Write(std::format("ModelBake: {} を書き出した", GetModelCachePath(directory, filename)));
+		} else {
+			Logger::Write(std::format("ModelBake: {} のキャッシュを書き出せなかった", source.string()));
+			++failedCount;
+		}
+	}
+	return failedCount == 0 ? 0 : 1;
+}
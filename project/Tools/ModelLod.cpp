@@ -0,0 +1,171 @@
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MeshLod.h"
+#include "ObjLoader.h"
+
+// objファイルからLODを作り、段階ごとの三角形数と誤差を表示するツール
+// -oを付けると各LODをobjファイルとして書き出すので、DCCツールで見比べられる
+//
+// 使い方: ModelLod [-n LODの最大数] [-r 残す割合] [-e 許す誤差] [-o 出力ディレクトリ] objファイル
+//   -n/-r/-eはGenerateLodsの引数 (既定は4, 0.5, 0.05)
+// 書き出したobjはmtlを元と同じ名前で参照する (出力ディレクトリに無ければコピーする)
+
+namespace {
+	void PrintUsage() {
+		std::fputs("使い方: ModelLod [-n LODの最大数] [-r 残す割合] [-e 許す誤差] [-o 出力ディレクトリ] objファイル\n", stderr);
+	}
+
+	template <typename T>
+	bool ParseValue(std::string_view text, T& value) {
+		return std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc() && !text.empty();
+	}
+
+	// LODの1段階をobjとして書き出す
+	// ObjLoaderの左手系への変換(X反転・V反転・巻き順反転)を戻し、そのLODで使う頂点だけを書く
+	bool WriteLodObj(const std::filesystem::path& path, const ModelData& modelData, const MeshLod& lod, const std::string& materialLibrary) {
+		std::vector<uint32_t> remap(modelData.vertices.size(), UINT32_MAX);
+		std::vector<uint32_t> usedVertices;
+		for (uint32_t s = 0; s < lod.subMeshCount; ++s) {
+			const SubMesh& subMesh = modelData.subMeshes[lod.subMeshOffset + s];
+			for (uint32_t i = 0; i < subMesh.indexCount; ++i) {
+				const uint32_t vertex = modelData.indices[subMesh.indexOffset + i];
+				if (remap[vertex] == UINT32_MAX) {
+					remap[vertex] = static_cast<uint32_t>(usedVertices.size()) + 1; // objの番号は1から
+					usedVertices.push_back(vertex);
+				}
+			}
+		}
+
+		std::string text = "# ModelLod\n";
+		if (!materialLibrary.empty()) {
+			text += std::format("mtllib {}\n", materialLibrary);
+		}
+		for (uint32_t vertex : usedVertices) {
+			const VertexData& v = modelData.vertices[vertex];
+			text += std::format("v {} {} {}\n", -v.position.x, v.position.y, v.position.z);
+			text += std::format("vt {} {}\n", v.texcoord.x, 1.0f - v.texcoord.y);
+			text += std::format("vn {} {} {}\n", -v.normal.x, v.normal.y, v.normal.z);
+		}
+		for (uint32_t s = 0; s < lod.subMeshCount; ++s) {
+			const SubMesh& subMesh = modelData.subMeshes[lod.subMeshOffset + s];
+			if (subMesh.materialIndex < modelData.materials.size()) {
+				text += std::format("usemtl {}\n", modelData.materials[subMesh.materialIndex].name);
+			}
+			const uint32_t* indices = modelData.indices.data() + subMesh.indexOffset;
+			for (uint32_t i = 0; i + 2 < subMesh.indexCount; i += 3) {
+				const uint32_t a = remap[indices[i + 2]];
+				const uint32_t b = remap[indices[i + 1]];
+				const uint32_t c = remap[indices[i]];
+				text += std::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", a, b, c);
+			}
+		}
+
+		FILE* file = std::fopen(path.string().c_str(), "wb");
+		if (!file) {
+			return false;
+		}
+		const bool isWritten = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+		return std::fclose(file) == 0 && isWritten;
+	}
+}
+
+int main(int argc, char* argv[]) {
+	uint32_t maxLodCount = 4;
+	float reduction = 0.5f;
+	float maxError = 0.05f;
+	std::filesystem::path outputDirectory;
+	std::filesystem::path source;
+	for (int i = 1; i < argc; ++i) {
+		const std::string_view arg = argv[i];
+		if (arg == "-h" || arg == "--help") {
+			PrintUsage();
+			return 0;
+		}
+		if (arg == "-n" || arg == "-r" || arg == "-e" || arg == "-o") {
+			if (i + 1 >= argc) {
+				PrintUsage();
+				return 1;
+			}
+			const std::string_view value = argv[++i];
+			bool isValid = true;
+			if (arg == "-n") {
+				isValid = ParseValue(value, maxLodCount) && maxLodCount > 0;
+			} else if (arg == "-r") {
+				isValid = ParseValue(value, reduction) && reduction > 0.0f && reduction < 1.0f;
+			} else if (arg == "-e") {
+				isValid = ParseValue(value, maxError) && maxError >= 0.0f;
+			} else {
+				outputDirectory = value;
+			}
+			if (!isValid) {
+				PrintUsage();
+				return 1;
+			}
+		} else if (source.empty()) {
+			source = arg;
+		} else {
+			PrintUsage();
+			return 1;
+		}
+	}
+	if (source.empty()) {
+		PrintUsage();
+		return 1;
+	}
+	if (!std::filesystem::is_regular_file(source)) {
+		std::fputs(std::format("ModelLod: {} が見つからない\n", source.string()).c_str(), stderr);
+		return 1;
+	}
+
+	std::string directory = source.parent_path().string();
+	if (directory.empty()) {
+		directory = ".";
+	}
+	ModelData modelData = LoadObjFile(directory, source.filename().string());
+	GenerateLods(modelData, maxLodCount, reduction, maxError);
+
+	// 段階ごとの三角形数と誤差 (誤差は境界球の半径に対する割合も出す)
+	std::fputs("LOD   三角形        割合      誤差  誤差/半径\n", stdout);
+	uint32_t baseIndexCount = 0;
+	for (size_t i = 0; i < modelData.lods.size(); ++i) {
+		const MeshLod& lod = modelData.lods[i];
+		uint32_t indexCount = 0;
+		for (uint32_t s = 0; s < lod.subMeshCount; ++s) {
+			indexCount += modelData.subMeshes[lod.subMeshOffset + s].indexCount;
+		}
+		if (i == 0) {
+			baseIndexCount = indexCount;
+		}
+		const float ratio = baseIndexCount > 0 ? 100.0f * static_cast<float>(indexCount) / static_cast<float>(baseIndexCount) : 0.0f;
+		const float radius = modelData.boundingSphere.radius;
+		std::fputs(std::format("{:3} {:8} {:10.1f}% {:9.5f} {:9.5f}\n",
+			i, indexCount / 3, ratio, lod.error, radius > 0.0f ? lod.error / radius : 0.0f).c_str(), stdout);
+	}
+
+	if (outputDirectory.empty()) {
+		return 0;
+	}
+	std::error_code errorCode;
+	std::filesystem::create_directories(outputDirectory, errorCode);
+	// mtlは元と同じ名前で参照するので、出力先に無ければコピーする
+	std::string materialLibrary;
+	if (!modelData.materialLibraryPath.empty() && std::filesystem::is_regular_file(modelData.materialLibraryPath)) {
+		const std::filesystem::path materialPath = modelData.materialLibraryPath;
+		materialLibrary = materialPath.filename().string();
+		std::filesystem::copy_file(materialPath, outputDirectory / materialLibrary, std::filesystem::copy_options::skip_existing, errorCode);
+	}
+	for (size_t i = 0; i < modelData.lods.size(); ++i) {
+		const std::filesystem::path path = outputDirectory / std::format("{}_lod{}.obj", source.stem().string(), i);
+		if (!WriteLodObj(path, modelData, modelData.lods[i], materialLibrary)) {
+			std::fputs(std::format("ModelLod: {} を書き出せなかった\n", path.string()).c_str(), stderr);
+			return 1;
+		}
+		std::fputs(std::format("{} を書き出した\n", path.string()).c_str(), stdout);
+	}
+	return 0;
+}
@@ -5,12 +5,20 @@
 #include <strsafe.h>
 #include <sstream>
 #include "Matrix.h"
+#include "Frustum.h"
+#include "TransformBatch.h"
+#include "ObjLoader.h"
+#include "ModelCache.h"
+#include "MeshLod.h"
+#include "MeshGenerator.h"
+#include "PackedVertex.h"
 #include "DebugCamera.h"
-#define _USE_MATH_DEFINES 
-#include <math.h>
 #include "StringUtil.h"
 #include "Input.h"
 #include "Sound.h"
+#include "SoundCache.h"
+#include "StreamingSound.h"
+#include "SpatialAudio.h"
 #include "DxcCompiler.h"
 #include "RootSignatureFactory.h"
 #include "InputLayout.h"
@@ -19,6 +27,8 @@
 #include "Sprite.h"
 #include "TextureManager.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <psapi.h>
 #pragma comment(lib, "Dbghelp.lib")
 
@@ -29,37 +39,6 @@ struct DirectionalLight {
 	float intensity;
 };
 
-struct MaterialData {
-	std::string textureFilePath;
-};
-
-// モデル関係の構造体
-struct ModelData {
-	std::vector<VertexData> vertices;
-	std::vector<uint32_t> indices;
-	MaterialData material;
-};
-
-// 三つ組のキー
-struct TripletKey {
-	uint32_t v, vt, vn;
-	bool operator == (const TripletKey&) const = default;
-};
-
-struct TripletHash {
-	size_t operator()(const TripletKey& k) const noexcept {
-		size_t h = 0;
-		auto mix = [&](uint32_t x) {
-			h ^= std::hash<uint32_t>{}(x)+0x9e3779b97f4a7c15ULL + (h << 5) + (h >> 2);
-			};
-
-		mix(k.v);
-		mix(k.vt);
-		mix(k.vn);
-		return h;
-	}
-};
-
 #pragma endregion
 
 #pragma region 自作関数
@@ -159,41 +138,6 @@ Microsoft::WRL::ComPtr<ID3D12Resource> CreateDepthStencilTextureResource(const M
 	return resource;
 }
 
-void WriteSphereVertices(const uint32_t subdivision, VertexData* vertexData) {
-	const float kLonEvery = 2.0f * float(M_PI) / float(subdivision); // 経度
-	const float kLatEvery = float(M_PI) / float(subdivision); // 緯度
-	// 緯度の方向に分割 -π/2 ~ π/2
-	for (uint32_t latIndex = 0; latIndex <= subdivision; ++latIndex) {
-		float lat = -float(M_PI) / 2.0f + kLatEvery * latIndex;
-
-		// 経度の方向に分割 0 ~ 2π
-		for (uint32_t lonIndex = 0; lonIndex <= subdivision; ++lonIndex) {
-			float lon = lonIndex * kLonEvery; // 現在の経度kLonEvery
-
-			Vector4 pos = {
-				cos(lat) * cos(lon),
-				sin(lat),
-				cos(lat) * sin(lon),
-				1.0f
-			};
-
-			// UV座標
-			Vector2 uv = {
-				lon / (2.0f * float(M_PI)),
-				1.0f - (lat + float(M_PI) / 2.0f) / float(M_PI)
-			};
-
-			uint32_t index = latIndex * (subdivision + 1) + lonIndex;
-			vertexData[index] = {
-				pos,
-				uv,
-				Normalize(Vector3(pos.x, pos.y, pos.z))
-			};
-
-		}
-	}
-}
-
 D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandle(Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>& descriptorHeap, uint32_t descriptorSize, uint32_t index) {
 	D3D12_CPU_DESCRIPTOR_HANDLE handleCPU = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
 	handleCPU.ptr += (descriptorSize * index);
@@ -206,115 +150,6 @@ D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandle(Microsoft::WRL::ComPtr<ID3D12
 	return handleGPU;
 }
 
-MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
-	// 必要な変数宣言とファイルを開く
-	MaterialData materialData; // 構築するMaterialData
-	std::string line; // ファイルから読んだ1行を格納するもの
-	std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
-	assert(file.is_open()); // 開けなかったら止める
-
-	// ファイルを読み、MaterialDataを構築
-	while (std::getline(file, line)) {
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier;
-
-		// identifierに応じた処理
-		if (identifier == "map_Kd") {
-			std::string textureFilename;
-			s >> textureFilename;
-			// 連結してファイルパスにする
-			materialData.textureFilePath = directoryPath + "/" + textureFilename;
-		}
-	}
-
-	return materialData;
-}
-
-ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename) {
-	ModelData modelData; // 
-	std::vector<Vector4> positions; // 位置
-	std::vector<Vector3> normals; // 法線
-	std::vector<Vector2> texcoords; // テクスチャ座標
-	std::string line; // ファイルから読んだ1行を格納するもの
-	std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
-	assert(file.is_open());
-
-	std::unordered_map<TripletKey, uint32_t, TripletHash> lut;
-
-	while (std::getline(file, line)) {
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier; // 先頭の識別子を読む
-
-		if (identifier == "v") {
-			Vector4 position;
-			s >> position.x >> position.y >> position.z;
-			position.w = 1.0f;
-			positions.push_back(position);
-		} else if (identifier == "vt") {
-			Vector2 texcoord;
-			s >> texcoord.x >> texcoord.y;
-			texcoords.push_back(texcoord);
-		} else if (identifier == "vn") {
-			Vector3 normal;
-			s >> normal.x >> normal.y >> normal.z;
-			normals.push_back(normal);
-		} else if (identifier == "f") {
-			//VertexData triangle[3];
-
-			struct FaceElm { uint32_t v, t, n; } f[3]{};
-
-			// 面は三角形限定。その他は未対応
-			for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
-				std::string vertexDefinition;
-				s >> vertexDefinition;
-				std::replace(vertexDefinition.begin(), vertexDefinition.end(), '/', ' ');
-				// 頂点の要素へのIndexは「位置/UV/法線」で格納されているので、分解してIndexを取得する
-				std::istringstream v(vertexDefinition);
-
-				v >> f[faceVertex].v >> f[faceVertex].t >> f[faceVertex].n;
-				f[faceVertex].v--;
-				f[faceVertex].t--;
-				f[faceVertex].n--;
-			}
-
-			for (int order : {2, 1, 0}) {
-				TripletKey key{ f[order].v, f[order].t, f[order].n };
-				auto it = lut.find(key);
-				uint32_t idx;
-				if (it == lut.end()) {
-					// 頂点生成
-					Vector4 p = positions[key.v];
-					Vector2 t = texcoords[key.vt];
-					Vector3 n = normals[key.vn];
-
-					p.x *= -1.0f;
-					t.y = 1.0f - t.y;
-					n.x *= -1.0f;
-
-					VertexData vtx{ p, t, n };
-					idx = (uint32_t)modelData.vertices.size();
-					modelData.vertices.push_back(vtx);
-					lut.emplace(key, idx);
-				} else {
-					idx = it->second;
-				}
-				modelData.indices.push_back(idx);
-			}
-
-		} else if (identifier == "mtllib") {
-			// materialTemplateLibraryファイルの名前を取得する
-			std::string materialFilename;
-			s >> materialFilename;
-			// 基本的にobjファイルと同一層にmtlは存在させるので、ディレクトリ名とファイル名を残す
-			modelData.material = LoadMaterialTemplateFile(directoryPath, materialFilename);
-		}
-	}
-
-	return modelData;
-}
-
 // Windowsアプリでのエントリーポイント(main関数)
 int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	D3DResourceLeakChecker leakCheck;
@@ -355,7 +190,7 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// 初期化完了ログ
 	Logger::Write("Complete Create D3D12Device!!!");
 
-	//ID3D12GraphicsCommandList* cmdList_ = graphics.GetCmdList();
+	ID3D12GraphicsCommandList* cmdList_ = graphics.GetCmdList();
 
 	// DxcCompilerの初期化
 	dxcCompiler.Init();
@@ -380,12 +215,14 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 #pragma region Texture読み込み
 	// モデル読み込み
-	/*ModelData modelData = LoadObjFile("resources", "axis.obj");
-	// 2枚目のTextureを読んで転送する
-	DirectX::ScratchImage mipImages2 = LoadTexture(modelData.material.textureFilePath);
-	const DirectX::TexMetadata& metadata2 = mipImages2.GetMetadata();
-	Microsoft::WRL::ComPtr<ID3D12Resource> textureResource2 = CreateTextureResource(graphics.GetDevice(), metadata2);
-	Microsoft::WRL::ComPtr<ID3D12Resource> intermediasteResource2 = UploadTextureData(textureResource2, mipImages2, graphics.GetDevice(), cmdList_);*/
+	ModelData modelData = LoadObjFileCached("resources", "axis.obj");
+	// 球などの基本形はファイルを使わずに作れる
+	//GenerateSphere(modelData, 16);
+	// マテリアルごとのテクスチャ (テクスチャの無いマテリアルはuvCheckerで描く)
+	std::vector<uint32_t> modelTextures;
+	for (const MaterialData& material : modelData.materials) {
+		modelTextures.push_back(material.textureFilePath.empty() ? tHChecker : TextureManager::Load(material.textureFilePath));
+	}
 #pragma endregion
 
 #pragma region SRVの設定
@@ -424,7 +261,7 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 #pragma region リソース設定
 	/*--モデル用のリソース設定--*/
 	// マテリアル用のリソースを作る。今回はcolor1つ分のサイズを用意する
-	/*Microsoft::WRL::ComPtr<ID3D12Resource> materialResource = CreateBufferResource(graphics.GetDevice(), sizeof(Material));
+	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource = CreateBufferResource(graphics.GetDevice(), sizeof(Material));
 	// マテリアルにデータを書き込む
 	Material* materialData = nullptr;
 	// 書き込むためのアドレスを取得
@@ -442,27 +279,29 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	directionalLightData->direction = { 1.0f, 0.0f, 0.0f };
 	directionalLightData->intensity = 1.0f;
 
-	// WVP用のリソースを作る。Matrix4x4 1つ分のサイズを用意する
-	Microsoft::WRL::ComPtr<ID3D12Resource> wvpResource = CreateBufferResource(graphics.GetDevice(), sizeof(TransformationMatrix));
+	// WVP用のリソースを作る。モデルを格子状に並べるので、置く数だけ用意する
+	// CBVの先頭は256バイト境界にそろえる必要があるので、1つ分を256バイトにする
+	constexpr uint32_t kModelGridSize = 4;
+	constexpr uint32_t kModelCount = kModelGridSize * kModelGridSize;
+	constexpr size_t kWvpStride = 256;
+	static_assert(sizeof(TransformationMatrix) <= kWvpStride);
+	Microsoft::WRL::ComPtr<ID3D12Resource> wvpResource = CreateBufferResource(graphics.GetDevice(), kWvpStride * kModelCount);
 	// データを書き込む
-	TransformationMatrix* wvpData = nullptr;
+	uint8_t* wvpData = nullptr;
 	// 書き込むためのアドレスを取得
 	wvpResource->Map(0, nullptr, reinterpret_cast<void**>(&wvpData));
 	// 単位行列を書き込んでおく
-	wvpData->WVP = MakeIdentity4x4();
-
-	//const uint32_t kSubdivision = 16; // 16分割
-
-	//uint32_t vertexNum = (kSubdivision + 1) * (kSubdivision + 1);
-	//uint32_t indexNum = kSubdivision * kSubdivision * 6;*/
+	for (uint32_t i = 0; i < kModelCount; ++i) {
+		TransformationMatrix* matrix = reinterpret_cast<TransformationMatrix*>(wvpData + kWvpStride * i);
+		matrix->WVP = MakeIdentity4x4();
+		matrix->World = MakeIdentity4x4();
+	}
 
-	/*--Index用リソース作成--*/
-	//Microsoft::WRL::ComPtr<ID3D12Resource> indexResourceModel = CreateBufferResource(graphics.GetDevice(), sizeof(uint32_t) * 6);
 #pragma endregion
 
-	// InputLayout
-	/*D3D12_INPUT_LAYOUT_DESC inputLayoutDesc3D{};
-	inputLayoutDesc3D = inputLayout.CreateInputLayout3D();
+	// InputLayout (モデルの頂点は圧縮したPackedVertexで送る)
+	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc3D{};
+	inputLayoutDesc3D = inputLayout.CreateInputLayout3DPacked();
 
 	// BlendStateの設定
 	D3D12_BLEND_DESC blendDesc{};
@@ -484,8 +323,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
 
 	// Shaderをコンパイルする
-	Microsoft::WRL::ComPtr<IDxcBlob> vs3DBlob = dxcCompiler.CompileShader(L"resources/hlsl/Object3D.VS.hlsl", L"vs_6_0");
-	Microsoft::WRL::ComPtr<IDxcBlob> ps3DBlob = dxcCompiler.CompileShader(L"resources/hlsl/Object3D.PS.hlsl", L"ps_6_0");
+	Microsoft::WRL::ComPtr<IDxcBlob> vs3DBlob = dxcCompiler.CompileShader(L"resources/hlsl/Object3dPacked.VS.hlsl", L"vs_6_0");
+	Microsoft::WRL::ComPtr<IDxcBlob> ps3DBlob = dxcCompiler.CompileShader(L"resources/hlsl/Object3d.PS.hlsl", L"ps_6_0");
 
 	// PSOを生成する
 	// 3D用
@@ -501,20 +340,25 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	);
 
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> pso3D = psoBuilder.BuildPso(psoDesc3D);
-	Logger::Write("PSO3D生成完了");*/
+	Logger::Write("PSO3D生成完了");
 
 #pragma region モデル用の頂点リソース
+	// 頂点はAABBの中の位置を16bitにして送る (1頂点16バイト)
+	std::vector<PackedVertex> packedVertices = PackVertices(modelData.vertices, modelData.bounds);
+	// 量子化した位置を元に戻す行列 (WVPに含めるのでシェーダーで戻す計算はいらない)
+	const Matrix4x4 dequantizeMatrix = MakeDequantizeMatrix(modelData.bounds);
+
 	// 頂点リソース
-	/*Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = CreateBufferResource(graphics.GetDevice(), sizeof(VertexData) * modelData.vertices.size());
+	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource = CreateBufferResource(graphics.GetDevice(), sizeof(PackedVertex) * packedVertices.size());
 
 	// 頂点バッファビューを作成する
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
 	// リソースの先頭のアドレスから使う
 	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-	// 使用するリソースのサイズは頂点3つ分のサイズ
-	vertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * modelData.vertices.size());
+	// 使用するリソースのサイズは全頂点分のサイズ
+	vertexBufferView.SizeInBytes = UINT(sizeof(PackedVertex) * packedVertices.size());
 	// 1頂点あたりのサイズ
-	vertexBufferView.StrideInBytes = sizeof(VertexData);
+	vertexBufferView.StrideInBytes = sizeof(PackedVertex);
 	Logger::Write("VertexResource生成完了");
 
 	// インデックスモデル用の頂点リソース
@@ -528,10 +372,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	Logger::Write("indexBufferViewModel生成完了");
 
 	// モデル用の頂点リソースにデータを書き込む
-	VertexData* vertexData = nullptr;
+	PackedVertex* vertexData = nullptr;
 	// 書き込むためのアドレスを取得
 	vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
-	std::memcpy(vertexData, modelData.vertices.data(), sizeof(VertexData) * modelData.vertices.size());
+	std::memcpy(vertexData, packedVertices.data(), sizeof(PackedVertex) * packedVertices.size());
 	vertexResource->Unmap(0, nullptr);
 	Logger::Write("VertexData生成完了");
 
@@ -542,33 +386,20 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	std::memcpy(indexDataModel, modelData.indices.data(), sizeof(uint32_t) * modelData.indices.size());
 	indexBufferModel->Unmap(0, nullptr);
 
-	Logger::Write("indexDataModelに書き込み完了");*/
+	Logger::Write("indexDataModelに書き込み完了");
 #pragma endregion
 
-	//uint32_t index = 0;
-	//uint32_t* indexDataModel = nullptr;
-	//indexResourceModel->Map(0, nullptr, reinterpret_cast<void**>(&indexDataModel));
-	//std::memcpy(indexDataModel, modelData.vertices.data(), sizeof(VertexData) * modelData.vertices.size());
-
-	/*for (uint32_t latIndex = 0; latIndex < kSubdivision; ++latIndex) {
-		for (uint32_t lonIndex = 0; lonIndex < kSubdivision; ++lonIndex) {
-			uint32_t ld = lonIndex + latIndex * (kSubdivision + 1);
-			uint32_t lt = lonIndex + (latIndex + 1) * (kSubdivision + 1);
-			uint32_t rd = (lonIndex + 1) + latIndex * (kSubdivision + 1);
-			uint32_t rt = (lonIndex + 1) + (latIndex + 1) * (kSubdivision + 1);
-
-			indexDataModel[index++] = rt;
-			indexDataModel[index++] = ld;
-			indexDataModel[index++] = lt;
-
-			indexDataModel[index++] = rd;
-			indexDataModel[index++] = ld;
-			indexDataModel[index++] = rt;
-		}
-	}*/
-
 	// Transform変数を作る
 	Transform transform = { {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f} };
+	// 並べるモデルのTransform (回転と拡縮はtransformと同じで、位置だけ格子状にずらす)
+	TransformSoA modelTransforms;
+	modelTransforms.Resize(kModelCount);
+	// 毎フレーム計算するワールド行列とWVP行列 (カリングとLODの選択にも使うので、書き込み専用のUploadヒープとは別に持つ)
+	std::vector<Matrix4x4> modelWorldMatrices(kModelCount);
+	std::vector<Matrix4x4> modelWvpMatrices(kModelCount);
+	// モデルごとの描画するか、どのLODか
+	std::vector<bool> isModelVisible(kModelCount);
+	std::vector<uint32_t> modelLodIndices(kModelCount);
 	//Transform cameraTransform = { {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -10.0f} };
 
 	Transform uvTransformSprite = {
@@ -581,11 +412,24 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	float modelColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
 
 	// 音声読み込み
-	SoundData soundData1 = xAudio2.SoundLoad("resources/gold.mp3");
+	// 同じパスは2回目から読み込まずに共有し、全部マスターボイスと同じサンプリングレートのfloatにそろえる
+	SoundCache soundCache(xAudio2, xAudio2.GetMixFormat());
+	SoundHandle soundData1 = soundCache.Load("resources/gold.mp3");
+	// BGMは全部読み込まずに少しずつデコードしながら鳴らす (Bキーで再生/一時停止)
+	StreamingSound bgm;
+	bgm.Open(xAudio2.GetXAudio2(), "resources/tin.mp3");
+	bool isBgmPlaying = false;
 	Logger::Write("音声読み込み");
 	DebugCamera debugCamera;
 	debugCamera.Initialize();
 
+	// 原点のまわりを回る音源 (Pキーで鳴らす)、聞く位置はカメラ
+	SpatialAudio spatialAudio(xAudio2.GetVoicePool());
+	const float orbitRadius = 10.0f;
+	const float orbitSpeed = 1.0f; // 1秒あたりの角度
+	float orbitAngle = 0.0f;
+	const EmitterId orbitEmitter = spatialAudio.CreateEmitter({ orbitRadius, 0.0f, 0.0f }, 2.0f, 100.0f);
+
 	sprite->Create(tHChecker, positoin, Color::WHITE);
 	
 	sprite->SetRotation(rotation);
@@ -597,44 +441,88 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		ImGui_ImplWin32_NewFrame();
 		ImGui::NewFrame();
 		input.Update();
+		xAudio2.Update();
 
 		/*-- 更新処理 --*/
-		if (input.IsPressed(DIK_SPACE)) {
+		if (input.IsPressed(DIK_SPACE) && soundData1) {
 			xAudio2.SoundPlayWave(soundData1);
 		}
+		if (input.IsPressed(DIK_B)) {
+			isBgmPlaying = !isBgmPlaying;
+			if (isBgmPlaying) {
+				bgm.Play();
+			} else {
+				bgm.Pause();
+			}
+		}
 
 		debugCamera.Update();
 
+		// 位置付きの音の更新 (カメラの後で)
+		const float deltaTime = ImGui::GetIO().DeltaTime;
+		orbitAngle += orbitSpeed * deltaTime;
+		spatialAudio.SetEmitterPosition(orbitEmitter, { orbitRadius * std::cos(orbitAngle), 0.0f, orbitRadius * std::sin(orbitAngle) });
+		spatialAudio.SetEmitterVelocity(orbitEmitter, { -orbitRadius * orbitSpeed * std::sin(orbitAngle), 0.0f, orbitRadius * orbitSpeed * std::cos(orbitAngle) });
+		if (input.IsPressed(DIK_P) && soundData1) {
+			spatialAudio.Play(orbitEmitter, soundData1);
+		}
+		spatialAudio.SetListener(debugCamera.GetPosition(), debugCamera.GetViewMatrix(), deltaTime);
+		spatialAudio.Update();
+
 		sprite->SetPosition(positoin);
 		sprite->SetColor(materialColor);
 		sprite->Update();
 
-		//materialData->color.x = modelColor[0];
-		//materialData->color.y = modelColor[1];
-		//materialData->color.z = modelColor[2];
-		//materialData->color.w = modelColor[3];
+		materialData->color.x = modelColor[0];
+		materialData->color.y = modelColor[1];
+		materialData->color.z = modelColor[2];
+		materialData->color.w = modelColor[3];
 
 		//sprite->SetTransform(transformSprite);
 		//sprite->SetMaterial(spriteMaterial);
 		//sprite->SetTexture(textureSrvHandleGPU);
 		//sprite->SetUvTransform(uvTransformSprite);
 
-		/*Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
 		Matrix4x4 viewMatrix = debugCamera.GetViewMatrix();
 		Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, float(app->GetWidth()) / float(app->GetHeight()), 0.1f, 100.0f);
 		// WVPMatrixを作る
-		Matrix4x4 worldViewProjectionMatrix = Multiply(worldMatrix, Multiply(viewMatrix, projectionMatrix));
-		wvpData->World = worldMatrix;
-		wvpData->WVP = worldViewProjectionMatrix;*/
+		Matrix4x4 viewProjectionMatrix = Multiply(viewMatrix, projectionMatrix);
+		// 全モデルのワールド行列とWVP行列をまとめて求める
+		for (uint32_t i = 0; i < kModelCount; ++i) {
+			const Vector3 offset = {
+				(float(i % kModelGridSize) - float(kModelGridSize - 1) * 0.5f) * 3.0f,
+				0.0f,
+				(float(i / kModelGridSize) - float(kModelGridSize - 1) * 0.5f) * 3.0f,
+			};
+			modelTransforms.Set(i, transform.scale, transform.rotate,
+				{ transform.translate.x + offset.x, transform.translate.y + offset.y, transform.translate.z + offset.z });
+		}
+		MakeWorldViewProjectionBatch(modelTransforms, viewProjectionMatrix,
+			modelWorldMatrices.data(), sizeof(Matrix4x4), modelWvpMatrices.data(), sizeof(Matrix4x4));
+
+		// 視錐台の外にあるモデルは描画しない
+		Frustum frustum = MakeFrustum(viewProjectionMatrix);
+		for (uint32_t i = 0; i < kModelCount; ++i) {
+			isModelVisible[i] = IsVisible(frustum, TransformAABB(modelData.bounds, modelWorldMatrices[i]));
+			if (!isModelVisible[i]) {
+				continue;
+			}
+			// 画面上の大きさからLODを選ぶ
+			modelLodIndices[i] = SelectLod(modelData, modelWorldMatrices[i], debugCamera.GetPosition(), 0.45f, float(app->GetHeight()));
+			TransformationMatrix* matrix = reinterpret_cast<TransformationMatrix*>(wvpData + kWvpStride * i);
+			matrix->World = modelWorldMatrices[i];
+			// 頂点の位置は量子化してあるので、戻す行列を先に掛ける
+			matrix->WVP = Multiply(dequantizeMatrix, modelWvpMatrices[i]);
+		}
 
 		// 開発用のUIの処理、実際に開発用のUIを出す場合はここをゲーム固有の処理に置き換える
-		/*ImGui::SliderAngle("SphereRotateX", &transform.rotate.x);
+		ImGui::SliderAngle("SphereRotateX", &transform.rotate.x);
 		ImGui::SliderAngle("SphereRotateY", &transform.rotate.y);
 		ImGui::SliderAngle("SphereRotateZ", &transform.rotate.z);
 		ImGui::ColorEdit4("modelColor", modelColor);
-		ImGui::Checkbox("enableLighting", (bool*)&materialData->enableLighting);*/
+		ImGui::Checkbox("enableLighting", (bool*)&materialData->enableLighting);
 
-		ImGui::ColorEdit4("modelColor", (float*)&materialColor);
+		ImGui::ColorEdit4("spriteColor", (float*)&materialColor);
 		ImGui::SliderFloat2("translateSprite", (float*)&positoin, 0.0f, 1000.0f, "%.3f");
 		//ImGui::SliderFloat3("rotateSprite", (float*)&transformSprite.rotate, 0.0f, 10.0f, "%.3f");
 		//ImGui::SliderFloat3("scaleSprite", (float*)&transformSprite.scale, 0.0f, 10.0f, "%.3f");
@@ -642,6 +530,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		ImGui::Text("positoin.y : %f", positoin.y);
 		ImGui::Text("FPS: %.2f", ImGui::GetIO().Framerate);
 		ShowMemoryUsage();
+		ImGui::Text("SourceVoice active: %u free: %u", xAudio2.GetVoicePool().GetActiveVoiceCount(), xAudio2.GetVoicePool().GetFreeVoiceCount());
+		ImGui::Text("SoundCache: %zu sounds, %.2f MB", soundCache.GetCount(), soundCache.GetResidentBytes() / (1024.0 * 1024.0));
+		const SpatialOutput orbitOutput = spatialAudio.GetOutput(orbitEmitter);
+		ImGui::Text("Emitter volume: %.2f pan: %.2f pitch: %.3f", orbitOutput.volume, orbitOutput.pan, orbitOutput.frequencyRatio);
 		//ImGui::DragFloat2("UVTranslate", &uvTransformSprite.translate.x, 0.01f, -10.0f, 10.0f);
 		//ImGui::DragFloat2("UVScale", &uvTransformSprite.scale.x, 0.01f, -10.0f, 10.0f);
 		//ImGui::SliderAngle("UVRotate", &uvTransformSprite.rotate.z);
@@ -654,8 +546,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		graphics.BeginFrame();
 
 		// RootSignatureを設定。PSOに設定しているけど別途設定が必要
-		//cmdList_->SetGraphicsRootSignature(rootSignature.Get());
-		/*cmdList_->SetPipelineState(pso3D.Get()); // PSOを設定
+		cmdList_->SetGraphicsRootSignature(rootSignature.Get());
+		cmdList_->SetPipelineState(pso3D.Get()); // PSOを設定
 		cmdList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 		cmdList_->IASetVertexBuffers(0, 1, &vertexBufferView); // VBVを設定
 		cmdList_->IASetIndexBuffer(&indexBufferViewModel);
@@ -663,16 +555,23 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		// 形状を設定。PSOに設定しているものとはまた別。同じものを設定する。
 		cmdList_->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
 
-		// wvp用のCBufferの場所を設定
-		cmdList_->SetGraphicsRootConstantBufferView(1, wvpResource->GetGPUVirtualAddress());
-
 		cmdList_->SetGraphicsRootConstantBufferView(3, directionalLightResource->GetGPUVirtualAddress());
 
-		// SRVのDescriptorTableの先頭を設定。2はrootParameter[2]である。
-		cmdList_->SetGraphicsRootDescriptorTable(2, useMonsterBall ? textureSrvHandleGPU2 : textureSrvHandleGPU);
-
-		// 描画 (DrawCall)。
-		cmdList_->DrawIndexedInstanced(UINT(modelData.indices.size()), 1, 0, 0, 0);*/
+		// 描画 (DrawCall)。モデルごとに、選んだLODのマテリアルごとに1回描く
+		// SRVのDescriptorTableはrootParameter[2]で、マテリアルごとに切り替える
+		for (uint32_t model = 0; model < kModelCount; ++model) {
+			if (!isModelVisible[model]) {
+				continue;
+			}
+			// wvp用のCBufferの場所を設定
+			cmdList_->SetGraphicsRootConstantBufferView(1, wvpResource->GetGPUVirtualAddress() + kWvpStride * model);
+			const MeshLod& modelLod = modelData.lods[modelLodIndices[model]];
+			for (uint32_t i = 0; i < modelLod.subMeshCount; ++i) {
+				const SubMesh& subMesh = modelData.subMeshes[modelLod.subMeshOffset + i];
+				cmdList_->SetGraphicsRootDescriptorTable(2, TextureManager::GetGPUHandle(modelTextures[subMesh.materialIndex]));
+				cmdList_->DrawIndexedInstanced(subMesh.indexCount, 1, subMesh.indexOffset, 0, 0);
+			}
+		}
 
 		spriteCommon->DrawCommon();
 		sprite->Draw();
@@ -683,8 +582,10 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 	input.Shutdown();
 
+	bgm.Close();
 	xAudio2.Shutdown();
-	xAudio2.SoundUnload(&soundData1);
+	soundData1.reset();
+	soundCache.Clear();
 
 
 	graphics.Shutdown();
@@ -0,0 +1,35 @@
+#include "Object3d.hlsli"
+
+struct TransformationMatrix
+{
+    float4x4 WVP; // MakeDequantizeMatrixを掛けたもの
+    float4x4 World;
+};
+
+ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+
+// PackedVertexの入力 (UNORM/SNORM/FLOATの変換はInputAssemblerが行う)
+struct VertexShaderInput
+{
+    float4 position : POSITION0;
+    float2 texcoord : TEXCOORD0;
+    float2 normal : NORMAL0;
+};
+
+// 八面体写像した法線を戻す
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 normal = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = saturate(-normal.z);
+    normal.xy -= fold * (step(0.0f, normal.xy) * 2.0f - 1.0f);
+    return normalize(normal);
+}
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    output.position = mul(input.position, gTransformationMatrix.WVP);
+    output.texcoord = input.texcoord;
+    output.normal = normalize(mul(DecodeOctahedral(input.normal), (float3x3)gTransformationMatrix.World));
+    return output;
+}
\ No newline at end of file